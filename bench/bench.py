@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+
+# Performance benchmark of ccfd: runs scalable cartesian and unstructured
+# cases for every thread count and stores the throughput, the scaling
+# efficiency and the startup time in a JSON file, which can be compared
+# with the file of an earlier run
+
+import sys
+import os
+import json
+import time
+import socket
+import argparse
+import subprocess
+from string import Template
+
+# cases: template, mesh file in the calc directory for the unstructured cases,
+# substitutions, equation systems, and for the cartesian cases the number of
+# elements in each direction
+rk = {"implicit": "F", "precond": "F", "analyticJacobian": "F",
+      "timeOrder": 2, "CFL": 0.9, "stationary": "F"}
+gmres = {"implicit": "T", "precond": "F", "analyticJacobian": "F",
+         "timeOrder": 1, "CFL": 10.0, "stationary": "T"}
+lusgs = {"implicit": "T", "precond": "T", "analyticJacobian": "T",
+         "timeOrder": 1, "CFL": 10.0, "stationary": "T"}
+
+cases = [
+    {"name": "cart_rk", "template": "cartesian.ini",
+     "par": dict(rk, mu=0.0, maxIter=100),
+     "eqn": ["euler", "navierstokes"], "nElems": [64, 128, 256]},
+    {"name": "cart_gmres", "template": "cartesian.ini",
+     "par": dict(gmres, mu=0.0, maxIter=20),
+     "eqn": ["euler", "navierstokes"], "nElems": [64, 128, 256]},
+    {"name": "cart_lusgs", "template": "cartesian.ini",
+     "par": dict(lusgs, mu=0.0, maxIter=20),
+     "eqn": ["euler", "navierstokes"], "nElems": [64, 128, 256]},
+    {"name": "cart_ns_rk", "template": "cartesian.ini",
+     "par": dict(rk, mu=0.1, maxIter=100),
+     "eqn": ["navierstokes"], "nElems": [64, 128, 256]},
+    {"name": "naca0012_rk", "template": "naca0012.ini",
+     "mesh": "naca0012/NACA0012.msh",
+     "par": dict(rk, mu=0.0, maxIter=100),
+     "eqn": ["euler", "navierstokes"]},
+    {"name": "cylinder_gmres", "template": "cylinder.ini",
+     "mesh": "cylinder/cylinder.msh",
+     "par": dict(gmres, mu=0.0, maxIter=20, wallBC=101, spatialOrder=1),
+     "eqn": ["euler", "navierstokes"]},
+    {"name": "cylinder_lusgs", "template": "cylinder.ini",
+     "mesh": "cylinder/cylinder.msh",
+     "par": dict(lusgs, mu=0.0, maxIter=20, wallBC=101, spatialOrder=1),
+     "eqn": ["euler", "navierstokes"]},
+    {"name": "cylinder_ns_rk", "template": "cylinder.ini",
+     "mesh": "cylinder/cylinder_visc.msh",
+     "par": dict(rk, mu=0.001, maxIter=100, wallBC=201, spatialOrder=2),
+     "eqn": ["navierstokes"]},
+]
+
+parser = argparse.ArgumentParser(description="Performance benchmark of ccfd")
+parser.add_argument("exe", help="ccfd executable")
+parser.add_argument("eqn", help="equation system of the executable")
+parser.add_argument("--threads", type=int, nargs="+", default=[1],
+                    help="thread counts of the sweep")
+parser.add_argument("--cases", nargs="+", default=None,
+                    help="names of the cases to run (default: all)")
+parser.add_argument("--repeat", type=int, default=1,
+                    help="runs per case, the fastest one is kept")
+parser.add_argument("--output", default=None,
+                    help="result file (default: bench_<eqn>.json)")
+parser.add_argument("--compare", default=None,
+                    help="result file of an earlier run")
+parser.add_argument("--tolerance", type=float, default=0.1,
+                    help="relative throughput loss counted as regression")
+args = parser.parse_args()
+
+exe = os.path.abspath(args.exe)
+output = args.output if args.output else "bench_%s.json" % args.eqn
+threads = sorted(set(args.threads))
+runDir = "run"
+os.makedirs(runDir, exist_ok=True)
+
+# the parameter file has no paths, the meshes are linked into the run
+# directory
+for case in cases:
+    if "mesh" in case:
+        link = os.path.join(runDir, os.path.basename(case["mesh"]))
+        if not os.path.exists(link):
+            os.symlink(os.path.abspath(os.path.join("..", "calc",
+                                                    case["mesh"])), link)
+        case["par"]["meshFile"] = os.path.splitext(
+            os.path.basename(case["mesh"]))[0]
+
+print("Benchmarking '%s', compiled with %s equation system" % (exe, args.eqn))
+print("Threads: %s" % " ".join(str(n) for n in threads))
+
+
+def run(case, nElemsX, nElemsY, nThreads):
+    """run one case and return the contents of its timer file"""
+    name = "%s_t%d" % (case["name"], nThreads)
+    if nElemsX > 0:
+        name = "%s_%dx%d_t%d" % (case["name"], nElemsX, nElemsY, nThreads)
+    par = dict(case["par"], nElemsX=nElemsX, nElemsY=nElemsY,
+               fileName=name, timerFile=name + ".json")
+
+    with open(os.path.join("cases", case["template"])) as f:
+        ini = Template(f.read()).substitute(par)
+    with open(os.path.join(runDir, name + ".ini"), "w") as f:
+        f.write(ini)
+
+    # pinned threads keep the first-touch placement of the arrays
+    env = dict(os.environ, OMP_NUM_THREADS=str(nThreads))
+    env.setdefault("OMP_PROC_BIND", "close")
+    env.setdefault("OMP_PLACES", "cores")
+    best = None
+    for i in range(args.repeat):
+        timerFile = os.path.join(runDir, name + ".json")
+        if os.path.exists(timerFile):
+            os.remove(timerFile)
+
+        tic = time.time()
+        with open(os.path.join(runDir, name + ".log"), "w") as log:
+            ret = subprocess.call([exe, name + ".ini"], cwd=runDir,
+                                  stdout=log, stderr=subprocess.STDOUT, env=env)
+        wall = time.time() - tic
+
+        if ret != 0 or not os.path.exists(timerFile):
+            print(" - %-32s: failed, see %s.log" % (name, name))
+            return None
+
+        with open(timerFile) as f:
+            res = json.load(f)
+        # everything that is not the time loop: reading and preparing the
+        # mesh, initialization, and the final clean up
+        res["startup"] = wall - res["time"]
+        if best is None or res["time"] < best["time"]:
+            best = res
+
+    print(" - %-32s: %10.4g cell updates/s" % (name,
+          best["cellUpdatesPerSecond"]))
+
+    return {"case": case["name"], "elements": best["elements"],
+            "threads": nThreads, "iterations": best["iterations"],
+            "time": best["time"], "startup": best["startup"],
+            "cellUpdatesPerSecond": best["cellUpdatesPerSecond"],
+            "cellResidualsPerSecond": best["cellResidualsPerSecond"],
+            "phases": best["phases"]}
+
+
+# run all cases for all thread counts, the cartesian cases additionally with
+# a fixed number of elements per thread for the weak scaling
+runs = []
+for case in cases:
+    if args.eqn not in case["eqn"]:
+        continue
+    if args.cases and case["name"] not in args.cases:
+        continue
+
+    for n in case.get("nElems", [0]):
+        for scaling in ("strong", "weak"):
+            if scaling == "weak" and n == 0:
+                continue
+
+            for nThreads in threads:
+                if scaling == "weak" and nThreads == threads[0]:
+                    continue
+
+                nElemsY = n * nThreads // threads[0] if scaling == "weak" else n
+                res = run(case, n, nElemsY, nThreads)
+                if res is None:
+                    continue
+
+                res["scaling"] = scaling
+                runs.append(res)
+
+# scaling efficiency with respect to the smallest thread count, the
+# throughput is per cell and iteration, so strong and weak scaling have the
+# same definition, only with a different number of elements
+def reference(res):
+    """strong scaling run with the smallest thread count and the same
+    number of elements per thread"""
+    nElems = res["elements"]
+    if res["scaling"] == "weak":
+        nElems = res["elements"] * threads[0] // res["threads"]
+    for r in runs:
+        if (r["case"] == res["case"] and r["scaling"] == "strong" and
+                r["threads"] == threads[0] and r["elements"] == nElems):
+            return r
+    return None
+
+
+for res in runs:
+    ref = reference(res)
+    res["efficiency"] = None
+    if ref:
+        res["efficiency"] = (res["cellUpdatesPerSecond"] * threads[0] /
+                             (ref["cellUpdatesPerSecond"] * res["threads"]))
+
+print("\n %-16s %-6s %9s %7s %14s %10s %10s" % ("case", "scale", "elements",
+      "threads", "updates/s", "efficiency", "startup"))
+for res in runs:
+    eff = "%10.3f" % res["efficiency"] if res["efficiency"] else "%10s" % "-"
+    print(" %-16s %-6s %9d %7d %14.4g %s %9.3fs" % (res["case"],
+          res["scaling"], res["elements"], res["threads"],
+          res["cellUpdatesPerSecond"], eff, res["startup"]))
+
+result = {"executable": exe, "eqn": args.eqn, "host": socket.gethostname(),
+          "date": time.strftime("%Y-%m-%d %H:%M:%S"), "threads": threads,
+          "runs": runs}
+with open(output, "w") as f:
+    json.dump(result, f, indent=2)
+print("\nResults written to '%s'" % output)
+
+# compare the throughput with an earlier run of the same cases
+if args.compare:
+    with open(args.compare) as f:
+        old = json.load(f)
+
+    key = lambda r: (r["case"], r["scaling"], r["elements"], r["threads"])
+    oldRuns = {key(r): r for r in old["runs"]}
+
+    print("\nComparison with '%s' (%s):" % (args.compare, old["date"]))
+    isRegression = False
+    for res in runs:
+        if key(res) not in oldRuns:
+            continue
+
+        ratio = (res["cellUpdatesPerSecond"] /
+                 oldRuns[key(res)]["cellUpdatesPerSecond"])
+        status = "good"
+        if ratio < 1.0 - args.tolerance:
+            status = "slower"
+            isRegression = True
+        print(" - %-16s %-6s %9d %3d: %6.3f %s" % (res["case"],
+              res["scaling"], res["elements"], res["threads"], ratio, status))
+
+    if isRegression:
+        sys.exit(1)
@@ -0,0 +1,115 @@
+/** \file
+ *
+ * \brief Microbenchmark for the block versions of the flux functions
+ *
+ * Calculates the convective fluxes of a large number of random face states
+ * for every flux function and reports the throughput in faces per second.
+ * Usage: fluxBench [nFaces] [nRepeat]
+ *
+ * \author hhh
+ * \date Wed 14 Oct 2026 02:41:07 PM CEST
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+
+#include "main.h"
+#include "equation.h"
+#include "fluxCalculation.h"
+#include "timeDiscretization.h"
+
+/**
+ * \brief Uniformly distributed random number between a and b
+ * \param[in] a Lower bound
+ * \param[in] b Upper bound
+ * \return Random number
+ */
+double randBetween(double a, double b)
+{
+	return a + (b - a) * (double)rand() / (double)RAND_MAX;
+}
+
+/**
+ * \brief Main benchmark routine
+ */
+int main(int argc, char *argv[])
+{
+	long nFaces = 1000000;
+	int nRepeat = 10;
+	if (argc > 1) {
+		nFaces = atol(argv[1]);
+	}
+	if (argc > 2) {
+		nRepeat = atoi(argv[2]);
+	}
+
+	if ((nFaces < 1) || (nRepeat < 1)) {
+		printf("| ERROR: Number of faces and repetitions must be positive\n");
+		exit(1);
+	}
+
+	gam = 1.4;
+	initGasConstants();
+
+	/* random rotated states, with sub- and supersonic normal velocities */
+	long nBlocks = (nFaces + FLUX_BLOCK - 1) / FLUX_BLOCK;
+	double (*qL)[NVAR][FLUX_BLOCK] = malloc(nBlocks * sizeof(*qL));
+	double (*qR)[NVAR][FLUX_BLOCK] = malloc(nBlocks * sizeof(*qR));
+	double (*f)[NVAR][FLUX_BLOCK]  = malloc(nBlocks * sizeof(*f));
+	if ((qL == NULL) || (qR == NULL) || (f == NULL)) {
+		printf("| ERROR: Unable to allocate %ld faces\n", nFaces);
+		exit(1);
+	}
+
+	srand(1);
+	for (long iBlock = 0; iBlock < nBlocks; ++iBlock) {
+		for (int i = 0; i < FLUX_BLOCK; ++i) {
+			qL[iBlock][RHO][i] = randBetween(0.5, 1.5);
+			qL[iBlock][VX][i]  = randBetween(-2.0, 2.0);
+			qL[iBlock][VY][i]  = randBetween(-1.0, 1.0);
+			qL[iBlock][P][i]   = randBetween(0.5, 1.5);
+
+			qR[iBlock][RHO][i] = randBetween(0.5, 1.5);
+			qR[iBlock][VX][i]  = randBetween(-2.0, 2.0);
+			qR[iBlock][VY][i]  = randBetween(-1.0, 1.0);
+			qR[iBlock][P][i]   = randBetween(0.5, 1.5);
+		}
+	}
+
+	const char *fluxName[] = {
+		"Godunov", "Roe", "HLL", "HLLE", "HLLC", "Lax-Friedrichs",
+		"Steger-Warming", "Central", "AUSMD", "AUSMDV", "van Leer"
+	};
+
+	printf("\nFlux Benchmark: %ld faces, %d repetitions, block size %d\n",
+			nFaces, nRepeat, FLUX_BLOCK);
+	for (iFlux = GOD; iFlux <= VANLEER; ++iFlux) {
+		double tStart = CPU_TIME();
+		for (int iRepeat = 0; iRepeat < nRepeat; ++iRepeat) {
+			#pragma omp parallel for
+			for (long iBlock = 0; iBlock < nBlocks; ++iBlock) {
+				long firstFace = iBlock * FLUX_BLOCK;
+				int nFacesBlock = (nFaces - firstFace < FLUX_BLOCK) ?
+					nFaces - firstFace : FLUX_BLOCK;
+				convectiveFluxBlock(nFacesBlock, qL[iBlock], qR[iBlock], f[iBlock]);
+			}
+		}
+		double tEnd = CPU_TIME();
+
+		/* checksum, so that the flux calculation is not optimized away */
+		double sum = 0.0;
+		for (long iFace = 0; iFace < nFaces; ++iFace) {
+			sum += f[iFace / FLUX_BLOCK][E][iFace % FLUX_BLOCK];
+		}
+
+		printf("| %-15s: %10.4g faces/s (checksum %.6e)\n", fluxName[iFlux - GOD],
+				(double)nFaces * nRepeat / (tEnd - tStart), sum);
+	}
+
+	free(qL);
+	free(qR);
+	free(f);
+
+	return 0;
+}
@@ -0,0 +1,25 @@
+# ParaView Catalyst pipeline of the vortex street, renders the pressure of
+# every in situ step to insitu/pressure_<timestep>.png, run with
+#   catalystScript = catalyst.py
+from paraview.simple import *
+from paraview import catalyst
+
+# the channel of ccfd
+grid = TrivialProducer(registrationName="grid")
+
+view = CreateView("RenderView")
+view.ViewSize = [1600, 600]
+view.OrientationAxesVisibility = 0
+display = Show(grid, view)
+ColorBy(display, ("CELLS", "Pressure"))
+display.RescaleTransferFunctionToDataRange(True)
+view.ResetCamera()
+
+png = CreateExtractor("PNG", view, registrationName="PNG")
+png.Trigger = "TimeStep"
+png.Writer.FileName = "pressure_{timestep:06d}.png"
+png.Writer.ImageResolution = [1600, 600]
+
+options = catalyst.Options()
+options.ExtractsOutputDirectory = "insitu"
+options.GlobalTrigger = "TimeStep"
@@ -23,11 +23,11 @@ for ini in inis:
     os.system("%s %s > %s.log 2>/dev/null"%(exe, ini, ini.rpartition('.')[0]))
 
     # read target output
-    targetName = sorted(glob("targetOutput/%s_*"%(ini.rpartition('.')[0])))[-1]
+    targetName = sorted(glob("targetOutput/%s_[0-9]*"%(ini.rpartition('.')[0])))[-1]
     targetDat = np.genfromtxt(targetName, skip_header=1, delimiter=',')[:,0:3]
 
     # read actual output
-    outputName = sorted(glob("%s_*"%(ini.rpartition('.')[0])))[-1]
+    outputName = sorted(glob("%s_[0-9]*"%(ini.rpartition('.')[0])))[-1]
     outputDat = np.genfromtxt(outputName, skip_header=1, delimiter=',')[:,0:3]
 
     # calculate differences
@@ -41,3 +41,36 @@ for ini in inis:
     else:
         print(" - %-18s: bad  (%.4e)"%(ini,diff))
         sys.exit(1)
+
+# restart the cases from a checkpoint of the given iteration, the restarted
+# calculation has to reproduce the uninterrupted one bit-exactly
+restarts = {"shock_FRZ.ini": 1000}
+
+for ini, restartIter in sorted(restarts.items()):
+    base = ini.rpartition('.')[0]
+    rstIni = "%s_RST.ini"%(base)
+
+    # the first part writes a checkpoint in every iteration
+    with open(ini) as f:
+        lines = [line for line in f if not line.startswith("fileName")]
+    with open(rstIni, "w") as f:
+        f.writelines(line for line in lines if not line.startswith("maxIter"))
+        f.write("fileName = %s_RST\nmaxIter = %d\ncheckpointInterval = 1e-12\n"%(base, restartIter))
+    os.system("%s %s > %s_RST.log 2>/dev/null"%(exe, rstIni, base))
+
+    # the second part continues from the checkpoint until the end
+    with open(rstIni, "w") as f:
+        f.writelines(lines)
+        f.write("fileName = %s_RST\n"%(base))
+    os.system("%s %s %s_RST.chk >> %s_RST.log 2>/dev/null"%(exe, rstIni, base, base))
+    os.remove(rstIni)
+
+    targetDat = np.genfromtxt(sorted(glob("%s_[0-9]*"%(base)))[-1], skip_header=1, delimiter=',')
+    outputDat = np.genfromtxt(sorted(glob("%s_RST_[0-9]*"%(base)))[-1], skip_header=1, delimiter=',')
+    diff = np.sqrt(((targetDat - outputDat)**2).sum())
+
+    if diff == 0.0:
+        print(" - %-18s: good (%.4e)"%(base + " restart",diff))
+    else:
+        print(" - %-18s: bad  (%.4e)"%(base + " restart",diff))
+        sys.exit(1)
@@ -9,6 +9,25 @@ EQNSYS = euler
 # multithreading flag [on, off]
 PARALLEL = on
 
+# domain decomposition with MPI [on, off]
+MPI = off
+
+# mixed precision, single precision Krylov vectors and LU-SGS blocks of the
+# implicit solver [on, off]
+MIXED = off
+
+# single precision face states, only buffered with fusedResidual = F [on, off]
+FLOATFACES = off
+
+# offload the explicit time integration to an accelerator with OpenMP target
+# directives, needs PARALLEL = on [on, off]
+GPU = off
+
+# in situ visualization with ParaView Catalyst, the Catalyst library is
+# searched in CATALYST_DIR [on, off]
+CATALYST = off
+CATALYST_DIR = /usr/local
+
 # debugging flag [on, off]
 DEBUG = off
 
@@ -17,3 +36,6 @@ PROF = off
 
 # CGNS library setup [3.4.1, 4.1.1]
 CGNS_VERSION = 3.4.1
+
+# HDF5 backend of the CGNS library, needed for compressed output [on, off]
+HDF5 = off
@@ -11,6 +11,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <math.h>
+#include <omp.h>
 
 #include "analyze.h"
 #include "readInTools.h"
@@ -21,6 +22,11 @@
 #include "exactFunction.h"
 #include "equation.h"
 #include "initialCondition.h"
+#include "parallel.h"
+#include "pointLocation.h"
+#include "timer.h"
+#include "device.h"
+#include "meshAdaptation.h"
 
 /* extern variables */
 bool doCalcWing;			/**< calculate CL CD flag */
@@ -30,10 +36,21 @@ bool hasExactSolution;			/**< exact solution existence flag */
 
 /**
  * \brief Initialize recording points
+ *
+ * With domain decomposition only the partition that contains a point
+ * records it.
  */
 void initRecordPoints(void)
 {
 	recordPoint.x = dyn2DdblArray(recordPoint.nPoints, 2);
+	recordPoint.elem = calloc(recordPoint.nPoints, sizeof(elem_t *));
+	recordPoint.ioFile = calloc(recordPoint.nPoints, sizeof(FILE *));
+	recordPoint.buffer = dyn2DdblArray(recordPoint.nPoints, RP_BUFFER * (NVAR + 1));
+	recordPoint.nBuffered = 0;
+	if ((!recordPoint.elem) || (!recordPoint.ioFile)) {
+		printf("| ERROR: could not allocate record points\n");
+		exit(1);
+	}
 
 	for (long iPt = 0; iPt < recordPoint.nPoints; ++iPt) {
 		double *coords = getDblArray("pointCoords", NDIM, NULL);
@@ -41,46 +58,22 @@ void initRecordPoints(void)
 		recordPoint.x[iPt][Y] = coords[Y];
 		free(coords);
 
-		elem_t *aElem = firstElem;
-		bool isInside;
-		while (aElem) {
-			isInside = true;
-			for (int i = 0; i < aElem->elemType; ++i) {
-				int iNode1 = i;
-				int iNode2 = i + 1;
-				if (iNode2 >= aElem->elemType) {
-					iNode2 = 0;
-				}
-				double u[NDIM];
-				u[X] = aElem->node[iNode2]->x[Y] - aElem->node[iNode1]->x[Y];
-				u[Y] = aElem->node[iNode1]->x[X] - aElem->node[iNode2]->x[X];
-				double tmp = sqrt(u[X] * u[X] + u[X] * u[X]);
-				u[X] /= tmp;
-				u[Y] /= tmp;
-
-				double x[NDIM];
-				x[X] = recordPoint.x[iPt][X] - aElem->node[iNode1]->x[X];
-				x[Y] = recordPoint.x[iPt][Y] - aElem->node[iNode1]->x[Y];
-
-				double projection = u[X] * x[X] + u[Y] * x[Y];
-				if (projection > 0.0) {
-					isInside = false;
-				}
-			}
-
-			if (isInside) {
-				recordPoint.elem[iPt] = aElem;
-				break;
-			}
-
-			aElem = aElem->next;
-		}
+		recordPoint.elem[iPt] = findElem(recordPoint.x[iPt]);
+		bool isInside = (recordPoint.elem[iPt] != NULL);
 
-		if (!isInside) {
+		/* the first partition that contains the point records it */
+		double ownerRank = (isInside ? mpiRank : mpiSize);
+		globalMin(&ownerRank, 1);
+		if (ownerRank == mpiSize) {
 			printf("| ERROR: Record Point # %ld is not in Domain\n", iPt);
 			exit(1);
 		}
 
+		if (ownerRank != mpiRank) {
+			recordPoint.elem[iPt] = NULL;
+			continue;
+		}
+
 		/* open file for writing */
 		char ioFileName[2 * STRLEN];
 		sprintf(ioFileName, "%s_recordPoint_%ld.csv", strOutFile, iPt);
@@ -181,6 +174,56 @@ void initWing(void)
 
 		aBCsidePtr = aBCsidePtr->next;
 	}
+
+	/* flat arrays of the sorted pressure and suction sides */
+	wing.nSides = 0;
+	for (int i = 0; i < 2; ++i) {
+		sidePtr_t *aSidePtr = (i == 0 ? wing.firstPressureSide : wing.firstSuctionSide);
+		while (aSidePtr) {
+			wing.nSides++;
+			aSidePtr = aSidePtr->next;
+		}
+
+		if (i == 0) {
+			wing.nPressureSides = wing.nSides;
+		}
+	}
+
+	wing.sideId = dyn1DintArray(wing.nSides);
+	wing.nLen = dyn2DdblArray(NDIM, wing.nSides);
+	wing.x = dyn2DdblArray(NDIM, wing.nSides);
+
+	long iSide = 0;
+	for (int i = 0; i < 2; ++i) {
+		sidePtr_t *aSidePtr = (i == 0 ? wing.firstPressureSide : wing.firstSuctionSide);
+		while (aSidePtr) {
+			side_t *aSide = aSidePtr->side;
+			wing.sideId[iSide] = aSide->id;
+			wing.nLen[X][iSide] = aSide->n[X] * aSide->len;
+			wing.nLen[Y][iSide] = aSide->n[Y] * aSide->len;
+			wing.x[X][iSide] = aSide->GP[X] + aSide->elem->bary[X];
+			wing.x[Y][iSide] = aSide->GP[Y] + aSide->elem->bary[Y];
+			iSide++;
+			aSidePtr = aSidePtr->next;
+		}
+	}
+
+	/* gnuplot file for the CP plot */
+	if (mpiRank == 0) {
+		char demFileName[STRLEN];
+		strcat(strcpy(demFileName, strOutFile), "_CP.dem");
+		FILE *demFile = fopen(demFileName, "w");
+		fprintf(demFile, "unset key\n");
+		fprintf(demFile, "set xlabel 'x'\n");
+		fprintf(demFile, "set ylabel 'cp'\n");
+		fprintf(demFile, "set yrange [*:*] reverse\n");
+		fprintf(demFile, "plot '%s_CP_pressureSide.csv' using 1:4 w l lc rgb 'black', \\\n",
+				strOutFile);
+		fprintf(demFile, "     '%s_CP_suctionSide.csv' using 1:4 w l lc rgb 'black'\n",
+				strOutFile);
+		fprintf(demFile, "pause -1");
+		fclose(demFile);
+	}
 }
 
 /**
@@ -191,6 +234,7 @@ void readWing(void)
 	printf("\nInitializing Wing:\n");
 	wing.refLength = getDbl("referenceLength", "1.0");
 	wing.wallId = getInt("wall_id", NULL);
+	wing.cpIterInterval = getInt("CPiterInterval", "0");
 }
 
 /**
@@ -201,9 +245,14 @@ void initAnalyze(void)
 	printf("\nInitializing Analysis:\n");
 	hasExactSolution = getBool("exactSolution", "F");
 	doCalcWing = getBool("calcWing", "F");
+	if (doCalcWing && useAdaptation) {
+		printf("| ERROR: The wing analysis does not support mesh adaptation\n");
+		exit(1);
+	}
 
+	/* the root writes the analysis files */
 	char resFileName[STRLEN];
-	if (doCalcWing || isStationary) {
+	if ((doCalcWing || isStationary) && (mpiRank == 0)) {
 		strcat(strcpy(resFileName, strOutFile), "_analysis.csv");
 
 		if (isRestart) {
@@ -238,7 +287,9 @@ void initAnalyze(void)
 	char demFileName[STRLEN];
 	if (doCalcWing) {
 		readWing();
+	}
 
+	if (doCalcWing && (mpiRank == 0)) {
 		/* residuals plot file */
 		strcat(strcpy(demFileName, strOutFile), "_residuals.dem");
 		FILE *demFile = fopen(demFileName, "w");
@@ -259,7 +310,7 @@ void initAnalyze(void)
 				resFileName);
 		fprintf(demFile, "pause -1");
 		fclose(demFile);
-	} else if (isStationary) {
+	} else if (isStationary && (mpiRank == 0)) {
 		strcat(strcpy(demFileName, strOutFile), "_residuals.dem");
 		FILE *demFile = fopen(demFileName, "w");
 		fprintf(demFile, "set title 'Residual Plot'\n");
@@ -286,79 +337,120 @@ void initAnalyze(void)
 	}
 }
 
+/**
+ * \brief Compare two rows of the CP data by their x- and y-coordinate
+ * \param[in] a Pointer to the first row
+ * \param[in] b Pointer to the second row
+ * \return Negative, zero or positive, if a is sorted before, equal to or after b
+ */
+int compareCP(const void *a, const void *b)
+{
+	const double *A = a;
+	const double *B = b;
+	if (A[0] != B[0]) {
+		return (A[0] < B[0] ? -1 : 1);
+	}
+
+	return (A[1] < B[1] ? -1 : (A[1] > B[1]));
+}
+
+/**
+ * \brief Write the pressure coefficient distribution along one side of the
+ *	wing
+ *
+ * With domain decomposition the CP data of all partitions is collected on
+ * the root, which sorts it along the chord and writes the file.
+ * \param[in] first First wing side of the side of the wing
+ * \param[in] last Wing side after the last side of the side of the wing
+ * \param[in] fileName Name of the CP output file
+ * \param[in] varName Name of the CP column
+ * \param[in] pInf Reference pressure
+ * \param[in] qInfQ Inverse of the dynamic reference pressure
+ */
+void cpSideOutput(long first, long last, const char *fileName,
+		const char *varName, double pInf, double qInfQ)
+{
+	long nWingSides = last - first;
+	double **cpData = dyn2DdblArray(nWingSides, 4);
+	for (long iSide = first; iSide < last; ++iSide) {
+		double p0 = sideData.pVar[P][wing.sideId[iSide]];
+		double x = wing.x[X][iSide];
+		double y = wing.x[Y][iSide];
+		cpData[iSide - first][0] = x;
+		cpData[iSide - first][1] = y;
+		cpData[iSide - first][2] = atan2(y, x);
+		cpData[iSide - first][3] = (p0 - pInf) * qInfQ;
+	}
+
+	long nRows;
+	double **cpAll = gatherRows(cpData, nWingSides, 4, NULL, &nRows);
+	free(cpData);
+	if (!cpAll) {
+		return;
+	}
+
+	/* every partition delivers its sides sorted along the chord */
+	if (mpiSize > 1) {
+		qsort((double *)(cpAll + nRows), nRows, 4 * sizeof(double),
+				compareCP);
+	}
+
+	FILE *cpFile = fopen(fileName, "w");
+	if (!cpFile) {
+		printf("| ERROR: Cannot open Output File for CP I/O\n");
+		exit(1);
+	}
+
+	fprintf(cpFile, "x, y, phi, %s\n", varName);
+	for (long i = 0; i < nRows; ++i) {
+		fprintf(cpFile, "%15.7f,%15.7f,%15.7f,%15.7f\n",
+			cpAll[i][0], cpAll[i][1], cpAll[i][2], cpAll[i][3]);
+	}
+	fclose(cpFile);
+	free(cpAll);
+}
+
+/**
+ * \brief Write the pressure coefficient distribution of the pressure and the
+ *	suction side of the wing
+ */
+void cpOutput(void)
+{
+	double v = refState[0][VX] / cos(alpha * pi / 180.0);
+	double qInfQ = 1.0 / (refState[0][RHO] * 0.5 * v * v);
+	double pInf = refState[0][P];
+
+	char fileName[STRLEN];
+	strcat(strcpy(fileName, strOutFile), "_CP_pressureSide.csv");
+	cpSideOutput(0, wing.nPressureSides, fileName, "CP_pressureSide",
+			pInf, qInfQ);
+
+	strcat(strcpy(fileName, strOutFile), "_CP_suctionSide.csv");
+	cpSideOutput(wing.nPressureSides, wing.nSides, fileName, "CP_suctionSide",
+			pInf, qInfQ);
+}
+
 /**
  * \brief Calculate CL and CD around the specified wall
  */
 void calcCoef(void)
 {
 	/* initialize values */
-	double cl = 0.0, cd = 0.0;
 	double v = refState[0][VX] / cos(alpha * pi / 180.0);
 	double qInfQ = 1.0 / (refState[0][RHO] * 0.5 * v * v);
 	double qInfLq = qInfQ / wing.refLength;
-	double pInf = refState[0][P];
-
-	/* open file for writing cp data */
-	char pressureFileName[STRLEN];
-	strcat(strcpy(pressureFileName, strOutFile), "_CP_pressureSide.csv");
-	FILE *cp1File = fopen(pressureFileName, "w");
-	if (!cp1File) {
-		printf("| ERROR: Cannot open Output File for CP I/O\n");
-		exit(1);
-	}
 
-	/* presure side: CL, CD, CP */
-	fprintf(cp1File, "x, y, phi, CP_pressureSide\n");
-	sidePtr_t *aSidePtr = wing.firstPressureSide;
-	while (aSidePtr) {
-		double p0 = aSidePtr->side->pVar[P];
-		double n[NDIM];
-		n[X]  = aSidePtr->side->n[X];
-		n[Y]  = aSidePtr->side->n[Y];
-		double len = aSidePtr->side->len;
-		cl += n[Y] * p0 * len;
-		cd += n[X] * p0 * len;
-		double cp = (p0 - pInf) * qInfQ;
-		fprintf(cp1File, "%15.7f,%15.7f,%15.7f,%15.7f\n",
-			aSidePtr->side->GP[X] + aSidePtr->side->elem->bary[X],
-			aSidePtr->side->GP[Y] + aSidePtr->side->elem->bary[Y],
-			atan2(aSidePtr->side->GP[Y] + aSidePtr->side->elem->bary[Y],
-			      aSidePtr->side->GP[X] + aSidePtr->side->elem->bary[X]),
-			cp);
-		aSidePtr = aSidePtr->next;
-	}
-	fclose(cp1File);
-
-	/* open file for writing CP data */
-	char suctionFileName[STRLEN];
-	strcat(strcpy(suctionFileName, strOutFile), "_CP_suctionSide.csv");
-	FILE *cp2File = fopen(suctionFileName, "w");
-	if (!cp2File) {
-		printf("| ERROR: Cannot open Output File for CP I/O\n");
-		exit(1);
+	/* integration of the pressure forces */
+	double coef[2] = {0.0, 0.0};
+	#pragma omp parallel for reduction(+:coef[:2])
+	for (long iSide = 0; iSide < wing.nSides; ++iSide) {
+		double p0 = sideData.pVar[P][wing.sideId[iSide]];
+		coef[0] += wing.nLen[Y][iSide] * p0;
+		coef[1] += wing.nLen[X][iSide] * p0;
 	}
 
-	fprintf(cp2File, "x, y, phi, CP_suctionSide\n");
-	aSidePtr = wing.firstSuctionSide;
-	while (aSidePtr) {
-		double p0 = aSidePtr->side->pVar[P];
-		double n[NDIM];
-		n[X]  = aSidePtr->side->n[X];
-		n[Y]  = aSidePtr->side->n[Y];
-		double len = aSidePtr->side->len;
-		cl += n[Y] * p0 * len;
-		cd += n[X] * p0 * len;
-		double cp = (p0 - pInf) * qInfQ;
-		fprintf(cp2File, "%15.7f,%15.7f,%15.7f,%15.7f\n",
-			aSidePtr->side->GP[X] + aSidePtr->side->elem->bary[X],
-			aSidePtr->side->GP[Y] + aSidePtr->side->elem->bary[Y],
-			atan2(aSidePtr->side->GP[Y] + aSidePtr->side->elem->bary[Y],
-			      aSidePtr->side->GP[X] + aSidePtr->side->elem->bary[X]),
-			cp);
-		aSidePtr = aSidePtr->next;
-	}
-	fclose(cp2File);
-
+	globalSum(coef, 2);
+	double cl = coef[0], cd = coef[1];
 	cl *= qInfLq;
 	cd *= qInfLq;
 
@@ -366,38 +458,84 @@ void calcCoef(void)
 	double alphaLoc = alpha * pi / 180.0;
 	wing.cl = cl * cos(alphaLoc) - cd * sin(alphaLoc);
 	wing.cd = cd * cos(alphaLoc) + cl * sin(alphaLoc);
+}
 
-	/* write gnuplot file for CP plot */
-	char demFileName[STRLEN];
-	strcat(strcpy(demFileName, strOutFile), "_CP.dem");
-	FILE *demFile = fopen(demFileName, "r");
-	if (!demFile) {
-		demFile = fopen(demFileName, "w");
-		fprintf(demFile, "unset key\n");
-		fprintf(demFile, "set xlabel 'x'\n");
-		fprintf(demFile, "set ylabel 'cp'\n");
-		fprintf(demFile, "set yrange [*:*] reverse\n");
-		fprintf(demFile, "plot '%s' using 1:4 w l lc rgb 'black', \\\n",
-				pressureFileName);
-		fprintf(demFile, "     '%s' using 1:4 w l lc rgb 'black'\n",
-				suctionFileName);
-		fprintf(demFile, "pause -1");
+/**
+ * \brief Write the buffered samples of all recording points
+ */
+void flushRecordPoints(void)
+{
+	for (long iPt = 0; iPt < recordPoint.nPoints; ++iPt) {
+		if (!recordPoint.elem[iPt]) {
+			continue;
+		}
+
+		for (int i = 0; i < recordPoint.nBuffered; ++i) {
+			double *val = &recordPoint.buffer[iPt][i * (NVAR + 1)];
+			fprintf(recordPoint.ioFile[iPt],
+				"%20.12f,%20.12f,%20.12f,%20.12f,%20.12f\n",
+				val[0], val[1 + RHO], val[1 + VX], val[1 + VY],
+				val[1 + P]);
+		}
 	}
-	fclose(demFile);
+
+	recordPoint.nBuffered = 0;
 }
 
 /**
- * \brief Evaluation of recording points
- * \param[in] time Calculation time at output
+ * \brief Store the flow field at the record points, the file output is
+ *	done every `RP_BUFFER` samples
+ * \param[in] time Calculation time
  */
 void evalRecordPoints(double time)
 {
 	for (long iPt = 0; iPt < recordPoint.nPoints; ++iPt) {
-		elem_t *aElem = recordPoint.elem[iPt];
-		fprintf(recordPoint.ioFile[iPt],
-			"%20.12f,%20.12f,%20.12f,%20.12f,%20.12f\n",
-			time + aElem->dt, aElem->pVar[RHO], aElem->pVar[VX],
-			aElem->pVar[VY], aElem->pVar[P]);
+		if (!recordPoint.elem[iPt]) {
+			continue;
+		}
+
+		long iElem = recordPoint.elem[iPt]->id;
+		double *val = &recordPoint.buffer[iPt][recordPoint.nBuffered * (NVAR + 1)];
+		val[0] = time + dtGlobal;
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			val[1 + iVar] = elemData.pVar[iVar][iElem];
+		}
+	}
+
+	recordPoint.nBuffered++;
+	if (recordPoint.nBuffered == RP_BUFFER) {
+		flushRecordPoints();
+	}
+}
+
+/**
+ * \brief Find the elements of the record points again, after the mesh was
+ *	adapted
+ */
+void locateRecordPoints(void)
+{
+	for (long iPt = 0; iPt < recordPoint.nPoints; ++iPt) {
+		if (recordPoint.elem[iPt]) {
+			recordPoint.elem[iPt] = findElem(recordPoint.x[iPt]);
+		}
+	}
+}
+
+/**
+ * \brief Write the remaining samples and close the record point files
+ */
+void closeRecordPoints(void)
+{
+	if (recordPoint.nPoints == 0) {
+		return;
+	}
+
+	flushRecordPoints();
+	for (long iPt = 0; iPt < recordPoint.nPoints; ++iPt) {
+		if (recordPoint.ioFile[iPt]) {
+			fclose(recordPoint.ioFile[iPt]);
+			recordPoint.ioFile[iPt] = NULL;
+		}
 	}
 }
 
@@ -410,6 +548,13 @@ void evalRecordPoints(double time)
  */
 void analyze(double time, long iter, double resIter[NVAR + 2])
 {
+	double tic = CPU_TIME();
+
+	/* states of the record points and wing sides */
+	if (useDevice) {
+		deviceProbes();
+	}
+
 	/* record points */
 	if (recordPoint.nPoints > 0) {
 		evalRecordPoints(time);
@@ -422,19 +567,27 @@ void analyze(double time, long iter, double resIter[NVAR + 2])
 
 		calcCoef();
 
-		resIter[4] = fabs(resIter[4] - wing.cl) / firstElem->dt;
-		resIter[5] = fabs(resIter[5] - wing.cd) / firstElem->dt;
+		if ((wing.cpIterInterval > 0) && (iter % wing.cpIterInterval == 0)) {
+			cpOutput();
+		}
+
+		/* rate of change in (pseudo) time */
+		resIter[4] = fabs(resIter[4] - wing.cl) / dtGlobal;
+		resIter[5] = fabs(resIter[5] - wing.cd) / dtGlobal;
 
-		fprintf(resFile, "%7ld, %13.8f, %15.8e, %15.10f, %15.10f\n",
-			iter, time + firstElem->dt, resIter[abortVariable],
-			wing.cl, wing.cd);
+		if (resFile) {
+			fprintf(resFile, "%7ld, %13.8f, %15.8e, %15.10f, %15.10f\n",
+				iter, time + dtGlobal, resIter[abortVariable],
+				wing.cl, wing.cd);
+		}
 	} else {
-		if (isStationary) {
+		if (isStationary && resFile) {
 			fprintf(resFile, "%7ld, %13.8f, %15.8e, %15.8e, %15.8e, %15.8e\n",
-				iter, time + firstElem->dt, resIter[RHO],
+				iter, time + dtGlobal, resIter[RHO],
 				resIter[VX], resIter[VY], resIter[E]);
 		}
 	}
+	timerAdd(TIMER_ANALYZE, &tic);
 }
 
 /**
@@ -446,6 +599,11 @@ void calcErrors(double time)
 {
 	double L1[NVAR] = {0.0}, L2[NVAR] = {0.0}, Linf[NVAR] = {0.0};
 
+	deviceToHost();
+
+	double **pVar[] = {elemData.pVar};
+	startHaloExchange(1, pVar);
+	finishHaloExchange();
 	spatialReconstruction(time);
 
 	#pragma omp parallel for reduction(max:Linf), reduction(+:L1,L2)
@@ -462,10 +620,10 @@ void calcErrors(double time)
 				aElem->xGP[iGP][Y] - aElem->bary[Y]};
 
 			double pVar[NVAR] = {
-				aElem->pVar[RHO] + dx[X] * aElem->u_x[RHO] + dx[Y] * aElem->u_y[RHO],
-				aElem->pVar[VX]  + dx[X] * aElem->u_x[VX]  + dx[Y] * aElem->u_y[VX],
-				aElem->pVar[VY]  + dx[X] * aElem->u_x[VY]  + dx[Y] * aElem->u_y[VY],
-				aElem->pVar[P]   + dx[X] * aElem->u_x[P]   + dx[Y] * aElem->u_y[P]};
+				elemData.pVar[RHO][iElem] + dx[X] * elemData.u_x[RHO][iElem] + dx[Y] * elemData.u_y[RHO][iElem],
+				elemData.pVar[VX][iElem]  + dx[X] * elemData.u_x[VX][iElem]  + dx[Y] * elemData.u_y[VX][iElem],
+				elemData.pVar[VY][iElem]  + dx[X] * elemData.u_x[VY][iElem]  + dx[Y] * elemData.u_y[VY][iElem],
+				elemData.pVar[P][iElem]   + dx[X] * elemData.u_x[P][iElem]   + dx[Y] * elemData.u_y[P][iElem]};
 
 			/* compute errors at GP */
 			double err[NVAR] = {
@@ -494,6 +652,10 @@ void calcErrors(double time)
 		}
 	}
 
+	globalSum(L1, NVAR);
+	globalSum(L2, NVAR);
+	globalMax(Linf, NVAR);
+
 	/* finalize L1 and L2 */
 	L1[RHO] *= totalArea_q;
 	L1[VX]  *= totalArea_q;
@@ -515,6 +677,10 @@ void calcErrors(double time)
 
 /**
  * \brief Calculate the global residual of the conservative variables
+ *
+ * The residual is the area weighted norm of the time derivative, not of the
+ * update of the conservative variables. It is thereby independent of the
+ * time step and stays comparable between global and local time stepping.
  * \param[in,out] resIter The residual vector containing the residuals
  *	of the conservative variables at the first four positions
  */
@@ -522,15 +688,20 @@ void globalResidual(double resIter[NVAR + 2])
 {
 	memset(resIter, 0, (NVAR + 2) * sizeof(double));
 
-	#pragma omp parallel for reduction(+:resIter[:NVAR + 2])
-	for (long iElem = 0; iElem < nElems; ++iElem) {
-		elem_t *aElem = elem[iElem];
-		resIter[RHO] += aElem->area * aElem->u_t[RHO] * aElem->u_t[RHO];
-		resIter[MX]  += aElem->area * aElem->u_t[MX]  * aElem->u_t[MX];
-		resIter[MY]  += aElem->area * aElem->u_t[MY]  * aElem->u_t[MY];
-		resIter[E]   += aElem->area * aElem->u_t[E]   * aElem->u_t[E];
+	if (useDevice) {
+		deviceResidual(resIter);
+	} else {
+		#pragma omp parallel for reduction(+:resIter[:NVAR + 2])
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			resIter[RHO] += elemData.area[iElem] * elemData.u_t[RHO][iElem] * elemData.u_t[RHO][iElem];
+			resIter[MX]  += elemData.area[iElem] * elemData.u_t[MX][iElem]  * elemData.u_t[MX][iElem];
+			resIter[MY]  += elemData.area[iElem] * elemData.u_t[MY][iElem]  * elemData.u_t[MY][iElem];
+			resIter[E]   += elemData.area[iElem] * elemData.u_t[E][iElem]   * elemData.u_t[E][iElem];
+		}
 	}
 
+	globalSum(resIter, NVAR);
+
 	/* compute 2-Norm of the residual */
 	resIter[RHO] = sqrt(resIter[RHO] * totalArea_q);
 	resIter[MX]  = sqrt(resIter[MX]  * totalArea_q);
@@ -543,7 +714,18 @@ void globalResidual(double resIter[NVAR + 2])
  */
 void freeAnalyze(void)
 {
+	if (recordPoint.nPoints > 0) {
+		free(recordPoint.x);
+		free(recordPoint.elem);
+		free(recordPoint.ioFile);
+		free(recordPoint.buffer);
+	}
+
 	if (doCalcWing) {
+		free(wing.sideId);
+		free(wing.nLen);
+		free(wing.x);
+
 		sidePtr_t *aSidePtr = wing.firstSuctionSide;
 		while (aSidePtr) {
 			if (aSidePtr->next) {
@@ -567,5 +749,8 @@ void freeAnalyze(void)
 				break;
 			}
 		}
+
+		wing.firstSuctionSide = NULL;
+		wing.firstPressureSide = NULL;
 	}
 }
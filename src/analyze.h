@@ -19,6 +19,8 @@ typedef struct recordPoint_t recordPoint_t;
 #include "boundary.h"
 #include "mesh.h"
 
+#define RP_BUFFER 100		/**< number of samples buffered per record point */
+
 /**
  * \brief Collection of all necessary values for the calculation of CL and CD
  */
@@ -30,6 +32,16 @@ struct wing_t {
 	boundary_t *wingBC;		/**< pointer to the BC of the wing */
 	sidePtr_t *firstPressureSide;	/**< pointer to the first pressure side */
 	sidePtr_t *firstSuctionSide;	/**< pointer to the first suction side */
+	long nSides;			/**< number of wing sides, the pressure
+						sides come first */
+	long nPressureSides;		/**< number of pressure sides */
+	long *sideId;			/**< element side ID of every wing side,
+						sorted along the chord */
+	double **nLen;			/**< normal vector times length of every
+						wing side [NDIM][nSides] */
+	double **x;			/**< midpoint of every wing side
+						[NDIM][nSides] */
+	int cpIterInterval;		/**< iteration interval for the CP output */
 };
 
 /**
@@ -40,6 +52,9 @@ struct recordPoint_t {
 	double **x;			/**< `nPoints`x`NDIM` array of RP coordinates */
 	elem_t **elem;			/**< array of elements that contain a RP */
 	FILE **ioFile;			/**< array of output file pointers */
+	double **buffer;		/**< buffered samples of every RP
+						[nPoints][RP_BUFFER*(NVAR+1)] */
+	int nBuffered;			/**< number of buffered samples */
 };
 
 extern bool doCalcWing;
@@ -49,6 +64,9 @@ extern bool hasExactSolution;
 
 void initAnalyze(void);
 void analyze(double time, long iter, double resIter[NVAR + 2]);
+void cpOutput(void);
+void locateRecordPoints(void);
+void closeRecordPoints(void);
 void calcErrors(double time);
 void globalResidual(double resIter[NVAR + 2]);
 void freeAnalyze(void);
@@ -0,0 +1,212 @@
+/** \file
+ *
+ * \brief Concurrent calculation of the variants of a batch
+ *
+ * The variants of a batch calculation are prepared one after another by the
+ * main process, which builds the mesh only for the first variant. With
+ * `batchJobs > 1` the main process then forks a child process right before
+ * the time stepping of every variant, which calculates the variant with its
+ * share of the OpenMP threads, while the main process prepares the next one.
+ * The children inherit the mesh and the geometry of the main process, whose
+ * memory is shared until it is written, and write their screen output into
+ * `<fileName>.log`. At most `batchJobs` variants are calculated at the same
+ * time. The main process itself runs without parallel regions, since the
+ * OpenMP threads of a process are not copied by the fork.
+ *
+ * \author hhh
+ * \date Fri 16 Oct 2026 09:41:27 AM CEST
+ */
+
+#define _POSIX_C_SOURCE 200809L	/**< fork and wait with -std=c99 */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <omp.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "main.h"
+#include "batch.h"
+#include "readInTools.h"
+#include "output.h"
+#include "parallel.h"
+#include "device.h"
+#include "insitu.h"
+#include "analyze.h"
+#include "meshSequencing.h"
+
+/* extern variables */
+int nBatchJobs = 1;			/**< number of variants calculated at the
+					  same time */
+bool isBatchJob;			/**< this process calculates a single
+					  variant */
+
+/* local variables */
+bool isBatchInit;			/**< the number of concurrent variants is
+					  fixed */
+int nThreadsBatch;			/**< number of threads of the main process */
+int nLevelsBatch;			/**< number of active parallel levels of
+					  the main process */
+int nRunningJobs;			/**< number of running child processes */
+int nFailedJobs;			/**< number of failed child processes */
+
+/**
+ * \brief Read the number of concurrent variants, called for every variant
+ *	and stage
+ *
+ * The number is fixed by the first variant, the later ones only read it.
+ * \param[in] nVariants The number of variants of the batch, 0 without batch
+ *	mode
+ */
+void initBatch(int nVariants)
+{
+	if (nVariants == 0) {
+		return;
+	}
+
+	int nJobs = getInt("batchJobs", "1");
+	if (isBatchInit) {
+		return;
+	}
+	isBatchInit = true;
+
+	nBatchJobs = nJobs;
+	if (nBatchJobs < 1) {
+		printf("| ERROR: batchJobs has to be at least 1\n");
+		exit(1);
+	}
+
+#ifdef _OPENMP
+	nThreadsBatch = omp_get_max_threads();
+	nLevelsBatch = omp_get_max_active_levels();
+#endif
+
+	if (nBatchJobs > 1) {
+		if (mpiSize > 1) {
+			printf("| ERROR: Concurrent batch variants need a single partition\n");
+			exit(1);
+		}
+
+		if (nBatchJobs > nVariants) {
+			nBatchJobs = nVariants;
+		}
+
+		/* the threads of OpenMP do not survive a fork, so the main
+		 * process prepares the variants without parallel regions, but
+		 * with the number of threads of the variants */
+#ifdef _OPENMP
+		int nThreads = nThreadsBatch / nBatchJobs;
+		omp_set_num_threads((nThreads > 1) ? nThreads : 1);
+		omp_set_max_active_levels(0);
+#endif
+	}
+}
+
+/**
+ * \brief Wait for a child process and count it, if it failed
+ */
+static void waitBatchJob(void)
+{
+	int status;
+	pid_t pid = wait(&status);
+	if (pid < 0) {
+		printf("| ERROR: could not wait for the batch variants\n");
+		exit(1);
+	}
+
+	if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+		printf("| WARNING: Batch variant of process %d failed\n", (int)pid);
+		nFailedJobs++;
+	}
+
+	nRunningJobs--;
+}
+
+/**
+ * \brief Start the time stepping of the variant in a child process
+ *
+ * Called after the initialization of a variant. The child returns and
+ * calculates the variant, the main process frees the variant and prepares
+ * the next one.
+ * \return True for the main process, false for the child process and
+ *	without concurrent variants
+ */
+bool startBatchJob(void)
+{
+	if (nBatchJobs == 1) {
+		return false;
+	}
+
+	if (useDevice || useCatalyst) {
+		printf("| ERROR: Concurrent batch variants are not possible with the accelerator or the in situ visualization\n");
+		exit(1);
+	}
+
+	while (nRunningJobs >= nBatchJobs) {
+		waitBatchJob();
+	}
+
+	/* the log of the variant also holds its coarse stages */
+	char logFile[STRLEN + 4];
+	strcpy(logFile, strOutFile);
+	if (sequenceLevel > 0) {
+		*strrchr(logFile, '_') = '\0';
+	}
+	strcat(logFile, ".log");
+
+	/* the buffered output must not be written by both processes */
+	fflush(NULL);
+
+	pid_t pid = fork();
+	if (pid < 0) {
+		printf("| ERROR: could not start the process of the batch variant\n");
+		exit(1);
+	}
+
+	if (pid == 0) {
+		isBatchJob = true;
+
+		if (!freopen(logFile, "w", stdout)) {
+			exit(1);
+		}
+
+#ifdef _OPENMP
+		omp_set_max_active_levels(nLevelsBatch);
+#endif
+		return false;
+	}
+
+	/* the files of the variant are written by the child */
+	if (resFile) {
+		fclose(resFile);
+		resFile = NULL;
+	}
+	closeRecordPoints();
+
+	nRunningJobs++;
+	printf("\n| Calculating the Variant in Process %d, Output in '%s'\n",
+			(int)pid, logFile);
+	return true;
+}
+
+/**
+ * \brief Wait for all variants of the batch
+ */
+void finishBatch(void)
+{
+	if (isBatchJob) {
+		return;
+	}
+
+	while (nRunningJobs > 0) {
+		waitBatchJob();
+	}
+
+	if (nFailedJobs > 0) {
+		printf("| ERROR: %d batch variants failed\n", nFailedJobs);
+		exit(1);
+	}
+}
@@ -0,0 +1,19 @@
+/** \file
+ *
+ * \author hhh
+ * \date Fri 16 Oct 2026 09:41:27 AM CEST
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdbool.h>
+
+extern int nBatchJobs;
+extern bool isBatchJob;
+
+void initBatch(int nVariants);
+bool startBatchJob(void);
+void finishBatch(void);
+
+#endif
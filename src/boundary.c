@@ -17,12 +17,112 @@
 #include "mesh.h"
 #include "equationOfState.h"
 #include "exactFunction.h"
+#include "memTools.h"
+
+#define BC_BLOCK 64			/**< number of BC sides per block */
 
 /* extern variables */
 boundary_t *firstBC;			/**< pointer to the first boundary condition */
 int nBC;				/**< number of boundary conditions */
 bool isPeriodic;			/**< periodic boundary condition flag */
 
+/**
+ * \brief Read the type and the parameters of a boundary condition
+ * \param[out] aBC Pointer to the boundary condition
+ */
+static void readBoundary(boundary_t *aBC)
+{
+	int intIn = getInt("BCtype", NULL);
+	aBC->BCtype = intIn / 100;
+	aBC->BCid = intIn % 100;
+
+	double Ma, alpha, c, v;
+	switch (aBC->BCtype) {
+	case SLIPWALL:
+		printf("| BC Type: Slip Wall\n");
+		break;
+	#ifdef navierstokes
+	case WALL: {
+		printf("| BC Type: No Slip Wall\n");
+
+		bool isAdiabatic = getBool("adiabaticWall", NULL);
+		if (isAdiabatic) {
+			aBC->isAdiabatic = true;
+			printf("| Adiabatic Wall\n");
+		} else {
+			aBC->isAdiabatic = false;
+
+			/* temperature or heat flux prescibed ? */
+			if (countKeys("wallTemperature", -1) > 1) {
+				aBC->isTemperaturePrescribed = true;
+				aBC->temperature = getDbl("wallTemperature", NULL);
+			} else if (countKeys("wallHeatFlux", -1) > 1) {
+				aBC->isTemperaturePrescribed = false;
+				aBC->temperature = getDbl("wallHeatFlux", NULL);
+			} else {
+				printf("| ERROR: Not possible to prescirbe Wall Heat Flux and Wall Temperature\n");
+				exit(1);
+			}
+		}
+		break;
+	}
+	#endif
+	case INFLOW:
+		printf("| BC Type: Inflow\n");
+
+		aBC->pVar[RHO] = getDbl("rho", NULL);
+
+		Ma = getDbl("mach", NULL);
+
+		alpha = getDbl("alpha", NULL);
+
+		aBC->pVar[P] = getDbl("pressure", NULL);
+
+		c = sqrt(gam * aBC->pVar[P] / aBC->pVar[RHO]);
+		v = Ma * c;
+		aBC->pVar[VX] = v * cos(alpha * pi / 180.0);
+		aBC->pVar[VY] = v * sin(alpha * pi / 180.0);
+		break;
+	case CHARACTERISTIC:
+		printf("| BC Type: Characteristic\n");
+
+		aBC->pVar[RHO] = getDbl("rho", NULL);
+
+		Ma = getDbl("mach", NULL);
+
+		alpha = getDbl("alpha", NULL);
+
+		aBC->pVar[P] = getDbl("pressure", NULL);
+
+		c = sqrt(gam * aBC->pVar[P] / aBC->pVar[RHO]);
+		v = Ma * c;
+		aBC->pVar[VX] = v * cos(alpha * pi / 180.0);
+		aBC->pVar[VY] = v * sin(alpha * pi / 180.0);
+		break;
+	case OUTFLOW:
+		printf("| BC Type: Outflow\n");
+		break;
+	case EXACTSOL:
+		printf("| BC Type: Exact Function\n");
+
+		aBC->exactFunc = getInt("BCexactFunc", NULL);
+		break;
+	case PERIODIC:
+		printf("| BC Type: Periodic\n");
+
+		aBC->connection = getDblArray("connection", NDIM, NULL);
+		break;
+	case PRESSURE_OUT:
+		printf("| BC Type: Pressure Outlet\n");
+
+		aBC->pVar[P] = getDbl("pressure", NULL);
+		break;
+	default:
+		printf("| ERROR: Illegal boundary condition!\n");
+		exit(1);
+	}
+}
+
 /**
  * \brief Initialize boundary conditions
  */
@@ -44,253 +144,591 @@ void initBoundary(void)
 		aBC->next = firstBC;
 		firstBC = aBC;
 
-		int intIn = getInt("BCtype", NULL);
-		aBC->BCtype = intIn / 100;
-		aBC->BCid = intIn % 100;
+		readBoundary(aBC);
+	}
+}
 
-		double Ma, alpha, c, v;
-		switch (aBC->BCtype) {
-		case SLIPWALL:
-			printf("| BC Type: Slip Wall\n");
-			break;
-		#ifdef navierstokes
-		case WALL: {
-			printf("| BC Type: No Slip Wall\n");
-
-			bool isAdiabatic = getBool("adiabaticWall", NULL);
-			if (isAdiabatic) {
-				aBC->isAdiabatic = true;
-				printf("| Adiabatic Wall\n");
-			} else {
-				aBC->isAdiabatic = false;
-
-				/* temperature or heat flux prescibed ? */
-				if (countKeys("wallTemperature", -1) > 1) {
-					aBC->isTemperaturePrescribed = true;
-					aBC->temperature = getDbl("wallTemperature", NULL);
-				} else if (countKeys("wallHeatFlux", -1) > 1) {
-					aBC->isTemperaturePrescribed = false;
-					aBC->temperature = getDbl("wallHeatFlux", NULL);
-				} else {
-					printf("| ERROR: Not possible to prescirbe Wall Heat Flux and Wall Temperature\n");
-					exit(1);
-				}
-			}
-			break;
+/**
+ * \brief Read the boundary conditions of a batch variant into the boundary
+ *	conditions of the mesh
+ *
+ * The sides of the mesh point to the boundary conditions, so the variant has
+ * to keep their number and types, only their parameters can change.
+ */
+void updateBoundary(void)
+{
+	printf("\nUpdating Boundary Conditions:\n");
+
+	if (getInt("nBC", NULL) != nBC) {
+		printf("| ERROR: The number of boundary conditions cannot change\n");
+		exit(1);
+	}
+
+	/* the boundary conditions are stored in reverse order */
+	for (int iBC = nBC - 1; iBC >= 0; --iBC) {
+		boundary_t *aBC = firstBC;
+		for (int i = 0; i < iBC; ++i) {
+			aBC = aBC->next;
+		}
+
+		int BCtype = aBC->BCtype;
+		int BCid = aBC->BCid;
+		double *connection = aBC->connection;
+
+		readBoundary(aBC);
+		if ((aBC->BCtype != BCtype) || (aBC->BCid != BCid)) {
+			printf("| ERROR: The boundary condition types cannot change\n");
+			exit(1);
 		}
-		#endif
-		case INFLOW:
-			printf("| BC Type: Inflow\n");
 
-			aBC->pVar[RHO] = getDbl("rho", NULL);
+		/* the periodic sides are already connected */
+		if (aBC->BCtype == PERIODIC) {
+			free(aBC->connection);
+			aBC->connection = connection;
+		}
+	}
+}
 
-			Ma = getDbl("mach", NULL);
+BEGIN_DEVICE
+/**
+ * \brief Ghost state of a slip wall, the normal velocity is mirrored
+ * \param[in] n Outward normal vector of the boundary side
+ * \param[in] int_pVar Internal cell primitive variables state
+ * \param[out] ghost_pVar Ghost cell primitive variables state
+ */
+static inline void slipWallState(const double n[NDIM], const double int_pVar[NVAR],
+		double ghost_pVar[NVAR])
+{
+	double VXloc[NDIM], VYloc[NDIM];
+	/* rotate into local coordinate system */
+	VXloc[X] =   n[X] * int_pVar[VX] + n[Y] * int_pVar[VY];
+	VYloc[X] = - n[Y] * int_pVar[VX] + n[X] * int_pVar[VY];
+
+	/* mirror VX and extrapolate VY */
+	VXloc[Y] = - VXloc[X];
+	VYloc[Y] =   VYloc[X];
+
+	/* backrotate into global coordinate system */
+	ghost_pVar[VX] = n[X] * VXloc[Y] - n[Y] * VYloc[Y];
+	ghost_pVar[VY] = n[Y] * VXloc[Y] + n[X] * VYloc[Y];
+
+	/* scalar and derived conservative variables */
+	ghost_pVar[RHO] = int_pVar[RHO];
+	ghost_pVar[P]   = int_pVar[P];
+}
 
-			alpha = getDbl("alpha", NULL);
+#ifdef navierstokes
+/**
+ * \brief Ghost state of a no-slip wall, both velocity components are mirrored
+ *	for a viscous fluid
+ * \param[in] n Outward normal vector of the boundary side
+ * \param[in] int_pVar Internal cell primitive variables state
+ * \param[out] ghost_pVar Ghost cell primitive variables state
+ */
+static inline void wallState(const double n[NDIM], const double int_pVar[NVAR],
+		double ghost_pVar[NVAR])
+{
+	double VXloc[NDIM], VYloc[NDIM];
+	/* rotate into local coordinate system */
+	VXloc[X] =   n[X] * int_pVar[VX] + n[Y] * int_pVar[VY];
+	VYloc[X] = - n[Y] * int_pVar[VX] + n[X] * int_pVar[VY];
+
+	/* mirror VX and extrapolate VY */
+	VXloc[Y] = - VXloc[X];
+	if (mu > 0.0) {
+		VYloc[Y] = - VYloc[X];
+	} else {
+		VYloc[Y] =   VYloc[X];
+	}
 
-			aBC->pVar[P] = getDbl("pressure", NULL);
+	/* backrotate into global coordinate system */
+	ghost_pVar[VX] = n[X] * VXloc[Y] - n[Y] * VYloc[Y];
+	ghost_pVar[VY] = n[Y] * VXloc[Y] + n[X] * VYloc[Y];
 
-			c = sqrt(gam * aBC->pVar[P] / aBC->pVar[RHO]);
-			v = Ma * c;
-			aBC->pVar[VX] = v * cos(alpha * pi / 180.0);
-			aBC->pVar[VY] = v * sin(alpha * pi / 180.0);
-			break;
-		case CHARACTERISTIC:
-			printf("| BC Type: Characteristic\n");
+	/* scalar and derived conservative variables */
+	ghost_pVar[RHO] = int_pVar[RHO];
+	ghost_pVar[P]   = int_pVar[P];
+}
+#endif
 
-			aBC->pVar[RHO] = getDbl("rho", NULL);
+/**
+ * \brief Ghost state of a supersonic outflow, the state is extrapolated
+ * \param[in] int_pVar Internal cell primitive variables state
+ * \param[out] ghost_pVar Ghost cell primitive variables state
+ */
+static inline void outflowState(const double int_pVar[NVAR], double ghost_pVar[NVAR])
+{
+	ghost_pVar[RHO] = int_pVar[RHO];
+	ghost_pVar[VX]  = int_pVar[VX];
+	ghost_pVar[VY]  = int_pVar[VY];
+	ghost_pVar[P]   = int_pVar[P];
+}
 
-			Ma = getDbl("mach", NULL);
+/**
+ * \brief Ghost state of a characteristic boundary, the incoming
+ *	characteristics are taken from the far field state
+ * \param[in] aBC Pointer to the boundary condition
+ * \param[in] n Outward normal vector of the boundary side
+ * \param[in] int_pVar Internal cell primitive variables state
+ * \param[out] ghost_pVar Ghost cell primitive variables state
+ */
+static inline void characteristicState(const boundary_t *aBC, const double n[NDIM],
+		double int_pVar[NVAR], double ghost_pVar[NVAR])
+{
+	/* compute Eigenvalues of ghost cell */
+	double c = sqrt(gam * aBC->pVar[P] / aBC->pVar[RHO]);
+	double v = n[X] * aBC->pVar[VX] + n[Y] * aBC->pVar[VY];
+
+	/* rotate primitive state into local coordinate system */
+	double int_pVarloc[NVAR], ghost_pVarloc[NVAR];
+	int_pVarloc[RHO] = int_pVar[RHO];
+	int_pVarloc[VX]  =   n[X] * int_pVar[VX] + n[Y] * int_pVar[VY];
+	int_pVarloc[VY]  = - n[Y] * int_pVar[VX] + n[X] * int_pVar[VY];
+	int_pVarloc[P]   = int_pVar[P];
+
+	ghost_pVarloc[RHO] = aBC->pVar[RHO];
+	ghost_pVarloc[VX]  =   n[X] * aBC->pVar[VX] + n[Y] * aBC->pVar[VY];
+	ghost_pVarloc[VY]  = - n[Y] * aBC->pVar[VX] + n[X] * aBC->pVar[VY];
+	ghost_pVarloc[P]   = aBC->pVar[P];
+
+	/* compute conservative variables of both cells */
+	double int_cVar[NVAR], ghost_cVar[NVAR];
+	primCons(int_pVarloc, int_cVar);
+	primCons(ghost_pVarloc, ghost_cVar);
+
+	/* compute characteristic variables of inner and ghost cell */
+	double int_charVar[3], ghost_charVar[3];
+	consChar(int_cVar, int_charVar, int_pVar);
+	consChar(ghost_cVar, ghost_charVar, int_pVar);
+
+	/* determine characteristic state at boundary */
+	if (v + c > 0.0) {
+		ghost_charVar[2] = int_charVar[2];
+	}
+	if (v > 0.0) {
+		ghost_charVar[1] = int_charVar[1];
+	}
+	if (v - c > 0.0) {
+		ghost_charVar[0] = int_charVar[0];
+	}
 
-			alpha = getDbl("alpha", NULL);
+	/* determine the conservative state of the ghost cell */
+	charCons(ghost_charVar, ghost_cVar, int_pVar);
+	if (v > 0.0) {
+		ghost_cVar[MY] = int_cVar[MY];
+	}
 
-			aBC->pVar[P] = getDbl("pressure", NULL);
+	/* determine the primitive state of the ghost cell */
+	consPrim(ghost_cVar, ghost_pVar);
 
-			c = sqrt(gam * aBC->pVar[P] / aBC->pVar[RHO]);
-			v = Ma * c;
-			aBC->pVar[VX] = v * cos(alpha * pi / 180.0);
-			aBC->pVar[VY] = v * sin(alpha * pi / 180.0);
-			break;
-		case OUTFLOW:
-			printf("| BC Type: Outflow\n");
-			break;
-		case EXACTSOL:
-			printf("| BC Type: Exact Function\n");
+	/* rotate the primitive state into the global coordinate system */
+	double VXloc = ghost_pVar[VX];
+	double VYloc = ghost_pVar[VY];
+	ghost_pVar[VX] = n[X] * VXloc - n[Y] * VYloc;
+	ghost_pVar[VY] = n[Y] * VXloc + n[X] * VYloc;
+}
 
-			aBC->exactFunc = getInt("BCexactFunc", NULL);
-			break;
-		case PERIODIC:
-			printf("| BC Type: Periodic\n");
+/**
+ * \brief Ghost state of a pressure outlet, the pressure is prescribed for a
+ *	subsonic outflow
+ * \param[in] aBC Pointer to the boundary condition
+ * \param[in] n Outward normal vector of the boundary side
+ * \param[in] int_pVar Internal cell primitive variables state
+ * \param[out] ghost_pVar Ghost cell primitive variables state
+ */
+static inline void pressureOutState(const boundary_t *aBC, const double n[NDIM],
+		const double int_pVar[NVAR], double ghost_pVar[NVAR])
+{
+	double c = sqrt(gam * int_pVar[P] / int_pVar[RHO]);
+	double v = n[X] * int_pVar[VX] + n[Y] * int_pVar[VY];
+
+	double p;
+	if (v / c < 1.0) {
+		p = aBC->pVar[P];
+	} else {
+		p = int_pVar[P];
+	}
 
-			aBC->connection = getDblArray("connection", NDIM, NULL);
-			break;
-		case PRESSURE_OUT:
-			printf("| BC Type: Pressure Outlet\n");
+	ghost_pVar[RHO] = int_pVar[RHO] * p / int_pVar[P];
+	ghost_pVar[VX]  = int_pVar[VX];
+	ghost_pVar[VY]  = int_pVar[VY];
+	ghost_pVar[P]   = p;
+}
 
-			aBC->pVar[P] = getDbl("pressure", NULL);
-			break;
-		default:
-			printf("| ERROR: Illegal boundary condition!\n");
-			exit(1);
-		}
+/**
+ * \brief Ghost state of all boundary conditions, which do not depend on the
+ *	position and the time, i.e. all but the exact function
+ * \param[in] aBC Pointer to the boundary condition
+ * \param[in] n Outward normal vector of the boundary side
+ * \param[in] int_pVar Internal cell primitive variables state
+ * \param[out] ghost_pVar Ghost cell primitive variables state
+ */
+void boundaryState(const boundary_t *aBC, double n[NDIM], double int_pVar[NVAR],
+		double ghost_pVar[NVAR])
+{
+	/* determine type of boundary condition */
+	switch (aBC->BCtype) {
+	case SLIPWALL:
+		slipWallState(n, int_pVar, ghost_pVar);
+		break;
+	#ifdef navierstokes
+	case WALL:
+		wallState(n, int_pVar, ghost_pVar);
+		break;
+	#endif
+	case INFLOW:
+		ghost_pVar[RHO] = aBC->pVar[RHO];
+		ghost_pVar[VX]  = aBC->pVar[VX];
+		ghost_pVar[VY]  = aBC->pVar[VY];
+		ghost_pVar[P]   = aBC->pVar[P];
+		break;
+	case OUTFLOW:
+		outflowState(int_pVar, ghost_pVar);
+		break;
+	case CHARACTERISTIC:
+		characteristicState(aBC, n, int_pVar, ghost_pVar);
+		break;
+	case PRESSURE_OUT:
+		pressureOutState(aBC, n, int_pVar, ghost_pVar);
+		break;
 	}
 }
+END_DEVICE
 
 /**
  * \brief Set boundary condition value at x
- * \param[in] aSide Pinter to a boundary side
+ * \param[in] aBC Pointer to the boundary condition
+ * \param[in] n Outward normal vector of the boundary side
  * \param[in] time Computation time at calculation
  * \param[in] int_pVar Internal cell primitive variables state
  * \param[out] ghost_pVar Ghost cell primitive variables state
  * \param[in] x Barycenter coordinates of the ghost cell
  */
-void boundary(side_t *aSide, double time, double int_pVar[NVAR],
+void boundary(boundary_t *aBC, double n[NDIM], double time, double int_pVar[NVAR],
 		double ghost_pVar[NVAR], double x[NDIM])
 {
-	/* extract normal vector */
-	double n[NDIM];
-	n[X] = aSide->connection->n[X];
-	n[Y] = aSide->connection->n[Y];
+	if (aBC->BCtype == EXACTSOL) {
+		exactFunc(aBC->exactFunc, x, time, ghost_pVar);
+	} else {
+		boundaryState(aBC, n, int_pVar, ghost_pVar);
+	}
+}
 
-	/* determine type of boundary condition */
-	switch (aSide->BC->BCtype) {
-	case SLIPWALL: {
-		double VXloc[NDIM], VYloc[NDIM];
-		/* rotate into local coordinate system */
-		VXloc[X] =   n[X] * int_pVar[VX] + n[Y] * int_pVar[VY];
-		VYloc[X] = - n[Y] * int_pVar[VX] + n[X] * int_pVar[VY];
-
-		/* mirror VX and extrapolate VY */
-		VXloc[Y] = - VXloc[X];
-		VYloc[Y] =   VYloc[X];
+/**
+ * \brief Free the grouping of the boundary sides of a mesh
+ * \param[in,out] s Side data of the mesh
+ */
+void freeBCgroups(sideData_t *s)
+{
+	free(s->BCorder);
+	free(s->BCoffset);
+	free(s->BCsideCache);
+	free(s->BCbaryCache);
+	free(s->BCintState);
+	free(s->BCghostState);
+	s->BCorder = NULL;
+	s->BCoffset = NULL;
+	s->BCsideCache = NULL;
+	s->BCbaryCache = NULL;
+	s->BCintState = NULL;
+	s->BCghostState = NULL;
+}
+
+/**
+ * \brief Group the boundary sides of a mesh by their boundary condition
+ *
+ * The BC sides of the i-th boundary condition of the list are stored in
+ * `BCorder`, from `BCoffset[i]` to `BCoffset[i + 1]`, so that the ghost
+ * states are computed batch by batch, with the type of the boundary known
+ * for the whole batch. The ghost states of the exact functions, which do not
+ * depend on the time, are computed once here, at the sides and at the ghost
+ * barycenters. Has to be called again, when the boundary parameters change.
+ * The BC side states of the fused residual are allocated as well.
+ * \param[in,out] s Side data of the mesh
+ * \param[in] e Element data of the mesh
+ * \param[in] nElemsMesh Number of elements of the mesh
+ * \param[in] nBCsidesMesh Number of BC sides of the mesh
+ */
+void groupBCsides(sideData_t *s, const elemData_t *e, long nElemsMesh,
+		long nBCsidesMesh)
+{
+	freeBCgroups(s);
+	s->BCorder = dyn1DintArray(nBCsidesMesh);
+	s->BCoffset = dyn1DintArray(nBC + 1);
+	s->BCintState = dyn2DdblArray(NVAR, nBCsidesMesh);
+	s->BCghostState = dyn2DdblArray(NVAR, nBCsidesMesh);
+
+	/* counting sort by the position of the boundary condition in the list */
+	long *iBatch = dyn1DintArray(nBCsidesMesh);
+	bool hasSteadyBC = false;
+	for (long iBC = 0; iBC < nBCsidesMesh; ++iBC) {
+		long i = 0;
+		for (boundary_t *aBC = firstBC; aBC != s->BC[iBC]; aBC = aBC->next) {
+			i++;
+		}
+		iBatch[iBC] = i;
+		s->BCoffset[i + 1]++;
+		hasSteadyBC |= (s->BC[iBC]->BCtype == EXACTSOL) &&
+			isExactFuncSteady(s->BC[iBC]->exactFunc);
+	}
 
-		/* backrotate into global coordinate system */
-		ghost_pVar[VX] = n[X] * VXloc[Y] - n[Y] * VYloc[Y];
-		ghost_pVar[VY] = n[Y] * VXloc[Y] + n[X] * VYloc[Y];
+	for (int i = 0; i < nBC; ++i) {
+		s->BCoffset[i + 1] += s->BCoffset[i];
+	}
 
-		/* scalar and derived conservative variables */
-		ghost_pVar[RHO] = int_pVar[RHO];
-		ghost_pVar[P]   = int_pVar[P];
+	long *pos = dyn1DintArray(nBC);
+	for (int i = 0; i < nBC; ++i) {
+		pos[i] = s->BCoffset[i];
+	}
 
-		break;
+	for (long iBC = 0; iBC < nBCsidesMesh; ++iBC) {
+		s->BCorder[pos[iBatch[iBC]]++] = iBC;
 	}
-	#ifdef navierstokes
-	case WALL: {
-		double VXloc[NDIM], VYloc[NDIM];
-		/* rotate into local coordinate system */
-		VXloc[X] =   n[X] * int_pVar[VX] + n[Y] * int_pVar[VY];
-		VYloc[X] = - n[Y] * int_pVar[VX] + n[X] * int_pVar[VY];
-
-		/* mirror VX and extrapolate VY */
-		VXloc[Y] = - VXloc[X];
-		if (mu > 0.0) {
-			VYloc[Y] = - VYloc[X];
-		} else {
-			VYloc[Y] =   VYloc[X];
+	free(pos);
+	free(iBatch);
+
+	if (!hasSteadyBC) {
+		return;
+	}
+
+	s->BCsideCache = dyn2DdblArray(NVAR, nBCsidesMesh);
+	s->BCbaryCache = dyn2DdblArray(NVAR, nBCsidesMesh);
+	for (long iBC = 0; iBC < nBCsidesMesh; ++iBC) {
+		boundary_t *aBC = s->BC[iBC];
+		if ((aBC->BCtype != EXACTSOL) || !isExactFuncSteady(aBC->exactFunc)) {
+			continue;
 		}
 
-		/* backrotate into global coordinate system */
-		ghost_pVar[VX] = n[X] * VXloc[Y] - n[Y] * VYloc[Y];
-		ghost_pVar[VY] = n[Y] * VXloc[Y] + n[X] * VYloc[Y];
+		long aSide = 2 * s->BCsideId[iBC];
+		long iElem = s->elem[aSide];
+		long gElem = nElemsMesh + iBC;
 
-		/* scalar and derived conservative variables */
-		ghost_pVar[RHO] = int_pVar[RHO];
-		ghost_pVar[P]   = int_pVar[P];
+		double x[NDIM], pVar[NVAR];
+		x[X] = s->GP[X][aSide] + e->bary[X][iElem];
+		x[Y] = s->GP[Y][aSide] + e->bary[Y][iElem];
+		exactFunc(aBC->exactFunc, x, 0.0, pVar);
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			s->BCsideCache[iVar][iBC] = pVar[iVar];
+		}
 
-		break;
+		x[X] = e->bary[X][gElem];
+		x[Y] = e->bary[Y][gElem];
+		exactFunc(aBC->exactFunc, x, 0.0, pVar);
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			s->BCbaryCache[iVar][iBC] = pVar[iVar];
+		}
+	}
+}
+
+/**
+ * \brief Load the state of a side from a block of boundary sides
+ * \param[in] i Position of the side in the block
+ * \param[in] nBlock Normal vectors of the block
+ * \param[in] intBlock Internal states of the block
+ * \param[out] n Normal vector of the side
+ * \param[out] int_pVar Internal state of the side
+ */
+static inline void loadBCside(int i, double nBlock[NDIM][BC_BLOCK],
+		double intBlock[NVAR][BC_BLOCK], double n[NDIM], double int_pVar[NVAR])
+{
+	n[X] = nBlock[X][i];
+	n[Y] = nBlock[Y][i];
+	for (int iVar = 0; iVar < NVAR; ++iVar) {
+		int_pVar[iVar] = intBlock[iVar][i];
 	}
+}
+
+/**
+ * \brief Store the ghost state of a side in a block of boundary sides
+ * \param[in] i Position of the side in the block
+ * \param[in] ghost_pVar Ghost state of the side
+ * \param[out] ghostBlock Ghost states of the block
+ */
+static inline void storeBCside(int i, const double ghost_pVar[NVAR],
+		double ghostBlock[NVAR][BC_BLOCK])
+{
+	for (int iVar = 0; iVar < NVAR; ++iVar) {
+		ghostBlock[iVar][i] = ghost_pVar[iVar];
+	}
+}
+
+/**
+ * \brief Ghost states of a block of BC sides with the same boundary condition
+ *
+ * The type of the boundary is decided once for the block, every type has its
+ * own loop over the sides.
+ * \param[in] aBC Boundary condition of the block
+ * \param[in] nFaces Number of sides in the block
+ * \param[in] BCidx BC side indices of the block
+ * \param[in] cache Ghost states of the time independent exact functions, or
+ *	NULL
+ * \param[in] time Computation time at calculation
+ * \param[in] nBlock Normal vectors of the sides
+ * \param[in] xBlock Coordinates of the ghost states, only for exact functions
+ * \param[in] intBlock Internal states of the sides
+ * \param[out] ghostBlock Ghost states of the sides
+ */
+static void blockBoundary(const boundary_t *aBC, int nFaces, const long *BCidx,
+		double **cache, double time, double nBlock[NDIM][BC_BLOCK],
+		double xBlock[NDIM][BC_BLOCK], double intBlock[NVAR][BC_BLOCK],
+		double ghostBlock[NVAR][BC_BLOCK])
+{
+	double n[NDIM], int_pVar[NVAR], ghost_pVar[NVAR];
+
+	switch (aBC->BCtype) {
+	case SLIPWALL:
+		for (int i = 0; i < nFaces; ++i) {
+			loadBCside(i, nBlock, intBlock, n, int_pVar);
+			slipWallState(n, int_pVar, ghost_pVar);
+			storeBCside(i, ghost_pVar, ghostBlock);
+		}
+		break;
+	#ifdef navierstokes
+	case WALL:
+		for (int i = 0; i < nFaces; ++i) {
+			loadBCside(i, nBlock, intBlock, n, int_pVar);
+			wallState(n, int_pVar, ghost_pVar);
+			storeBCside(i, ghost_pVar, ghostBlock);
+		}
+		break;
 	#endif
 	case INFLOW:
-		ghost_pVar[RHO] = aSide->BC->pVar[RHO];
-		ghost_pVar[VX]  = aSide->BC->pVar[VX];
-		ghost_pVar[VY]  = aSide->BC->pVar[VY];
-		ghost_pVar[P]   = aSide->BC->pVar[P];
-
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			for (int i = 0; i < nFaces; ++i) {
+				ghostBlock[iVar][i] = aBC->pVar[iVar];
+			}
+		}
 		break;
 	case OUTFLOW:
-		ghost_pVar[RHO] = int_pVar[RHO];
-		ghost_pVar[VX]  = int_pVar[VX];
-		ghost_pVar[VY]  = int_pVar[VY];
-		ghost_pVar[P]   = int_pVar[P];
-
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			for (int i = 0; i < nFaces; ++i) {
+				ghostBlock[iVar][i] = intBlock[iVar][i];
+			}
+		}
 		break;
-	case CHARACTERISTIC: {
-		/* compute Eigenvalues of ghost cell */
-		double c = sqrt(gam * aSide->BC->pVar[P] / aSide->BC->pVar[RHO]);
-		double v = n[X] * aSide->BC->pVar[VX] + n[Y] * aSide->BC->pVar[VY];
-
-		/* rotate primitive state into local coordinate system */
-		double int_pVarloc[NVAR], ghost_pVarloc[NVAR];
-		int_pVarloc[RHO] = int_pVar[RHO];
-		int_pVarloc[VX]  =   n[X] * int_pVar[VX] + n[Y] * int_pVar[VY];
-		int_pVarloc[VY]  = - n[Y] * int_pVar[VX] + n[X] * int_pVar[VY];
-		int_pVarloc[P]   = int_pVar[P];
-
-		ghost_pVarloc[RHO] = aSide->BC->pVar[RHO];
-		ghost_pVarloc[VX]  =   n[X] * aSide->BC->pVar[VX] + n[Y] * aSide->BC->pVar[VY];
-		ghost_pVarloc[VY]  = - n[Y] * aSide->BC->pVar[VX] + n[X] * aSide->BC->pVar[VY];
-		ghost_pVarloc[P]   = aSide->BC->pVar[P];
-
-		/* compute conservative variables of both cells */
-		double int_cVar[NVAR], ghost_cVar[NVAR];
-		primCons(int_pVarloc, int_cVar);
-		primCons(ghost_pVarloc, ghost_cVar);
-
-		/* compute characteristic variables of inner and ghost cell */
-		double int_charVar[3], ghost_charVar[3];
-		consChar(int_cVar, int_charVar, int_pVar);
-		consChar(ghost_cVar, ghost_charVar, int_pVar);
-
-		/* determine characteristic state at boundary */
-		if (v + c > 0.0) {
-			ghost_charVar[2] = int_charVar[2];
+	case CHARACTERISTIC:
+		for (int i = 0; i < nFaces; ++i) {
+			loadBCside(i, nBlock, intBlock, n, int_pVar);
+			characteristicState(aBC, n, int_pVar, ghost_pVar);
+			storeBCside(i, ghost_pVar, ghostBlock);
 		}
-		if (v > 0.0) {
-			ghost_charVar[1] = int_charVar[1];
+		break;
+	case EXACTSOL:
+		if (cache) {
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				for (int i = 0; i < nFaces; ++i) {
+					ghostBlock[iVar][i] = cache[iVar][BCidx[i]];
+				}
+			}
+		} else {
+			for (int i = 0; i < nFaces; ++i) {
+				double x[NDIM] = {xBlock[X][i], xBlock[Y][i]};
+				exactFunc(aBC->exactFunc, x, time, ghost_pVar);
+				storeBCside(i, ghost_pVar, ghostBlock);
+			}
 		}
-		if (v - c > 0.0) {
-			ghost_charVar[0] = int_charVar[0];
+		break;
+	case PRESSURE_OUT:
+		for (int i = 0; i < nFaces; ++i) {
+			loadBCside(i, nBlock, intBlock, n, int_pVar);
+			pressureOutState(aBC, n, int_pVar, ghost_pVar);
+			storeBCside(i, ghost_pVar, ghostBlock);
 		}
+		break;
+	}
+}
 
-		/* determine the conservative state of the ghost cell */
-		charCons(ghost_charVar, ghost_cVar, int_pVar);
-		if (v > 0.0) {
-			ghost_cVar[MY] = int_cVar[MY];
-		}
+/**
+ * \brief Compute the ghost states of the BC sides, has to be called by all
+ *	threads of a parallel region, the barrier at the end is included
+ *
+ * The BC sides are processed batch by batch, see `groupBCsides`, each batch in
+ * blocks, whose states are gathered and scattered back.
+ * \param[in] time Computation time at calculation
+ * \param[in] isFused The internal states are taken from `BCintState` and
+ *	the ghost states are stored in `BCghostState` as well, in double
+ *	precision, instead of the side arrays only
+ */
+static void batchBCatSides(double time, bool isFused)
+{
+	int iBatch = 0;
+	for (boundary_t *aBC = firstBC; aBC; aBC = aBC->next, ++iBatch) {
+		long first = sideData.BCoffset[iBatch];
+		long nBatch = sideData.BCoffset[iBatch + 1] - first;
+		long nBlocks = (nBatch + BC_BLOCK - 1) / BC_BLOCK;
+		bool isCached = (aBC->BCtype == EXACTSOL) && sideData.BCsideCache &&
+			isExactFuncSteady(aBC->exactFunc);
+		bool needsPosition = (aBC->BCtype == EXACTSOL) && !isCached;
+
+		#pragma omp for nowait
+		for (long iBlock = 0; iBlock < nBlocks; ++iBlock) {
+			const long *BCidx = sideData.BCorder + first + iBlock * BC_BLOCK;
+			int nFaces = (nBatch - iBlock * BC_BLOCK < BC_BLOCK) ?
+				nBatch - iBlock * BC_BLOCK : BC_BLOCK;
+
+			double nBlock[NDIM][BC_BLOCK], xBlock[NDIM][BC_BLOCK];
+			double intBlock[NVAR][BC_BLOCK], ghostBlock[NVAR][BC_BLOCK];
+			for (int i = 0; i < nFaces; ++i) {
+				long iSide = sideData.BCsideId[BCidx[i]];
+				long aSide = 2 * iSide;		/* physical element side */
+				nBlock[X][i] = sideData.n[X][iSide];
+				nBlock[Y][i] = sideData.n[Y][iSide];
+				for (int iVar = 0; iVar < NVAR; ++iVar) {
+					intBlock[iVar][i] = (isFused ?
+						sideData.BCintState[iVar][BCidx[i]] :
+						sideData.pVar[iVar][aSide]);
+				}
 
-		/* determine the primitive state of the ghost cell */
-		consPrim(ghost_cVar, ghost_pVar);
+				if (needsPosition) {
+					long iElem = sideData.elem[aSide];
+					xBlock[X][i] = sideData.GP[X][aSide] + elemData.bary[X][iElem];
+					xBlock[Y][i] = sideData.GP[Y][aSide] + elemData.bary[Y][iElem];
+				}
+			}
 
-		/* rotate the primitive state into the global coordinate system */
-		double VXloc = ghost_pVar[VX];
-		double VYloc = ghost_pVar[VY];
-		ghost_pVar[VX] = n[X] * VXloc - n[Y] * VYloc;
-		ghost_pVar[VY] = n[Y] * VXloc + n[X] * VYloc;
+			blockBoundary(aBC, nFaces, BCidx, (isCached ? sideData.BCsideCache : NULL),
+					time, nBlock, xBlock, intBlock, ghostBlock);
 
-		break;
-	}
-	case EXACTSOL:
-		exactFunc(aSide->BC->exactFunc, x, time, ghost_pVar);
-		break;
-	case PRESSURE_OUT: {
-		double c = sqrt(gam * int_pVar[P] / int_pVar[RHO]);
-		double v = n[X] * int_pVar[VX] + n[Y] * int_pVar[VY];
+			for (int i = 0; i < nFaces; ++i) {
+				long gSide = 2 * sideData.BCsideId[BCidx[i]] + 1;	/* ghost element side */
+				for (int iVar = 0; iVar < NVAR; ++iVar) {
+					sideData.pVar[iVar][gSide] = ghostBlock[iVar][i];
+				}
 
-		double p;
-		if (v / c < 1.0) {
-			p = aSide->BC->pVar[P];
-		} else {
-			p = int_pVar[P];
+				if (isFused) {
+					for (int iVar = 0; iVar < NVAR; ++iVar) {
+						sideData.BCghostState[iVar][BCidx[i]] = ghostBlock[iVar][i];
+					}
+				}
+			}
 		}
+	}
 
-		ghost_pVar[RHO] = int_pVar[RHO] * p / int_pVar[P];
-		ghost_pVar[VX]  = int_pVar[VX];
-		ghost_pVar[VY]  = int_pVar[VY];
-		ghost_pVar[P]   = p;
+	#pragma omp barrier
+}
 
-		break;
-	}
-	}
+/**
+ * \brief Set the ghost values at sides inside of a parallel region, has to be
+ *	called by all threads, the barrier at the end is included
+ * \param[in] time Computation time at calculation
+ */
+void setBCatSidesThread(double time)
+{
+	batchBCatSides(time, false);
+}
+
+/**
+ * \brief Set the ghost states of the fused residual inside of a parallel
+ *	region, from the internal states in `BCintState`, has to be called by
+ *	all threads, the barrier at the end is included
+ *
+ * The states stay in double precision, also if the side arrays are single
+ * precision.
+ * \param[in] time Computation time at calculation
+ */
+void setBCstatesThread(double time)
+{
+	batchBCatSides(time, true);
 }
 
 /**
@@ -299,35 +737,63 @@ void boundary(side_t *aSide, double time, double int_pVar[NVAR],
  */
 void setBCatSides(double time)
 {
-	#pragma omp parallel for
-	for (long iSide = 0; iSide < nBCsides; ++iSide) {
-		side_t *gSide = BCside[iSide];
-		side_t *aSide = gSide->connection;
-		elem_t *aElem = aSide->elem;
-
-		double x[NDIM];
-		x[X] = aSide->GP[X] + aElem->bary[X];
-		x[Y] = aSide->GP[Y] + aElem->bary[Y];
-
-		boundary(gSide, time, aSide->pVar, gSide->pVar, x);
-	}
+	#pragma omp parallel
+	setBCatSidesThread(time);
 }
 
 /**
- * \brief Set the ghost values at elements
+ * \brief Set the ghost values at elements, has to be called by all threads of
+ *	a parallel region
  * \param[in] time Computation time at calculation
  */
 void setBCatBarys(double time)
 {
-	#pragma omp parallel for
-	for (long iSide = 0; iSide < nBCsides; ++iSide) {
-		side_t *gSide = BCside[iSide];
-		elem_t *gElem = gSide->elem;
-		side_t *aSide = gSide->connection;
-		elem_t *aElem = aSide->elem;
-
-		boundary(gSide, time, aElem->pVar, gElem->pVar, gElem->bary);
+	int iBatch = 0;
+	for (boundary_t *aBC = firstBC; aBC; aBC = aBC->next, ++iBatch) {
+		long first = sideData.BCoffset[iBatch];
+		long nBatch = sideData.BCoffset[iBatch + 1] - first;
+		long nBlocks = (nBatch + BC_BLOCK - 1) / BC_BLOCK;
+		bool isCached = (aBC->BCtype == EXACTSOL) && sideData.BCbaryCache &&
+			isExactFuncSteady(aBC->exactFunc);
+		bool needsPosition = (aBC->BCtype == EXACTSOL) && !isCached;
+
+		#pragma omp for nowait
+		for (long iBlock = 0; iBlock < nBlocks; ++iBlock) {
+			const long *BCidx = sideData.BCorder + first + iBlock * BC_BLOCK;
+			int nFaces = (nBatch - iBlock * BC_BLOCK < BC_BLOCK) ?
+				nBatch - iBlock * BC_BLOCK : BC_BLOCK;
+
+			double nBlock[NDIM][BC_BLOCK], xBlock[NDIM][BC_BLOCK];
+			double intBlock[NVAR][BC_BLOCK], ghostBlock[NVAR][BC_BLOCK];
+			for (int i = 0; i < nFaces; ++i) {
+				long iSide = sideData.BCsideId[BCidx[i]];
+				long iElem = sideData.elem[2 * iSide];
+				nBlock[X][i] = sideData.n[X][iSide];
+				nBlock[Y][i] = sideData.n[Y][iSide];
+				for (int iVar = 0; iVar < NVAR; ++iVar) {
+					intBlock[iVar][i] = elemData.pVar[iVar][iElem];
+				}
+
+				if (needsPosition) {
+					long gElem = nElems + BCidx[i];
+					xBlock[X][i] = elemData.bary[X][gElem];
+					xBlock[Y][i] = elemData.bary[Y][gElem];
+				}
+			}
+
+			blockBoundary(aBC, nFaces, BCidx, (isCached ? sideData.BCbaryCache : NULL),
+					time, nBlock, xBlock, intBlock, ghostBlock);
+
+			for (int i = 0; i < nFaces; ++i) {
+				long gElem = nElems + BCidx[i];
+				for (int iVar = 0; iVar < NVAR; ++iVar) {
+					elemData.pVar[iVar][gElem] = ghostBlock[iVar][i];
+				}
+			}
+		}
 	}
+
+	#pragma omp barrier
 }
 
 /**
@@ -346,5 +812,4 @@ void freeBoundary(void)
 			break;
 		}
 	}
-	free(BCside);
 }
@@ -50,9 +50,19 @@ extern int nBC;
 extern bool isPeriodic;
 
 void initBoundary(void);
+void updateBoundary(void);
+void freeBCgroups(sideData_t *s);
+void groupBCsides(sideData_t *s, const elemData_t *e, long nElemsMesh,
+		long nBCsidesMesh);
+void setBCatSidesThread(double time);
+void setBCstatesThread(double time);
 void setBCatSides(double time);
 void setBCatBarys(double time);
-void boundary(side_t *aSide, double time, double int_pVar[NVAR],
+BEGIN_DEVICE
+void boundaryState(const boundary_t *aBC, double n[NDIM], double int_pVar[NVAR],
+		double ghost_pVar[NVAR]);
+END_DEVICE
+void boundary(boundary_t *aBC, double n[NDIM], double time, double int_pVar[NVAR],
 		double ghost_pVar[NVAR], double x[NDIM]);
 void freeBoundary(void);
 
@@ -0,0 +1,398 @@
+/** \file
+ *
+ * \brief Binary checkpoints of the solver state for a fast and bit-exact
+ *	restart
+ *
+ * A checkpoint holds the conservative variables of all elements in double
+ * precision, the time, the iteration number, the output schedule and the
+ * counters of the implicit solver, for the dual time stepping also the
+ * solution of the previous time step, once the limiter is frozen its values,
+ * and with mesh adaptation the refinement flags of all cells, from which the
+ * adapted mesh is rebuilt before the elements are read. The primitive
+ * variables and the implicit state `Q` follow from the conservative
+ * variables, just like at the start of every time step. With domain
+ * decomposition every partition writes its own file, `<fileName>.chk` on the
+ * root and `<fileName>.chk.<rank>` on all other partitions, so a checkpoint
+ * can only be restarted with the same number of partitions.
+ *
+ * \author hhh
+ * \date Thu 15 Oct 2026 10:12:48 AM CEST
+ */
+
+#define _POSIX_C_SOURCE 200809L	/**< fileno and fsync with -std=c99 */
+
+typedef struct checkpointHeader_t checkpointHeader_t;
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <omp.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "checkpoint.h"
+#include "mesh.h"
+#include "output.h"
+#include "readInTools.h"
+#include "equationOfState.h"
+#include "timeDiscretization.h"
+#include "linearSolver.h"
+#include "memTools.h"
+#include "parallel.h"
+#include "device.h"
+#include "meshAdaptation.h"
+#include "reconstruction.h"
+
+#define CHECKPOINT_VERSION 5	/**< version of the checkpoint layout */
+
+/**
+ * \brief Header of the checkpoint file
+ */
+struct checkpointHeader_t {
+	char magic[8];			/**< file identifier "CCFDCHK" */
+	long version;			/**< version of the checkpoint layout */
+	long nElemsGlobal;		/**< number of elements of all partitions */
+	long nElems;			/**< number of elements of the partition */
+	long mpiSize;			/**< number of partitions */
+	long nVar;			/**< number of conservative variables */
+	long isStationary;		/**< stationary calculation flag */
+	long iter;			/**< iteration number */
+	double t;			/**< calculation time */
+	double timeOverall;		/**< overall time */
+	double printTime;		/**< time of the next data output */
+	long printIter;			/**< iteration of the next data output */
+	long nNewtonIterGlobal;		/**< global number of Newton iterations */
+	long nGMRESiterGlobal;		/**< global number of GMRES iterations */
+	double cfl;			/**< current CFL number */
+	double cflResidual;		/**< residual of the CFL ramping */
+	double dtPrevious;		/**< previous time step of the dual time
+					  stepping, 0 if the previous solution
+					  does not follow the elements */
+	long nAdaptFlags;		/**< number of refinement flags of the
+					  adapted mesh, 0 without adaptation */
+	long isLimiterFrozen;		/**< the limiter values are frozen and
+					  follow the elements */
+};
+
+/* extern variables */
+double checkpointInterval;		/**< wall clock interval of the
+					  checkpoints in seconds, 0 disables them */
+bool isCheckpointRestart;		/**< restarted from a checkpoint */
+
+/* local variables */
+char checkpointFile[2 * STRLEN];	/**< name of the checkpoint file */
+double tLastCheckpoint;			/**< wall clock time of the last
+					  checkpoint */
+
+/**
+ * \brief Name of the checkpoint file of this partition
+ * \param[out] fileName The name of the file
+ * \param[in] baseName The name of the root partition's file
+ */
+void checkpointFileName(char fileName[2 * STRLEN + 8], const char *baseName)
+{
+	if (mpiRank > 0) {
+		sprintf(fileName, "%s.%d", baseName, mpiRank);
+	} else {
+		strcpy(fileName, baseName);
+	}
+}
+
+/**
+ * \brief Initialize the checkpoints
+ */
+void initCheckpoint(void)
+{
+	checkpointInterval = getDbl("checkpointInterval", "0.0");
+	sprintf(checkpointFile, "%s.chk", strOutFile);
+	tLastCheckpoint = CPU_TIME();
+}
+
+/**
+ * \brief Check if a restart file is a checkpoint
+ * \param[in] fileName The name of the restart file
+ * \return True, if the file starts with the checkpoint identifier
+ */
+bool isCheckpoint(const char *fileName)
+{
+	char magic[8] = "";
+	FILE *file = fopen(fileName, "rb");
+	if (!file) {
+		return false;
+	}
+
+	size_t nRead = fread(magic, sizeof(magic), 1, file);
+	fclose(file);
+
+	return (nRead == 1) && (!memcmp(magic, "CCFDCHK", 8));
+}
+
+/**
+ * \brief Flush the directory entry of a file to the disk
+ * \param[in] fileName The name of the file
+ * \return True, if the directory was synchronized
+ */
+static bool syncDirectory(const char *fileName)
+{
+	char dirName[2 * STRLEN + 8];
+	strcpy(dirName, fileName);
+	char *slash = strrchr(dirName, '/');
+	if (slash == dirName) {
+		slash[1] = '\0';
+	} else if (slash) {
+		*slash = '\0';
+	} else {
+		strcpy(dirName, ".");
+	}
+
+	int fd = open(dirName, O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	bool isSynced = (fsync(fd) == 0);
+	close(fd);
+	return isSynced;
+}
+
+/**
+ * \brief Write the solver state into the checkpoint file
+ *
+ * The state is written into a temporary file, which is renamed into place,
+ * so an interrupted write never destroys the previous checkpoint. The file
+ * is synchronized before and its directory after the rename, so that also
+ * a crash of the node leaves a complete checkpoint.
+ * \param[in] iter The completed iteration
+ */
+void writeCheckpoint(long iter)
+{
+	deviceToHost();
+
+	checkpointHeader_t header;
+	memset(&header, 0, sizeof(header));
+
+	strcpy(header.magic, "CCFDCHK");
+	header.version = CHECKPOINT_VERSION;
+	header.nElemsGlobal = nElemsGlobal;
+	header.nElems = nElems;
+	header.mpiSize = mpiSize;
+	header.nVar = NVAR;
+	header.isStationary = isStationary;
+	header.iter = iter;
+	header.t = t;
+	header.timeOverall = timeOverall;
+	header.printTime = printTime;
+	header.printIter = printIter;
+	header.nNewtonIterGlobal = nNewtonIterGlobal;
+	header.nGMRESiterGlobal = nGMRESiterGlobal;
+	header.cfl = cfl;
+	header.cflResidual = cflResidual;
+	header.dtPrevious = (isDualTimeStepping ? dtPrevious : 0.0);
+
+	char *adaptFlags = NULL;
+	header.nAdaptFlags = adaptationFlags(&adaptFlags);
+	header.isLimiterFrozen = isLimiterFrozen;
+
+	long *fileId = dyn1DintArray(nElems);
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		fileId[iElem] = elem[iElem]->fileId;
+	}
+
+	char fileName[2 * STRLEN + 8], tmpFile[2 * STRLEN + 12];
+	checkpointFileName(fileName, checkpointFile);
+	sprintf(tmpFile, "%s.tmp", fileName);
+
+	bool isWritten = false;
+	FILE *file = fopen(tmpFile, "wb");
+	if (file) {
+		isWritten = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+			(fwrite(adaptFlags, sizeof(char), header.nAdaptFlags,
+				file) == (size_t)header.nAdaptFlags) &&
+			(fwrite(fileId, sizeof(long), nElems, file) == (size_t)nElems);
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			isWritten = isWritten && (fwrite(elemData.cVar[iVar],
+					sizeof(double), nElems, file) == (size_t)nElems);
+		}
+		for (int iVar = 0; (iVar < NVAR) && (header.dtPrevious > 0.0); ++iVar) {
+			isWritten = isWritten && (fwrite(cVarPrevious[iVar],
+					sizeof(double), nElems, file) == (size_t)nElems);
+		}
+		for (int iVar = 0; (iVar < NVAR) && isLimiterFrozen; ++iVar) {
+			isWritten = isWritten && (fwrite(limiterPhi[iVar],
+					sizeof(double), nElems, file) == (size_t)nElems);
+		}
+		isWritten = isWritten && (fflush(file) == 0) &&
+			(fsync(fileno(file)) == 0);
+		isWritten = (fclose(file) == 0) && isWritten;
+
+		if (isWritten) {
+			isWritten = (rename(tmpFile, fileName) == 0);
+		}
+
+		if (!isWritten) {
+			remove(tmpFile);
+		} else if (!syncDirectory(fileName)) {
+			printf("| WARNING: could not synchronize the directory of checkpoint '%s'\n",
+					fileName);
+		}
+	}
+
+	if (!isWritten) {
+		printf("| WARNING: could not write checkpoint '%s'\n", fileName);
+	}
+
+	free(adaptFlags);
+	free(fileId);
+}
+
+/**
+ * \brief Write a checkpoint, if the checkpoint interval has passed
+ *
+ * The decision is taken with the wall clock of the slowest partition, so
+ * that all partitions write the checkpoint of the same iteration.
+ * \param[in] iter The completed iteration
+ */
+void checkpoint(long iter)
+{
+	if (checkpointInterval <= 0.0) {
+		return;
+	}
+
+	double tElapsed = CPU_TIME() - tLastCheckpoint;
+	globalMax(&tElapsed, 1);
+	if (tElapsed < checkpointInterval) {
+		return;
+	}
+
+	writeCheckpoint(iter);
+	tLastCheckpoint = CPU_TIME();
+}
+
+/**
+ * \brief Restore the solver state from a checkpoint file, used at restart
+ *
+ * The elements have to be in the same order as at the time of the
+ * checkpoint, which holds for the same mesh, renumbering and partitioning.
+ */
+void readCheckpoint(void)
+{
+	char fileName[2 * STRLEN + 8];
+	checkpointFileName(fileName, strIniCondFile);
+
+	FILE *file = fopen(fileName, "rb");
+	if (!file) {
+		printf("| ERROR: could not open checkpoint '%s'\n", fileName);
+		exit(1);
+	}
+
+	checkpointHeader_t header;
+	if ((fread(&header, sizeof(header), 1, file) != 1) ||
+			(memcmp(header.magic, "CCFDCHK", 8)) ||
+			(header.version != CHECKPOINT_VERSION)) {
+		printf("| ERROR: '%s' is no valid checkpoint\n", fileName);
+		exit(1);
+	}
+
+	/* the adapted mesh is rebuilt before the elements are compared */
+	if (header.nAdaptFlags > 0) {
+		if (!useAdaptation) {
+			printf("| ERROR: Checkpoint '%s' needs mesh adaptation\n",
+					fileName);
+			exit(1);
+		}
+
+		char *adaptFlags = malloc(header.nAdaptFlags);
+		if (!adaptFlags) {
+			printf("| ERROR: could not allocate adaptFlags\n");
+			exit(1);
+		}
+
+		if (fread(adaptFlags, sizeof(char), header.nAdaptFlags, file) !=
+				(size_t)header.nAdaptFlags) {
+			printf("| ERROR: Checkpoint '%s' is truncated\n", fileName);
+			exit(1);
+		}
+
+		restoreAdaptation(adaptFlags, header.nAdaptFlags);
+		free(adaptFlags);
+	}
+
+	if ((header.nElemsGlobal != nElemsGlobal) || (header.nElems != nElems) ||
+			(header.mpiSize != mpiSize) || (header.nVar != NVAR) ||
+			(header.isStationary != isStationary)) {
+		printf("| ERROR: Checkpoint '%s' does not match the calculation\n",
+				fileName);
+		exit(1);
+	}
+
+	long *fileId = dyn1DintArray(nElems);
+	bool isRead = (fread(fileId, sizeof(long), nElems, file) == (size_t)nElems);
+	for (int iVar = 0; iVar < NVAR; ++iVar) {
+		isRead = isRead && (fread(elemData.cVar[iVar], sizeof(double),
+					nElems, file) == (size_t)nElems);
+	}
+
+	/* without the previous solution the dual time stepping starts with an
+	 * implicit Euler step */
+	if (isDualTimeStepping && (header.dtPrevious > 0.0)) {
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			isRead = isRead && (fread(cVarPrevious[iVar], sizeof(double),
+						nElems, file) == (size_t)nElems);
+		}
+		dtPrevious = header.dtPrevious;
+	}
+
+	/* the frozen limiter is not computed again from the restored solution */
+	if (header.isLimiterFrozen) {
+		if (!limiterPhi) {
+			printf("| ERROR: Checkpoint '%s' needs the limiter freezing\n",
+					fileName);
+			exit(1);
+		}
+
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			isRead = isRead && (fread(limiterPhi[iVar], sizeof(double),
+						nElems, file) == (size_t)nElems);
+		}
+		isLimiterFrozen = true;
+	}
+	fclose(file);
+
+	if (!isRead) {
+		printf("| ERROR: Checkpoint '%s' is truncated\n", fileName);
+		exit(1);
+	}
+
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		if (fileId[iElem] != elem[iElem]->fileId) {
+			printf("| ERROR: Elements of checkpoint '%s' are in a different order\n",
+					fileName);
+			exit(1);
+		}
+
+		consPrimElem(iElem);
+	}
+	free(fileId);
+
+	iniIterationNumber = header.iter;
+	t = header.t;
+	timeOverall = header.timeOverall;
+	printTime = header.printTime;
+	printIter = header.printIter;
+	nNewtonIterGlobal = header.nNewtonIterGlobal;
+	nGMRESiterGlobal = header.nGMRESiterGlobal;
+	if (isCflRamping) {
+		cfl = header.cfl;
+		cflResidual = header.cflResidual;
+	}
+	isCheckpointRestart = true;
+
+	if (isStationary) {
+		printf("| Restarted at Iteration %ld\n", iniIterationNumber);
+	} else {
+		printf("| Restarted at Time %.10g, Iteration %ld\n", t,
+				iniIterationNumber);
+	}
+}
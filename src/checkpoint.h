@@ -0,0 +1,21 @@
+/** \file
+ *
+ * \author hhh
+ * \date Thu 15 Oct 2026 10:12:48 AM CEST
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdbool.h>
+
+extern double checkpointInterval;
+extern bool isCheckpointRestart;
+
+void initCheckpoint(void);
+bool isCheckpoint(const char *fileName);
+void writeCheckpoint(long iter);
+void checkpoint(long iter);
+void readCheckpoint(void);
+
+#endif
@@ -0,0 +1,821 @@
+/** \file
+ *
+ * \brief Offloading of the explicit time integration to an accelerator
+ *
+ * With `make GPU=on` the residual evaluation and the time update of the
+ * explicit Euler and Runge-Kutta schemes run as OpenMP target kernels. The
+ * solution and mesh arrays are copied to the device once and stay there for
+ * the whole time loop. Only the reductions of the time step and of the
+ * residual, the states needed by `analyze` and the fields of the data output
+ * come back to the host.
+ *
+ * The pointer tables of the 2D host arrays are not valid on the device, so
+ * the kernels work on the contiguous storage behind them: variable `iVar` of
+ * element `iElem` is `pVar[iVar * nTotal + iElem]` instead of
+ * `elemData.pVar[iVar][iElem]`. Every kernel copies the pointers into local
+ * variables, which are translated to the device addresses when the target
+ * region starts. Without an accelerator the kernels run on the host.
+ *
+ * \author hhh
+ * \date Thu 15 Oct 2026 02:41:17 PM CEST
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <omp.h>
+
+#include "main.h"
+#include "device.h"
+#include "mesh.h"
+#include "equation.h"
+#include "exactRiemann.h"
+#include "equationOfState.h"
+#include "boundary.h"
+#include "fluxCalculation.h"
+#include "reconstruction.h"
+#include "finiteVolume.h"
+#include "timeDiscretization.h"
+#include "multigrid.h"
+#include "analyze.h"
+#include "readInTools.h"
+#include "memTools.h"
+#include "parallel.h"
+#include "timer.h"
+#include "meshAdaptation.h"
+
+typedef struct deviceData_t deviceData_t;
+
+/**
+ * \brief Host addresses of the arrays that are mapped to the device
+ *
+ * The 2D arrays are stored variable after variable, with the number of
+ * entries of one variable as stride.
+ */
+struct deviceData_t {
+	long nTotal;			/**< stride of the element arrays with
+						ghost elements */
+	long nSideIdx;			/**< length of `sideIdx` */
+	double *sx;			/**< cell extension in x-direction */
+	double *sy;			/**< cell extension in y-direction */
+	double *area;			/**< area of the element */
+	double *areaq;			/**< inverse of element area */
+	double *venkEps_sq;		/**< Venkatakrishnan limiter constant */
+	double *dt;			/**< element time step */
+	long *sideOffset;		/**< CSR offsets into `sideIdx` */
+	long *sideIdx;			/**< element side IDs of all elements */
+	double *pVar;			/**< primitive variables [NVAR][nTotal] */
+	double *cVar;			/**< conservative variables [NVAR][nElems] */
+	double *cVarStage;		/**< initial Runge-Kutta stage
+						[NVAR][nElems] */
+	double *u_x;			/**< x-gradient [NVAR][nTotal] */
+	double *u_y;			/**< y-gradient [NVAR][nTotal] */
+	double *u_t;			/**< time derivative [NVAR][nElems] */
+	double *n;			/**< normal vector [NDIM][nSides] */
+	double *len;			/**< length of the side */
+	double *flux;			/**< numerical flux [NVAR][nSides] */
+	long *elem;			/**< element of each element side */
+	double *GP;			/**< vector to the Gaussian point
+						[NDIM][2 * nSides] */
+	double *w;			/**< gradient reconstruction weights
+						[NDIM][2 * nSides] */
+	face_t *sidePVar;		/**< states at the element sides, only
+						stored at boundaries [NVAR][2 * nSides] */
+	long *BCsideId;			/**< side ID of every BC side */
+	long *BCidx;			/**< index of the boundary condition of
+						every BC side in `BC` */
+	boundary_t *BC;			/**< copies of the boundary conditions */
+	long nProbeElems;		/**< number of record point elements */
+	long *probeElem;		/**< record point elements */
+	double *probeElemVar;		/**< primitive variables of the record
+						point elements [NVAR][nProbeElems] */
+	long nProbeSides;		/**< number of wing sides */
+	long *probeSide;		/**< element sides of the wing */
+	double *probeSideP;		/**< pressure at the wing sides */
+};
+
+/* extern variables */
+bool useDevice;				/**< offload the time integration flag */
+
+/* local variables */
+deviceData_t dev;			/**< arrays mapped to the device */
+bool isHostCurrent;			/**< the host holds the latest solution */
+
+BEGIN_DEVICE
+
+/**
+ * \brief Get the state of an element at one of its side GPs
+ * \param[in] iSide Element side index
+ * \param[in] iElem Element the side belongs to
+ * \param[in] order Spatial order
+ * \param[in] nTotal Stride of the element arrays
+ * \param[in] nElemSides Stride of the element side arrays
+ * \param[in] pVar Primitive variables of the elements
+ * \param[in] u_x x-gradients of the elements
+ * \param[in] u_y y-gradients of the elements
+ * \param[in] GP Vectors from the barycenters to the side GPs
+ * \param[out] state Reconstructed primitive state
+ */
+static inline void deviceSideState(long iSide, long iElem, int order,
+		long nTotal, long nElemSides, const double *pVar,
+		const double *u_x, const double *u_y, const double *GP,
+		double state[NVAR])
+{
+	if (order == 1) {
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			state[iVar] = pVar[iVar * nTotal + iElem];
+		}
+	} else {
+		double dx = GP[X * nElemSides + iSide];
+		double dy = GP[Y * nElemSides + iSide];
+
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			state[iVar] = pVar[iVar * nTotal + iElem]
+				+ dx * u_x[iVar * nTotal + iElem]
+				+ dy * u_y[iVar * nTotal + iElem];
+		}
+	}
+}
+
+END_DEVICE
+
+/**
+ * \brief Initialize the offloading and copy the solution and the mesh to the
+ *	device
+ *
+ * Only the explicit time integration of the Euler equations on a single
+ * partition, without source terms and exact function boundaries, is
+ * offloaded. All other calculations run on the host.
+ */
+void initDevice(void)
+{
+	useDevice = false;
+
+#ifdef USE_GPU
+	printf("\nInitializing Device:\n");
+	if (!getBool("useDevice", "T")) {
+		printf("| Running on the Host\n");
+		return;
+	}
+
+	const char *reason = NULL;
+	#ifdef navierstokes
+	reason = "the Navier-Stokes equations";
+	#endif
+	if (isImplicit) {
+		reason = "implicit time stepping";
+	} else if (nMGlevels > 1) {
+		reason = "multigrid";
+	} else if (mpiSize > 1) {
+		reason = "domain decomposition";
+	} else if (doCalcSource) {
+		reason = "source terms";
+	} else if (smoothingCoeff > 0.0) {
+		reason = "residual smoothing";
+	} else if (limiterFreezeResidual > 0.0) {
+		reason = "limiter freezing";
+	} else if (useAdaptation) {
+		reason = "mesh adaptation";
+	}
+	for (boundary_t *aBC = firstBC; aBC; aBC = aBC->next) {
+		if (aBC->BCtype == EXACTSOL) {
+			reason = "exact function boundary conditions";
+		}
+	}
+
+	if (reason) {
+		printf("| WARNING: No offloading with %s, running on the host\n",
+				reason);
+		return;
+	}
+
+	useDevice = true;
+	isHostCurrent = true;
+
+	int nDevices = omp_get_num_devices();
+	if (nDevices > 0) {
+		printf("| Offloading to Device %d of %d\n",
+				omp_get_default_device() + 1, nDevices);
+	} else {
+		printf("| WARNING: No Device Found, Kernels Run on the Host\n");
+	}
+
+	dev.nTotal = nElems + nBCsides + nHaloElems;
+	dev.nSideIdx = elemData.sideOffset[nElems];
+	dev.sx = elemData.sx;
+	dev.sy = elemData.sy;
+	dev.area = elemData.area;
+	dev.areaq = elemData.areaq;
+	dev.venkEps_sq = elemData.venkEps_sq;
+	dev.dt = elemData.dt;
+	dev.sideOffset = elemData.sideOffset;
+	dev.sideIdx = elemData.sideIdx;
+	dev.pVar = elemData.pVar[0];
+	dev.cVar = elemData.cVar[0];
+	dev.cVarStage = elemData.cVarStage[0];
+	dev.u_x = elemData.u_x[0];
+	dev.u_y = elemData.u_y[0];
+	dev.u_t = elemData.u_t[0];
+	dev.n = sideData.n[0];
+	dev.len = sideData.len;
+	dev.flux = sideData.flux[0];
+	dev.elem = sideData.elem;
+	dev.GP = sideData.GP[0];
+	dev.w = sideData.w[0];
+	dev.sidePVar = sideData.pVar[0];
+	dev.BCsideId = sideData.BCsideId;
+
+	/* the boundary conditions are copied into an array, the list
+	 * pointers of the copies are not used on the device */
+	dev.BC = malloc((nBC > 0 ? nBC : 1) * sizeof(boundary_t));
+	if (!dev.BC) {
+		printf("| ERROR: could not allocate dev.BC\n");
+		exit(1);
+	}
+	int iBC = 0;
+	for (boundary_t *aBC = firstBC; aBC; aBC = aBC->next) {
+		dev.BC[iBC++] = *aBC;
+	}
+
+	dev.BCidx = dyn1DintArray(nBCsides);
+	for (long iSide = 0; iSide < nBCsides; ++iSide) {
+		iBC = 0;
+		for (boundary_t *aBC = firstBC; aBC != sideData.BC[iSide]; aBC = aBC->next) {
+			iBC++;
+		}
+		dev.BCidx[iSide] = iBC;
+	}
+
+	/* states that are needed by analyze in every iteration */
+	dev.nProbeElems = 0;
+	dev.probeElem = dyn1DintArray(recordPoint.nPoints);
+	for (long iPt = 0; iPt < recordPoint.nPoints; ++iPt) {
+		if (recordPoint.elem[iPt]) {
+			dev.probeElem[dev.nProbeElems++] = recordPoint.elem[iPt]->id;
+		}
+	}
+	dev.probeElemVar = dyn1DdblArray(NVAR * dev.nProbeElems);
+
+	dev.nProbeSides = (doCalcWing ? wing.nSides : 0);
+	dev.probeSide = dyn1DintArray(dev.nProbeSides);
+	for (long iSide = 0; iSide < dev.nProbeSides; ++iSide) {
+		dev.probeSide[iSide] = wing.sideId[iSide];
+	}
+	dev.probeSideP = dyn1DdblArray(dev.nProbeSides);
+
+	/* physical constants of the flux functions and boundary conditions */
+	#pragma omp target update to(R, gam, gam1, gam2, gam1q, cp, Pr, mu, iFlux, gamExp)
+
+	long nTotal = dev.nTotal, nSideIdx = dev.nSideIdx;
+	long nProbeElems = dev.nProbeElems, nProbeSides = dev.nProbeSides;
+
+	double tic = CPU_TIME();
+	#pragma omp target enter data map(to: dev.sx[0:nElems], dev.sy[0:nElems], \
+			dev.area[0:nElems], dev.areaq[0:nElems], dev.venkEps_sq[0:nElems], \
+			dev.sideOffset[0:nElems + 1], dev.sideIdx[0:nSideIdx], \
+			dev.pVar[0:NVAR * nTotal], dev.cVar[0:NVAR * nElems], \
+			dev.n[0:NDIM * nSides], dev.len[0:nSides], dev.elem[0:2 * nSides], \
+			dev.GP[0:NDIM * 2 * nSides], dev.w[0:NDIM * 2 * nSides], \
+			dev.sidePVar[0:NVAR * 2 * nSides], dev.BCsideId[0:nBCsides], \
+			dev.BCidx[0:nBCsides], dev.BC[0:nBC], dev.probeElem[0:nProbeElems], \
+			dev.probeSide[0:nProbeSides]) \
+		map(alloc: dev.dt[0:nElems], dev.cVarStage[0:NVAR * nElems], \
+			dev.u_x[0:NVAR * nTotal], dev.u_y[0:NVAR * nTotal], \
+			dev.u_t[0:NVAR * nElems], dev.flux[0:NVAR * nSides], \
+			dev.probeElemVar[0:NVAR * nProbeElems], \
+			dev.probeSideP[0:nProbeSides])
+	printf("| Mapped Mesh and Solution to the Device in %g s\n", CPU_TIME() - tic);
+#endif
+}
+
+/**
+ * \brief Compute the stable time step of every element on the device
+ * \param[out] dtMin Minimum of the convective and of the viscous time steps
+ *	of the partition
+ */
+void deviceTimeStep(double dtMin[2])
+{
+	double *sx = dev.sx, *sy = dev.sy, *area = dev.area, *dt = dev.dt;
+	double *pVar = dev.pVar;
+	long nTotal = dev.nTotal;
+	double cflNumber = cfl;
+
+	double dtConvMax = 1e150;
+	long nNaN = 0;
+	if (isTimeStep1D) {
+		#pragma omp target teams distribute parallel for \
+			reduction(min:dtConvMax) reduction(+:nNaN)
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			double rho = pVar[RHO * nTotal + iElem];
+			double vx = pVar[VX * nTotal + iElem];
+			double p = pVar[P * nTotal + iElem];
+
+			double a = sqrt(gam * p / rho);
+			double dtConv = cflNumber * sy[iElem] / (fabs(vx) + a);
+			if (!isfinite(dtConv)) {
+				nNaN++;
+			}
+			dt[iElem] = dtConv;
+			dtConvMax = fmin(dtConvMax, dtConv);
+		}
+	} else {
+		#pragma omp target teams distribute parallel for \
+			reduction(min:dtConvMax) reduction(+:nNaN)
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			double rho = pVar[RHO * nTotal + iElem];
+			double vx = pVar[VX * nTotal + iElem];
+			double vy = pVar[VY * nTotal + iElem];
+			double p = pVar[P * nTotal + iElem];
+
+			double a = sqrt(gam * p / rho);
+			double sumSpectralRadii = (fabs(vx) + a) * sx[iElem]
+						+ (fabs(vy) + a) * sy[iElem];
+			double dtConv = cflNumber * area[iElem] / sumSpectralRadii;
+			if (!isfinite(dtConv)) {
+				nNaN++;
+			}
+			dt[iElem] = dtConv;
+			dtConvMax = fmin(dtConvMax, dtConv);
+		}
+	}
+
+	if (nNaN > 0) {
+		printf("| Convective Time Step NaN\n");
+		exit(1);
+	}
+
+	/* the Euler equations have no viscous time step */
+	dtMin[0] = dtConvMax;
+	dtMin[1] = 1e150;
+}
+
+/**
+ * \brief Sum up the area weighted time steps on the device
+ * \param[out] dtMean Area weighted sum of the element time steps and the
+ *	area of the partition
+ */
+void deviceMeanTimeStep(double dtMean[2])
+{
+	double *area = dev.area, *dt = dev.dt;
+
+	double dtSum = 0.0, areaSum = 0.0;
+	#pragma omp target teams distribute parallel for \
+		reduction(+:dtSum, areaSum)
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		dtSum += area[iElem] * dt[iElem];
+		areaSum += area[iElem];
+	}
+
+	dtMean[0] = dtSum;
+	dtMean[1] = areaSum;
+}
+
+/**
+ * \brief Set the time step of all elements on the device
+ * \param[in] dtGlob The global time step
+ */
+void deviceSetTimeStep(double dtGlob)
+{
+	double *dt = dev.dt;
+
+	#pragma omp target teams distribute parallel for
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		dt[iElem] = dtGlob;
+	}
+}
+
+/**
+ * \brief Set the ghost states at the barycenters of the ghost elements
+ */
+static void deviceBCatBarys(void)
+{
+	double *pVar = dev.pVar, *n = dev.n;
+	long *elem = dev.elem, *BCsideId = dev.BCsideId, *BCidx = dev.BCidx;
+	boundary_t *BC = dev.BC;
+	long nTotal = dev.nTotal;
+
+	#pragma omp target teams distribute parallel for
+	for (long iBC = 0; iBC < nBCsides; ++iBC) {
+		long iSide = BCsideId[iBC];
+		long iElem = elem[2 * iSide];
+		long gElem = nElems + iBC;
+
+		double nVec[NDIM] = {n[X * nSides + iSide], n[Y * nSides + iSide]};
+		double int_pVar[NVAR], ghost_pVar[NVAR];
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			int_pVar[iVar] = pVar[iVar * nTotal + iElem];
+		}
+
+		boundaryState(&BC[BCidx[iBC]], nVec, int_pVar, ghost_pVar);
+
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			pVar[iVar * nTotal + gElem] = ghost_pVar[iVar];
+		}
+	}
+}
+
+/**
+ * \brief Compute and limit the gradients of all elements on the device, in
+ *	the same way as `limitedGradients`
+ */
+static void deviceLimitedGradients(void)
+{
+	double *pVar = dev.pVar, *u_x = dev.u_x, *u_y = dev.u_y;
+	double *GP = dev.GP, *w = dev.w, *venkEps_sq = dev.venkEps_sq;
+	long *sideOffset = dev.sideOffset, *sideIdx = dev.sideIdx, *elem = dev.elem;
+	long nTotal = dev.nTotal, nElemSides = 2 * nSides;
+	int limiterType = limiter;
+
+	#pragma omp target teams distribute parallel for
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		double pVarElem[NVAR], uMin[NVAR], uMax[NVAR];
+		double gradX[NVAR] = {0.0}, gradY[NVAR] = {0.0};
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			pVarElem[iVar] = uMin[iVar] = uMax[iVar] = pVar[iVar * nTotal + iElem];
+		}
+
+		/* gradients and neighbor extrema */
+		for (long j = sideOffset[iElem]; j < sideOffset[iElem + 1]; ++j) {
+			long iSide = sideIdx[j];
+			long NBelem = elem[iSide ^ 1];
+
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				double pVarNB = pVar[iVar * nTotal + NBelem];
+				double pDiff = pVarNB - pVarElem[iVar];
+
+				gradX[iVar] += w[X * nElemSides + iSide] * pDiff;
+				gradY[iVar] += w[Y * nElemSides + iSide] * pDiff;
+
+				uMin[iVar] = fmin(uMin[iVar], pVarNB);
+				uMax[iVar] = fmax(uMax[iVar], pVarNB);
+			}
+		}
+
+		/* limiter */
+		double phi[NVAR] = {1.0, 1.0, 1.0, 1.0};
+		for (long j = sideOffset[iElem]; j < sideOffset[iElem + 1]; ++j) {
+			long iSide = sideIdx[j];
+			double dx = GP[X * nElemSides + iSide];
+			double dy = GP[Y * nElemSides + iSide];
+
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				double minDiff = uMin[iVar] - pVarElem[iVar];
+				double maxDiff = uMax[iVar] - pVarElem[iVar];
+				double uDiff = gradX[iVar] * dx + gradY[iVar] * dy;
+
+				double phiLoc = 1.0;
+				if (limiterType == BARTHJESPERSEN) {
+					if (uDiff > 0.0) {
+						phiLoc = fmin(1.0, maxDiff / uDiff);
+					} else if (uDiff < 0.0) {
+						phiLoc = fmin(1.0, minDiff / uDiff);
+					}
+				} else if (limiterType == VENKATAKRISHNAN) {
+					double eps_sq = venkEps_sq[iElem];
+					double uDiffsq = uDiff * uDiff;
+					double minDiffsq = minDiff * minDiff;
+					double maxDiffsq = maxDiff * maxDiff;
+
+					if (uDiff > 0.0) {
+						phiLoc = 1.0 / uDiff * (((maxDiffsq + eps_sq) * uDiff
+									+ 2.0 * uDiffsq * maxDiff)
+								/ (maxDiffsq + 2.0 * uDiffsq + uDiff
+									* maxDiff + eps_sq));
+					} else if (uDiff < 0.0) {
+						phiLoc = 1.0 / uDiff * (((minDiffsq + eps_sq) * uDiff
+									+ 2.0 * uDiffsq * minDiff)
+								/ (minDiffsq + 2.0 * uDiffsq + uDiff
+									* minDiff + eps_sq));
+					}
+				}
+
+				phi[iVar] = fmin(phi[iVar], phiLoc);
+			}
+		}
+
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			u_x[iVar * nTotal + iElem] = gradX[iVar] * phi[iVar];
+			u_y[iVar * nTotal + iElem] = gradY[iVar] * phi[iVar];
+		}
+	}
+}
+
+/**
+ * \brief Calculate the fluxes over all sides on the device
+ *
+ * Every side is calculated by a thread of its own, which reconstructs the
+ * states, evaluates the boundary conditions and the flux function. As in
+ * the fused residual evaluation, only the states at the boundary sides are
+ * stored.
+ */
+static void deviceFluxCalculation(void)
+{
+	double *pVar = dev.pVar, *u_x = dev.u_x, *u_y = dev.u_y;
+	double *n = dev.n, *len = dev.len, *flux = dev.flux, *GP = dev.GP;
+	long *elem = dev.elem, *BCidx = dev.BCidx;
+	face_t *sidePVar = dev.sidePVar;
+	boundary_t *BC = dev.BC;
+	long nTotal = dev.nTotal, nElemSides = 2 * nSides;
+	int order = spatialOrder;
+
+	#pragma omp target teams distribute parallel for
+	for (long iSide = 0; iSide < nSides; ++iSide) {
+		long lSide = 2 * iSide;
+		long rSide = 2 * iSide + 1;
+		long lElem = elem[lSide];
+		long rElem = elem[rSide];
+		double nx = n[X * nSides + iSide];
+		double ny = n[Y * nSides + iSide];
+
+		double pVarL[NVAR], pVarR[NVAR];
+		deviceSideState(lSide, lElem, order, nTotal, nElemSides, pVar,
+				u_x, u_y, GP, pVarL);
+
+		if (rElem < nElems) {
+			deviceSideState(rSide, rElem, order, nTotal, nElemSides,
+					pVar, u_x, u_y, GP, pVarR);
+		} else {
+			double nVec[NDIM] = {nx, ny};
+			boundaryState(&BC[BCidx[rElem - nElems]], nVec, pVarL, pVarR);
+
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				sidePVar[iVar * nElemSides + lSide] = pVarL[iVar];
+				sidePVar[iVar * nElemSides + rSide] = pVarR[iVar];
+			}
+		}
+
+		/* rotate the states into normal direction */
+		double qL[NVAR], qR[NVAR];
+		qL[RHO] = pVarL[RHO];
+		qL[VX]  =   nx * pVarL[VX] + ny * pVarL[VY];
+		qL[VY]  = - ny * pVarL[VX] + nx * pVarL[VY];
+		qL[P]   = pVarL[P];
+
+		qR[RHO] = pVarR[RHO];
+		qR[VX]  =   nx * pVarR[VX] + ny * pVarR[VY];
+		qR[VY]  = - ny * pVarR[VX] + nx * pVarR[VY];
+		qR[P]   = pVarR[P];
+
+		double f[NVAR] = {0.0};
+		convectiveFlux(qL, qR, f);
+
+		/* rotate back and integrate over the side */
+		flux[RHO * nSides + iSide] = f[RHO] * len[iSide];
+		flux[MX * nSides + iSide]  = (nx * f[MX] - ny * f[MY]) * len[iSide];
+		flux[MY * nSides + iSide]  = (ny * f[MX] + nx * f[MY]) * len[iSide];
+		flux[E * nSides + iSide]   = f[E] * len[iSide];
+	}
+}
+
+/**
+ * \brief Perform the spatial operator of the finite volume scheme on the
+ *	device, the result is the time derivative of every element
+ */
+static void deviceTimeDerivative(void)
+{
+	double tic = CPU_TIME();
+	if (spatialOrder == 2) {
+		deviceBCatBarys();
+		timerAdd(TIMER_BOUNDARY, &tic);
+		deviceLimitedGradients();
+		timerAdd(TIMER_RECONSTRUCTION, &tic);
+	}
+
+	deviceFluxCalculation();
+	timerAdd(TIMER_FLUX, &tic);
+
+	double *flux = dev.flux, *u_t = dev.u_t, *areaq = dev.areaq;
+	long *sideOffset = dev.sideOffset, *sideIdx = dev.sideIdx;
+
+	#pragma omp target teams distribute parallel for
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		double sum[NVAR] = {0.0};
+
+		for (long j = sideOffset[iElem]; j < sideOffset[iElem + 1]; ++j) {
+			long iSide = sideIdx[j];
+
+			/* the flux is stored for the first element of the side */
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				if (iSide % 2 == 0) {
+					sum[iVar] += flux[iVar * nSides + iSide / 2];
+				} else {
+					sum[iVar] += - flux[iVar * nSides + iSide / 2];
+				}
+			}
+		}
+
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			u_t[iVar * nElems + iElem] = - sum[iVar] * areaq[iElem];
+		}
+	}
+	timerAdd(TIMER_UPDATE, &tic);
+}
+
+/**
+ * \brief Update the conservative variables on the device
+ *
+ * The new state is `cVar = cVarBase + coeff * dt * u_t`, followed by the
+ * conversion into primitive variables.
+ * \param[in] cVarBase Initial state, `cVar` itself or the initial
+ *	Runge-Kutta stage
+ * \param[in] coeff Coefficient of the time step
+ */
+static void deviceUpdate(double *cVarBase, double coeff)
+{
+	double *cVar = dev.cVar, *pVar = dev.pVar, *u_t = dev.u_t, *dt = dev.dt;
+	long nTotal = dev.nTotal;
+
+	double tic = CPU_TIME();
+	#pragma omp target teams distribute parallel for
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		double dtElem = dt[iElem];
+		double cVarElem[NVAR], pVarElem[NVAR];
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			cVarElem[iVar] = cVarBase[iVar * nElems + iElem]
+				+ coeff * dtElem * u_t[iVar * nElems + iElem];
+			cVar[iVar * nElems + iElem] = cVarElem[iVar];
+		}
+
+		consPrim(cVarElem, pVarElem);
+
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			pVar[iVar * nTotal + iElem] = pVarElem[iVar];
+		}
+	}
+	timerAdd(TIMER_TIMEUPDATE, &tic);
+
+	isHostCurrent = false;
+}
+
+/**
+ * \brief Explicit Euler time step on the device, with the time steps of the
+ *	elements
+ * \param[out] resIter Residual vector for time step
+ */
+void deviceTimeStepEuler(double resIter[NVAR + 2])
+{
+	deviceTimeDerivative();
+	deviceUpdate(dev.cVar, 1.0);
+
+	globalResidual(resIter);
+}
+
+/**
+ * \brief Runge-Kutta time step with `nRKstages` stages on the device
+ * \param[out] resIter Residual vector for time step
+ */
+void deviceTimeStepRK(double resIter[NVAR + 2])
+{
+	double *cVar = dev.cVar, *cVarStage = dev.cVarStage;
+
+	/* save the initial solution as needed for the RK scheme */
+	double tic = CPU_TIME();
+	#pragma omp target teams distribute parallel for
+	for (long i = 0; i < NVAR * nElems; ++i) {
+		cVarStage[i] = cVar[i];
+	}
+	timerAdd(TIMER_TIMEUPDATE, &tic);
+
+	/* loop over the RK stages */
+	for (int iStage = 1; iStage <= nRKstages; ++iStage) {
+		deviceTimeDerivative();
+		deviceUpdate(dev.cVarStage, RKcoeff[iStage]);
+	}
+
+	globalResidual(resIter);
+}
+
+/**
+ * \brief Sum up the squared time derivatives on the device, weighted with the
+ *	element areas
+ * \param[out] resIter Sums of the conservative variables
+ */
+void deviceResidual(double resIter[NVAR])
+{
+	double *area = dev.area, *u_t = dev.u_t;
+
+	double resRHO = 0.0, resMX = 0.0, resMY = 0.0, resE = 0.0;
+	#pragma omp target teams distribute parallel for \
+		reduction(+:resRHO, resMX, resMY, resE)
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		double uRHO = u_t[RHO * nElems + iElem];
+		double uMX  = u_t[MX * nElems + iElem];
+		double uMY  = u_t[MY * nElems + iElem];
+		double uE   = u_t[E * nElems + iElem];
+
+		resRHO += area[iElem] * uRHO * uRHO;
+		resMX  += area[iElem] * uMX  * uMX;
+		resMY  += area[iElem] * uMY  * uMY;
+		resE   += area[iElem] * uE   * uE;
+	}
+
+	resIter[RHO] = resRHO;
+	resIter[MX]  = resMX;
+	resIter[MY]  = resMY;
+	resIter[E]   = resE;
+}
+
+/**
+ * \brief Copy the states of the record point elements and the pressure at
+ *	the wing sides to the host, as needed by `analyze`
+ */
+void deviceProbes(void)
+{
+	long nProbeElems = dev.nProbeElems, nProbeSides = dev.nProbeSides;
+	if ((nProbeElems == 0) && (nProbeSides == 0)) {
+		return;
+	}
+
+	double *pVar = dev.pVar, *probeElemVar = dev.probeElemVar;
+	double *probeSideP = dev.probeSideP;
+	face_t *sidePVar = dev.sidePVar;
+	long *probeElem = dev.probeElem, *probeSide = dev.probeSide;
+	long nTotal = dev.nTotal, nElemSides = 2 * nSides;
+
+	double tic = CPU_TIME();
+	#pragma omp target teams distribute parallel for
+	for (long i = 0; i < nProbeElems; ++i) {
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			probeElemVar[iVar * nProbeElems + i] =
+				pVar[iVar * nTotal + probeElem[i]];
+		}
+	}
+
+	#pragma omp target teams distribute parallel for
+	for (long i = 0; i < nProbeSides; ++i) {
+		probeSideP[i] = sidePVar[P * nElemSides + probeSide[i]];
+	}
+
+	#pragma omp target update from(probeElemVar[0:NVAR * nProbeElems], \
+			probeSideP[0:nProbeSides])
+
+	for (long i = 0; i < nProbeElems; ++i) {
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			elemData.pVar[iVar][probeElem[i]] =
+				probeElemVar[iVar * nProbeElems + i];
+		}
+	}
+	for (long i = 0; i < nProbeSides; ++i) {
+		sideData.pVar[P][probeSide[i]] = probeSideP[i];
+	}
+	timerAdd(TIMER_TRANSFER, &tic);
+}
+
+/**
+ * \brief Copy the solution and the boundary side states to the host, if
+ *	the host is not up to date
+ */
+void deviceToHost(void)
+{
+	if (!useDevice || isHostCurrent) {
+		return;
+	}
+
+	/* the array sections only appear in the directives */
+	#ifdef _OPENMP
+		long nTotal = dev.nTotal;
+	#endif
+
+	double tic = CPU_TIME();
+	#pragma omp target update from(dev.pVar[0:NVAR * nTotal], \
+			dev.cVar[0:NVAR * nElems], dev.sidePVar[0:NVAR * 2 * nSides])
+	isHostCurrent = true;
+	timerAdd(TIMER_TRANSFER, &tic);
+}
+
+/**
+ * \brief Release the device memory
+ */
+void freeDevice(void)
+{
+	if (!useDevice) {
+		return;
+	}
+
+	#ifdef _OPENMP
+		long nTotal = dev.nTotal, nSideIdx = dev.nSideIdx;
+		long nProbeElems = dev.nProbeElems, nProbeSides = dev.nProbeSides;
+	#endif
+
+	#pragma omp target exit data map(delete: dev.sx[0:nElems], dev.sy[0:nElems], \
+			dev.area[0:nElems], dev.areaq[0:nElems], dev.venkEps_sq[0:nElems], \
+			dev.sideOffset[0:nElems + 1], dev.sideIdx[0:nSideIdx], \
+			dev.pVar[0:NVAR * nTotal], dev.cVar[0:NVAR * nElems], \
+			dev.n[0:NDIM * nSides], dev.len[0:nSides], dev.elem[0:2 * nSides], \
+			dev.GP[0:NDIM * 2 * nSides], dev.w[0:NDIM * 2 * nSides], \
+			dev.sidePVar[0:NVAR * 2 * nSides], dev.BCsideId[0:nBCsides], \
+			dev.BCidx[0:nBCsides], dev.BC[0:nBC], dev.probeElem[0:nProbeElems], \
+			dev.probeSide[0:nProbeSides], dev.dt[0:nElems], \
+			dev.cVarStage[0:NVAR * nElems], dev.u_x[0:NVAR * nTotal], \
+			dev.u_y[0:NVAR * nTotal], dev.u_t[0:NVAR * nElems], \
+			dev.flux[0:NVAR * nSides], dev.probeElemVar[0:NVAR * nProbeElems], \
+			dev.probeSideP[0:nProbeSides])
+
+	free(dev.BC);
+	free(dev.BCidx);
+	free(dev.probeElem);
+	free(dev.probeElemVar);
+	free(dev.probeSide);
+	free(dev.probeSideP);
+}
@@ -0,0 +1,27 @@
+/** \file
+ *
+ * \author hhh
+ * \date Thu 15 Oct 2026 02:41:17 PM CEST
+ */
+
+#ifndef DEVICE_H
+#define DEVICE_H
+
+#include <stdbool.h>
+
+#include "main.h"
+
+extern bool useDevice;
+
+void initDevice(void);
+void deviceTimeStep(double dtMin[2]);
+void deviceMeanTimeStep(double dtMean[2]);
+void deviceSetTimeStep(double dt);
+void deviceTimeStepEuler(double resIter[NVAR + 2]);
+void deviceTimeStepRK(double resIter[NVAR + 2]);
+void deviceResidual(double resIter[NVAR]);
+void deviceProbes(void);
+void deviceToHost(void);
+void freeDevice(void);
+
+#endif
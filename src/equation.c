@@ -11,6 +11,7 @@
 #include <math.h>
 
 #include "equation.h"
+#include "exactRiemann.h"
 #include "readInTools.h"
 
 /* extern variables */
@@ -34,6 +35,22 @@ double sqrt2;				/**< sqrt(2.0) */
 double sqrt3;				/**< sqrt(3.0) */
 double sqrt3q;				/**< 1.0 / sqrt(3.0) */
 
+/**
+ * \brief Calculate the constants that follow from the heat capacity ratio,
+ *	also used by the flux benchmark, which has no parameter file
+ */
+void initGasConstants(void)
+{
+	pi = acos(-1.0);
+	gam1 = gam - 1.0;
+	gam2 = gam - 2.0;
+	gam1q = 1.0 / gam1;
+	sqrt2 = sqrt(2.0);
+	sqrt3 = sqrt(3.0);
+	sqrt3q = 1 / sqrt3;
+	initExactRiemann();
+}
+
 /**
  * \brief Initialize equations
  */
@@ -109,13 +126,7 @@ void initEquation(void)
 		exit(1);
 	}
 
-	pi = acos(-1.0);
-	gam1 = gam - 1.0;
-	gam2 = gam - 2.0;
-	gam1q = 1.0 / gam1;
-	sqrt2 = sqrt(2.0);
-	sqrt3 = sqrt(3.0);
-	sqrt3q = 1 / sqrt3;
+	initGasConstants();
 
 	doCalcSource = getBool("calcSource", "F");
 	if (doCalcSource) {
@@ -9,9 +9,12 @@
 
 #include <stdbool.h>
 
+#include "main.h"
+
 extern double pi;
 
 extern bool doCalcSource;
+BEGIN_DEVICE
 extern double R;
 extern double gam;
 extern double gam1;
@@ -22,6 +25,7 @@ extern double Pr;
 extern double mu;
 
 extern int iFlux;
+END_DEVICE
 
 extern int intExactFunc;
 extern int sourceFunc;
@@ -29,6 +33,7 @@ extern double sqrt2;
 extern double sqrt3;
 extern double sqrt3q;
 
+void initGasConstants(void);
 void initEquation(void);
 
 #endif
@@ -10,6 +10,7 @@
 
 #include "main.h"
 #include "equation.h"
+#include "mesh.h"
 
 /**
  * \brief Convert primitive variables into conservative variables
@@ -108,3 +109,43 @@ void charCons(double charac[3], double cVar[NVAR], double pVarRef[NVAR])
 	cVar[MX]  = cVar1D[1];
 	cVar[E]   = cVar1D[2];
 }
+
+/**
+ * \brief Convert the primitive variables of an element into conservative
+ *	variables
+ * \param[in] iElem Element ID
+ */
+void primConsElem(long iElem)
+{
+	double pVar[NVAR] = {
+		elemData.pVar[RHO][iElem], elemData.pVar[VX][iElem],
+		elemData.pVar[VY][iElem], elemData.pVar[P][iElem]
+	};
+	double cVar[NVAR];
+	primCons(pVar, cVar);
+
+	elemData.cVar[RHO][iElem] = cVar[RHO];
+	elemData.cVar[MX][iElem]  = cVar[MX];
+	elemData.cVar[MY][iElem]  = cVar[MY];
+	elemData.cVar[E][iElem]   = cVar[E];
+}
+
+/**
+ * \brief Convert the conservative variables of an element into primitive
+ *	variables
+ * \param[in] iElem Element ID
+ */
+void consPrimElem(long iElem)
+{
+	double cVar[NVAR] = {
+		elemData.cVar[RHO][iElem], elemData.cVar[MX][iElem],
+		elemData.cVar[MY][iElem], elemData.cVar[E][iElem]
+	};
+	double pVar[NVAR];
+	consPrim(cVar, pVar);
+
+	elemData.pVar[RHO][iElem] = pVar[RHO];
+	elemData.pVar[VX][iElem]  = pVar[VX];
+	elemData.pVar[VY][iElem]  = pVar[VY];
+	elemData.pVar[P][iElem]   = pVar[P];
+}
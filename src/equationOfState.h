@@ -9,9 +9,13 @@
 
 #include "main.h"
 
+BEGIN_DEVICE
 void primCons(const double pVar[NVAR], double cVar[NVAR]);
 void consPrim(const double cVar[NVAR], double pVar[NVAR]);
 void consChar(double cVar[NVAR], double charac[3], double pVarRef[NVAR]);
 void charCons(double charac[3], double cVar[NVAR], double pVarRef[NVAR]);
+END_DEVICE
+void primConsElem(long iElem);
+void consPrimElem(long iElem);
 
 #endif
@@ -17,6 +17,16 @@
 #include "equationOfState.h"
 #include "exactRiemann.h"
 
+/**
+ * \brief Check whether an exact function does not depend on the time
+ * \param[in] iExactFunc The exact function control
+ * \return True for the time independent exact functions
+ */
+bool isExactFuncSteady(int iExactFunc)
+{
+	return (iExactFunc == 1) || (iExactFunc == 2);
+}
+
 /** \brief Calculate an exact function
  *
  * This function contains the following exact functions:
@@ -7,6 +7,9 @@
 #ifndef EXACTFUNCTION_H
 #define EXACTFUNCTION_H
 
+#include <stdbool.h>
+
+bool isExactFuncSteady(int iExactFunc);
 void exactFunc(int iExactFunc, double x[NDIM], double time, double pVar[NVAR]);
 
 #endif
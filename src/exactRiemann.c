@@ -1,6 +1,6 @@
 /** \file
  *
- * \brief Contains the function to calculate the exact Riemann flux
+ * \brief Contains the functions to calculate the exact Riemann flux
  *
  * \author hhh
  * \date Sun 29 Mar 2020 12:35:17 PM CEST
@@ -8,17 +8,29 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
 #include <math.h>
 
 #include "equation.h"
+#include "exactRiemann.h"
+#include "fluxCalculation.h"
+
+BEGIN_DEVICE
+
+/* extern variables */
+double gamExp[9];			/**< exponents and factors of gamma */
 
 /* local variables */
-double G[9];				/**< gamma vector */
 double tol = 1e-6;			/**< tolerance for the iteration */
 int nIter = 1000;			/**< maximum number of iterations */
+double nearUniform = 1e-4;		/**< relative jumps below which a single
+					  Newton step is sufficient */
 
 /**
  * \brief Helper function for `exactRiemann`
+ *
+ * The rarefaction branch needs only one power, since
+ * (p / pk)^(-(gamma + 1) / (2 gamma)) = (p / pk)^((gamma - 1) / (2 gamma)) / (p / pk).
  * \param[out] f Flux
  * \param[out] fd Flux difference
  * \param[in] p Pressure
@@ -26,12 +38,15 @@ int nIter = 1000;			/**< maximum number of iterations */
  * \param[in] pk Critical pressure
  * \param[in] ck Critical speed of sound
  */
-void preFun(double *f, double *fd, double p, double rhok, double pk, double ck)
+static inline void preFun(double *f, double *fd, double p, double rhok,
+		double pk, double ck)
 {
+	const double *G = gamExp;
 	if (p < pk) {
 		double pRat = p / pk;
-		*f = G[3] * ck * (pow(pRat, G[0]) - 1.0);
-		*fd = (1.0 / (rhok * ck)) * pow(pRat, -G[1]);
+		double pPow = pow(pRat, G[0]);
+		*f = G[3] * ck * (pPow - 1.0);
+		*fd = pPow / (pRat * rhok * ck);
 	} else {
 		double ak = G[4] / rhok;
 		double bk = G[5] * pk;
@@ -42,55 +57,53 @@ void preFun(double *f, double *fd, double p, double rhok, double pk, double ck)
 }
 
 /**
- * \brief Calculate the exact solution to the Riemann problem
+ * \brief Abort, since the given states generate vacuum
  * \param[in] rhol Left side density
  * \param[in] rhor Right side density
- * \param[out] rho The resulting density
  * \param[in] ul Left side velocity
  * \param[in] ur Right side velocity
- * \param[out] u Resulting velocity
  * \param[in] pl Left side pressure
  * \param[in] pr Right side pressure
- * \param[out] p Resulting pressure
  * \param[in] al Left side speed of sound
  * \param[in] ar Right side speed of sound
- * \param[in] s	Speed of the discontinuity
  */
-void exactRiemann(double rhol, double rhor, double *rho,
-		  double ul,   double ur,   double *u,
-		  double pl,   double pr,   double *p,
-		  double al,   double ar,   double s)
+static void vacuumError(double rhol, double rhor, double ul, double ur,
+		double pl, double pr, double al, double ar)
 {
-	/* fill G matrix */
-	G[0] = (gam - 1.0) / (2.0 * gam);
-	G[1] = (gam + 1.0) / (2.0 * gam);
-	G[2] = 2.0 * gam / (gam - 1.0);
-	G[3] = 2.0 / (gam - 1.0);
-	G[4] = 2.0 / (gam + 1.0);
-	G[5] = (gam - 1.0) / (gam + 1.0);
-	G[6] = 0.5 * (gam - 1.0);
-	G[7] = 1.0 / gam;
-	G[8] = gam - 1.0;
-
-	double du = ur - ul;
-	double duCrit = G[3] * (al + ar) - du;
-	if (duCrit < 0.0) {
-		printf("| ERROR: Vacuum is generated by given data:\n");
-		printf("| rho_l   = %g\n", rhol);
-		printf("| rho_r   = %g\n", rhor);
-		printf("| u_l     = %g\n", ul);
-		printf("| u_r     = %g\n", ur);
-		printf("| p_l     = %g\n", pl);
-		printf("| p_r     = %g\n", pr);
-		printf("| a_l     = %g\n", al);
-		printf("| a_r     = %g\n", ar);
-		printf("| du      = %g\n", du);
-		printf("| G[3]    = %g\n", G[3]);
-		printf("| a_l+a_r = %g\n", al + ar);
-		exit(1);
-	}
+	printf("| ERROR: Vacuum is generated by given data:\n");
+	printf("| rho_l   = %g\n", rhol);
+	printf("| rho_r   = %g\n", rhor);
+	printf("| u_l     = %g\n", ul);
+	printf("| u_r     = %g\n", ur);
+	printf("| p_l     = %g\n", pl);
+	printf("| p_r     = %g\n", pr);
+	printf("| a_l     = %g\n", al);
+	printf("| a_r     = %g\n", ar);
+	printf("| du      = %g\n", ur - ul);
+	printf("| G[3]    = %g\n", gamExp[3]);
+	printf("| a_l+a_r = %g\n", al + ar);
+	exit(1);
+}
 
-	/* starting pressure */
+/**
+ * \brief Starting pressure of the Newton iteration
+ *
+ * The primitive variable solution is taken if it lies between the two
+ * pressures, otherwise the two-rarefaction or the two-shock approximation.
+ * \param[in] rhol Left side density
+ * \param[in] rhor Right side density
+ * \param[in] ul Left side velocity
+ * \param[in] ur Right side velocity
+ * \param[in] pl Left side pressure
+ * \param[in] pr Right side pressure
+ * \param[in] al Left side speed of sound
+ * \param[in] ar Right side speed of sound
+ * \return The starting pressure
+ */
+static inline double startingPressure(double rhol, double rhor,
+		double ul, double ur, double pl, double pr, double al, double ar)
+{
+	const double *G = gamExp;
 	double qMax = 2.0;
 	double pv = 0.5 * (pl + pr)
 		- 0.125 * (ur - ul) * (rhol + rhor) * (al + ar);
@@ -98,51 +111,77 @@ void exactRiemann(double rhol, double rhor, double *rho,
 	double pMax = fmax(pl, pr);
 	double qRat = pMax / pMin;
 	if ((qRat < qMax) && (pMin < pv) && (pv < pMax)) {
-		*p = fmax(tol, pv);
+		return fmax(tol, pv);
+	} else if (pv < pMin) {
+		double pnu = al + ar - G[6] * (ur - ul);
+		double pde = al / pow(pl, G[0]) + ar / pow(pr, G[0]);
+		return pow(pnu / pde, G[2]);
 	} else {
-		if (pv < pMin) {
-			double pnu = al + ar - G[6] * (ur - ul);
-			double pde = al / pow(pl, G[0]) + ar / pow(pr, G[0]);
-			*p = pow(pnu / pde, G[2]);
-		} else {
-			double gel = sqrt((G[4] / rhol) / (G[5] * pl + fmax(tol, pv)));
-			double ger = sqrt((G[4] / rhor) / (G[5] * pr + fmax(tol, pv)));
-			*p = (gel * pl + ger * pr - (ur - ul)) / (gel + ger);
-			*p = fmax(tol, *p);
-		}
+		double gel = sqrt((G[4] / rhol) / (G[5] * pl + fmax(tol, pv)));
+		double ger = sqrt((G[4] / rhor) / (G[5] * pr + fmax(tol, pv)));
+		return fmax(tol, (gel * pl + ger * pr - (ur - ul)) / (gel + ger));
 	}
+}
 
-	/* iteration */
-	double p0 = *p;
-	double cha = 2.0 * tol;
-	int KK = 0;
-	double fr = 0.0, fl = 0.0, frd = 0.0, fld = 0.0;
-	while ((cha > tol) && (KK < nIter)) {
-		preFun(&fl, &fld, *p, rhol, pl, al);
-		preFun(&fr, &frd, *p, rhor, pr, ar);
-
-		*p -= (fl + fr + du) / (fld + frd);
-		cha = 2.0 * fabs((*p - p0) / (*p + p0));
-
-		if (*p < 0.0) {
-			*p = tol;
-		}
-
-		p0 = *p;
+/**
+ * \brief One Newton step for the pressure of the star region
+ * \param[in,out] p Pressure
+ * \param[out] u Velocity of the star region, from the pressure before the step
+ * \param[in] rhol Left side density
+ * \param[in] rhor Right side density
+ * \param[in] ul Left side velocity
+ * \param[in] ur Right side velocity
+ * \param[in] pl Left side pressure
+ * \param[in] pr Right side pressure
+ * \param[in] al Left side speed of sound
+ * \param[in] ar Right side speed of sound
+ * \return The relative change of the pressure
+ */
+static inline double newtonStep(double *p, double *u, double rhol, double rhor,
+		double ul, double ur, double pl, double pr, double al, double ar)
+{
+	double fl, fld, fr, frd;
+	preFun(&fl, &fld, *p, rhol, pl, al);
+	preFun(&fr, &frd, *p, rhor, pr, ar);
 
-		KK++;
-	}
+	double p0 = *p;
+	*p -= (fl + fr + ur - ul) / (fld + frd);
+	double cha = 2.0 * fabs((*p - p0) / (*p + p0));
 
-	if (KK > nIter) {
-		printf("| WARNING: Divergence in Newton-Raphson Scheme\n");
+	if (*p < 0.0) {
+		*p = tol;
 	}
 
 	*u = 0.5 * (ul + ur + fr - fl);
+	return cha;
+}
 
-	double pm = *p;
-	double um = *u;
-
-	/* sample */
+/**
+ * \brief Sample the solution of the Riemann problem
+ *
+ * Along the isentropes the density follows from a single power, the speed of
+ * sound and the pressure from (c / ck)^2 = (p / pk) / (rho / rhok).
+ * \param[in] pm Pressure of the star region
+ * \param[in] um Velocity of the star region
+ * \param[in] s Speed at which to sample
+ * \param[in] rhol Left side density
+ * \param[in] rhor Right side density
+ * \param[in] ul Left side velocity
+ * \param[in] ur Right side velocity
+ * \param[in] pl Left side pressure
+ * \param[in] pr Right side pressure
+ * \param[in] al Left side speed of sound
+ * \param[in] ar Right side speed of sound
+ * \param[out] rho The resulting density
+ * \param[out] u Resulting velocity
+ * \param[out] p Resulting pressure
+ */
+static inline void sampleState(double pm, double um, double s,
+		double rhol, double rhor, double ul, double ur,
+		double pl, double pr, double al, double ar,
+		double *rho, double *u, double *p)
+{
+	const double *G = gamExp;
 	if (s < um) {
 		if (pm < pl) {
 			if (s < ul - al) {
@@ -150,17 +189,20 @@ void exactRiemann(double rhol, double rhor, double *rho,
 				*u = ul;
 				*p = pl;
 			} else {
-				double cml = al * pow(pm / pl, G[0]);
+				double rhoRat = pow(pm / pl, G[7]);
+				double cml = al * sqrt(pm / pl / rhoRat);
 				double stl = um - cml;
 				if (s > stl) {
-					*rho = rhol * pow(pm / pl, G[7]);
+					*rho = rhol * rhoRat;
 					*u = um;
 					*p = pm;
 				} else {
 					*u = G[4] * (al + G[6] * ul + s);
 					double c = G[4] * (al + G[6] * (ul - s));
-					*rho = rhol * pow(c / al, G[3]);
-					*p = pl * pow(c / al, G[2]);
+					double cRat = c / al;
+					double rhoFan = pow(cRat, G[3]);
+					*rho = rhol * rhoFan;
+					*p = pl * rhoFan * cRat * cRat;
 				}
 			}
 		} else {
@@ -196,19 +238,207 @@ void exactRiemann(double rhol, double rhor, double *rho,
 				*u = ur;
 				*p = pr;
 			} else {
-				double cmr = ar * pow(pm / pr, G[0]);
+				double rhoRat = pow(pm / pr, G[7]);
+				double cmr = ar * sqrt(pm / pr / rhoRat);
 				double str = um + cmr;
 				if (s < str) {
-					*rho = rhor * pow(pm / pr, G[7]);
+					*rho = rhor * rhoRat;
 					*u = um;
 					*p = pm;
 				} else {
 					*u = G[4] * (-ar + G[6] * ur + s);
 					double c = G[4] * (ar - G[6] * (ur - s));
-					*rho = rhor * pow(c / ar, G[3]);
-					*p = pr * pow(c / ar, G[2]);
+					double cRat = c / ar;
+					double rhoFan = pow(cRat, G[3]);
+					*rho = rhor * rhoFan;
+					*p = pr * rhoFan * cRat * cRat;
 				}
 			}
 		}
 	}
 }
+
+/**
+ * \brief Calculate the exact solution to the Riemann problem
+ * \param[in] rhol Left side density
+ * \param[in] rhor Right side density
+ * \param[out] rho The resulting density
+ * \param[in] ul Left side velocity
+ * \param[in] ur Right side velocity
+ * \param[out] u Resulting velocity
+ * \param[in] pl Left side pressure
+ * \param[in] pr Right side pressure
+ * \param[out] p Resulting pressure
+ * \param[in] al Left side speed of sound
+ * \param[in] ar Right side speed of sound
+ * \param[in] s	Speed of the discontinuity
+ */
+void exactRiemann(double rhol, double rhor, double *rho,
+		  double ul,   double ur,   double *u,
+		  double pl,   double pr,   double *p,
+		  double al,   double ar,   double s)
+{
+	if (gamExp[3] * (al + ar) - (ur - ul) < 0.0) {
+		vacuumError(rhol, rhor, ul, ur, pl, pr, al, ar);
+	}
+
+	/* iteration */
+	double pm = startingPressure(rhol, rhor, ul, ur, pl, pr, al, ar);
+	double um = 0.0;
+	double cha = 2.0 * tol;
+	int KK = 0;
+	while ((cha > tol) && (KK < nIter)) {
+		cha = newtonStep(&pm, &um, rhol, rhor, ul, ur, pl, pr, al, ar);
+		KK++;
+	}
+
+	if (cha > tol) {
+		printf("| WARNING: Divergence in Newton-Raphson Scheme\n");
+	}
+
+	sampleState(pm, um, s, rhol, rhor, ul, ur, pl, pr, al, ar, rho, u, p);
+}
+
+/**
+ * \brief Solution of the Riemann problem at the interface, for the Godunov flux
+ *
+ * Identical pressures and velocities on both sides are the solution itself,
+ * and for nearly uniform states the starting pressure is already second order
+ * accurate, so that a single Newton step is taken instead of the iteration.
+ * \param[in] rhol Left side density
+ * \param[in] rhor Right side density
+ * \param[out] rho The resulting density
+ * \param[in] ul Left side velocity
+ * \param[in] ur Right side velocity
+ * \param[out] u Resulting velocity
+ * \param[in] pl Left side pressure
+ * \param[in] pr Right side pressure
+ * \param[out] p Resulting pressure
+ * \param[in] al Left side speed of sound
+ * \param[in] ar Right side speed of sound
+ */
+void godunovState(double rhol, double rhor, double *rho,
+		  double ul,   double ur,   double *u,
+		  double pl,   double pr,   double *p,
+		  double al,   double ar)
+{
+	double du = ur - ul;
+	if (gamExp[3] * (al + ar) - du < 0.0) {
+		vacuumError(rhol, rhor, ul, ur, pl, pr, al, ar);
+	}
+
+	double pm = pl, um = ul;
+	if ((pl != pr) || (du != 0.0)) {
+		pm = startingPressure(rhol, rhor, ul, ur, pl, pr, al, ar);
+		bool isNearUniform = (fabs(pr - pl) < nearUniform * (pl + pr))
+			&& (fabs(du) < nearUniform * (al + ar));
+		for (int iter = 0; iter < nIter; ++iter) {
+			double cha = newtonStep(&pm, &um, rhol, rhor, ul, ur,
+					pl, pr, al, ar);
+			if ((cha <= tol) || isNearUniform) {
+				break;
+			}
+		}
+	}
+
+	sampleState(pm, um, 0.0, rhol, rhor, ul, ur, pl, pr, al, ar, rho, u, p);
+}
+
+/**
+ * \brief Interface solutions of the Riemann problems of a block of faces
+ *
+ * Batched form of `godunovState`: the starting pressures, the Newton steps
+ * and the sampling are each done in a loop over the faces, the Newton steps
+ * only over the faces that have not converged yet.
+ * \param[in] nFaces Number of faces in the block, at most FLUX_BLOCK
+ * \param[in] qL Rotated left states
+ * \param[in] qR Rotated right states
+ * \param[out] qM Rotated states at the interfaces, the tangential velocity is
+ *	taken from the upwind side
+ */
+void godunovStateBlock(int nFaces, double qL[NVAR][FLUX_BLOCK],
+		double qR[NVAR][FLUX_BLOCK], double qM[NVAR][FLUX_BLOCK])
+{
+	double aL[FLUX_BLOCK], aR[FLUX_BLOCK];
+	double pm[FLUX_BLOCK], um[FLUX_BLOCK], cha[FLUX_BLOCK];
+	bool isVacuum = false;
+	for (int i = 0; i < nFaces; ++i) {
+		aL[i] = sqrt(gam * qL[P][i] / qL[RHO][i]);
+		aR[i] = sqrt(gam * qR[P][i] / qR[RHO][i]);
+		isVacuum |= (gamExp[3] * (aL[i] + aR[i]) - (qR[VX][i] - qL[VX][i]) < 0.0);
+		pm[i] = qL[P][i];
+		um[i] = qL[VX][i];
+	}
+
+	if (isVacuum) {
+		for (int i = 0; i < nFaces; ++i) {
+			if (gamExp[3] * (aL[i] + aR[i]) - (qR[VX][i] - qL[VX][i]) < 0.0) {
+				vacuumError(qL[RHO][i], qR[RHO][i], qL[VX][i], qR[VX][i],
+						qL[P][i], qR[P][i], aL[i], aR[i]);
+			}
+		}
+	}
+
+	/* faces with a jump in pressure or velocity */
+	int active[FLUX_BLOCK];
+	int nActive = 0;
+	for (int i = 0; i < nFaces; ++i) {
+		if ((qL[P][i] != qR[P][i]) || (qL[VX][i] != qR[VX][i])) {
+			active[nActive++] = i;
+		}
+	}
+
+	for (int j = 0; j < nActive; ++j) {
+		int i = active[j];
+		pm[i] = startingPressure(qL[RHO][i], qR[RHO][i], qL[VX][i], qR[VX][i],
+				qL[P][i], qR[P][i], aL[i], aR[i]);
+	}
+
+	/* the nearly uniform faces converge with the first step */
+	for (int iter = 0; (iter < nIter) && (nActive > 0); ++iter) {
+		for (int j = 0; j < nActive; ++j) {
+			int i = active[j];
+			cha[i] = newtonStep(&pm[i], &um[i], qL[RHO][i], qR[RHO][i],
+					qL[VX][i], qR[VX][i], qL[P][i], qR[P][i],
+					aL[i], aR[i]);
+			if ((iter == 0)
+					&& (fabs(qR[P][i] - qL[P][i]) < nearUniform * (qL[P][i] + qR[P][i]))
+					&& (fabs(qR[VX][i] - qL[VX][i]) < nearUniform * (aL[i] + aR[i]))) {
+				cha[i] = 0.0;
+			}
+		}
+
+		int nLeft = 0;
+		for (int j = 0; j < nActive; ++j) {
+			if (cha[active[j]] > tol) {
+				active[nLeft++] = active[j];
+			}
+		}
+		nActive = nLeft;
+	}
+
+	for (int i = 0; i < nFaces; ++i) {
+		sampleState(pm[i], um[i], 0.0, qL[RHO][i], qR[RHO][i],
+				qL[VX][i], qR[VX][i], qL[P][i], qR[P][i], aL[i], aR[i],
+				&qM[RHO][i], &qM[VX][i], &qM[P][i]);
+		qM[VY][i] = (qM[VX][i] > 0.0) ? qL[VY][i] : qR[VY][i];
+	}
+}
+
+END_DEVICE
+
+/**
+ * \brief Calculate the exponents and factors of gamma for the Riemann solvers
+ */
+void initExactRiemann(void)
+{
+	gamExp[0] = (gam - 1.0) / (2.0 * gam);
+	gamExp[1] = (gam + 1.0) / (2.0 * gam);
+	gamExp[2] = 2.0 * gam / (gam - 1.0);
+	gamExp[3] = 2.0 / (gam - 1.0);
+	gamExp[4] = 2.0 / (gam + 1.0);
+	gamExp[5] = (gam - 1.0) / (gam + 1.0);
+	gamExp[6] = 0.5 * (gam - 1.0);
+	gamExp[7] = 1.0 / gam;
+	gamExp[8] = gam - 1.0;
+}
@@ -7,9 +7,24 @@
 #ifndef EXACTRIEMANN_H
 #define EXACTRIEMANN_H
 
+#include "main.h"
+#include "fluxCalculation.h"
+
+BEGIN_DEVICE
+extern double gamExp[9];
+
 void exactRiemann(double rhol, double rhor, double *rho,
 		  double ul,   double ur,   double *u,
 		  double pl,   double pr,   double *p,
 		  double al,   double ar,   double s);
+void godunovState(double rhol, double rhor, double *rho,
+		  double ul,   double ur,   double *u,
+		  double pl,   double pr,   double *p,
+		  double al,   double ar);
+void godunovStateBlock(int nFaces, double qL[NVAR][FLUX_BLOCK],
+		double qR[NVAR][FLUX_BLOCK], double qM[NVAR][FLUX_BLOCK]);
+END_DEVICE
+
+void initExactRiemann(void);
 
 #endif
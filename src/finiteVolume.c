@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <omp.h>
 
 #include "main.h"
 #include "finiteVolume.h"
@@ -19,10 +20,86 @@
 #include "fluxCalculation.h"
 #include "equation.h"
 #include "source.h"
+#include "boundary.h"
+#include "timer.h"
+#include "parallel.h"
+#include "memTools.h"
 
 /* extern variables */
 int spatialOrder;			/**< the spacial order to be used */
 int fluxFunction;			/**< the flux function to be used */
+bool useFusedResidual;			/**< reconstruct states and apply boundary conditions inside the flux loop */
+bool useStructured;			/**< use the structured kernels of cartesian meshes */
+
+/**
+ * \brief Check that the sides of a cartesian mesh are ordered row by row
+ *
+ * The structured kernels derive the side and element indices from the
+ * position in the mesh, which is only valid for the side order of
+ * `orderCartesianSides` and the side lists of `createCartMesh`.
+ *
+ * \return True if the structured kernels can be used
+ */
+static bool checkStructuredSides(void)
+{
+	long iMax = cartMesh.iMax;
+	long jMax = cartMesh.jMax;
+	long nXsides = (iMax - 1) * jMax;
+	long nYsides = iMax * (jMax - 1);
+
+	if ((nElems != iMax * jMax) || (nSides < nXsides + nYsides)) {
+		return false;
+	}
+
+	for (long j = 0; j < jMax; ++j) {
+		for (long i = 0; i < iMax - 1; ++i) {
+			long iSide = j * (iMax - 1) + i;
+			long iElem = j * iMax + i;
+			if ((sideData.elem[2 * iSide] != iElem) ||
+					(sideData.elem[2 * iSide + 1] != iElem + 1)) {
+				return false;
+			}
+		}
+	}
+
+	for (long iElem = 0; iElem < nYsides; ++iElem) {
+		long iSide = nXsides + iElem;
+		if ((sideData.elem[2 * iSide] != iElem) ||
+				(sideData.elem[2 * iSide + 1] != iElem + iMax)) {
+			return false;
+		}
+	}
+
+	/* the interior elements list their sides left, top, right, bottom */
+	for (long j = 1; j < jMax - 1; ++j) {
+		for (long i = 1; i < iMax - 1; ++i) {
+			long iElem = j * iMax + i;
+			long *idx = &elemData.sideIdx[elemData.sideOffset[iElem]];
+			if ((elemData.sideOffset[iElem + 1] - elemData.sideOffset[iElem] != 4) ||
+					(idx[0] != 2 * (iElem - j - 1) + 1) ||
+					(idx[1] != 2 * (nXsides + iElem)) ||
+					(idx[2] != 2 * (iElem - j)) ||
+					(idx[3] != 2 * (nXsides + iElem - iMax) + 1)) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+ * \brief Calculate the element constants of the Venkatakrishnan limiter
+ */
+static void venkatakrishnanConstants(void)
+{
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		elemData.venkEps_sq[iElem] =
+			(venk_k * sqrt(elemData.area[iElem])) *
+			(venk_k * sqrt(elemData.area[iElem])) *
+			(venk_k * sqrt(elemData.area[iElem]));
+	}
+}
 
 /**
  * \brief Initialize the finite volume method
@@ -43,25 +120,501 @@ void initFV(void)
 		case VENKATAKRISHNAN:
 			printf("| Limiter: Venkatakrishnan\n");
 			venk_k = getDbl("venk_k", "1");
-
-			for (long iElem = 0; iElem < nElems; ++iElem) {
-				elem[iElem]->venkEps_sq =
-					(venk_k * sqrt(elem[iElem]->area)) *
-					(venk_k * sqrt(elem[iElem]->area)) *
-					(venk_k * sqrt(elem[iElem]->area));
-			}
+			venkatakrishnanConstants();
 			break;
 		default:
 			printf("| ERROR: Limiter must be either 1 or 2\n");
 			exit(1);
 		}
+
+		/* the limiter values are kept fixed once the residual is low
+		 * enough, so that they do not stall the convergence */
+		limiterFreezeResidual = getDbl("freezeLimiter", "0.0");
+		if (limiterFreezeResidual > 0.0) {
+			if (!isStationary) {
+				printf("| ERROR: Freezing the Limiter requires a stationary problem\n");
+				exit(1);
+			}
+			limiterPhi = dyn2DdblArray(NVAR, nElems);
+			printf("| Limiter Frozen below Residual: %g\n", limiterFreezeResidual);
+		}
+	} else {
+		limiterFreezeResidual = 0.0;
 	}
+	isLimiterFrozen = false;
 
-	for (long iElem = 0; iElem < nElems; ++iElem) {
+	useFusedResidual = getBool("fusedResidual", "T");
+	if (useFusedResidual) {
+		printf("| Using fused residual evaluation\n");
+	}
+
+	useStructured = false;
+	if ((meshType == CARTESIAN) && getBool("structuredPath", "T")) {
+		if ((mpiSize == 1) && useFusedResidual && checkStructuredSides()) {
+			useStructured = true;
+			printf("| Using structured kernels for the cartesian mesh\n");
+		} else {
+			printf("| Structured kernels not available, using unstructured kernels\n");
+		}
+	}
+
+	for (int iVar = 0; iVar < NVAR; ++iVar) {
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			elemData.source[iVar][iElem] = 0.0;
+		}
+	}
+}
+
+/**
+ * \brief Update the element constants of the finite volume method, after the
+ *	mesh was adapted
+ */
+void updateFV(void)
+{
+	if ((spatialOrder == 2) && (limiter == VENKATAKRISHNAN)) {
+		venkatakrishnanConstants();
+	}
+
+	/* the cartesian structure is lost with the first refinement */
+	useStructured = false;
+
+	for (int iVar = 0; iVar < NVAR; ++iVar) {
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			elemData.source[iVar][iElem] = 0.0;
+		}
+	}
+}
+
+/**
+ * \brief Get the state of an element at one of its side GPs
+ * \param[in] iSide Element side index
+ * \param[in] iElem Element the side belongs to
+ * \param[out] pVar Reconstructed primitive state
+ */
+static inline void sideState(long iSide, long iElem, double pVar[NVAR])
+{
+	if (spatialOrder == 1) {
+		pVar[RHO] = elemData.pVar[RHO][iElem];
+		pVar[VX]  = elemData.pVar[VX][iElem];
+		pVar[VY]  = elemData.pVar[VY][iElem];
+		pVar[P]   = elemData.pVar[P][iElem];
+	} else {
+		double dx = sideData.GP[X][iSide];
+		double dy = sideData.GP[Y][iSide];
+
+		pVar[RHO] = elemData.pVar[RHO][iElem]
+			+ dx * elemData.u_x[RHO][iElem] + dy * elemData.u_y[RHO][iElem];
+
+		pVar[VX]  = elemData.pVar[VX][iElem]
+			+ dx * elemData.u_x[VX][iElem]  + dy * elemData.u_y[VX][iElem];
+
+		pVar[VY]  = elemData.pVar[VY][iElem]
+			+ dx * elemData.u_x[VY][iElem]  + dy * elemData.u_y[VY][iElem];
+
+		pVar[P]   = elemData.pVar[P][iElem]
+			+ dx * elemData.u_x[P][iElem]   + dy * elemData.u_y[P][iElem];
+	}
+}
+
+/**
+ * \brief Set the side states of the halo elements at the interface sides
+ */
+static void haloSideStates(void)
+{
+	#pragma omp parallel for
+	for (long iSide = nSides - nInterfaceSides; iSide < nSides; ++iSide) {
+		long rSide = 2 * iSide + 1;
+		double pVar[NVAR];
+		sideState(rSide, sideData.elem[rSide], pVar);
+
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			sideData.pVar[iVar][rSide] = pVar[iVar];
+		}
+	}
+}
+
+/**
+ * \brief Reconstruct the states at the boundary sides and compute their ghost
+ *	states for the fused residual evaluation
+ *
+ * The ghost states are computed in batches per boundary condition, see
+ * `setBCstatesThread`, instead of one by one inside of the flux loop. The
+ * flux loop takes them from the double precision BC side states, they are
+ * also stored in the side arrays for the force coefficients. Has to be
+ * called by all threads of a parallel region.
+ *
+ * \param[in] time Calculation time
+ */
+static void fusedBoundaryStates(double time)
+{
+	#pragma omp for
+	for (long iBC = 0; iBC < nBCsides; ++iBC) {
+		long lSide = 2 * sideData.BCsideId[iBC];
+
+		double pVar[NVAR];
+		sideState(lSide, sideData.elem[lSide], pVar);
 		for (int iVar = 0; iVar < NVAR; ++iVar) {
-			elem[iElem]->source[iVar] = 0.0;
+			sideData.BCintState[iVar][iBC] = pVar[iVar];
+			sideData.pVar[iVar][lSide] = pVar[iVar];
+		}
+	}
+
+	setBCstatesThread(time);
+}
+
+/**
+ * \brief Calculate the fluxes over a range of sides in a single pass
+ *
+ * The side states are reconstructed from the (limited) element gradients
+ * inside of the flux loop, instead of writing them to the side arrays first
+ * and reading them back afterwards. Only the states at the boundaries are
+ * taken from the BC side states, they are computed beforehand by
+ * `fusedBoundaryStates`.
+ *
+ * Has to be called by all threads of a parallel region, there is no barrier
+ * at the end.
+ *
+ * \param[in] sideStart First side of the range
+ * \param[in] sideEnd Side after the last side of the range
+ */
+static void fusedFluxCalculation(long sideStart, long sideEnd)
+{
+	long nBlocks = (sideEnd - sideStart + FLUX_BLOCK - 1) / FLUX_BLOCK;
+	double ticThread = CPU_TIME();
+
+	#pragma omp for nowait
+	for (long iBlock = 0; iBlock < nBlocks; ++iBlock) {
+		long firstSide = sideStart + iBlock * FLUX_BLOCK;
+		int nFaces = (sideEnd - firstSide < FLUX_BLOCK) ? sideEnd - firstSide : FLUX_BLOCK;
+
+		double pVarLblock[NVAR][FLUX_BLOCK], pVarRblock[NVAR][FLUX_BLOCK];
+		for (int i = 0; i < nFaces; ++i) {
+			long iSide = firstSide + i;
+			long lSide = 2 * iSide;
+			long rSide = 2 * iSide + 1;
+			long lElem = sideData.elem[lSide];
+			long rElem = sideData.elem[rSide];
+
+			double pVarL[NVAR], pVarR[NVAR];
+			sideState(lSide, lElem, pVarL);
+
+			if ((rElem < nElems) || (rElem >= nElems + nBCsides)) {
+				sideState(rSide, rElem, pVarR);
+			} else {
+				for (int iVar = 0; iVar < NVAR; ++iVar) {
+					pVarR[iVar] = sideData.BCghostState[iVar][rElem - nElems];
+				}
+			}
+
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				pVarLblock[iVar][i] = pVarL[iVar];
+				pVarRblock[iVar][i] = pVarR[iVar];
+			}
+		}
+
+		blockFlux(firstSide, nFaces, pVarLblock, pVarRblock);
+	}
+
+	timerThreadAdd(TIMER_FLUX, ticThread);
+}
+
+/**
+ * \brief Calculate the fluxes of a cartesian mesh
+ *
+ * The inner sides are stored row by row, see `orderCartesianSides`, so the
+ * states of a block of sides are gathered from consecutive elements, without
+ * looking up the elements of the sides. The boundary and periodic sides
+ * follow the inner sides and are calculated by `fusedFluxCalculation`. Has to
+ * be called by all threads of a parallel region, there is no barrier at the
+ * end.
+ */
+static void structuredFluxCalculation(void)
+{
+	long iMax = cartMesh.iMax;
+	long jMax = cartMesh.jMax;
+	long nXsides = (iMax - 1) * jMax;
+	long nYsides = iMax * (jMax - 1);
+	long nRowBlocks = (iMax - 1 + FLUX_BLOCK - 1) / FLUX_BLOCK;
+	long nXblocks = jMax * nRowBlocks;
+	long nYblocks = (nYsides + FLUX_BLOCK - 1) / FLUX_BLOCK;
+	double ticThread = CPU_TIME();
+
+	#pragma omp for nowait
+	for (long iBlock = 0; iBlock < nXblocks + nYblocks; ++iBlock) {
+		long firstSide, firstElem, rOffset;
+		int nFaces;
+		if (iBlock < nXblocks) {
+			/* sides between the elements iElem and iElem + 1 */
+			long j = iBlock / nRowBlocks;
+			long i = (iBlock % nRowBlocks) * FLUX_BLOCK;
+			firstSide = j * (iMax - 1) + i;
+			firstElem = j * iMax + i;
+			rOffset = 1;
+			nFaces = (iMax - 1 - i < FLUX_BLOCK) ? iMax - 1 - i : FLUX_BLOCK;
+		} else {
+			/* sides between the elements iElem and iElem + iMax */
+			long i = (iBlock - nXblocks) * FLUX_BLOCK;
+			firstSide = nXsides + i;
+			firstElem = i;
+			rOffset = iMax;
+			nFaces = (nYsides - i < FLUX_BLOCK) ? nYsides - i : FLUX_BLOCK;
+		}
+
+		double pVarL[NVAR][FLUX_BLOCK], pVarR[NVAR][FLUX_BLOCK];
+		if (spatialOrder == 1) {
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				double *pVar = elemData.pVar[iVar];
+				for (int i = 0; i < nFaces; ++i) {
+					pVarL[iVar][i] = pVar[firstElem + i];
+					pVarR[iVar][i] = pVar[firstElem + i + rOffset];
+				}
+			}
+		} else {
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				double *pVar = elemData.pVar[iVar];
+				double *u_x = elemData.u_x[iVar];
+				double *u_y = elemData.u_y[iVar];
+				for (int i = 0; i < nFaces; ++i) {
+					long lSide = 2 * (firstSide + i);
+					long lElem = firstElem + i;
+					long rElem = lElem + rOffset;
+
+					pVarL[iVar][i] = pVar[lElem]
+						+ sideData.GP[X][lSide] * u_x[lElem]
+						+ sideData.GP[Y][lSide] * u_y[lElem];
+
+					pVarR[iVar][i] = pVar[rElem]
+						+ sideData.GP[X][lSide + 1] * u_x[rElem]
+						+ sideData.GP[Y][lSide + 1] * u_y[rElem];
+				}
+			}
+		}
+
+		blockFlux(firstSide, nFaces, pVarL, pVarR);
+	}
+
+	timerThreadAdd(TIMER_FLUX, ticThread);
+
+	fusedFluxCalculation(nXsides + nYsides, nSides);
+}
+
+/**
+ * \brief Add the flux over an element side to the sum of the element
+ * \param[in] iSide Element side index
+ * \param[in,out] u_t Sum of the fluxes
+ */
+static inline void addSideFlux(long iSide, double u_t[NVAR])
+{
+	/* the flux is stored for the first element of the side */
+	if (iSide % 2 == 0) {
+		u_t[RHO] += sideData.flux[RHO][iSide / 2];
+		u_t[MX]  += sideData.flux[MX][iSide / 2];
+		u_t[MY]  += sideData.flux[MY][iSide / 2];
+		u_t[E]   += sideData.flux[E][iSide / 2];
+	} else {
+		u_t[RHO] += - sideData.flux[RHO][iSide / 2];
+		u_t[MX]  += - sideData.flux[MX][iSide / 2];
+		u_t[MY]  += - sideData.flux[MY][iSide / 2];
+		u_t[E]   += - sideData.flux[E][iSide / 2];
+	}
+}
+
+/**
+ * \brief Calculate the time derivative of an element from its fluxes
+ * \param[in] iElem Element ID
+ * \param[in] u_t Sum of the fluxes over the element sides
+ */
+static inline void setTimeDerivative(long iElem, double u_t[NVAR])
+{
+	/* source term contribution */
+	elemData.u_t[RHO][iElem] = (elemData.source[RHO][iElem] - u_t[RHO]) * elemData.areaq[iElem];
+	elemData.u_t[MX][iElem]  = (elemData.source[MX][iElem]  - u_t[MX])  * elemData.areaq[iElem];
+	elemData.u_t[MY][iElem]  = (elemData.source[MY][iElem]  - u_t[MY])  * elemData.areaq[iElem];
+	elemData.u_t[E][iElem]   = (elemData.source[E][iElem]   - u_t[E])   * elemData.areaq[iElem];
+}
+
+/**
+ * \brief Calculate the time derivative of an element from the fluxes of the
+ *	sides in its side list
+ * \param[in] iElem Element ID
+ */
+static inline void elemTimeDerivative(long iElem)
+{
+	double u_t[NVAR] = {0.0};
+
+	for (long j = elemData.sideOffset[iElem]; j < elemData.sideOffset[iElem + 1]; ++j) {
+		addSideFlux(elemData.sideIdx[j], u_t);
+	}
+
+	setTimeDerivative(iElem, u_t);
+}
+
+/**
+ * \brief Calculate the time derivatives of the elements of a cartesian mesh
+ *
+ * The sides of the interior elements follow from their position, in the
+ * order of their side lists, so the sums are the same as with the side
+ * lists. The elements at the boundaries use their side lists. Has to be
+ * called by all threads of a parallel region, there is no barrier at the end.
+ */
+static void structuredTimeDerivative(void)
+{
+	long iMax = cartMesh.iMax;
+	long jMax = cartMesh.jMax;
+	long nXsides = (iMax - 1) * jMax;
+	double ticThread = CPU_TIME();
+
+	#pragma omp for nowait
+	for (long j = 0; j < jMax; ++j) {
+		if ((j == 0) || (j == jMax - 1) || (iMax < 3)) {
+			for (long iElem = j * iMax; iElem < (j + 1) * iMax; ++iElem) {
+				elemTimeDerivative(iElem);
+			}
+			continue;
+		}
+
+		elemTimeDerivative(j * iMax);
+		for (long iElem = j * iMax + 1; iElem < (j + 1) * iMax - 1; ++iElem) {
+			double u_t[NVAR] = {0.0};
+			addSideFlux(2 * (iElem - j - 1) + 1, u_t);
+			addSideFlux(2 * (nXsides + iElem), u_t);
+			addSideFlux(2 * (iElem - j), u_t);
+			addSideFlux(2 * (nXsides + iElem - iMax) + 1, u_t);
+			setTimeDerivative(iElem, u_t);
+		}
+		elemTimeDerivative((j + 1) * iMax - 1);
+	}
+
+	timerThreadAdd(TIMER_UPDATE, ticThread);
+}
+
+/**
+ * \brief Calculate the source terms and the time derivatives of the elements
+ *
+ * Has to be called by all threads of a parallel region. The time derivatives
+ * of the unstructured elements are calculated with a static schedule over the
+ * elements and without a barrier at the end.
+ *
+ * \param[in] time Calculation time
+ * \param[in,out] tic Start of the phase, only used by the master thread
+ */
+static void timeDerivativeThread(double time, double *tic)
+{
+	if (doCalcSource) {
+		calcSource(time);
+		#pragma omp master
+		timerAdd(TIMER_SOURCE, tic);
+	}
+
+	/* time update of the conservative variables */
+	if (useStructured) {
+		structuredTimeDerivative();
+		#pragma omp barrier
+	} else {
+		double ticThread = CPU_TIME();
+
+		#pragma omp for schedule(static) nowait
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			elemTimeDerivative(iElem);
+		}
+
+		timerThreadAdd(TIMER_UPDATE, ticThread);
+	}
+
+	#pragma omp master
+	timerAdd(TIMER_UPDATE, tic);
+}
+
+/**
+ * \brief Perform the spacial operator of the fused residual evaluation inside
+ *	of a parallel region
+ *
+ * All phases are work-sharing loops of the calling team, so that the threads
+ * are not forked and joined for every phase. The loops over the elements use
+ * the static schedule of the first-touch placement of the element arrays. The
+ * halo exchange is done by the master thread, the other threads wait at the
+ * next barrier or, for the last exchange, calculate the fluxes of the sides
+ * inside of the partition.
+ *
+ * When this function returns, the time derivative of an element is only
+ * complete for the thread that owns the element with a static schedule over
+ * the elements, a barrier is needed before the other elements are read.
+ *
+ * \param[in] time Calculation time at which to perform the finite volume differentiation
+ */
+void fvTimeDerivativeThread(double time)
+{
+	double tic = CPU_TIME();
+
+	/* set dt for boundary condition calculation */
+	#pragma omp for schedule(static)
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		elemData.dtLoc[iElem] = 0.5 * elemData.dt[iElem] * (timeOrder - 1);
+	}
+
+	if (useStructured) {
+		if (spatialOrder == 2) {
+			setBCatBarys(time);
+			#pragma omp master
+			timerAdd(TIMER_BOUNDARY, &tic);
+			limitedGradients();
+			#pragma omp master
+			timerAdd(TIMER_RECONSTRUCTION, &tic);
 		}
+		fusedBoundaryStates(time);
+		#pragma omp master
+		timerAdd(TIMER_BOUNDARY, &tic);
+		structuredFluxCalculation();
+	} else {
+		double **pVar[] = {elemData.pVar};
+		double **grad[] = {elemData.u_x, elemData.u_y};
+		long nOwnSides = nSides - nInterfaceSides;
+
+		if (spatialOrder == 2) {
+			#pragma omp master
+			{
+				startHaloExchange(1, pVar);
+				finishHaloExchange();
+				timerAdd(TIMER_COMMUNICATION, &tic);
+			}
+			#pragma omp barrier
+			setBCatBarys(time);
+			#pragma omp master
+			timerAdd(TIMER_BOUNDARY, &tic);
+			limitedGradients();
+			#pragma omp master
+			{
+				timerAdd(TIMER_RECONSTRUCTION, &tic);
+				startHaloExchange(2, grad);
+				timerAdd(TIMER_COMMUNICATION, &tic);
+			}
+		} else {
+			#pragma omp master
+			{
+				startHaloExchange(1, pVar);
+				timerAdd(TIMER_COMMUNICATION, &tic);
+			}
+		}
+		fusedBoundaryStates(time);
+		#pragma omp master
+		timerAdd(TIMER_BOUNDARY, &tic);
+		fusedFluxCalculation(0, nOwnSides);
+		#pragma omp master
+		{
+			timerAdd(TIMER_FLUX, &tic);
+			finishHaloExchange();
+			timerAdd(TIMER_COMMUNICATION, &tic);
+		}
+		#pragma omp barrier
+		fusedFluxCalculation(nOwnSides, nSides);
 	}
+
+	/* the element sums need the fluxes of all sides */
+	#pragma omp barrier
+	#pragma omp master
+	timerAdd(TIMER_FLUX, &tic);
+
+	timeDerivativeThread(time, &tic);
 }
 
 /**
@@ -71,51 +624,54 @@ void initFV(void)
  * the cells are reconstructed. Following that, the boundary conditions at the
  * sides are applied and the numerical flux is calculated, using the specified
  * flux function. Finally, the source term is evaluated and the time derivatives
- * of all the elements are calculated.
+ * of all the elements are calculated. With the fused residual evaluation, the
+ * gradients are limited right after they are computed, the boundary states
+ * are set right before the flux loop and the reconstruction is evaluated
+ * inside of it, all in a single parallel region, see
+ * `fvTimeDerivativeThread`.
+ *
+ * With domain decomposition the states, and for second order the gradients,
+ * of the halo elements are exchanged with the neighbor partitions. In the
+ * fused residual evaluation the exchange of the last array overlaps with the
+ * flux calculation of the sides inside of the partition.
  *
  * \param[in] time Calculation time at which to perform the finite volume differentiation
  */
 void fvTimeDerivative(double time)
 {
+	if (useFusedResidual) {
+		#pragma omp parallel
+		fvTimeDerivativeThread(time);
+		return;
+	}
+
 	/* set dt for boundary condition calculation */
 	#pragma omp parallel for
 	for (long iElem = 0; iElem < nElems; ++iElem) {
-		elem_t *aElem = elem[iElem];
-		aElem->dtLoc = 0.5 * aElem->dt * (timeOrder - 1);
+		elemData.dtLoc[iElem] = 0.5 * elemData.dt[iElem] * (timeOrder - 1);
 	}
 
+	double **pVar[] = {elemData.pVar};
+	double **grad[] = {elemData.u_x, elemData.u_y};
+
+	double tic = CPU_TIME();
+	startHaloExchange(1, pVar);
+	finishHaloExchange();
+	timerAdd(TIMER_COMMUNICATION, &tic);
 	spatialReconstruction(time);
+	timerAdd(TIMER_RECONSTRUCTION, &tic);
+	if (spatialOrder == 2) {
+		startHaloExchange(2, grad);
+		finishHaloExchange();
+		timerAdd(TIMER_COMMUNICATION, &tic);
+	}
+	haloSideStates();
+	timerAdd(TIMER_RECONSTRUCTION, &tic);
 	setBCatSides(time);
+	timerAdd(TIMER_BOUNDARY, &tic);
 	fluxCalculation();
+	timerAdd(TIMER_FLUX, &tic);
 
-	if (doCalcSource) {
-		calcSource(time);
-	}
-
-	/* time update of the conservative variables */
-	#pragma omp parallel for
-	for (long iElem = 0; iElem < nElems; ++iElem) {
-		elem_t *aElem = elem[iElem];
-		side_t *aSide = aElem->firstSide;
-
-		aElem->u_t[RHO] = 0.0;
-		aElem->u_t[VX]  = 0.0;
-		aElem->u_t[VY]  = 0.0;
-		aElem->u_t[E]   = 0.0;
-
-		while (aSide) {
-			aElem->u_t[RHO] += aSide->flux[RHO];
-			aElem->u_t[VX]  += aSide->flux[VX];
-			aElem->u_t[VY]  += aSide->flux[VY];
-			aElem->u_t[E]   += aSide->flux[E];
-
-			aSide = aSide->nextElemSide;
-		}
-
-		/* source term contribution */
-		aElem->u_t[RHO] = (aElem->source[RHO] - aElem->u_t[RHO]) * aElem->areaq;
-		aElem->u_t[VX]  = (aElem->source[VX]  - aElem->u_t[VX])  * aElem->areaq;
-		aElem->u_t[VY]  = (aElem->source[VY]  - aElem->u_t[VY])  * aElem->areaq;
-		aElem->u_t[E]   = (aElem->source[E]   - aElem->u_t[E])   * aElem->areaq;
-	}
+	#pragma omp parallel
+	timeDerivativeThread(time, &tic);
 }
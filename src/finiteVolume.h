@@ -7,10 +7,16 @@
 #ifndef FINITEVOLUME_H
 #define FINITEVOLUME_H
 
+#include <stdbool.h>
+
 extern int spatialOrder;
 extern int fluxFunction;
+extern bool useFusedResidual;
+extern bool useStructured;
 
 void initFV(void);
+void updateFV(void);
 void fvTimeDerivative(double time);
+void fvTimeDerivativeThread(double time);
 
 #endif
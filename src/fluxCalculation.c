@@ -7,6 +7,7 @@
  */
 
 #include <math.h>
+#include <omp.h>
 
 #include "main.h"
 #include "mesh.h"
@@ -14,6 +15,37 @@
 #include "exactRiemann.h"
 #include "boundary.h"
 #include "linearSolver.h"
+#include "fluxCalculation.h"
+#include "timeDiscretization.h"
+#include "timer.h"
+
+BEGIN_DEVICE
+
+/**
+ * \brief Maximum of two values
+ *
+ * Unlike fmax(), the comparison can be vectorized by the compiler.
+ * \param[in] a First value
+ * \param[in] b Second value
+ * \return The larger of the two values
+ */
+static inline double vmax(double a, double b)
+{
+	return (a > b) ? a : b;
+}
+
+/**
+ * \brief Minimum of two values
+ *
+ * Unlike fmin(), the comparison can be vectorized by the compiler.
+ * \param[in] a First value
+ * \param[in] b Second value
+ * \return The smaller of the two values
+ */
+static inline double vmin(double a, double b)
+{
+	return (a < b) ? a : b;
+}
 
 /**
  * \brief Godunov flux, which is the exact flux
@@ -27,17 +59,17 @@
  * \param[in] pR Right side pressure
  * \param[out] fluxLoc The local numeric flux
  */
-void flux_god(double rhoL, double rhoR,
-	      double vxL,  double vxR,
-	      double vyL,  double vyR,
-	      double pL,   double pR,
-	      double fluxLoc[4])
+static inline void flux_god(double rhoL, double rhoR,
+			    double vxL,  double vxR,
+			    double vyL,  double vyR,
+			    double pL,   double pR,
+			    double fluxLoc[4])
 {
 	double cL = sqrt(gam * pL / rhoL);
 	double cR = sqrt(gam * pR / rhoR);
 
 	double rho, vx, p;
-	exactRiemann(rhoL, rhoR, &rho, vxL, vxR, &vx, pL, pR, &p, cL, cR, 0.0);
+	godunovState(rhoL, rhoR, &rho, vxL, vxR, &vx, pL, pR, &p, cL, cR);
 
 	double vy;
 	if (vx > 0.0) {
@@ -64,11 +96,11 @@ void flux_god(double rhoL, double rhoR,
  * \param[in] pR Right side pressure
  * \param[out] fluxLoc The local numeric flux
  */
-void flux_roe(double rhoL, double rhoR,
-	      double vxL,  double vxR,
-	      double vyL,  double vyR,
-	      double pL,   double pR,
-	      double fluxLoc[4])
+static inline void flux_roe(double rhoL, double rhoR,
+			    double vxL,  double vxR,
+			    double vyL,  double vyR,
+			    double pL,   double pR,
+			    double fluxLoc[4])
 {
 	/* calculate left/right enthalpy */
 	double mxL = rhoL * vxL;
@@ -128,12 +160,9 @@ void flux_roe(double rhoL, double rhoR,
 	double al[4] = {vxL - cL, vxL, vxL, vxL + cL};
 	double ar[4] = {vxR - cR, vxR, vxR, vxR + cR};
 	for (int i = 0; i < 4; ++i) {
-		double da = fmax(fmax(0.0, a[i] - al[i]), ar[i] - a[i]);
-		if (fabs(a[i]) < da) {
-			a[i] = 0.5 * (a[i] * a[i] / da + da);
-		} else {
-			a[i] = fabs(a[i]);
-		}
+		double da = vmax(vmax(0.0, a[i] - al[i]), ar[i] - a[i]);
+		double aFix = 0.5 * (a[i] * a[i] / da + da);
+		a[i] = (fabs(a[i]) < da) ? aFix : fabs(a[i]);
 	}
 
 	/* calculate Row flux */
@@ -158,11 +187,11 @@ void flux_roe(double rhoL, double rhoR,
  * \param[in] pR Right side pressure
  * \param[out] fluxLoc The local numeric flux
  */
-void flux_hll(double rhoL, double rhoR,
-	      double vxL,  double vxR,
-	      double vyL,  double vyR,
-	      double pL,   double pR,
-	      double fluxLoc[4])
+static inline void flux_hll(double rhoL, double rhoR,
+			    double vxL,  double vxR,
+			    double vyL,  double vyR,
+			    double pL,   double pR,
+			    double fluxLoc[4])
 {
 	/* calculation of auxiliary values */
 	double rhoLq = 1.0 / rhoL;
@@ -198,30 +227,15 @@ void flux_hll(double rhoL, double rhoR,
 	double cM = sqrt(gam1 * (HM - 0.5 * (uM * uM + vM * vM)));
 
 	/* calculation signal speeds */
-	double arp = fmax(vxR + cR, uM + cM);
-	double alm = fmin(vxL - cL, uM - cM);
+	double arp = vmax(vxR + cR, uM + cM);
+	double alm = vmin(vxL - cL, uM - cM);
 	double arpAlmQ = 1.0 / (arp - alm);
 
 	/* calculation HLL flux */
-	if (alm > 0.0) {
-		fluxLoc[0] = fL[0];
-		fluxLoc[1] = fL[1];
-		fluxLoc[2] = fL[2];
-		fluxLoc[3] = fL[3];
-	} else if (arp < 0.0) {
-		fluxLoc[0] = fR[0];
-		fluxLoc[1] = fR[1];
-		fluxLoc[2] = fR[2];
-		fluxLoc[3] = fR[3];
-	} else {
-		fluxLoc[0] = (arp * fL[0] - alm * fR[0]) * arpAlmQ
-			   + (arp * alm) * arpAlmQ * (uR[0] - uL[0]);
-		fluxLoc[1] = (arp * fL[1] - alm * fR[1]) * arpAlmQ
-			   + (arp * alm) * arpAlmQ * (uR[1] - uL[1]);
-		fluxLoc[2] = (arp * fL[2] - alm * fR[2]) * arpAlmQ
-			   + (arp * alm) * arpAlmQ * (uR[2] - uL[2]);
-		fluxLoc[3] = (arp * fL[3] - alm * fR[3]) * arpAlmQ
-			   + (arp * alm) * arpAlmQ * (uR[3] - uL[3]);
+	for (int i = 0; i < 4; ++i) {
+		double fHLL = (arp * fL[i] - alm * fR[i]) * arpAlmQ
+			    + (arp * alm) * arpAlmQ * (uR[i] - uL[i]);
+		fluxLoc[i] = (alm > 0.0) ? fL[i] : ((arp < 0.0) ? fR[i] : fHLL);
 	}
 }
 
@@ -237,11 +251,11 @@ void flux_hll(double rhoL, double rhoR,
  * \param[in] pR Right side pressure
  * \param[out] fluxLoc The local numeric flux
  */
-void flux_hlle(double rhoL, double rhoR,
-	       double vxL,  double vxR,
-	       double vyL,  double vyR,
-	       double pL,   double pR,
-	       double fluxLoc[4])
+static inline void flux_hlle(double rhoL, double rhoR,
+			     double vxL,  double vxR,
+			     double vyL,  double vyR,
+			     double pL,   double pR,
+			     double fluxLoc[4])
 {
 	/* calculation of auxiliary values */
 	double rhoLq = 1.0 / rhoL;
@@ -273,30 +287,15 @@ void flux_hlle(double rhoL, double rhoR,
 	double eta2 = 0.5 * rhoSqR * rhoSqL / (rhoSqR + rhoSqL) / (rhoSqR + rhoSqL);
 	double d = sqrt((rhoSqR * cR * cR + rhoSqL * cL * cL) * rhoSqQsum
 			+ eta2 * (vxR - vxL) * (vxR - vxL));
-	double arp = fmax(vxR + cR, uM + d);
-	double alm = fmin(vxL - cL, uM - d);
+	double arp = vmax(vxR + cR, uM + d);
+	double alm = vmin(vxL - cL, uM - d);
 	double arpAlmQ = 1.0 / (arp - alm);
 
 	/* calculation HLLE flux */
-	if (alm > 0.0) {
-		fluxLoc[0] = fL[0];
-		fluxLoc[1] = fL[1];
-		fluxLoc[2] = fL[2];
-		fluxLoc[3] = fL[3];
-	} else if (arp < 0.0) {
-		fluxLoc[0] = fR[0];
-		fluxLoc[1] = fR[1];
-		fluxLoc[2] = fR[2];
-		fluxLoc[3] = fR[3];
-	} else {
-		fluxLoc[0] = (arp * fL[0] - alm * fR[0]) * arpAlmQ
-			   + (arp * alm) * arpAlmQ * (uR[0] - uL[0]);
-		fluxLoc[1] = (arp * fL[1] - alm * fR[1]) * arpAlmQ
-			   + (arp * alm) * arpAlmQ * (uR[1] - uL[1]);
-		fluxLoc[2] = (arp * fL[2] - alm * fR[2]) * arpAlmQ
-			   + (arp * alm) * arpAlmQ * (uR[2] - uL[2]);
-		fluxLoc[3] = (arp * fL[3] - alm * fR[3]) * arpAlmQ
-			   + (arp * alm) * arpAlmQ * (uR[3] - uL[3]);
+	for (int i = 0; i < 4; ++i) {
+		double fHLL = (arp * fL[i] - alm * fR[i]) * arpAlmQ
+			    + (arp * alm) * arpAlmQ * (uR[i] - uL[i]);
+		fluxLoc[i] = (alm > 0.0) ? fL[i] : ((arp < 0.0) ? fR[i] : fHLL);
 	}
 }
 
@@ -312,11 +311,11 @@ void flux_hlle(double rhoL, double rhoR,
  * \param[in] pR Right side pressure
  * \param[out] fluxLoc The local numeric flux
  */
-void flux_hllc(double rhoL, double rhoR,
-	       double vxL,  double vxR,
-	       double vyL,  double vyR,
-	       double pL,   double pR,
-	       double fluxLoc[4])
+static inline void flux_hllc(double rhoL, double rhoR,
+			     double vxL,  double vxR,
+			     double vyL,  double vyR,
+			     double pL,   double pR,
+			     double fluxLoc[4])
 {
 	/* calculation of auxiliary values */
 	double rhoLq = 1.0 / rhoL;
@@ -352,46 +351,35 @@ void flux_hllc(double rhoL, double rhoR,
 	double cM = sqrt(gam1 * (HM - 0.5 * (uM * uM + vM * vM)));
 
 	/* calculation signal speeds */
-	double arp = fmax(vxR + cR, uM + cM);
-	double alm = fmin(vxL - cL, uM - cM);
-
-	/* calculation HLL flux */
-	if (alm > 0.0) {
-		fluxLoc[0] = fL[0];
-		fluxLoc[1] = fL[1];
-		fluxLoc[2] = fL[2];
-		fluxLoc[3] = fL[3];
-	} else if (arp < 0.0) {
-		fluxLoc[0] = fR[0];
-		fluxLoc[1] = fR[1];
-		fluxLoc[2] = fR[2];
-		fluxLoc[3] = fR[3];
-	} else {
-		double as = (pR - pL + uL[MX] * (alm - vxL) - uR[MX] * (arp - vxR))
-			/ (rhoL * (alm - vxL) - rhoR * (arp - vxR));
-		if ((alm <= 0.0) && (as >= 0.0)) {
-			double fac = rhoL * (alm - vxL) / (alm - as);
-			double us[NVAR] = {fac,
-					   as * fac,
-					   vyL * fac,
-					   fac * (eL / rhoL + (as - vxL) *
-						(as + pL / (rhoL * (alm - vxL))))};
-			fluxLoc[0] = fL[0] + alm * (us[0] - uL[0]);
-			fluxLoc[1] = fL[1] + alm * (us[1] - uL[1]);
-			fluxLoc[2] = fL[2] + alm * (us[2] - uL[2]);
-			fluxLoc[3] = fL[3] + alm * (us[3] - uL[3]);
-		} else {
-			double fac = rhoR * (arp - vxR) / (arp - as);
-			double us[NVAR] = {fac,
-					   as * fac,
-					   vyR * fac,
-					   fac * (eR / rhoR + (as - vxR) *
-						(as + pR / (rhoR * (arp - vxR))))};
-			fluxLoc[0] = fR[0] + arp * (us[0] - uR[0]);
-			fluxLoc[1] = fR[1] + arp * (us[1] - uR[1]);
-			fluxLoc[2] = fR[2] + arp * (us[2] - uR[2]);
-			fluxLoc[3] = fR[3] + arp * (us[3] - uR[3]);
-		}
+	double arp = vmax(vxR + cR, uM + cM);
+	double alm = vmin(vxL - cL, uM - cM);
+
+	/* calculation of the star states, both are evaluated so that the
+	 * flux can be selected without branches */
+	double as = (pR - pL + uL[MX] * (alm - vxL) - uR[MX] * (arp - vxR))
+		/ (rhoL * (alm - vxL) - rhoR * (arp - vxR));
+
+	double facL = rhoL * (alm - vxL) / (alm - as);
+	double usL[NVAR] = {facL,
+			    as * facL,
+			    vyL * facL,
+			    facL * (eL / rhoL + (as - vxL) *
+				(as + pL / (rhoL * (alm - vxL))))};
+
+	double facR = rhoR * (arp - vxR) / (arp - as);
+	double usR[NVAR] = {facR,
+			    as * facR,
+			    vyR * facR,
+			    facR * (eR / rhoR + (as - vxR) *
+				(as + pR / (rhoR * (arp - vxR))))};
+
+	/* calculation HLLC flux */
+	bool isLeftStar = (alm <= 0.0) && (as >= 0.0);
+	for (int i = 0; i < 4; ++i) {
+		double fsL = fL[i] + alm * (usL[i] - uL[i]);
+		double fsR = fR[i] + arp * (usR[i] - uR[i]);
+		double fs = isLeftStar ? fsL : fsR;
+		fluxLoc[i] = (alm > 0.0) ? fL[i] : ((arp < 0.0) ? fR[i] : fs);
 	}
 }
 
@@ -407,16 +395,16 @@ void flux_hllc(double rhoL, double rhoR,
  * \param[in] pR Right side pressure
  * \param[out] fluxLoc The local numeric flux
  */
-void flux_lxf(double rhoL, double rhoR,
-	      double vxL,  double vxR,
-	      double vyL,  double vyR,
-	      double pL,   double pR,
-	      double fluxLoc[4])
+static inline void flux_lxf(double rhoL, double rhoR,
+			    double vxL,  double vxR,
+			    double vyL,  double vyR,
+			    double pL,   double pR,
+			    double fluxLoc[4])
 {
 	/* compute maximum Eigenvalue */
 	double cL = sqrt(gam * pL / rhoL);
 	double cR = sqrt(gam * pR / rhoR);
-	double a  = fmax(fabs(vxR) + cR, fabs(vxL) + cL);
+	double a  = vmax(fabs(vxR) + cR, fabs(vxL) + cL);
 
 	/* calculate left/right energy and enthalpy */
 	double eL = gam1q * pL + 0.5 * rhoL * (vxL * vxL + vyL * vyL);
@@ -457,11 +445,11 @@ void flux_lxf(double rhoL, double rhoR,
  * \param[in] pR Right side pressure
  * \param[out] fluxLoc The local numeric flux
  */
-void flux_stw(double rhoL, double rhoR,
-	      double vxL,  double vxR,
-	      double vyL,  double vyR,
-	      double pL,   double pR,
-	      double fluxLoc[4])
+static inline void flux_stw(double rhoL, double rhoR,
+			    double vxL,  double vxR,
+			    double vyL,  double vyR,
+			    double pL,   double pR,
+			    double fluxLoc[4])
 {
 	/* calculation of speed of sound */
 	double cL = sqrt(gam * pL / rhoL);
@@ -475,14 +463,14 @@ void flux_stw(double rhoL, double rhoR,
 	double aR[4] = {vxR - cR, vxR, vxR, vxR + cR};
 
 	/* calculation of positive and negative Eigenvalues */
-	double ap[4] = {fmax(aL[0], 0.0),
-			fmax(aL[1], 0.0),
-			fmax(aL[2], 0.0),
-			fmax(aL[3], 0.0)};
-	double am[4] = {fmin(aR[0], 0.0),
-			fmin(aR[1], 0.0),
-			fmin(aR[2], 0.0),
-			fmin(aR[3], 0.0)};
+	double ap[4] = {vmax(aL[0], 0.0),
+			vmax(aL[1], 0.0),
+			vmax(aL[2], 0.0),
+			vmax(aL[3], 0.0)};
+	double am[4] = {vmin(aR[0], 0.0),
+			vmin(aR[1], 0.0),
+			vmin(aR[2], 0.0),
+			vmin(aR[3], 0.0)};
 
 	/* calculate positve flux from left and right */
 	double fp[4];
@@ -521,11 +509,11 @@ void flux_stw(double rhoL, double rhoR,
  * \param[in] pR Right side pressure
  * \param[out] fluxLoc The local numeric flux
  */
-void flux_cen(double rhoL, double rhoR,
-	      double vxL,  double vxR,
-	      double vyL,  double vyR,
-	      double pL,   double pR,
-	      double fluxLoc[4])
+static inline void flux_cen(double rhoL, double rhoR,
+			    double vxL,  double vxR,
+			    double vyL,  double vyR,
+			    double pL,   double pR,
+			    double fluxLoc[4])
 {
 	/* calculate energies */
 	double eL = gam1q * pL + 0.5 * rhoL * (vxL * vxL + vyL * vyL);
@@ -562,11 +550,11 @@ void flux_cen(double rhoL, double rhoR,
  * \param[in] pR Right side pressure
  * \param[out] fluxLoc The local numeric flux
  */
-void flux_ausmd(double rhoL, double rhoR,
-	        double vxL,  double vxR,
-	        double vyL,  double vyR,
-	        double pL,   double pR,
-	        double fluxLoc[4])
+static inline void flux_ausmd(double rhoL, double rhoR,
+			      double vxL,  double vxR,
+			      double vyL,  double vyR,
+			      double pL,   double pR,
+			      double fluxLoc[4])
 {
 	/* calculate left/right energy and enthalpy */
 	double eL = gam1q * pL + 0.5 * rhoL * (vxL * vxL + vyL * vyL);
@@ -576,7 +564,7 @@ void flux_ausmd(double rhoL, double rhoR,
 	double HR = (eR + pR) / rhoR;
 
 	/* maximum speed of sound */
-	double cm = fmax(sqrt(gam * pL / rhoL), sqrt(gam * pR / rhoR));
+	double cm = vmax(sqrt(gam * pL / rhoL), sqrt(gam * pR / rhoR));
 
 	double alphaL = 2.0 * pL / rhoL / (pL / rhoL + pR / rhoR);
 	double alphaR = 2.0 * pR / rhoR / (pL / rhoL + pR / rhoR);
@@ -624,11 +612,11 @@ void flux_ausmd(double rhoL, double rhoR,
  * \param[in] pR Right side pressure
  * \param[out] fluxLoc The local numeric flux
  */
-void flux_ausmdv(double rhoL, double rhoR,
-	         double vxL,  double vxR,
-	         double vyL,  double vyR,
-	         double pL,   double pR,
-	         double fluxLoc[4])
+static inline void flux_ausmdv(double rhoL, double rhoR,
+			       double vxL,  double vxR,
+			       double vyL,  double vyR,
+			       double pL,   double pR,
+			       double fluxLoc[4])
 {
 	/* calculate left/right energy and enthalpy */
 	double eL = gam1q * pL + 0.5 * rhoL * (vxL * vxL + vyL * vyL);
@@ -640,51 +628,30 @@ void flux_ausmdv(double rhoL, double rhoR,
 	/* maximum speed of sound */
 	double cL = sqrt(gam * pL / rhoL);
 	double cR = sqrt(gam * pR / rhoR);
-	double cm = fmax(cL, cR);
+	double cm = vmax(cL, cR);
 
 	double alphaL = 2.0 * pL / rhoL / (pL / rhoL + pR / rhoR);
 	double alphaR = 2.0 * pR / rhoR / (pL / rhoL + pR / rhoR);
 
-	double uPlus, pPlus;
-	if (fabs(vxL) < cm) {
-		pPlus = 0.25 * pL * (vxL + cm) * (vxL + cm) / (cm * cm) * (2.0 - vxL / cm);
-		if (vxL > 0.0) {
-			uPlus = vxL + alphaL * (vxL - cm) * (vxL - cm);
-		} else {
-			uPlus =       alphaL * (vxL + cm) * (vxL + cm);
-		}
-	} else {
-		if (vxL > 0.0) {
-			uPlus = vxL;
-			pPlus = pL;
-		} else {
-			uPlus = 0.0;
-			pPlus = 0.0;
-		}
-	}
-
-	double uMinus, pMinus;
-	if (fabs(vxR) < cm) {
-		pMinus = 0.25 * pR * (vxR - cm) * (vxR - cm) / (cm * cm) * (2.0 + vxR / cm);
-		if (vxR > 0.0) {
-			uMinus =     - alphaR * (vxL - cm) * (vxL - cm);
-		} else {
-			uMinus = vxR - alphaR * (vxR + cm) * (vxR + cm);
-		}
-	} else {
-		if (vxR > 0.0) {
-			uMinus = 0.0;
-			pMinus = 0.0;
-		} else {
-			uMinus = vxR;
-			pMinus = pR;
-		}
-	}
+	/* subsonic and supersonic splittings, selected without branches */
+	double pPlusSub = 0.25 * pL * (vxL + cm) * (vxL + cm) / (cm * cm) * (2.0 - vxL / cm);
+	double uPlusPos = vxL + alphaL * (vxL - cm) * (vxL - cm);
+	double uPlusNeg =       alphaL * (vxL + cm) * (vxL + cm);
+	bool isSubL = fabs(vxL) < cm;
+	double uPlus = isSubL ? ((vxL > 0.0) ? uPlusPos : uPlusNeg) : ((vxL > 0.0) ? vxL : 0.0);
+	double pPlus = isSubL ? pPlusSub : ((vxL > 0.0) ? pL  : 0.0);
+
+	double pMinusSub = 0.25 * pR * (vxR - cm) * (vxR - cm) / (cm * cm) * (2.0 + vxR / cm);
+	double uMinusPos =     - alphaR * (vxL - cm) * (vxL - cm);
+	double uMinusNeg = vxR - alphaR * (vxR + cm) * (vxR + cm);
+	bool isSubR = fabs(vxR) < cm;
+	double uMinus = isSubR ? ((vxR > 0.0) ? uMinusPos : uMinusNeg) : ((vxR > 0.0) ? 0.0 : vxR);
+	double pMinus = isSubR ? pMinusSub : ((vxR > 0.0) ? 0.0 : pR);
 
 	/* calculate AUSMDV flux */
 	double rhoU = uPlus * rhoL + uMinus * rhoR;
 
-	double s = fmin(1.0, 10.0 * fabs(pR - pL) / fmin(pR, pL));
+	double s = vmin(1.0, 10.0 * fabs(pR - pL) / vmin(pR, pL));
 	double rhoUsq = 0.5 * (1.0 + s) * (rhoL * vxL * uPlus + rhoR * vxR * uMinus);
 	rhoUsq += 0.25 * (1.0 - s) * (rhoU * (vxR + vxL) - fabs(rhoU) * (vxR - vxL));
 
@@ -694,21 +661,17 @@ void flux_ausmdv(double rhoL, double rhoR,
 	fluxLoc[3] = 0.5 * (rhoU * (HR + HL) - fabs(rhoU) * (HR - HL));
 
 	/* entropy fix */
-	bool tmpa = (vxL - cL < 0.0) && (vxR - cR > 0.0);
-	bool tmpb = (vxL + cL < 0.0) && (vxR + cR > 0.0);
+	double amL = vxL - cL, amR = vxR - cR;
+	double apL = vxL + cL, apR = vxR + cR;
+	/* both comparisons are always evaluated, so that no branch is needed */
+	bool tmpa = (amL < 0.0) & (amR > 0.0);
+	bool tmpb = (apL < 0.0) & (apR > 0.0);
 	double tmpL[4] = {1.0, vxL, vyL, HL};
 	double tmpR[4] = {1.0, vxR, vyR, HR};
-	if (tmpa && !tmpb) {
-		fluxLoc[0] -= 0.125 * ((vxR - cR) - (vxL - cL)) * (rhoR * tmpR[0] - rhoL * tmpL[0]);
-		fluxLoc[1] -= 0.125 * ((vxR - cR) - (vxL - cL)) * (rhoR * tmpR[1] - rhoL * tmpL[1]);
-		fluxLoc[2] -= 0.125 * ((vxR - cR) - (vxL - cL)) * (rhoR * tmpR[2] - rhoL * tmpL[2]);
-		fluxLoc[3] -= 0.125 * ((vxR - cR) - (vxL - cL)) * (rhoR * tmpR[3] - rhoL * tmpL[3]);
-	}
-	if (!tmpa && tmpb) {
-		fluxLoc[0] -= 0.125 * ((vxR + cR) - (vxL + cL)) * (rhoR * tmpR[0] - rhoL * tmpL[0]);
-		fluxLoc[1] -= 0.125 * ((vxR + cR) - (vxL + cL)) * (rhoR * tmpR[1] - rhoL * tmpL[1]);
-		fluxLoc[2] -= 0.125 * ((vxR + cR) - (vxL + cL)) * (rhoR * tmpR[2] - rhoL * tmpL[2]);
-		fluxLoc[3] -= 0.125 * ((vxR + cR) - (vxL + cL)) * (rhoR * tmpR[3] - rhoL * tmpL[3]);
+	for (int i = 0; i < 4; ++i) {
+		double fixA = fluxLoc[i] - 0.125 * (amR - amL) * (rhoR * tmpR[i] - rhoL * tmpL[i]);
+		double fixB = fluxLoc[i] - 0.125 * (apR - apL) * (rhoR * tmpR[i] - rhoL * tmpL[i]);
+		fluxLoc[i] = (tmpa && !tmpb) ? fixA : ((!tmpa && tmpb) ? fixB : fluxLoc[i]);
 	}
 }
 
@@ -724,11 +687,11 @@ void flux_ausmdv(double rhoL, double rhoR,
  * \param[in] pR Right side pressure
  * \param[out] fluxLoc The local numeric flux
  */
-void flux_vanleer(double rhoL, double rhoR,
-	          double vxL,  double vxR,
-	          double vyL,  double vyR,
-	          double pL,   double pR,
-	          double fluxLoc[4])
+static inline void flux_vanleer(double rhoL, double rhoR,
+				double vxL,  double vxR,
+				double vyL,  double vyR,
+				double pL,   double pR,
+				double fluxLoc[4])
 {
 	/* calculate speed of sound */
 	double cL = sqrt(gam * pL / rhoL);
@@ -742,43 +705,41 @@ void flux_vanleer(double rhoL, double rhoR,
 	double HR = (eR + pR) / rhoR;
 
 	/* positive flux from left to right */
-	double fp[4], ML = vxL / cL;
-	if (ML > 1.0) {
-		fp[0] = rhoL * vxL;
-		fp[1] = fp[0] * vxL + pL;
-		fp[2] = fp[0] * vyL;
-		fp[3] = fp[0] * HL;
-	} else if ((ML < 1.0) && (ML > - 1.0)) {
-		double cx = gam1 * vxL + 2.0 * cL;
-		fp[0] = 0.25 * rhoL * cL * (ML + 1.0) * (ML + 1.0);
-		fp[1] = fp[0] * cx / gam;
-		fp[2] = fp[0] * vyL;
-		fp[3] = 0.5 * (fp[1] * cx * gam / (gam * gam - 1.0) + fp[2] * vyL);
-	} else {
-		fp[0] = 0.0;
-		fp[1] = 0.0;
-		fp[2] = 0.0;
-		fp[3] = 0.0;
+	double ML = vxL / cL;
+	double fpSup[4], fpSub[4];
+	fpSup[0] = rhoL * vxL;
+	fpSup[1] = fpSup[0] * vxL + pL;
+	fpSup[2] = fpSup[0] * vyL;
+	fpSup[3] = fpSup[0] * HL;
+
+	double cxL = gam1 * vxL + 2.0 * cL;
+	fpSub[0] = 0.25 * rhoL * cL * (ML + 1.0) * (ML + 1.0);
+	fpSub[1] = fpSub[0] * cxL / gam;
+	fpSub[2] = fpSub[0] * vyL;
+	fpSub[3] = 0.5 * (fpSub[1] * cxL * gam / (gam * gam - 1.0) + fpSub[2] * vyL);
+
+	double fp[4];
+	for (int i = 0; i < 4; ++i) {
+		fp[i] = (ML > 1.0) ? fpSup[i] : (((ML < 1.0) && (ML > - 1.0)) ? fpSub[i] : 0.0);
 	}
 
 	/* negative flux from right to left */
-	double fm[4], MR = vxR / cR;
-	if (MR < - 1.0) {
-		fm[0] = rhoR * vxR;
-		fm[1] = fm[0] * vxR + pR;
-		fm[2] = fm[0] * vyR;
-		fm[3] = fm[0] * HR;
-	} else if ((MR < 1.0) && (MR > - 1.0)) {
-		double cx = gam1 * vxR - 2.0 * cR;
-		fm[0] = - 0.25 * rhoR * cR * (1.0 - MR) * (1.0 - MR);
-		fm[1] = fm[0] * cx / gam;
-		fm[2] = fm[0] * vyR;
-		fm[3] = 0.5 * (fm[1] * cx * gam / (gam * gam - 1.0) + fm[2] * vyR);
-	} else {
-		fm[0] = 0.0;
-		fm[1] = 0.0;
-		fm[2] = 0.0;
-		fm[3] = 0.0;
+	double MR = vxR / cR;
+	double fmSup[4], fmSub[4];
+	fmSup[0] = rhoR * vxR;
+	fmSup[1] = fmSup[0] * vxR + pR;
+	fmSup[2] = fmSup[0] * vyR;
+	fmSup[3] = fmSup[0] * HR;
+
+	double cxR = gam1 * vxR - 2.0 * cR;
+	fmSub[0] = - 0.25 * rhoR * cR * (1.0 - MR) * (1.0 - MR);
+	fmSub[1] = fmSub[0] * cxR / gam;
+	fmSub[2] = fmSub[0] * vyR;
+	fmSub[3] = 0.5 * (fmSub[1] * cxR * gam / (gam * gam - 1.0) + fmSub[2] * vyR);
+
+	double fm[4];
+	for (int i = 0; i < 4; ++i) {
+		fm[i] = (MR < - 1.0) ? fmSup[i] : (((MR < 1.0) && (MR > - 1.0)) ? fmSub[i] : 0.0);
 	}
 
 	/* calculate van Leer flux */
@@ -789,60 +750,162 @@ void flux_vanleer(double rhoL, double rhoR,
 }
 
 /**
- * \brief Select the convective flux
- * \param[in] rhoL Left side density
- * \param[in] rhoR Right side density
- * \param[in] vxL Left side x-velocity
- * \param[in] vxR Right side x-velocity
- * \param[in] vyL Left side y-velocity
- * \param[in] vyR Right side y-velocity
- * \param[in] pL Left side pressure
- * \param[in] pR Right side pressure
- * \param[out] fluxLoc The local numeric flux
+ * \brief Generate the block version of a flux function
+ *
+ * The face loop only contains the inlined flux function, so that it can be
+ * vectorized over the faces of the block.
  */
-void convectiveFlux(double rhoL, double rhoR,
-		    double vxL,  double vxR,
-		    double vyL,  double vyR,
-		    double pL,   double pR,
-		    double fluxLoc[4])
+#define FLUX_BLOCK_FUNC(func)							\
+static void func##_block(int nFaces, double qL[NVAR][FLUX_BLOCK],		\
+		double qR[NVAR][FLUX_BLOCK], double f[NVAR][FLUX_BLOCK])	\
+{										\
+	for (int i = 0; i < nFaces; ++i) {					\
+		double fluxLoc[4];						\
+		func(qL[RHO][i], qR[RHO][i], qL[VX][i], qR[VX][i],		\
+		     qL[VY][i], qR[VY][i], qL[P][i],  qR[P][i], fluxLoc);	\
+		f[RHO][i] = fluxLoc[0];						\
+		f[MX][i]  = fluxLoc[1];						\
+		f[MY][i]  = fluxLoc[2];						\
+		f[E][i]   = fluxLoc[3];						\
+	}									\
+}
+
+/**
+ * \brief Godunov flux for a block of faces
+ *
+ * The Riemann problems of the block are solved together, see
+ * `godunovStateBlock`.
+ * \param[in] nFaces Number of faces in the block, at most FLUX_BLOCK
+ * \param[in] qL Rotated left states
+ * \param[in] qR Rotated right states
+ * \param[out] f Convective fluxes in the normal system
+ */
+static void flux_god_block(int nFaces, double qL[NVAR][FLUX_BLOCK],
+		double qR[NVAR][FLUX_BLOCK], double f[NVAR][FLUX_BLOCK])
+{
+	double qM[NVAR][FLUX_BLOCK];
+	godunovStateBlock(nFaces, qL, qR, qM);
+
+	for (int i = 0; i < nFaces; ++i) {
+		double rho = qM[RHO][i], vx = qM[VX][i], vy = qM[VY][i], p = qM[P][i];
+		f[RHO][i] = rho * vx;
+		f[MX][i]  = rho * vx * vx + p;
+		f[MY][i]  = rho * vx * vy;
+		f[E][i]   = vx * (gam / gam1 * p + 0.5 * rho * (vx * vx + vy * vy));
+	}
+}
+
+FLUX_BLOCK_FUNC(flux_roe)
+FLUX_BLOCK_FUNC(flux_hll)
+FLUX_BLOCK_FUNC(flux_hlle)
+FLUX_BLOCK_FUNC(flux_hllc)
+FLUX_BLOCK_FUNC(flux_lxf)
+FLUX_BLOCK_FUNC(flux_stw)
+FLUX_BLOCK_FUNC(flux_cen)
+FLUX_BLOCK_FUNC(flux_ausmd)
+FLUX_BLOCK_FUNC(flux_ausmdv)
+FLUX_BLOCK_FUNC(flux_vanleer)
+
+/**
+ * \brief Convective flux for a block of faces
+ *
+ * The states have to be rotated into the normal system of the faces and are
+ * stored variable by variable, the flux function is selected once per block.
+ * \param[in] nFaces Number of faces in the block, at most FLUX_BLOCK
+ * \param[in] qL Rotated left states
+ * \param[in] qR Rotated right states
+ * \param[out] f Convective fluxes in the normal system
+ */
+void convectiveFluxBlock(int nFaces, double qL[NVAR][FLUX_BLOCK],
+		double qR[NVAR][FLUX_BLOCK], double f[NVAR][FLUX_BLOCK])
+{
+	switch (iFlux) {
+	case GOD:
+		flux_god_block(nFaces, qL, qR, f);
+		break;
+	case ROE:
+		flux_roe_block(nFaces, qL, qR, f);
+		break;
+	case HLL:
+		flux_hll_block(nFaces, qL, qR, f);
+		break;
+	case HLLE:
+		flux_hlle_block(nFaces, qL, qR, f);
+		break;
+	case HLLC:
+		flux_hllc_block(nFaces, qL, qR, f);
+		break;
+	case LXF:
+		flux_lxf_block(nFaces, qL, qR, f);
+		break;
+	case STW:
+		flux_stw_block(nFaces, qL, qR, f);
+		break;
+	case CEN:
+		flux_cen_block(nFaces, qL, qR, f);
+		break;
+	case AUSMD:
+		flux_ausmd_block(nFaces, qL, qR, f);
+		break;
+	case AUSMDV:
+		flux_ausmdv_block(nFaces, qL, qR, f);
+		break;
+	case VANLEER:
+		flux_vanleer_block(nFaces, qL, qR, f);
+		break;
+	}
+}
+
+/**
+ * \brief Convective flux over a single face
+ *
+ * Used where every face is calculated by a thread of its own, as in the
+ * kernels offloaded to the device.
+ * \param[in] qL Rotated left state
+ * \param[in] qR Rotated right state
+ * \param[out] f Convective flux in the normal system
+ */
+void convectiveFlux(double qL[NVAR], double qR[NVAR], double f[NVAR])
 {
 	switch (iFlux) {
 	case GOD:
-		flux_god(rhoL, rhoR, vxL, vxR, vyL, vyR, pL, pR, fluxLoc);
+		flux_god(qL[RHO], qR[RHO], qL[VX], qR[VX], qL[VY], qR[VY], qL[P], qR[P], f);
 		break;
 	case ROE:
-		flux_roe(rhoL, rhoR, vxL, vxR, vyL, vyR, pL, pR, fluxLoc);
+		flux_roe(qL[RHO], qR[RHO], qL[VX], qR[VX], qL[VY], qR[VY], qL[P], qR[P], f);
 		break;
 	case HLL:
-		flux_hll(rhoL, rhoR, vxL, vxR, vyL, vyR, pL, pR, fluxLoc);
+		flux_hll(qL[RHO], qR[RHO], qL[VX], qR[VX], qL[VY], qR[VY], qL[P], qR[P], f);
 		break;
 	case HLLE:
-		flux_hlle(rhoL, rhoR, vxL, vxR, vyL, vyR, pL, pR, fluxLoc);
+		flux_hlle(qL[RHO], qR[RHO], qL[VX], qR[VX], qL[VY], qR[VY], qL[P], qR[P], f);
 		break;
 	case HLLC:
-		flux_hllc(rhoL, rhoR, vxL, vxR, vyL, vyR, pL, pR, fluxLoc);
+		flux_hllc(qL[RHO], qR[RHO], qL[VX], qR[VX], qL[VY], qR[VY], qL[P], qR[P], f);
 		break;
 	case LXF:
-		flux_lxf(rhoL, rhoR, vxL, vxR, vyL, vyR, pL, pR, fluxLoc);
+		flux_lxf(qL[RHO], qR[RHO], qL[VX], qR[VX], qL[VY], qR[VY], qL[P], qR[P], f);
 		break;
 	case STW:
-		flux_stw(rhoL, rhoR, vxL, vxR, vyL, vyR, pL, pR, fluxLoc);
+		flux_stw(qL[RHO], qR[RHO], qL[VX], qR[VX], qL[VY], qR[VY], qL[P], qR[P], f);
 		break;
 	case CEN:
-		flux_cen(rhoL, rhoR, vxL, vxR, vyL, vyR, pL, pR, fluxLoc);
+		flux_cen(qL[RHO], qR[RHO], qL[VX], qR[VX], qL[VY], qR[VY], qL[P], qR[P], f);
 		break;
 	case AUSMD:
-		flux_ausmd(rhoL, rhoR, vxL, vxR, vyL, vyR, pL, pR, fluxLoc);
+		flux_ausmd(qL[RHO], qR[RHO], qL[VX], qR[VX], qL[VY], qR[VY], qL[P], qR[P], f);
 		break;
 	case AUSMDV:
-		flux_ausmdv(rhoL, rhoR, vxL, vxR, vyL, vyR, pL, pR, fluxLoc);
+		flux_ausmdv(qL[RHO], qR[RHO], qL[VX], qR[VX], qL[VY], qR[VY], qL[P], qR[P], f);
 		break;
 	case VANLEER:
-		flux_vanleer(rhoL, rhoR, vxL, vxR, vyL, vyR, pL, pR, fluxLoc);
+		flux_vanleer(qL[RHO], qR[RHO], qL[VX], qR[VX], qL[VY], qR[VY], qL[P], qR[P], f);
 		break;
 	}
 }
 
+END_DEVICE
+
 #ifdef navierstokes
 /**
  * \brief Calculate the diffusive flux
@@ -873,126 +936,248 @@ void diffusionFlux(double state[NVAR], double gradX[NVAR], double gradY[NVAR],
 }
 #endif
 
-/** \brief Perform the flux calculation
+/**
+ * \brief Normal flux Jacobian dF/dU of the Euler equations
+ * \param[in] pVar Primitive state
+ * \param[in] n Normal vector
+ * \param[out] A Flux Jacobian with respect to the conservative variables
+ */
+void eulerFluxJacobian(double pVar[NVAR], double n[NDIM], double A[NVAR][NVAR])
+{
+	double vx = pVar[VX], vy = pVar[VY];
+	double vn = vx * n[X] + vy * n[Y];
+	double phi = 0.5 * gam1 * (vx * vx + vy * vy);
+	double H = gam / gam1 * pVar[P] / pVar[RHO] + 0.5 * (vx * vx + vy * vy);
+
+	A[RHO][RHO] = 0.0;
+	A[RHO][MX]  = n[X];
+	A[RHO][MY]  = n[Y];
+	A[RHO][E]   = 0.0;
+
+	A[MX][RHO]  = n[X] * phi - vx * vn;
+	A[MX][MX]   = vn - (gam - 2.0) * vx * n[X];
+	A[MX][MY]   = vx * n[Y] - gam1 * vy * n[X];
+	A[MX][E]    = gam1 * n[X];
+
+	A[MY][RHO]  = n[Y] * phi - vy * vn;
+	A[MY][MX]   = vy * n[X] - gam1 * vx * n[Y];
+	A[MY][MY]   = vn - (gam - 2.0) * vy * n[Y];
+	A[MY][E]    = gam1 * n[Y];
+
+	A[E][RHO]   = vn * (phi - H);
+	A[E][MX]    = H * n[X] - gam1 * vx * vn;
+	A[E][MY]    = H * n[Y] - gam1 * vy * vn;
+	A[E][E]     = gam * vn;
+}
+
+/**
+ * \brief Approximate Jacobian of the integrated face flux
  *
- * Calculation of left and right state, the velocity vector is transformed into
- * the normal system of the cell interfaces. The function finishes with a
- * back rotation of the velocity vector into global coordinate system.
+ * The flux is linearized as Rusanov flux with a frozen spectral radius,
+ * F = 0.5 * (F(U_L) + F(U_R) - lambda * (U_R - U_L)) * len. For the
+ * Navier-Stokes equations the viscous spectral radius is added to lambda.
+ * \param[in] iSide Side ID
+ * \param[in] pVarL Left primitive state
+ * \param[in] pVarR Right primitive state
+ * \param[out] dFdUL Derivative of the flux with respect to the left state
+ * \param[out] dFdUR Derivative of the flux with respect to the right state
  */
-void fluxCalculation(void)
+void fluxJacobian(long iSide, double pVarL[NVAR], double pVarR[NVAR],
+		double dFdUL[NVAR][NVAR], double dFdUR[NVAR][NVAR])
 {
-	#pragma omp parallel for
-	for (long iSide = 0; iSide < nSides; ++iSide) {
-		side_t *aSide = side[iSide];
-
-		/* extract left state */
-		double pVar[NVAR];
-		pVar[RHO] = aSide->pVar[RHO];
-		pVar[VX]  = aSide->pVar[VX];
-		pVar[VY]  = aSide->pVar[VY];
-		pVar[P]   = aSide->pVar[P];
-
-		/* rotate it into normal direction */
-		double pVarL[NVAR];
-		pVarL[RHO] = pVar[RHO];
-		pVarL[VX]  =   aSide->n[X] * pVar[VX] + aSide->n[Y] * pVar[VY];
-		pVarL[VY]  = - aSide->n[Y] * pVar[VX] + aSide->n[X] * pVar[VY];
-		pVarL[P]   = pVar[P];
-
-		/* extract right state */
-		pVar[RHO] = aSide->connection->pVar[RHO];
-		pVar[VX]  = aSide->connection->pVar[VX];
-		pVar[VY]  = aSide->connection->pVar[VY];
-		pVar[P]   = aSide->connection->pVar[P];
-
-		/* rotate it into normal direction */
-		double pVarR[NVAR];
-		pVarR[RHO] = pVar[RHO];
-		pVarR[VX]  =   aSide->n[X] * pVar[VX] + aSide->n[Y] * pVar[VY];
-		pVarR[VY]  = - aSide->n[Y] * pVar[VX] + aSide->n[X] * pVar[VY];
-		pVarR[P]   = pVar[P];
+	double n[NDIM] = {sideData.n[X][iSide], sideData.n[Y][iSide]};
+	double len = sideData.len[iSide];
+
+	eulerFluxJacobian(pVarL, n, dFdUL);
+	eulerFluxJacobian(pVarR, n, dFdUR);
+
+	double cL = sqrt(gam * pVarL[P] / pVarL[RHO]);
+	double cR = sqrt(gam * pVarR[P] / pVarR[RHO]);
+	double lambda = fmax(fabs(pVarL[VX] * n[X] + pVarL[VY] * n[Y]) + cL,
+			     fabs(pVarR[VX] * n[X] + pVarR[VY] * n[Y]) + cR);
+
+	#ifdef navierstokes
+	double rho = 0.5 * (pVarL[RHO] + pVarR[RHO]);
+	lambda += 2.0 * mu * fmax(4.0 / 3.0, gam / Pr) / (rho * sideData.baryBaryDist[iSide]);
+	#endif
+
+	for (int iVar = 0; iVar < NVAR; ++iVar) {
+		for (int jVar = 0; jVar < NVAR; ++jVar) {
+			dFdUL[iVar][jVar] *= 0.5 * len;
+			dFdUR[iVar][jVar] *= 0.5 * len;
+		}
+		dFdUL[iVar][iVar] += 0.5 * len * lambda;
+		dFdUR[iVar][iVar] -= 0.5 * len * lambda;
+	}
+}
 
-		#ifdef navierstokes
-		/* extract left and right gradients */
-		double stateMean[NVAR] = {
-			0.5 * (aSide->connection->pVar[RHO] + aSide->pVar[RHO]),
-			0.5 * (aSide->connection->pVar[VX]  + aSide->pVar[VX]),
-			0.5 * (aSide->connection->pVar[VY]  + aSide->pVar[VY]),
-			0.5 * (aSide->connection->pVar[P]   + aSide->pVar[P])
-		};
-		double gradUxMean[NVAR] = {
-			0.5 * (aSide->elem->u_x[RHO] + aSide->connection->elem->u_x[RHO]),
-			0.5 * (aSide->elem->u_x[VX]  + aSide->connection->elem->u_x[VX]),
-			0.5 * (aSide->elem->u_x[VY]  + aSide->connection->elem->u_x[VY]),
-			0.5 * (aSide->elem->u_x[P]   + aSide->connection->elem->u_x[P])
-		};
-		double gradUyMean[NVAR] = {
-			0.5 * (aSide->elem->u_y[RHO] + aSide->connection->elem->u_y[RHO]),
-			0.5 * (aSide->elem->u_y[VX]  + aSide->connection->elem->u_y[VX]),
-			0.5 * (aSide->elem->u_y[VY]  + aSide->connection->elem->u_y[VY]),
-			0.5 * (aSide->elem->u_y[P]   + aSide->connection->elem->u_y[P])
-		};
-		double baryBary[NDIM] = {
-			aSide->baryBaryVec[X] / aSide->baryBaryDist,
-			aSide->baryBaryVec[Y] / aSide->baryBaryDist
-		};
-		double correction[NVAR] = {
-			gradUxMean[RHO] * baryBary[X] + gradUyMean[RHO] * baryBary[Y] - (aSide->connection->elem->pVar[RHO] - aSide->elem->pVar[RHO]) / aSide->baryBaryDist,
-			gradUxMean[VX]  * baryBary[X] + gradUyMean[VX]  * baryBary[Y] - (aSide->connection->elem->pVar[VX]  - aSide->elem->pVar[VX])  / aSide->baryBaryDist,
-			gradUxMean[VY]  * baryBary[X] + gradUyMean[VY]  * baryBary[Y] - (aSide->connection->elem->pVar[VY]  - aSide->elem->pVar[VY])  / aSide->baryBaryDist,
-			gradUxMean[P]   * baryBary[X] + gradUyMean[P]   * baryBary[Y] - (aSide->connection->elem->pVar[P]   - aSide->elem->pVar[P])   / aSide->baryBaryDist
-		};
-		double gradUx[NVAR] = {
-			gradUxMean[RHO] - correction[RHO] * baryBary[X],
-			gradUxMean[VX]  - correction[VX]  * baryBary[X],
-			gradUxMean[VY]  - correction[VY]  * baryBary[X],
-			gradUxMean[P]   - correction[P]   * baryBary[X]
-		};
-		double gradUy[NVAR] = {
-			gradUyMean[RHO] - correction[RHO] * baryBary[Y],
-			gradUyMean[VX]  - correction[VX]  * baryBary[Y],
-			gradUyMean[VY]  - correction[VY]  * baryBary[Y],
-			gradUyMean[P]   - correction[P]   * baryBary[Y]
-		};
-		#endif
+#ifdef navierstokes
+/**
+ * \brief Diffusive flux over one side in normal direction
+ * \param[in] iSide Side ID
+ * \param[in] pVarLeft Primitive state of the first element of the side
+ * \param[in] pVarRight Primitive state of the second element of the side
+ * \param[out] fluxDiff Diffusive flux in normal direction
+ */
+void sideDiffusionFlux(long iSide, double pVarLeft[NVAR], double pVarRight[NVAR],
+		double fluxDiff[NVAR])
+{
+	double n[NDIM] = {sideData.n[X][iSide], sideData.n[Y][iSide]};
+	long lElem = sideData.elem[2 * iSide];
+	long rElem = sideData.elem[2 * iSide + 1];
+
+	/* extract left and right gradients */
+	double stateMean[NVAR] = {
+		0.5 * (pVarRight[RHO] + pVarLeft[RHO]),
+		0.5 * (pVarRight[VX]  + pVarLeft[VX]),
+		0.5 * (pVarRight[VY]  + pVarLeft[VY]),
+		0.5 * (pVarRight[P]   + pVarLeft[P])
+	};
+	double gradUxMean[NVAR] = {
+		0.5 * (elemData.u_x[RHO][lElem] + elemData.u_x[RHO][rElem]),
+		0.5 * (elemData.u_x[VX][lElem]  + elemData.u_x[VX][rElem]),
+		0.5 * (elemData.u_x[VY][lElem]  + elemData.u_x[VY][rElem]),
+		0.5 * (elemData.u_x[P][lElem]   + elemData.u_x[P][rElem])
+	};
+	double gradUyMean[NVAR] = {
+		0.5 * (elemData.u_y[RHO][lElem] + elemData.u_y[RHO][rElem]),
+		0.5 * (elemData.u_y[VX][lElem]  + elemData.u_y[VX][rElem]),
+		0.5 * (elemData.u_y[VY][lElem]  + elemData.u_y[VY][rElem]),
+		0.5 * (elemData.u_y[P][lElem]   + elemData.u_y[P][rElem])
+	};
+	double baryBary[NDIM] = {
+		sideData.baryBaryVec[X][iSide] / sideData.baryBaryDist[iSide],
+		sideData.baryBaryVec[Y][iSide] / sideData.baryBaryDist[iSide]
+	};
+	double correction[NVAR] = {
+		gradUxMean[RHO] * baryBary[X] + gradUyMean[RHO] * baryBary[Y] - (elemData.pVar[RHO][rElem] - elemData.pVar[RHO][lElem]) / sideData.baryBaryDist[iSide],
+		gradUxMean[VX]  * baryBary[X] + gradUyMean[VX]  * baryBary[Y] - (elemData.pVar[VX][rElem]  - elemData.pVar[VX][lElem])  / sideData.baryBaryDist[iSide],
+		gradUxMean[VY]  * baryBary[X] + gradUyMean[VY]  * baryBary[Y] - (elemData.pVar[VY][rElem]  - elemData.pVar[VY][lElem])  / sideData.baryBaryDist[iSide],
+		gradUxMean[P]   * baryBary[X] + gradUyMean[P]   * baryBary[Y] - (elemData.pVar[P][rElem]   - elemData.pVar[P][lElem])   / sideData.baryBaryDist[iSide]
+	};
+	double gradUx[NVAR] = {
+		gradUxMean[RHO] - correction[RHO] * baryBary[X],
+		gradUxMean[VX]  - correction[VX]  * baryBary[X],
+		gradUxMean[VY]  - correction[VY]  * baryBary[X],
+		gradUxMean[P]   - correction[P]   * baryBary[X]
+	};
+	double gradUy[NVAR] = {
+		gradUyMean[RHO] - correction[RHO] * baryBary[Y],
+		gradUyMean[VX]  - correction[VX]  * baryBary[Y],
+		gradUyMean[VY]  - correction[VY]  * baryBary[Y],
+		gradUyMean[P]   - correction[P]   * baryBary[Y]
+	};
+
+	double fluxDiffX[4] = {0.0}, fluxDiffY[4] = {0.0};
+	diffusionFlux(stateMean, gradUx, gradUy, fluxDiffX, fluxDiffY);
+
+	fluxDiff[RHO] = fluxDiffX[RHO] * n[X] + fluxDiffY[RHO] * n[Y];
+	fluxDiff[MX]  = fluxDiffX[MX]  * n[X] + fluxDiffY[MX]  * n[Y];
+	fluxDiff[MY]  = fluxDiffX[MY]  * n[X] + fluxDiffY[MY]  * n[Y];
+	fluxDiff[E]   = fluxDiffX[E]   * n[X] + fluxDiffY[E]   * n[Y];
+}
+#endif
 
-		/* calculate flux */
-		double fluxConv[4] = {0.0};
-		convectiveFlux(pVarL[RHO], pVarR[RHO],
-			       pVarL[VX],  pVarR[VX],
-			       pVarL[VY],  pVarR[VY],
-			       pVarL[P],   pVarR[P],
-			       fluxConv);
+/**
+ * \brief Numerical flux over a block of consecutive sides
+ *
+ * The velocity vectors of the left and right states are transformed into the
+ * normal system of the cell interfaces and the convective fluxes of the whole
+ * block are calculated at once. The function finishes with a back rotation of
+ * the fluxes into the global coordinate system and the integration over the
+ * sides. The fluxes are stored for the first element of each side.
+ * \param[in] firstSide ID of the first side of the block
+ * \param[in] nFaces Number of sides in the block, at most FLUX_BLOCK
+ * \param[in] pVarL Primitive states of the first elements of the sides
+ * \param[in] pVarR Primitive states of the second elements of the sides
+ */
+void blockFlux(long firstSide, int nFaces, double pVarL[NVAR][FLUX_BLOCK],
+		double pVarR[NVAR][FLUX_BLOCK])
+{
+	/* rotate the states into normal direction */
+	double qL[NVAR][FLUX_BLOCK], qR[NVAR][FLUX_BLOCK];
+	#pragma omp simd
+	for (int i = 0; i < nFaces; ++i) {
+		double nx = sideData.n[X][firstSide + i];
+		double ny = sideData.n[Y][firstSide + i];
+
+		qL[RHO][i] = pVarL[RHO][i];
+		qL[VX][i]  =   nx * pVarL[VX][i] + ny * pVarL[VY][i];
+		qL[VY][i]  = - ny * pVarL[VX][i] + nx * pVarL[VY][i];
+		qL[P][i]   = pVarL[P][i];
+
+		qR[RHO][i] = pVarR[RHO][i];
+		qR[VX][i]  =   nx * pVarR[VX][i] + ny * pVarR[VY][i];
+		qR[VY][i]  = - ny * pVarR[VX][i] + nx * pVarR[VY][i];
+		qR[P][i]   = pVarR[P][i];
+	}
 
-		#ifdef navierstokes
-		double fluxDiffX[4] = {0.0}, fluxDiffY[4] = {0.0};
-		diffusionFlux(stateMean, gradUx, gradUy, fluxDiffX, fluxDiffY);
-		#endif
+	/* calculate flux */
+	double f[NVAR][FLUX_BLOCK];
+	convectiveFluxBlock(nFaces, qL, qR, f);
 
-		/* rotate flux into global coordinate system and update residual */
-		aSide->flux[RHO] = fluxConv[RHO];
-		aSide->flux[MX]  = aSide->n[X] * fluxConv[MX] - aSide->n[Y] * fluxConv[MY];
-		aSide->flux[MY]  = aSide->n[Y] * fluxConv[MX] + aSide->n[X] * fluxConv[MY];
-		aSide->flux[E]   = fluxConv[E];
+	for (int i = 0; i < nFaces; ++i) {
+		long iSide = firstSide + i;
+		double nx = sideData.n[X][iSide];
+		double ny = sideData.n[Y][iSide];
+
+		/* rotate flux into global coordinate system */
+		double flux[NVAR];
+		flux[RHO] = f[RHO][i];
+		flux[MX]  = nx * f[MX][i] - ny * f[MY][i];
+		flux[MY]  = ny * f[MX][i] + nx * f[MY][i];
+		flux[E]   = f[E][i];
 
 		#ifdef navierstokes
 		/* sum up diffusion part of the fluxes */
-		aSide->flux[RHO] -= (fluxDiffX[RHO] * aSide->n[X] + fluxDiffY[RHO] * aSide->n[Y]);
-		aSide->flux[MX]  -= (fluxDiffX[MX]  * aSide->n[X] + fluxDiffY[MX]  * aSide->n[Y]);
-		aSide->flux[MY]  -= (fluxDiffX[MY]  * aSide->n[X] + fluxDiffY[MY]  * aSide->n[Y]);
-		aSide->flux[E]   -= (fluxDiffX[E]   * aSide->n[X] + fluxDiffY[E]   * aSide->n[Y]);
+		double pVarLeft[NVAR]  = {pVarL[RHO][i], pVarL[VX][i], pVarL[VY][i], pVarL[P][i]};
+		double pVarRight[NVAR] = {pVarR[RHO][i], pVarR[VX][i], pVarR[VY][i], pVarR[P][i]};
+		double fluxDiff[NVAR];
+		sideDiffusionFlux(iSide, pVarLeft, pVarRight, fluxDiff);
+
+		flux[RHO] -= fluxDiff[RHO];
+		flux[MX]  -= fluxDiff[MX];
+		flux[MY]  -= fluxDiff[MY];
+		flux[E]   -= fluxDiff[E];
 		#endif
 
-		/* integrate flux over edge using the midpoint rule */
-		aSide->flux[RHO] *= aSide->len;
-		aSide->flux[MX]  *= aSide->len;
-		aSide->flux[MY]  *= aSide->len;
-		aSide->flux[E]   *= aSide->len;
-
-		/* set flux of connection cell */
-		aSide->connection->flux[RHO] = - aSide->flux[RHO];
-		aSide->connection->flux[MX]  = - aSide->flux[MX];
-		aSide->connection->flux[MY]  = - aSide->flux[MY];
-		aSide->connection->flux[E]   = - aSide->flux[E];
+		/* integrate flux over edge using the midpoint rule, the
+		 * connection cell receives its negative */
+		sideData.flux[RHO][iSide] = flux[RHO] * sideData.len[iSide];
+		sideData.flux[MX][iSide]  = flux[MX]  * sideData.len[iSide];
+		sideData.flux[MY][iSide]  = flux[MY]  * sideData.len[iSide];
+		sideData.flux[E][iSide]   = flux[E]   * sideData.len[iSide];
+	}
+}
+
+/**
+ * \brief Perform the flux calculation for all sides, from the states at the
+ *	sides
+ */
+void fluxCalculation(void)
+{
+	long nBlocks = (nSides + FLUX_BLOCK - 1) / FLUX_BLOCK;
+
+	#pragma omp parallel
+	{
+		double ticThread = CPU_TIME();
+
+		#pragma omp for nowait
+		for (long iBlock = 0; iBlock < nBlocks; ++iBlock) {
+			long firstSide = iBlock * FLUX_BLOCK;
+			int nFaces = (nSides - firstSide < FLUX_BLOCK) ? nSides - firstSide : FLUX_BLOCK;
+
+			double pVarL[NVAR][FLUX_BLOCK], pVarR[NVAR][FLUX_BLOCK];
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				for (int i = 0; i < nFaces; ++i) {
+					pVarL[iVar][i] = sideData.pVar[iVar][2 * (firstSide + i)];
+					pVarR[iVar][i] = sideData.pVar[iVar][2 * (firstSide + i) + 1];
+				}
+			}
+
+			blockFlux(firstSide, nFaces, pVarL, pVarR);
+		}
+
+		timerThreadAdd(TIMER_FLUX, ticThread);
 	}
 }
@@ -7,6 +7,19 @@
 #ifndef FLUXCALCULATION_H
 #define FLUXCALCULATION_H
 
+#include "main.h"
+
+#define FLUX_BLOCK 64		/**< number of sides whose fluxes are calculated together */
+
+void fluxJacobian(long iSide, double pVarL[NVAR], double pVarR[NVAR],
+		double dFdUL[NVAR][NVAR], double dFdUR[NVAR][NVAR]);
+BEGIN_DEVICE
+void convectiveFluxBlock(int nFaces, double qL[NVAR][FLUX_BLOCK],
+		double qR[NVAR][FLUX_BLOCK], double f[NVAR][FLUX_BLOCK]);
+void convectiveFlux(double qL[NVAR], double qR[NVAR], double f[NVAR]);
+END_DEVICE
+void blockFlux(long firstSide, int nFaces, double pVarL[NVAR][FLUX_BLOCK],
+		double pVarR[NVAR][FLUX_BLOCK]);
 void fluxCalculation(void);
 
 #endif
@@ -0,0 +1,839 @@
+/** \file
+ *
+ * \brief Reader for gmsh mesh files
+ *
+ * The mesh file is mapped into memory and parsed without the stdio
+ * functions. Supported are the ASCII format 2.2 and the ASCII and binary
+ * format 4.1. All lines or records of the nodes and elements are located
+ * first, afterwards they are parsed in parallel.
+ *
+ * \author hhh
+ * \date Wed 14 Oct 2026 08:14:36 PM CEST
+ */
+
+typedef struct elemBlock_t elemBlock_t;
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "main.h"
+#include "gmsh.h"
+#include "mesh.h"
+#include "memTools.h"
+
+/**
+ * \brief Element block of a version 4 file
+ */
+struct elemBlock_t {
+	int type;			/**< gmsh element type */
+	long pGroup;			/**< physical group of the entity */
+	long n;				/**< number of elements in the block */
+	long offset;			/**< position of the first element in the
+						BC edge, triangle or quadrangle array */
+	const char *data;		/**< first record of a binary block */
+	const char **line;		/**< line of every element of an ASCII
+						block */
+};
+
+/* local variables */
+const char *fileStart;			/**< begin of the mapped mesh file */
+const char *fileEnd;			/**< end of the mapped mesh file */
+bool isBinary;				/**< binary file flag */
+
+/**
+ * \brief Number of nodes of the gmsh element types
+ */
+const int nElemNodes[32] = {0, 2, 3, 4, 4, 8, 6, 5, 3, 6, 9, 10, 27, 18, 14,
+	1, 8, 20, 15, 13, 9, 10, 12, 15, 15, 21, 4, 5, 6, 20, 35, 56};
+
+/**
+ * \brief Abort with a reading error
+ */
+void gmshReadError(void)
+{
+	printf("| ERROR: Reading error in gmsh file\n");
+	exit(1);
+}
+
+/**
+ * \brief Get the begin of the next line
+ * \param[in] str Position inside of the current line
+ * \return Begin of the next line
+ */
+const char *nextLine(const char *str)
+{
+	const char *c = memchr(str, '\n', fileEnd - str);
+	if (!c) {
+		printf("| ERROR: Unexpected end of gmsh file\n");
+		exit(1);
+	}
+
+	return c + 1;
+}
+
+/**
+ * \brief Find a section of the mesh file
+ * \param[in] name Name of the section, e.g. `$Nodes`
+ * \return Begin of the first line after the section header, NULL if the
+ *	section does not exist
+ */
+const char *findSection(const char *name)
+{
+	size_t len = strlen(name);
+	const char *c = fileStart;
+	while (c + len < fileEnd) {
+		if ((*c == '$') && (!strncmp(c, name, len)) &&
+				((c[len] == '\n') || (c[len] == '\r'))) {
+			return nextLine(c);
+		}
+
+		c = memchr(c, '\n', fileEnd - c);
+		if (!c) {
+			return NULL;
+		}
+		c++;
+	}
+
+	return NULL;
+}
+
+/**
+ * \brief Store the begin of a number of consecutive lines
+ * \param[in,out] str Begin of the first line, after the call the begin of
+ *	the line that follows the last one
+ * \param[in] n Number of lines
+ * \return Array with the begin of every line
+ */
+const char **indexLines(const char **str, long n)
+{
+	const char **line = malloc(n * sizeof(const char *) + 1);
+	if (!line) {
+		printf("| ERROR: could not allocate line\n");
+		exit(1);
+	}
+
+	const char *c = *str;
+	for (long i = 0; i < n; ++i) {
+		line[i] = c;
+		c = nextLine(c);
+	}
+
+	*str = c;
+	return line;
+}
+
+/**
+ * \brief Parse an integer number
+ * \param[in,out] str Position in the current line, after the call the
+ *	position behind the number
+ * \return The number
+ */
+long parseLong(const char **str)
+{
+	const char *c = *str;
+	while ((*c == ' ') || (*c == '\t') || (*c == '\r')) {
+		c++;
+	}
+
+	bool isNegative = (*c == '-');
+	if ((*c == '-') || (*c == '+')) {
+		c++;
+	}
+
+	if ((*c < '0') || (*c > '9')) {
+		gmshReadError();
+	}
+
+	long val = 0;
+	while ((*c >= '0') && (*c <= '9')) {
+		val = 10 * val + (*c - '0');
+		c++;
+	}
+
+	*str = c;
+	return (isNegative ? -val : val);
+}
+
+/**
+ * \brief Parse a floating point number
+ *
+ * Numbers whose decimal mantissa and power of ten are both exactly
+ * representable are converted with a single multiplication or division,
+ * which is correctly rounded. All other numbers are passed to `strtod`,
+ * so the result is always identical to `strtod`.
+ * \param[in,out] str Position in the current line, after the call the
+ *	position behind the number
+ * \return The number
+ */
+double parseDouble(const char **str)
+{
+	static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6,
+		1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+		1e18, 1e19, 1e20, 1e21, 1e22};
+
+	const char *c = *str;
+	while ((*c == ' ') || (*c == '\t') || (*c == '\r')) {
+		c++;
+	}
+
+	const char *start = c;
+	bool isNegative = (*c == '-');
+	if ((*c == '-') || (*c == '+')) {
+		c++;
+	}
+
+	uint64_t mantissa = 0;
+	int nDigits = 0, nSignificant = 0, exponent = 0;
+	while ((*c >= '0') && (*c <= '9')) {
+		mantissa = 10 * mantissa + (*c - '0');
+		nSignificant += (mantissa > 0);
+		nDigits++;
+		c++;
+		if (nSignificant > 19) {
+			break;
+		}
+	}
+
+	if ((*c == '.') && (nSignificant <= 19)) {
+		c++;
+		while ((*c >= '0') && (*c <= '9')) {
+			mantissa = 10 * mantissa + (*c - '0');
+			nSignificant += (mantissa > 0);
+			nDigits++;
+			exponent--;
+			c++;
+			if (nSignificant > 19) {
+				break;
+			}
+		}
+	}
+
+	if ((nDigits > 0) && (nSignificant <= 19) && ((*c == 'e') || (*c == 'E'))) {
+		c++;
+		bool isNegativeExp = (*c == '-');
+		if ((*c == '-') || (*c == '+')) {
+			c++;
+		}
+
+		if ((*c < '0') || (*c > '9')) {
+			gmshReadError();
+		}
+
+		int exp = 0;
+		while ((*c >= '0') && (*c <= '9')) {
+			if (exp < 10000) {
+				exp = 10 * exp + (*c - '0');
+			}
+			c++;
+		}
+		exponent += (isNegativeExp ? -exp : exp);
+	}
+
+	if ((nDigits > 0) && (nSignificant <= 19) && (mantissa <= (1ULL << 53))
+			&& (exponent >= -22) && (exponent <= 22)) {
+		double val = (double)mantissa;
+		if (exponent < 0) {
+			val /= pow10[-exponent];
+		} else {
+			val *= pow10[exponent];
+		}
+
+		*str = c;
+		return (isNegative ? -val : val);
+	}
+
+	/* slow path */
+	char *end;
+	double val = strtod(start, &end);
+	if (end == start) {
+		gmshReadError();
+	}
+
+	*str = end;
+	return val;
+}
+
+/**
+ * \brief Copy binary data from the mesh file
+ * \param[out] dest Destination of the data
+ * \param[in] size Size of the data in bytes
+ * \param[in,out] str Position in the mesh file, after the call the position
+ *	behind the data
+ */
+void readBinary(void *dest, size_t size, const char **str)
+{
+	if (*str + size > fileEnd) {
+		printf("| ERROR: Unexpected end of gmsh file\n");
+		exit(1);
+	}
+
+	memcpy(dest, *str, size);
+	*str += size;
+}
+
+/**
+ * \brief Read a size_t of a binary file or an integer of an ASCII file
+ * \param[in,out] str Position in the mesh file
+ * \return The number
+ */
+long readSize(const char **str)
+{
+	if (isBinary) {
+		size_t val;
+		readBinary(&val, sizeof(size_t), str);
+		return val;
+	} else {
+		return parseLong(str);
+	}
+}
+
+/**
+ * \brief Read an int of a binary file or an integer of an ASCII file
+ * \param[in,out] str Position in the mesh file
+ * \return The number
+ */
+long readInt(const char **str)
+{
+	if (isBinary) {
+		int val;
+		readBinary(&val, sizeof(int), str);
+		return val;
+	} else {
+		return parseLong(str);
+	}
+}
+
+/**
+ * \brief Read a double of a binary file or a number of an ASCII file
+ * \param[in,out] str Position in the mesh file
+ * \return The number
+ */
+double readDouble(const char **str)
+{
+	if (isBinary) {
+		double val;
+		readBinary(&val, sizeof(double), str);
+		return val;
+	} else {
+		return parseDouble(str);
+	}
+}
+
+/**
+ * \brief Allocate the BC edge, triangle and quadrangle arrays
+ * \param[in,out] BCedge Pointer to 2D array, used for the BC edges
+ * \param[in] nBCedges Number of BC edges
+ * \param[in,out] tria Pointer to a 2D array, used for the triangles
+ * \param[in,out] quad Pointer to a 2D array, used for the quadrangles
+ */
+void allocateElements(long ***BCedge, long nBCedges, long ***tria, long ***quad)
+{
+	*BCedge = dyn2DintArray(nBCedges, 3);
+	if (nTrias > 0) {
+		*tria = dyn2DintArray(nTrias, 4);
+	}
+
+	if (nQuads > 0) {
+		*quad = dyn2DintArray(nQuads, 5);
+	}
+}
+
+/**
+ * \brief Read the nodes and elements of a version 2 file
+ * \param[in,out] vertex Pointer to 2D array, used for the vertices
+ * \param[in,out] nVertices Pointer to the number of total vertices in `vertex`
+ * \param[in,out] BCedge Pointer to 2D array, used for the BC edges
+ * \param[in,out] nBCedges Pointer to the number of total BC edges
+ * \param[in,out] tria Pointer to a 2D array, used for the triangles
+ * \param[in,out] quad Pointer to a 2D array, used for the quadrangles
+ */
+void readGmsh2(double ***vertex, long *nVertices, long ***BCedge,
+		long *nBCedges, long ***tria, long ***quad)
+{
+	/* read in nodes */
+	const char *c = findSection("$Nodes");
+	*nVertices = (c ? parseLong(&c) : 0);
+	if (*nVertices == 0) {
+		printf("| ERROR: No Nodes in Mesh file\n");
+		exit(1);
+	}
+
+	c = nextLine(c);
+	const char **line = indexLines(&c, *nVertices);
+	*vertex = dyn2DdblArray(*nVertices, 2);
+	#pragma omp parallel for
+	for (long iVert = 0; iVert < *nVertices; ++iVert) {
+		const char *str = line[iVert];
+		long id = parseLong(&str);
+		if (iVert != id - 1) {
+			printf("| ERROR: NodeID %ld does not match Node Position\n", id);
+			exit(1);
+		}
+
+		(*vertex)[iVert][X] = parseDouble(&str);
+		(*vertex)[iVert][Y] = parseDouble(&str);
+	}
+	free(line);
+
+	/* read in elements: element type, physical group and nodes */
+	c = findSection("$Elements");
+	long nElem = (c ? parseLong(&c) : 0);
+	if (nElem == 0) {
+		printf("| ERROR: No Elements in Mesh file\n");
+		exit(1);
+	}
+
+	c = nextLine(c);
+	line = indexLines(&c, nElem);
+	long **elemTmp = dyn2DintArray(nElem, 6);
+	#pragma omp parallel for
+	for (long iElem = 0; iElem < nElem; ++iElem) {
+		const char *str = line[iElem];
+		parseLong(&str);
+		int type = parseLong(&str);
+		int nTags = parseLong(&str);
+		elemTmp[iElem][0] = type;
+		elemTmp[iElem][1] = (nTags > 0 ? parseLong(&str) : 0);
+		for (int iTag = 1; iTag < nTags; ++iTag) {
+			parseLong(&str);
+		}
+
+		if ((type >= 1) && (type <= 3)) {
+			for (int i = 0; i < nElemNodes[type]; ++i) {
+				elemTmp[iElem][2 + i] = parseLong(&str) - 1;
+			}
+		}
+	}
+	free(line);
+
+	/* BC edges, triangles and quadrangles keep their order of the file */
+	*nBCedges = nTrias = nQuads = 0;
+	for (long iElem = 0; iElem < nElem; ++iElem) {
+		switch (elemTmp[iElem][0]) {
+		case 1:
+			*nBCedges += (elemTmp[iElem][1] > 100);
+			break;
+		case 2:
+			nTrias++;
+			break;
+		case 3:
+			nQuads++;
+			break;
+		}
+	}
+
+	allocateElements(BCedge, *nBCedges, tria, quad);
+	long iBCedge = 0, iTria = 0, iQuad = 0;
+	for (long iElem = 0; iElem < nElem; ++iElem) {
+		long *aElem = elemTmp[iElem];
+		switch (aElem[0]) {
+		case 1:
+			/* line */
+			if (aElem[1] > 100) {
+				/* boundary condition */
+				(*BCedge)[iBCedge][0] = aElem[2];
+				(*BCedge)[iBCedge][1] = aElem[3];
+				(*BCedge)[iBCedge][2] = aElem[1];
+				iBCedge++;
+			}
+			break;
+		case 2:
+			/* triangle */
+			for (int i = 0; i < 3; ++i) {
+				(*tria)[iTria][i] = aElem[2 + i];
+			}
+			(*tria)[iTria][3] = aElem[1];
+			iTria++;
+			break;
+		case 3:
+			/* quadrilateral */
+			for (int i = 0; i < 4; ++i) {
+				(*quad)[iQuad][i] = aElem[2 + i];
+			}
+			(*quad)[iQuad][4] = aElem[1];
+			iQuad++;
+			break;
+		}
+	}
+
+	free(elemTmp);
+}
+
+/**
+ * \brief Read the nodes and elements of a version 4.1 file
+ * \param[in,out] vertex Pointer to 2D array, used for the vertices
+ * \param[in,out] nVertices Pointer to the number of total vertices in `vertex`
+ * \param[in,out] BCedge Pointer to 2D array, used for the BC edges
+ * \param[in,out] nBCedges Pointer to the number of total BC edges
+ * \param[in,out] tria Pointer to a 2D array, used for the triangles
+ * \param[in,out] quad Pointer to a 2D array, used for the quadrangles
+ */
+void readGmsh4(double ***vertex, long *nVertices, long ***BCedge,
+		long *nBCedges, long ***tria, long ***quad)
+{
+	/* read the physical group of every curve entity */
+	const char *c = findSection("$Entities");
+	if (!c) {
+		printf("| ERROR: No curves in mesh file\n");
+		exit(1);
+	}
+
+	long nPEntities = readSize(&c);
+	long nCEntities = readSize(&c);
+	readSize(&c);
+	readSize(&c);
+	if (nCEntities == 0) {
+		printf("| ERROR: No curves in mesh file\n");
+		exit(1);
+	}
+
+	if (!isBinary) {
+		c = nextLine(c);
+	}
+
+	for (long i = 0; i < nPEntities; ++i) {
+		/* skip points */
+		if (isBinary) {
+			readInt(&c);
+			for (int iDim = 0; iDim < 3; ++iDim) {
+				readDouble(&c);
+			}
+
+			long nTags = readSize(&c);
+			c += nTags * sizeof(int);
+		} else {
+			c = nextLine(c);
+		}
+	}
+
+	long *curveTag = dyn1DintArray(nCEntities);
+	long *curvePGroup = dyn1DintArray(nCEntities);
+	for (long i = 0; i < nCEntities; ++i) {
+		curveTag[i] = readInt(&c);
+		for (int k = 0; k < 6; ++k) {
+			readDouble(&c);
+		}
+
+		long nTags = readSize(&c);
+		for (long iTag = 0; iTag < nTags; ++iTag) {
+			long tag = readInt(&c);
+			if (iTag == 0) {
+				curvePGroup[i] = tag;
+			}
+		}
+
+		if (isBinary) {
+			long nPoints = readSize(&c);
+			c += nPoints * sizeof(int);
+		} else {
+			c = nextLine(c);
+		}
+	}
+
+	/* read in the nodes */
+	c = findSection("$Nodes");
+	long nBlocks = 0;
+	*nVertices = 0;
+	if (c) {
+		nBlocks = readSize(&c);
+		*nVertices = readSize(&c);
+		readSize(&c);
+		readSize(&c);
+	}
+
+	if (*nVertices == 0) {
+		printf("| ERROR: No Nodes in Mesh file\n");
+		exit(1);
+	}
+
+	if (!isBinary) {
+		c = nextLine(c);
+	}
+
+	*vertex = dyn2DdblArray(*nVertices, 2);
+	long iVert = 0;
+	for (long iBlock = 0; iBlock < nBlocks; ++iBlock) {
+		int dim = readInt(&c);
+		readInt(&c);
+		int isParametric = readInt(&c);
+		long nNodes = readSize(&c);
+		int nCoords = 3 + (isParametric ? dim : 0);
+		if (iVert + nNodes > *nVertices) {
+			gmshReadError();
+		}
+
+		if (isBinary) {
+			const char *tags = c;
+			const char *coords = c + nNodes * sizeof(size_t);
+			c = coords + nNodes * nCoords * sizeof(double);
+			if (c > fileEnd) {
+				gmshReadError();
+			}
+
+			#pragma omp parallel for
+			for (long i = 0; i < nNodes; ++i) {
+				size_t id;
+				memcpy(&id, tags + i * sizeof(size_t), sizeof(size_t));
+				if (iVert + i != (long)id - 1) {
+					printf("| ERROR: NodeID %ld does not match Node Position\n", (long)id);
+					exit(1);
+				}
+
+				memcpy((*vertex)[iVert + i],
+						coords + i * nCoords * sizeof(double),
+						NDIM * sizeof(double));
+			}
+		} else {
+			c = nextLine(c);
+			const char **tagLine = indexLines(&c, nNodes);
+			const char **coordLine = indexLines(&c, nNodes);
+
+			#pragma omp parallel for
+			for (long i = 0; i < nNodes; ++i) {
+				const char *str = tagLine[i];
+				long id = parseLong(&str);
+				if (iVert + i != id - 1) {
+					printf("| ERROR: NodeID %ld does not match Node Position\n", id);
+					exit(1);
+				}
+
+				str = coordLine[i];
+				(*vertex)[iVert + i][X] = parseDouble(&str);
+				(*vertex)[iVert + i][Y] = parseDouble(&str);
+			}
+
+			free(tagLine);
+			free(coordLine);
+		}
+
+		iVert += nNodes;
+	}
+
+	/* locate the element blocks */
+	c = findSection("$Elements");
+	long nElem = 0;
+	nBlocks = 0;
+	if (c) {
+		nBlocks = readSize(&c);
+		nElem = readSize(&c);
+		readSize(&c);
+		readSize(&c);
+	}
+
+	if (nElem == 0) {
+		printf("| ERROR: No Elements in Mesh file\n");
+		exit(1);
+	}
+
+	if (!isBinary) {
+		c = nextLine(c);
+	}
+
+	elemBlock_t *block = calloc(nBlocks, sizeof(elemBlock_t));
+	if (!block) {
+		printf("| ERROR: could not allocate block\n");
+		exit(1);
+	}
+
+	*nBCedges = nTrias = nQuads = 0;
+	for (long iBlock = 0; iBlock < nBlocks; ++iBlock) {
+		elemBlock_t *aBlock = &block[iBlock];
+		int dim = readInt(&c);
+		long tag = readInt(&c);
+		aBlock->type = readInt(&c);
+		aBlock->n = readSize(&c);
+		if ((aBlock->type < 1) || (aBlock->type >= 32)) {
+			printf("| ERROR: Unsupported gmsh element type %d\n", aBlock->type);
+			exit(1);
+		}
+
+		/* surfaces are all in the same group */
+		aBlock->pGroup = 1;
+		if (dim == 1) {
+			aBlock->pGroup = 0;
+			for (long i = 0; i < nCEntities; ++i) {
+				if (curveTag[i] == tag) {
+					aBlock->pGroup = curvePGroup[i];
+				}
+			}
+		}
+
+		if (isBinary) {
+			aBlock->data = c;
+			c += aBlock->n * (1 + nElemNodes[aBlock->type]) * sizeof(size_t);
+			if (c > fileEnd) {
+				gmshReadError();
+			}
+		} else {
+			c = nextLine(c);
+			aBlock->line = indexLines(&c, aBlock->n);
+		}
+
+		switch (aBlock->type) {
+		case 1:
+			if (aBlock->pGroup > 100) {
+				aBlock->offset = *nBCedges;
+				*nBCedges += aBlock->n;
+			}
+			break;
+		case 2:
+			aBlock->offset = nTrias;
+			nTrias += aBlock->n;
+			break;
+		case 3:
+			aBlock->offset = nQuads;
+			nQuads += aBlock->n;
+			break;
+		}
+	}
+
+	free(curveTag);
+	free(curvePGroup);
+
+	/* read in the elements */
+	allocateElements(BCedge, *nBCedges, tria, quad);
+	for (long iBlock = 0; iBlock < nBlocks; ++iBlock) {
+		elemBlock_t *aBlock = &block[iBlock];
+		long **dest = NULL;
+		int nNodes = nElemNodes[aBlock->type];
+		switch (aBlock->type) {
+		case 1:
+			if (aBlock->pGroup > 100) {
+				dest = *BCedge;
+			}
+			break;
+		case 2:
+			dest = *tria;
+			break;
+		case 3:
+			dest = *quad;
+			break;
+		}
+
+		if (dest) {
+			#pragma omp parallel for
+			for (long i = 0; i < aBlock->n; ++i) {
+				long *aElem = dest[aBlock->offset + i];
+				if (isBinary) {
+					size_t nodes[1 + nNodes];
+					memcpy(nodes, aBlock->data + i * (1 + nNodes) * sizeof(size_t),
+							(1 + nNodes) * sizeof(size_t));
+					for (int k = 0; k < nNodes; ++k) {
+						aElem[k] = nodes[1 + k] - 1;
+					}
+				} else {
+					const char *str = aBlock->line[i];
+					parseLong(&str);
+					for (int k = 0; k < nNodes; ++k) {
+						aElem[k] = parseLong(&str) - 1;
+					}
+				}
+
+				aElem[nNodes] = aBlock->pGroup;
+			}
+		}
+
+		free(aBlock->line);
+	}
+
+	free(block);
+}
+
+/**
+ * \brief Read in a gmsh mesh file
+ * \param[in] fileName Name of the mesh file
+ * \param[in,out] vertex Pointer to 2D array, used for the vertices
+ * \param[in,out] nVertices Pointer to the number of total vertices in `vertex`
+ * \param[in,out] BCedge Pointer to 2D array, used for the BC edges
+ * \param[in,out] nBCedges Pointer to the number of total BC edges
+ * \param[in,out] tria Pointer to a 2D array, used for the triangles
+ * \param[in,out] quad Pointer to a 2D array, used for the quadrangles
+ */
+void readGmsh(char fileName[STRLEN], double ***vertex, long *nVertices, long ***BCedge,
+		long *nBCedges, long ***tria, long ***quad)
+{
+	/* map the mesh file into memory */
+	int fd = open(fileName, O_RDONLY);
+	if (fd < 0) {
+		printf("| ERROR: Could not find Mesh File '%s'\n", fileName);
+		exit(1);
+	}
+
+	struct stat fileStat;
+	if ((fstat(fd, &fileStat) != 0) || (fileStat.st_size == 0)) {
+		printf("| ERROR: Could not read Mesh File '%s'\n", fileName);
+		exit(1);
+	}
+
+	size_t fileSize = fileStat.st_size;
+	void *map = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED) {
+		printf("| ERROR: Could not map Mesh File '%s'\n", fileName);
+		exit(1);
+	}
+
+	close(fd);
+	fileStart = map;
+	fileEnd = fileStart + fileSize;
+
+	/* read in mesh format */
+	const char *c = findSection("$MeshFormat");
+	if (!c) {
+		printf("| ERROR: No Mesh Format in Mesh file\n");
+		exit(1);
+	}
+
+	double version = parseDouble(&c);
+	isBinary = (parseLong(&c) == 1);
+	if (parseLong(&c) != sizeof(double)) {
+		printf("| ERROR: gmsh files need a data size of %zu\n", sizeof(double));
+		exit(1);
+	}
+
+	if (isBinary) {
+		int one;
+		c = nextLine(c);
+		readBinary(&one, sizeof(int), &c);
+		if (one != 1) {
+			printf("| ERROR: gmsh file has a different endianness\n");
+			exit(1);
+		}
+	}
+
+	int mshFmt = (int)version;
+	switch (mshFmt) {
+	case 2:
+		if (isBinary) {
+			printf("| ERROR: Binary gmsh files need Mesh Format 4.1\n");
+			exit(1);
+		}
+
+		readGmsh2(vertex, nVertices, BCedge, nBCedges, tria, quad);
+		break;
+	case 4:
+		if (version < 4.1) {
+			printf("| ERROR: gmsh Mesh Format %g not supported, use 4.1\n", version);
+			exit(1);
+		}
+
+		readGmsh4(vertex, nVertices, BCedge, nBCedges, tria, quad);
+		break;
+	default:
+		printf("| ERROR: Wrong gmsh Mesh Format '%d'\n", mshFmt);
+		exit(1);
+	}
+
+	munmap(map, fileSize);
+
+	printf("| %7ld Nodes read\n", *nVertices);
+	printf("| %7ld Triangles read\n", nTrias);
+	printf("| %7ld Quadrangles read\n", nQuads);
+	printf("| %7ld Boundary Edges read\n", *nBCedges);
+}
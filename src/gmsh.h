@@ -0,0 +1,15 @@
+/** \file
+ *
+ * \author hhh
+ * \date Wed 14 Oct 2026 08:14:36 PM CEST
+ */
+
+#ifndef GMSH_H
+#define GMSH_H
+
+#include "main.h"
+
+void readGmsh(char fileName[STRLEN], double ***vertex, long *nVertices, long ***BCedge,
+		long *nBCedges, long ***tria, long ***quad);
+
+#endif
@@ -21,6 +21,8 @@
 #include "exactFunction.h"
 #include "equationOfState.h"
 #include "cgnslib.h"
+#include "checkpoint.h"
+#include "solutionMapping.h"
 
 /* extern variables */
 int icType;			/**< type of initial condition */
@@ -90,6 +92,9 @@ void initInitialCondition(void)
 
 /**
  * \brief Read a solution from a CGNS file, used at restart
+ *
+ * The solution of another mesh is mapped onto the elements, see
+ * `mapRestartSolution`.
  */
 void cgnsReadSolution(void)
 {
@@ -104,27 +109,60 @@ void cgnsReadSolution(void)
 	if (cg_zone_read(indexFile, 1, 1, zoneName, iSize))
 		cg_error_exit();
 
-	if (nElems != iSize[1]) {
+	if ((!isMappedRestart) && (nElemsGlobal != iSize[1])) {
 		printf("| ERROR: Wrong Number of Elements in CGNS flow solution\n");
 		exit(1);
 	}
 
-	/* allocate array for the flow solution */
-	double *rhoArr = malloc(nElems * sizeof(double));
-	double *vxArr = malloc(nElems * sizeof(double));
-	double *vyArr = malloc(nElems * sizeof(double));
-	double *pArr = malloc(nElems * sizeof(double));
-
-	cgsize_t rMin[1] = {1}, rMax[1] = {nElems};
-	if (cg_field_read(indexFile, 1, 1, 1, "Density", RealDouble, rMin, rMax, rhoArr))
-		cg_error_exit();
-	if (cg_field_read(indexFile, 1, 1, 1, "VelocityX", RealDouble, rMin, rMax, vxArr))
-		cg_error_exit();
-	if (cg_field_read(indexFile, 1, 1, 1, "VelocityY", RealDouble, rMin, rMax, vyArr))
-		cg_error_exit();
-	if (cg_field_read(indexFile, 1, 1, 1, "Pressure", RealDouble, rMin, rMax, pArr))
+	/* the latest flow solution, a time series file holds several ones */
+	int nSols, iSol;
+	if (cg_nsols(indexFile, 1, 1, &nSols))
 		cg_error_exit();
 
+	char solName[33];
+	for (iSol = nSols; iSol > 0; --iSol) {
+		GridLocation_t location;
+		if (cg_sol_info(indexFile, 1, 1, iSol, solName, &location))
+			cg_error_exit();
+
+		if (!strncmp(solName, "FlowSolution", 12)) {
+			break;
+		}
+	}
+
+	if (iSol == 0) {
+		printf("| ERROR: No flow solution in CGNS file\n");
+		exit(1);
+	}
+
+	/* the solutions of a time series file are named after their
+	 * iteration number, the file name has no time stamp */
+	if (isStationary && (strlen(solName) > 12)) {
+		iniIterationNumber = strtol(solName + 12, NULL, 10);
+	}
+
+	/* the solution of another mesh is mapped chunk by chunk */
+	double *rhoArr = NULL, *vxArr = NULL, *vyArr = NULL, *pArr = NULL;
+	if (isMappedRestart) {
+		mapRestartSolution(indexFile, iSol, iSize[1]);
+	} else {
+		/* allocate array for the flow solution */
+		rhoArr = malloc(nElemsGlobal * sizeof(double));
+		vxArr = malloc(nElemsGlobal * sizeof(double));
+		vyArr = malloc(nElemsGlobal * sizeof(double));
+		pArr = malloc(nElemsGlobal * sizeof(double));
+
+		cgsize_t rMin[1] = {1}, rMax[1] = {nElemsGlobal};
+		if (cg_field_read(indexFile, 1, 1, iSol, "Density", RealDouble, rMin, rMax, rhoArr))
+			cg_error_exit();
+		if (cg_field_read(indexFile, 1, 1, iSol, "VelocityX", RealDouble, rMin, rMax, vxArr))
+			cg_error_exit();
+		if (cg_field_read(indexFile, 1, 1, iSol, "VelocityY", RealDouble, rMin, rMax, vyArr))
+			cg_error_exit();
+		if (cg_field_read(indexFile, 1, 1, iSol, "Pressure", RealDouble, rMin, rMax, pArr))
+			cg_error_exit();
+	}
+
 	/* read iteration number, time, and wall clock time */
 	if (cg_goto(indexFile, 1, "end"))
 		cg_error_exit();
@@ -139,13 +177,19 @@ void cgnsReadSolution(void)
 	if (cg_close(indexFile))
 		cg_error_exit();
 
-	/* save CGNS solution into mesh */
+	if (isMappedRestart) {
+		finishRestartMapping();
+		return;
+	}
+
+	/* save CGNS solution into mesh, the file is in mesh file order */
 	elem_t *aElem = firstElem;
 	while (aElem) {
-		aElem->pVar[RHO] = rhoArr[aElem->id];
-		aElem->pVar[VX]  = vxArr[aElem->id];
-		aElem->pVar[VY]  = vyArr[aElem->id];
-		aElem->pVar[P]   = pArr[aElem->id];
+		long iElem = aElem->fileId;
+		elemData.pVar[RHO][aElem->id] = rhoArr[iElem];
+		elemData.pVar[VX][aElem->id]  = vxArr[iElem];
+		elemData.pVar[VY][aElem->id]  = vyArr[iElem];
+		elemData.pVar[P][aElem->id]   = pArr[iElem];
 
 		aElem = aElem->next;
 	}
@@ -165,6 +209,14 @@ void setInitialCondition(void)
 	printf("\nSetting Initial Conditions:\n");
 	elem_t *aElem;
 	if (isRestart) {
+		if (isCheckpoint(strIniCondFile)) {
+			/* the conservative variables are restored, computing them
+			 * again from the primitive ones would change the round-off */
+			readCheckpoint();
+			printf("| Done.\n");
+			return;
+		}
+
 		cgnsReadSolution();
 	} else {
 		switch (icType) {
@@ -172,10 +224,10 @@ void setInitialCondition(void)
 			/* cell test */
 			aElem = firstElem;
 			while (aElem) {
-				aElem->pVar[RHO] = 1.0 * aElem->id;
-				aElem->pVar[VX] = 0.0;
-				aElem->pVar[VY] = 0.0;
-				aElem->pVar[P] = 1.0;
+				elemData.pVar[RHO][aElem->id] = 1.0 * aElem->id;
+				elemData.pVar[VX][aElem->id] = 0.0;
+				elemData.pVar[VY][aElem->id] = 0.0;
+				elemData.pVar[P][aElem->id] = 1.0;
 
 				aElem = aElem->next;
 			}
@@ -186,15 +238,15 @@ void setInitialCondition(void)
 			aElem = firstElem;
 			while (aElem) {
 				if (nDomains == 1) {
-					aElem->pVar[RHO] = refState[0][RHO];
-					aElem->pVar[VX]  = refState[0][VX];
-					aElem->pVar[VY]  = refState[0][VY];
-					aElem->pVar[P]   = refState[0][P];
+					elemData.pVar[RHO][aElem->id] = refState[0][RHO];
+					elemData.pVar[VX][aElem->id]  = refState[0][VX];
+					elemData.pVar[VY][aElem->id]  = refState[0][VY];
+					elemData.pVar[P][aElem->id]   = refState[0][P];
 				} else {
-					aElem->pVar[RHO] = refState[aElem->domain - 1][RHO];
-					aElem->pVar[VX]  = refState[aElem->domain - 1][VX];
-					aElem->pVar[VY]  = refState[aElem->domain - 1][VY];
-					aElem->pVar[P]   = refState[aElem->domain - 1][P];
+					elemData.pVar[RHO][aElem->id] = refState[aElem->domain - 1][RHO];
+					elemData.pVar[VX][aElem->id]  = refState[aElem->domain - 1][VX];
+					elemData.pVar[VY][aElem->id]  = refState[aElem->domain - 1][VY];
+					elemData.pVar[P][aElem->id]   = refState[aElem->domain - 1][P];
 				}
 				aElem = aElem->next;
 			}
@@ -203,7 +255,11 @@ void setInitialCondition(void)
 			/* exact function */
 			aElem = firstElem;
 			while (aElem) {
-				exactFunc(intExactFunc, aElem->bary, 0.0, aElem->pVar);
+				double pVar[NVAR];
+				exactFunc(intExactFunc, aElem->bary, 0.0, pVar);
+				for (int iVar = 0; iVar < NVAR; ++iVar) {
+					elemData.pVar[iVar][aElem->id] = pVar[iVar];
+				}
 				aElem = aElem->next;
 			}
 			break;
@@ -215,7 +271,7 @@ void setInitialCondition(void)
 
 	aElem = firstElem;
 	while (aElem) {
-		primCons(aElem->pVar, aElem->cVar);
+		primConsElem(aElem->id);
 		aElem = aElem->next;
 	}
 
@@ -0,0 +1,262 @@
+/** \file
+ *
+ * \brief In situ visualization with ParaView Catalyst
+ *
+ * The mesh and the primitive variables of the partition are handed to a
+ * Catalyst pipeline script as a Conduit mesh blueprint, at every data output
+ * and every `catalystIterInterval` iterations. The elements are described as
+ * polygons, so triangles and quadrilaterals share one topology. The node
+ * coordinates and the connectivity are collected once and again only after
+ * a mesh adaptation, the fields are passed as references to `elemData.pVar`
+ * without any copy.
+ *
+ * Catalyst is only available if `ccfd` is compiled with `CATALYST = on`, the
+ * implementation, e.g. ParaView, is loaded at run time from the paths in
+ * `CATALYST_IMPLEMENTATION_PATHS`.
+ *
+ * \author hhh
+ * \date Thu 15 Oct 2026 06:47:21 PM CEST
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <omp.h>
+#ifdef USE_CATALYST
+#include <catalyst.h>
+#endif
+
+#include "main.h"
+#include "insitu.h"
+#include "readInTools.h"
+#include "mesh.h"
+#include "memTools.h"
+#include "timer.h"
+#include "timeDiscretization.h"
+#include "device.h"
+
+/* extern variables */
+bool useCatalyst;			/**< in situ visualization flag */
+long catalystIterInterval;		/**< iteration interval of the in situ
+					  visualization, 0 only at data outputs */
+
+#ifdef USE_CATALYST
+/* local variables */
+long lastCatalystIter;			/**< iteration of the last execution */
+long nCatalystNodes;			/**< number of nodes of the partition */
+long nCatalystConn;			/**< length of the connectivity */
+double **catalystCoords;		/**< node coordinates of the partition */
+conduit_int64 *catalystConn;		/**< nodes of the elements */
+conduit_int64 *catalystSizes;		/**< number of nodes of each element */
+conduit_int64 *catalystOffsets;		/**< first node of each element in
+					  `catalystConn` */
+
+/**
+ * \brief Collect the nodes and the connectivity of the partition's elements
+ */
+static void catalystMesh(void)
+{
+	/* local node number of every global node */
+	long *localNode = dyn1DintArray(nNodes);
+	for (long iNode = 0; iNode < nNodes; ++iNode) {
+		localNode[iNode] = -1;
+	}
+
+	nCatalystConn = 0;
+	nCatalystNodes = 0;
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		elem_t *aElem = elem[iElem];
+		for (int iNode = 0; iNode < aElem->elemType; ++iNode) {
+			if (localNode[aElem->node[iNode]->id] < 0) {
+				localNode[aElem->node[iNode]->id] = nCatalystNodes++;
+			}
+		}
+		nCatalystConn += aElem->elemType;
+	}
+
+	catalystCoords = dyn2DdblArray(NDIM, nCatalystNodes);
+	catalystConn = malloc(sizeof(conduit_int64) * nCatalystConn);
+	catalystSizes = malloc(sizeof(conduit_int64) * nElems);
+	catalystOffsets = malloc(sizeof(conduit_int64) * nElems);
+	if (!catalystConn || !catalystSizes || !catalystOffsets) {
+		printf("| ERROR: could not allocate the Catalyst connectivity\n");
+		exit(1);
+	}
+
+	long nConn = 0;
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		elem_t *aElem = elem[iElem];
+		catalystSizes[iElem] = aElem->elemType;
+		catalystOffsets[iElem] = nConn;
+		for (int iNode = 0; iNode < aElem->elemType; ++iNode) {
+			node_t *aNode = aElem->node[iNode];
+			long jNode = localNode[aNode->id];
+			catalystCoords[X][jNode] = aNode->x[X];
+			catalystCoords[Y][jNode] = aNode->x[Y];
+			catalystConn[nConn++] = jNode;
+		}
+	}
+
+	free(localNode);
+}
+#endif
+
+/**
+ * \brief Initialize the in situ visualization and load the pipeline script
+ */
+void initCatalyst(void)
+{
+	char *script = getStr("catalystScript", "");
+	useCatalyst = (strlen(script) > 0);
+	if (!useCatalyst) {
+		free(script);
+		return;
+	}
+
+	printf("\nInitializing Catalyst:\n");
+#ifdef USE_CATALYST
+	catalystIterInterval = getInt("catalystIterInterval", "0");
+	if (catalystIterInterval < 0) {
+		printf("| ERROR: catalystIterInterval must not be negative\n");
+		exit(1);
+	}
+	char *implementation = getStr("catalystImplementation", "paraview");
+
+	conduit_node *params = conduit_node_create();
+	conduit_node_set_path_char8_str(params, "catalyst/scripts/script0", script);
+	conduit_node_set_path_char8_str(params, "catalyst_load/implementation", implementation);
+	enum catalyst_status err = catalyst_initialize(params);
+	conduit_node_destroy(params);
+	if (err != catalyst_status_ok) {
+		printf("| ERROR: could not initialize Catalyst with '%s', status %d\n",
+				implementation, (int)err);
+		exit(1);
+	}
+
+	catalystMesh();
+	lastCatalystIter = -1;
+	printf("| Pipeline Script: %s\n", script);
+	free(implementation);
+#else
+	printf("| ERROR: ccfd was compiled without Catalyst, set CATALYST = on\n");
+	exit(1);
+#endif
+	free(script);
+}
+
+/**
+ * \brief Execute the pipeline script with the current solution
+ *
+ * The pipeline is executed at most once per iteration, so the calls at the
+ * data outputs and at the in situ interval do not repeat each other.
+ *
+ * \param[in] time The computational time of the solution
+ * \param[in] iter The iteration number of the solution
+ */
+void catalystOutput(double time, long iter)
+{
+#ifdef USE_CATALYST
+	if (!useCatalyst || (iter == lastCatalystIter)) {
+		return;
+	}
+	lastCatalystIter = iter;
+
+	deviceToHost();
+
+	double tic = CPU_TIME();
+	conduit_node *params = conduit_node_create();
+	conduit_node_set_path_int64(params, "catalyst/state/timestep", iter);
+	conduit_node_set_path_float64(params, "catalyst/state/time", time);
+	conduit_node_set_path_char8_str(params, "catalyst/channels/grid/type", "mesh");
+
+	conduit_node *mesh = conduit_node_fetch(params, "catalyst/channels/grid/data");
+	conduit_node_set_path_char8_str(mesh, "coordsets/coords/type", "explicit");
+	conduit_node_set_path_external_float64_ptr(mesh, "coordsets/coords/values/x",
+			catalystCoords[X], nCatalystNodes);
+	conduit_node_set_path_external_float64_ptr(mesh, "coordsets/coords/values/y",
+			catalystCoords[Y], nCatalystNodes);
+
+	conduit_node_set_path_char8_str(mesh, "topologies/mesh/type", "unstructured");
+	conduit_node_set_path_char8_str(mesh, "topologies/mesh/coordset", "coords");
+	conduit_node_set_path_char8_str(mesh, "topologies/mesh/elements/shape", "polygonal");
+	conduit_node_set_path_external_int64_ptr(mesh, "topologies/mesh/elements/connectivity",
+			catalystConn, nCatalystConn);
+	conduit_node_set_path_external_int64_ptr(mesh, "topologies/mesh/elements/sizes",
+			catalystSizes, nElems);
+	conduit_node_set_path_external_int64_ptr(mesh, "topologies/mesh/elements/offsets",
+			catalystOffsets, nElems);
+
+	/* the first nElems entries of the element arrays are the elements */
+	const char *fieldName[] = {"Density", "Velocity", "Pressure"};
+	for (int iField = 0; iField < 3; ++iField) {
+		char path[STRLEN];
+		sprintf(path, "fields/%s/association", fieldName[iField]);
+		conduit_node_set_path_char8_str(mesh, path, "element");
+		sprintf(path, "fields/%s/topology", fieldName[iField]);
+		conduit_node_set_path_char8_str(mesh, path, "mesh");
+		sprintf(path, "fields/%s/volume_dependent", fieldName[iField]);
+		conduit_node_set_path_char8_str(mesh, path, "false");
+	}
+	conduit_node_set_path_external_float64_ptr(mesh, "fields/Density/values",
+			elemData.pVar[RHO], nElems);
+	conduit_node_set_path_external_float64_ptr(mesh, "fields/Velocity/values/x",
+			elemData.pVar[VX], nElems);
+	conduit_node_set_path_external_float64_ptr(mesh, "fields/Velocity/values/y",
+			elemData.pVar[VY], nElems);
+	conduit_node_set_path_external_float64_ptr(mesh, "fields/Pressure/values",
+			elemData.pVar[P], nElems);
+
+	enum catalyst_status err = catalyst_execute(params);
+	conduit_node_destroy(params);
+	if (err != catalyst_status_ok) {
+		printf("| WARNING: Catalyst pipeline failed at iteration %ld, status %d\n",
+				iter, (int)err);
+	}
+	timerAdd(TIMER_OUTPUT, &tic);
+#else
+	(void)time;
+	(void)iter;
+#endif
+}
+
+/**
+ * \brief Collect the mesh of the in situ visualization again, after the mesh
+ *	was adapted
+ */
+void catalystUpdateMesh(void)
+{
+#ifdef USE_CATALYST
+	if (!useCatalyst) {
+		return;
+	}
+
+	free(catalystCoords);
+	free(catalystConn);
+	free(catalystSizes);
+	free(catalystOffsets);
+	catalystMesh();
+#endif
+}
+
+/**
+ * \brief Finalize the pipeline and free the mesh of the in situ visualization
+ */
+void freeCatalyst(void)
+{
+#ifdef USE_CATALYST
+	if (!useCatalyst) {
+		return;
+	}
+
+	conduit_node *params = conduit_node_create();
+	catalyst_finalize(params);
+	conduit_node_destroy(params);
+
+	free(catalystCoords);
+	free(catalystConn);
+	free(catalystSizes);
+	free(catalystOffsets);
+#endif
+	useCatalyst = false;
+}
@@ -0,0 +1,20 @@
+/** \file
+ *
+ * \author hhh
+ * \date Thu 15 Oct 2026 06:47:21 PM CEST
+ */
+
+#ifndef INSITU_H
+#define INSITU_H
+
+#include <stdbool.h>
+
+extern bool useCatalyst;
+extern long catalystIterInterval;
+
+void initCatalyst(void);
+void catalystOutput(double time, long iter);
+void catalystUpdateMesh(void);
+void freeCatalyst(void);
+
+#endif
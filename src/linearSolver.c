@@ -13,6 +13,7 @@
 #include <math.h>
 #include <float.h>
 #include <string.h>
+#include <omp.h>
 
 #include "main.h"
 #include "linearSolver.h"
@@ -23,6 +24,8 @@
 #include "fluxCalculation.h"
 #include "equationOfState.h"
 #include "finiteVolume.h"
+#include "parallel.h"
+#include "timer.h"
 
 /* extern variables */
 int nKdim;			/**< number Krylov spaces */
@@ -37,10 +40,14 @@ int nInnerNewton;		/**< maximum number of Newton iterations for
 int nInnerGMRES;		/**< maximum number of GMRES iterations for
 					one stage */
 
+int nPrecondBuilds;		/**< number of preconditioner builds */
+
 bool usePrecond;		/**< use LUSGS preconditioner flag */
+bool useAnalyticJacobian;	/**< approximate analytic Jacobian flag */
+int lusgsOrdering;		/**< ordering of the LU-SGS sweeps */
 
-double rEps0;			/**< DBL_EPSILON */
-double srEps0;			/**< sqrt(DBL_EPSILON) */
+double rEps0;			/**< sqrt(DBL_EPSILON), finite difference step */
+double srEps0;			/**< 1 / rEps0 */
 
 double eps2newton;		/**< square of newton relative epsilon */
 double eps2newton_sq;		/**< newton relative epsilon */
@@ -52,15 +59,325 @@ double **XK;			/**< kth X vector array */
 double **R_XK;			/**< residual of kth vector array */
 
 /* local variables */
-double ***D;			/**< D-Matrix of LUSGS procedure */
-double ***Dinv;			/**< inverse of D-Matrix */
-double **dRdU;			/**< dR / dU */
-
-double ***V;			/**< temporary array, used in GMRES */
-double ***Z;			/**< temporary array, used in GMRES */
+int nRestarts;			/**< maximum number of GMRES restarts */
+int nRestartsGlobal;		/**< global number of GMRES restarts */
+int precondRebuild;		/**< number of linear solves after which the
+					preconditioner is rebuilt */
+int precondRebuildGMRES;	/**< number of GMRES iterations of a solve
+					after which the preconditioner is rebuilt */
+int nSolvesSinceBuild;		/**< linear solves with the current
+					preconditioner */
+int nLastGMRES;			/**< GMRES iterations of the last solve */
+double tBuild;			/**< time spent building the preconditioner */
+double tPrecond;		/**< time spent applying the preconditioner */
+double tMatVec;			/**< time spent in matrix vector products */
+
+krylov_t ***Dinv;		/**< inverse of the diagonal Jacobian blocks */
+
+long *blockRowPtr;		/**< first block of each element row, the
+					diagonal block comes first */
+long *blockCol;			/**< element (column) of each block */
+long *blockTrans;		/**< block at the transposed position */
+long *sideBlock;		/**< block of the neighbor of each element
+					side, -1 for ghost cells */
+int nColors;			/**< number of colors for the FD Jacobian */
+long *colorOffset;		/**< first element of each color */
+long *colorElem;		/**< elements sorted by color */
+double *pVarUnperturbed;	/**< unperturbed state during FD evaluation */
+
+long *lusgsRank;		/**< an element neighbor is in the lower part of
+					the matrix (forward sweep) if its rank is
+					smaller */
+int nFwGroups;			/**< number of independent forward groups */
+long *fwOffset;			/**< first element of each forward group */
+long *fwElem;			/**< elements sorted by forward group */
+int nBwGroups;			/**< number of independent backward groups */
+long *bwOffset;			/**< first element of each backward group */
+long *bwElem;			/**< elements sorted by backward group */
+krylov_t ***dRdU;		/**< dR / dU as NVAR x NVAR blocks (BCSR) */
+
+krylov_t ***V;			/**< Krylov basis, used in GMRES */
+krylov_t ***Z;			/**< preconditioned Krylov basis, used in
+					GMRES */
 double **R0;			/**< temporary array, used in GMRES */
 double **W;			/**< temporary array, used in GMRES */
-double **deltaXstar;		/**< temporary array, used in LUSGS */
+krylov_t **deltaXstar;		/**< temporary array, used in LUSGS */
+
+/**
+ * \brief Set up the block sparse storage of the Jacobian
+ *
+ * Each element row holds its diagonal block followed by one block per
+ * distinct face neighbour, in the order of the element sides. Ghost cells
+ * do not get a block.
+ */
+void createBlockMatrix(void)
+{
+	long nSideBlocks = elemData.sideOffset[nElems];
+
+	blockRowPtr = dyn1DintArray(nElems + 1);
+	blockCol = dyn1DintArray(nElems + nSideBlocks);
+	sideBlock = dyn1DintArray(nSideBlocks);
+
+	long iBlock = 0;
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		blockRowPtr[iElem] = iBlock;
+		blockCol[iBlock++] = iElem;
+
+		for (long j = elemData.sideOffset[iElem]; j < elemData.sideOffset[iElem + 1]; ++j) {
+			long NBelem = sideData.elem[elemData.sideIdx[j] ^ 1];
+			sideBlock[j] = -1;
+			if (NBelem >= nElems) {
+				continue;
+			}
+
+			for (long k = blockRowPtr[iElem]; k < iBlock; ++k) {
+				if (blockCol[k] == NBelem) {
+					sideBlock[j] = k;
+					break;
+				}
+			}
+
+			if (sideBlock[j] < 0) {
+				sideBlock[j] = iBlock;
+				blockCol[iBlock++] = NBelem;
+			}
+		}
+	}
+	blockRowPtr[nElems] = iBlock;
+
+	/* the sparsity pattern is symmetric, find the transposed blocks */
+	blockTrans = dyn1DintArray(iBlock);
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		for (long k = blockRowPtr[iElem]; k < blockRowPtr[iElem + 1]; ++k) {
+			long jElem = blockCol[k];
+			for (long l = blockRowPtr[jElem]; l < blockRowPtr[jElem + 1]; ++l) {
+				if (blockCol[l] == iElem) {
+					blockTrans[k] = l;
+					break;
+				}
+			}
+		}
+	}
+
+	dRdU = dyn3DkrylovArray(iBlock, NVAR, NVAR);
+
+	printf("| Jacobian: %ld blocks (%.2f MB)\n", iBlock,
+			iBlock * NVAR * NVAR * sizeof(krylov_t) / 1048576.0);
+}
+
+/**
+ * \brief Sort the elements into groups, keeping the element order inside
+ *	each group
+ * \param[in] group Group of each element
+ * \param[in] nGroups Number of groups
+ * \param[out] offset First element of each group, size nGroups + 1
+ * \param[out] list Elements sorted by group
+ */
+void sortByGroup(int *group, int nGroups, long **offset, long **list)
+{
+	*offset = dyn1DintArray(nGroups + 1);
+	*list = dyn1DintArray(nElems);
+
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		(*offset)[group[iElem] + 1]++;
+	}
+	for (int iGroup = 0; iGroup < nGroups; ++iGroup) {
+		(*offset)[iGroup + 1] += (*offset)[iGroup];
+	}
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		(*list)[(*offset)[group[iElem]]++] = iElem;
+	}
+	for (int iGroup = nGroups; iGroup > 0; --iGroup) {
+		(*offset)[iGroup] = (*offset)[iGroup - 1];
+	}
+	(*offset)[0] = 0;
+}
+
+/**
+ * \brief Greedy coloring of the elements in element order, elements within
+ *	dist faces of each other get different colors
+ * \param[in] dist Coloring distance
+ * \param[out] color Color of each element
+ * \return Number of colors
+ */
+int colorElements(int dist, int *color)
+{
+	long *mark = malloc(nElems * sizeof(long));
+	long *front = malloc(nElems * sizeof(long));
+	bool *isUsed = calloc(nElems + 1, sizeof(bool));
+	if (!mark || !front || !isUsed) {
+		printf("| ERROR: could not allocate coloring arrays\n");
+		exit(1);
+	}
+
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		color[iElem] = -1;
+		mark[iElem] = -1;
+	}
+
+	int nColorsLoc = 0;
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		/* breadth first search up to the coloring distance */
+		long nFront = 0, iFront = 0;
+		front[nFront++] = iElem;
+		mark[iElem] = iElem;
+		for (int iDist = 0; iDist < dist; ++iDist) {
+			long nLevel = nFront;
+			for (; iFront < nLevel; ++iFront) {
+				long aElem = front[iFront];
+				for (long j = elemData.sideOffset[aElem]; j < elemData.sideOffset[aElem + 1]; ++j) {
+					long NBelem = sideData.elem[elemData.sideIdx[j] ^ 1];
+					if ((NBelem < nElems) && (mark[NBelem] != iElem)) {
+						mark[NBelem] = iElem;
+						front[nFront++] = NBelem;
+					}
+				}
+			}
+		}
+
+		for (long k = 1; k < nFront; ++k) {
+			if (color[front[k]] >= 0) {
+				isUsed[color[front[k]]] = true;
+			}
+		}
+
+		int iColor = 0;
+		while (isUsed[iColor]) {
+			iColor++;
+		}
+		color[iElem] = iColor;
+		if (iColor >= nColorsLoc) {
+			nColorsLoc = iColor + 1;
+		}
+
+		for (long k = 1; k < nFront; ++k) {
+			if (color[front[k]] >= 0) {
+				isUsed[color[front[k]]] = false;
+			}
+		}
+	}
+
+	free(mark);
+	free(front);
+	free(isUsed);
+
+	return nColorsLoc;
+}
+
+/**
+ * \brief Color the elements for the finite difference Jacobian
+ *
+ * Perturbing an element changes the residual of all elements within the
+ * stencil radius r (1 for first order, 2 for second order), while the
+ * Jacobian only stores face neighbor blocks. Elements that are more than
+ * r + 1 faces apart can therefore be perturbed at the same time without
+ * mixing their contributions.
+ */
+void createColoring(void)
+{
+	int *color = malloc(nElems * sizeof(int));
+	if (!color) {
+		printf("| ERROR: could not allocate color\n");
+		exit(1);
+	}
+
+	nColors = colorElements(spatialOrder + 1, color);
+	sortByGroup(color, nColors, &colorOffset, &colorElem);
+	pVarUnperturbed = dyn1DdblArray(nElems);
+
+	free(color);
+
+	printf("| Jacobian: %d colors for finite differences\n", nColors);
+}
+
+/**
+ * \brief Set up the ordering of the LU-SGS sweeps
+ *
+ * Level scheduling keeps the element order of the serial sweeps: an
+ * element is in the level after the highest level of its lower (forward)
+ * or upper (backward) neighbors, and all elements of one level are
+ * independent. The multicolor ordering sweeps over the colors of a
+ * distance-1 coloring instead, which gives fewer and larger groups but a
+ * different and weaker preconditioner: on the cylinder case it needs 736
+ * Newton and 3680 GMRES iterations instead of 173 and 865.
+ */
+void createLUSGSordering(void)
+{
+	lusgsRank = dyn1DintArray(nElems);
+	int *group = malloc(nElems * sizeof(int));
+	if (!group) {
+		printf("| ERROR: could not allocate group\n");
+		exit(1);
+	}
+
+	switch (lusgsOrdering) {
+	case LUSGS_SERIAL:
+		printf("| LU-SGS: serial sweeps\n");
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			lusgsRank[iElem] = iElem;
+		}
+		break;
+	case LUSGS_LEVEL:
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			lusgsRank[iElem] = iElem;
+		}
+
+		/* forward levels */
+		nFwGroups = 0;
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			group[iElem] = 0;
+			for (long k = blockRowPtr[iElem] + 1; k < blockRowPtr[iElem + 1]; ++k) {
+				if ((blockCol[k] < iElem) && (group[blockCol[k]] >= group[iElem])) {
+					group[iElem] = group[blockCol[k]] + 1;
+				}
+			}
+			if (group[iElem] >= nFwGroups) {
+				nFwGroups = group[iElem] + 1;
+			}
+		}
+		sortByGroup(group, nFwGroups, &fwOffset, &fwElem);
+
+		/* backward levels */
+		nBwGroups = 0;
+		for (long iElem = nElems - 1; iElem >= 0; --iElem) {
+			group[iElem] = 0;
+			for (long k = blockRowPtr[iElem] + 1; k < blockRowPtr[iElem + 1]; ++k) {
+				if ((blockCol[k] > iElem) && (group[blockCol[k]] >= group[iElem])) {
+					group[iElem] = group[blockCol[k]] + 1;
+				}
+			}
+			if (group[iElem] >= nBwGroups) {
+				nBwGroups = group[iElem] + 1;
+			}
+		}
+		sortByGroup(group, nBwGroups, &bwOffset, &bwElem);
+
+		printf("| LU-SGS: level scheduling, %d forward and %d backward levels\n",
+				nFwGroups, nBwGroups);
+		break;
+	case LUSGS_MULTICOLOR:
+		nFwGroups = nBwGroups = colorElements(1, group);
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			lusgsRank[iElem] = group[iElem];
+		}
+		sortByGroup(group, nFwGroups, &fwOffset, &fwElem);
+
+		/* the backward sweep runs over the colors in reverse */
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			group[iElem] = nBwGroups - 1 - group[iElem];
+		}
+		sortByGroup(group, nBwGroups, &bwOffset, &bwElem);
+
+		printf("| LU-SGS: multicolor, %d colors\n", nFwGroups);
+		printf("| WARNING: The multicolor LU-SGS sweeps need about four times more Newton and GMRES iterations than the serial ones\n");
+		break;
+	default:
+		printf("| ERROR: Illegal LU-SGS ordering: %d\n", lusgsOrdering);
+		exit(1);
+	}
+
+	free(group);
+}
 
 /**
  * \brief Initialize linear solver
@@ -77,6 +394,14 @@ void initLinearSolver(void)
 		epsGMRES = getDbl("epsGMRES", "0.001");
 
 		rEps0 = sqrt(DBL_EPSILON);
+#ifdef FLOAT_FACES
+		/* without the fused residual the fluxes are calculated from the
+		 * single precision side states, which have to resolve the finite
+		 * difference step */
+		if (!useFusedResidual) {
+			rEps0 = sqrt(FLT_EPSILON);
+		}
+#endif
 		srEps0 = 1.0 / rEps0;
 
 		nNewtonIter = getInt("nNewtonIter", "20");
@@ -85,6 +410,9 @@ void initLinearSolver(void)
 		nGMRESiterGlobal = 0;
 		nInnerNewton = 0;
 		nInnerGMRES = 0;
+		nPrecondBuilds = 0;
+		nRestartsGlobal = 0;
+		nRestarts = getInt("nRestarts", "0");
 
 		gamEW = getDbl("gammaEW", "0.9");
 
@@ -93,16 +421,42 @@ void initLinearSolver(void)
 
 		usePrecond = getBool("precond", "F");
 		if (usePrecond) {
-			D = dyn3DdblArray(nElems, NVAR, NVAR);
-			Dinv = dyn3DdblArray(nElems, NVAR, NVAR);
-			deltaXstar = dyn2DdblArray(NVAR, nElems);
-			dRdU = dyn2DdblArray(NVAR * nElems, NVAR * nElems);
+			useAnalyticJacobian = getBool("analyticJacobian", "F");
+			if ((!useAnalyticJacobian) && (mpiSize > 1)) {
+				printf("| ERROR: Finite difference Jacobian not available with MPI, set analyticJacobian = T\n");
+				exit(1);
+			}
+			lusgsOrdering = getInt("lusgsOrdering", "0");
+			precondRebuild = getInt("precondRebuild", "1");
+			precondRebuildGMRES = getInt("precondRebuildGMRES", "0");
+			if (precondRebuild < 1) {
+				printf("| ERROR: precondRebuild must be at least 1\n");
+				exit(1);
+			}
+
+			Dinv = dyn3DkrylovArray(nElems, NVAR, NVAR);
+			deltaXstar = dyn2DkrylovArray(NVAR, nElems);
+			createBlockMatrix();
+			if (!useAnalyticJacobian) {
+				createColoring();
+			}
+			createLUSGSordering();
 		}
 
-		V = dyn3DdblArray(nKdim, NVAR, nElems);
-		Z = dyn3DdblArray(nKdim, NVAR, nElems);
+		V = dyn3DkrylovArray(nKdim, NVAR, nElems);
+		Z = dyn3DkrylovArray(nKdim, NVAR, nElems);
 		R0 = dyn2DdblArray(NVAR, nElems);
 		W = dyn2DdblArray(NVAR, nElems);
+
+#ifdef MIXED_PRECISION
+		printf("| Mixed Precision: single precision Krylov vectors and preconditioner\n");
+#endif
+#ifdef FLOAT_FACES
+		if (!useFusedResidual) {
+			printf("| WARNING: Single precision side states limit the accuracy of the\n");
+			printf("|          matrix free Jacobian to about 1e-4\n");
+		}
+#endif
 	}
 }
 
@@ -124,6 +478,30 @@ double vectorDotProduct(double **A, double **B)
 		res += A[E][iElem]   * B[E][iElem];
 	}
 
+	globalSum(&res, 1);
+	return res;
+}
+
+/**
+ * \brief Compute dot product of a Krylov vector A and a state vector B,
+ *	accumulated in double precision
+ * \param[in] A Krylov vector for every element
+ * \param[in] B State vector for every element
+ * \return sum(sum(A_ij * B_ij, i = RHO,MX,MY,E), i = 1..nElems)
+ */
+double krylovDotProduct(krylov_t **A, double **B)
+{
+	double res = 0.0;
+
+	#pragma omp parallel for reduction(+:res)
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		res += A[RHO][iElem] * B[RHO][iElem];
+		res += A[MX][iElem]  * B[MX][iElem];
+		res += A[MY][iElem]  * B[MY][iElem];
+		res += A[E][iElem]   * B[E][iElem];
+	}
+
+	globalSum(&res, 1);
 	return res;
 }
 
@@ -133,7 +511,7 @@ double vectorDotProduct(double **A, double **B)
  * \param[out] Ainv The 4x4 inverse matrix of A
  * \return 0 = Inverse does not exist, 1 = Inverse computed
  */
-bool calcDinv(double **A, double **Ainv)
+bool calcDinv(double A[NVAR][NVAR], double Ainv[NVAR][NVAR])
 {
 	double det = A[0][0]*(A[1][1]*(A[2][2]*A[3][3]-A[2][3]*A[3][2])
 		+A[1][2]*(A[2][3]*A[3][1]-A[2][1]*A[3][3])+A[1][3]*(A[2][1]
@@ -179,212 +557,349 @@ bool calcDinv(double **A, double **Ainv)
 }
 
 /**
- * \brief Compute the global Jacobian matrix by use of finite differences
- * \param[in] time Computation time at calculation
- * \param[in] dt Time step at calculation
+ * \brief Assemble the approximate analytic Jacobian of the first order
+ *	residual
+ *
+ * The face flux is linearized as a Rusanov flux, independent of the chosen
+ * flux function, and the dependence of the ghost cells on the inner state
+ * is neglected.
  */
-void buildMatrix(double time, double dt)
+void buildAnalyticJacobian(void)
 {
 	#pragma omp parallel for
-	for (long iElem = 0; iElem < NVAR * nElems; ++iElem) {
-		for (long jElem = 0; jElem < NVAR * nElems; ++jElem) {
-			dRdU[iElem][jElem] = 0.0;
-		}
-	}
-
 	for (long iElem = 0; iElem < nElems; ++iElem) {
-		elem_t *aElem = elem[iElem];
+		krylov_t **D = dRdU[blockRowPtr[iElem]];
 
-		for (int iVar = 0; iVar < NVAR; ++iVar) {
-			aElem->pVar[iVar] += rEps0;
-			fvTimeDerivative(time);
-			aElem->pVar[iVar] -= rEps0;
+		for (long j = elemData.sideOffset[iElem]; j < elemData.sideOffset[iElem + 1]; ++j) {
+			long iSide = elemData.sideIdx[j] / 2;
+			long lElem = sideData.elem[2 * iSide];
+			long rElem = sideData.elem[2 * iSide + 1];
 
-			for (int jVar = 0; jVar < NVAR; ++jVar) {
-				dRdU[iElem * NVAR + jVar][iVar + iElem * NVAR]
-					+= (aElem->u_t[jVar] - R_XK[jVar][iElem]) * srEps0;
+			double pVarL[NVAR], pVarR[NVAR];
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				pVarL[iVar] = elemData.pVar[iVar][lElem];
+				pVarR[iVar] = elemData.pVar[iVar][rElem];
+			}
+
+			double dFdUL[NVAR][NVAR], dFdUR[NVAR][NVAR];
+			fluxJacobian(iSide, pVarL, pVarR, dFdUL, dFdUR);
+
+			/* the flux leaves the left and enters the right element */
+			double (*dFdUself)[NVAR], (*dFdUnb)[NVAR], sign;
+			if (lElem == iElem) {
+				dFdUself = dFdUL;
+				dFdUnb = dFdUR;
+				sign = - elemData.areaq[iElem];
+			} else {
+				dFdUself = dFdUR;
+				dFdUnb = dFdUL;
+				sign = elemData.areaq[iElem];
 			}
 
-			side_t *aSide = aElem->firstSide;
-			while (aSide) {
-				if ((aSide->connection->elem->id >=0)
-						&& (aSide->connection->elem->id) < nElems) {
-					long jElem = aSide->connection->elem->id;
-					elem_t *bElem = elem[jElem];
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				for (int jVar = 0; jVar < NVAR; ++jVar) {
+					D[iVar][jVar] += sign * dFdUself[iVar][jVar];
+				}
+			}
 
+			if (sideBlock[j] >= 0) {
+				krylov_t **block = dRdU[sideBlock[j]];
+				for (int iVar = 0; iVar < NVAR; ++iVar) {
 					for (int jVar = 0; jVar < NVAR; ++jVar) {
-						dRdU[jElem * NVAR + jVar][iVar + iElem * NVAR]
-							+= (bElem->u_t[jVar] - R_XK[jVar][jElem]) * srEps0;
+						block[iVar][jVar] += sign * dFdUnb[iVar][jVar];
 					}
 				}
-
-				aSide = aSide->nextElemSide;
 			}
 		}
 	}
+}
+
+/**
+ * \brief Compute the global Jacobian matrix by use of colored finite
+ *	differences or the approximate analytic Jacobian, each row is scaled
+ *	with the time step of its element
+ * \param[in] time Computation time at calculation
+ */
+void buildMatrix(double time)
+{
+	double tic = CPU_TIME();
+	long nBlocks = blockRowPtr[nElems];
 
 	#pragma omp parallel for
-	for (long iElem = 0; iElem < NVAR * nElems; ++iElem) {
-		for (long jElem = 0; jElem < NVAR * nElems; ++jElem) {
-			dRdU[iElem][jElem] *= - dt;
+	for (long iBlock = 0; iBlock < nBlocks; ++iBlock) {
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			for (int jVar = 0; jVar < NVAR; ++jVar) {
+				dRdU[iBlock][iVar][jVar] = 0.0;
+			}
 		}
+	}
+
+	if (useAnalyticJacobian) {
+		buildAnalyticJacobian();
+	} else {
+		/* perturb all elements of one color at once */
+		for (int iColor = 0; iColor < nColors; ++iColor) {
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				#pragma omp parallel for
+				for (long i = colorOffset[iColor]; i < colorOffset[iColor + 1]; ++i) {
+					long iElem = colorElem[i];
+					pVarUnperturbed[iElem] = elemData.pVar[iVar][iElem];
+					elemData.pVar[iVar][iElem] += rEps0;
+				}
+
+				fvTimeDerivative(time);
 
-		dRdU[iElem][iElem] += 1.0;
+				#pragma omp parallel for
+				for (long i = colorOffset[iColor]; i < colorOffset[iColor + 1]; ++i) {
+					long iElem = colorElem[i];
+					elemData.pVar[iVar][iElem] = pVarUnperturbed[iElem];
+
+					/* column iElem of the rows of iElem and its neighbors */
+					for (long k = blockRowPtr[iElem]; k < blockRowPtr[iElem + 1]; ++k) {
+						long jElem = blockCol[k];
+						krylov_t **block = dRdU[blockTrans[k]];
+
+						for (int jVar = 0; jVar < NVAR; ++jVar) {
+							block[jVar][iVar]
+								+= (elemData.u_t[jVar][jElem] - R_XK[jVar][jElem]) * srEps0;
+						}
+					}
+				}
+			}
+		}
 	}
 
 	#pragma omp parallel for
 	for (long iElem = 0; iElem < nElems; ++iElem) {
-		long r = iElem * NVAR;
+		double dt = elemData.dt[iElem];
+		for (long k = blockRowPtr[iElem]; k < blockRowPtr[iElem + 1]; ++k) {
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				for (int jVar = 0; jVar < NVAR; ++jVar) {
+					dRdU[k][iVar][jVar] *= - dt;
+				}
+			}
+		}
 
+		/* diagonal block, always inverted in double precision */
+		krylov_t **D = dRdU[blockRowPtr[iElem]];
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			D[iVar][iVar] += 1.0;
+		}
+
+		double A[NVAR][NVAR], Ainv[NVAR][NVAR];
 		for (int iVar = 0; iVar < NVAR; ++iVar) {
 			for (int jVar = 0; jVar < NVAR; ++jVar) {
-				D[iElem][iVar][jVar] = dRdU[r + iVar][r + jVar];
+				A[iVar][jVar] = D[iVar][jVar];
 			}
 		}
 
-		bool isOK = calcDinv(D[iElem], Dinv[iElem]);
+		bool isOK = calcDinv(A, Ainv);
 		if (!isOK) {
 			printf("| LUSGS D-Matrix is singular at Element %ld\n", iElem);
 			exit(1);
 		}
 
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			for (int jVar = 0; jVar < NVAR; ++jVar) {
+				Dinv[iElem][iVar][jVar] = Ainv[iVar][jVar];
+			}
+		}
 	}
+	timerAdd(TIMER_MATRIX, &tic);
 }
 
 /**
- * \brief LUSGS preconditioner
+ * \brief LUSGS forward sweep for one element
+ * \param[in] iElem Element ID
  * \param[in] B Old vector, to be preconditioned
- * \param[out] delX Preconditioned vector
- * \note This function is slow to execute, it might be possible to speed it up
- *	via the use of omp locks for every element
  */
-void LUSGS(double **B, double **delX)
+void LUSGSforward(long iElem, krylov_t **B)
 {
-	#pragma omp parallel for
-	for (long iElem = 0; iElem < nElems; ++iElem) {
-		for (int iVar = 0; iVar < NVAR; ++iVar) {
-			delX[iVar][iElem] = 0.0;
-			deltaXstar[iVar][iElem] = 0.0;
+	double tmp1[NVAR] = {0.0};
+	for (long k = blockRowPtr[iElem] + 1; k < blockRowPtr[iElem + 1]; ++k) {
+		long NBelemID = blockCol[k];
+		if (lusgsRank[NBelemID] < lusgsRank[iElem]) {
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				for (int jVar = 0; jVar < NVAR; ++jVar) {
+					tmp1[iVar] += dRdU[k][iVar][jVar]
+						* deltaXstar[jVar][NBelemID];
+				}
+			}
 		}
 	}
 
-	/* forward sweep */
-	for (long iElem = 0; iElem < nElems; ++iElem) {
-		elem_t *aElem = elem[iElem];
-		side_t *aSide = aElem->firstSide;
-
-		double tmp1[NVAR] = {0.0};
-		while (aSide) {
-			long NBelemID = aSide->connection->elem->id;
-			if ((NBelemID >= 0) && (NBelemID < iElem)) {
-				long r = iElem * NVAR;
-				long s = NBelemID * NVAR;
-				for (int iVar = 0; iVar < NVAR; ++iVar) {
-					for (int jVar = 0; jVar < NVAR; ++jVar) {
-						tmp1[iVar] += dRdU[r + iVar][s + jVar]
-							* deltaXstar[jVar][NBelemID];
-					}
+	double tmp2[NVAR] = {0.0};
+	for (int iVar = 0; iVar < NVAR; ++iVar) {
+		for (int jVar = 0; jVar < NVAR; ++jVar) {
+			tmp2[iVar] += Dinv[iElem][iVar][jVar]
+				* (B[jVar][iElem] - tmp1[jVar]);
+		}
+		deltaXstar[iVar][iElem] = tmp2[iVar];
+	}
+}
+
+/**
+ * \brief LUSGS backward sweep for one element
+ * \param[in] iElem Element ID
+ * \param[out] delX Preconditioned vector
+ */
+void LUSGSbackward(long iElem, krylov_t **delX)
+{
+	double tmp1[NVAR] = {0.0};
+	for (long k = blockRowPtr[iElem] + 1; k < blockRowPtr[iElem + 1]; ++k) {
+		long NBelemID = blockCol[k];
+		if (lusgsRank[NBelemID] > lusgsRank[iElem]) {
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				for (int jVar = 0; jVar < NVAR; ++jVar) {
+					tmp1[iVar] += dRdU[k][iVar][jVar]
+						* delX[jVar][NBelemID];
 				}
 			}
+		}
+	}
 
-			aSide = aSide->nextElemSide;
+	double tmp2[NVAR] = {0.0};
+	for (int iVar = 0; iVar < NVAR; ++iVar) {
+		for (int jVar = 0; jVar < NVAR; ++jVar) {
+			tmp2[iVar] += Dinv[iElem][iVar][jVar]* tmp1[jVar];
 		}
+		delX[iVar][iElem] = deltaXstar[iVar][iElem] - tmp2[iVar];
+	}
+}
 
-		double tmp2[NVAR] = {0.0};
+/**
+ * \brief LUSGS preconditioner
+ * \param[in] B Old vector, to be preconditioned
+ * \param[out] delX Preconditioned vector
+ * \note With level scheduled or multicolor ordering the elements of each
+ *	group are swept in parallel
+ */
+void LUSGS(krylov_t **B, krylov_t **delX)
+{
+	double tic = CPU_TIME();
+	#pragma omp parallel for
+	for (long iElem = 0; iElem < nElems; ++iElem) {
 		for (int iVar = 0; iVar < NVAR; ++iVar) {
-			for (int jVar = 0; jVar < NVAR; ++jVar) {
-				tmp2[iVar] += Dinv[iElem][iVar][jVar]
-					* (B[jVar][iElem] - tmp1[jVar]);
-			}
-			deltaXstar[iVar][iElem] = tmp2[iVar];
+			delX[iVar][iElem] = 0.0;
+			deltaXstar[iVar][iElem] = 0.0;
 		}
 	}
 
-	/* backwards sweep */
-	for (long iElem = nElems - 1; iElem >= 0; --iElem) {
-		elem_t *aElem = elem[iElem];
-		side_t *aSide = aElem->firstSide;
+	if (lusgsOrdering == LUSGS_SERIAL) {
+		/* forward sweep */
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			LUSGSforward(iElem, B);
+		}
 
-		double tmp1[NVAR] = {0.0};
-		while (aSide) {
-			long NBelemID = aSide->connection->elem->id;
-			if ((NBelemID > iElem) && (NBelemID < nElems)) {
-				long r = iElem * NVAR;
-				long s = NBelemID * NVAR;
-				for (int iVar = 0; iVar < NVAR; ++iVar) {
-					for (int jVar = 0; jVar < NVAR; ++jVar) {
-						tmp1[iVar] += dRdU[r + iVar][s + jVar]
-							* delX[jVar][NBelemID];
-					}
-				}
+		/* backwards sweep */
+		for (long iElem = nElems - 1; iElem >= 0; --iElem) {
+			LUSGSbackward(iElem, delX);
+		}
+	} else {
+		/* forward sweep */
+		for (int iGroup = 0; iGroup < nFwGroups; ++iGroup) {
+			#pragma omp parallel for
+			for (long i = fwOffset[iGroup]; i < fwOffset[iGroup + 1]; ++i) {
+				LUSGSforward(fwElem[i], B);
 			}
-
-			aSide = aSide->nextElemSide;
 		}
 
-		double tmp2[NVAR] = {0.0};
-		for (int iVar = 0; iVar < NVAR; ++iVar) {
-			for (int jVar = 0; jVar < NVAR; ++jVar) {
-				tmp2[iVar] += Dinv[iElem][iVar][jVar]* tmp1[jVar];
+		/* backwards sweep */
+		for (int iGroup = 0; iGroup < nBwGroups; ++iGroup) {
+			#pragma omp parallel for
+			for (long i = bwOffset[iGroup]; i < bwOffset[iGroup + 1]; ++i) {
+				LUSGSbackward(bwElem[i], delX);
 			}
-			delX[iVar][iElem] = deltaXstar[iVar][iElem] - tmp2[iVar];
 		}
 	}
+	timerAdd(TIMER_LUSGS, &tic);
 }
 
 /**
- * \brief Computes matrix vector product using spatial operator and finite differences
+ * \brief Computes matrix vector product using spatial operator and finite
+ *	differences, with the time steps of the elements
  * \param[in] time Computation time at calculation
- * \param[in] dt Time step at calculation
  * \param[in] alpha Relaxation parameter
  * \param[in] v Input vector for the matrix vector product
  * \param[out] res Resulting vector of the matrix vector product
  */
-void matrixVector(double time, double dt, double alpha, double **v,
-		double **res)
+void matrixVector(double time, double alpha, krylov_t **v, double **res)
 {
 	/* prerequisites for FD matrix vector approximation */
-	double epsFD = vectorDotProduct(v, v);
+	double epsFD = 0.0;
+	#pragma omp parallel for reduction(+:epsFD)
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		epsFD += (double)v[RHO][iElem] * v[RHO][iElem];
+		epsFD += (double)v[MX][iElem]  * v[MX][iElem];
+		epsFD += (double)v[MY][iElem]  * v[MY][iElem];
+		epsFD += (double)v[E][iElem]   * v[E][iElem];
+	}
+	globalSum(&epsFD, 1);
 	epsFD = rEps0 / sqrt(epsFD);
 
 	#pragma omp parallel for
 	for (long iElem = 0; iElem < nElems; ++iElem) {
-		elem_t *aElem = elem[iElem];
-
-		aElem->cVar[RHO] = XK[RHO][iElem] + epsFD * v[RHO][iElem];
-		aElem->cVar[MX]  = XK[MX][iElem]  + epsFD * v[MX][iElem];
-		aElem->cVar[MY]  = XK[MY][iElem]  + epsFD * v[MY][iElem];
-		aElem->cVar[E]   = XK[E][iElem]   + epsFD * v[E][iElem];
+		elemData.cVar[RHO][iElem] = XK[RHO][iElem] + epsFD * v[RHO][iElem];
+		elemData.cVar[MX][iElem]  = XK[MX][iElem]  + epsFD * v[MX][iElem];
+		elemData.cVar[MY][iElem]  = XK[MY][iElem]  + epsFD * v[MY][iElem];
+		elemData.cVar[E][iElem]   = XK[E][iElem]   + epsFD * v[E][iElem];
 
-		consPrim(aElem->cVar, aElem->pVar);
+		consPrimElem(iElem);
 	}
 
 	fvTimeDerivative(time);
 
 	#pragma omp parallel for
 	for (long iElem = 0; iElem < nElems; ++iElem) {
-		elem_t *aElem = elem[iElem];
+		double dt = elemData.dt[iElem];
+		res[RHO][iElem] = v[RHO][iElem] - alpha * dt * (elemData.u_t[RHO][iElem] - R_XK[RHO][iElem]) / epsFD;
+		res[MX][iElem]  = v[MX][iElem]  - alpha * dt * (elemData.u_t[MX][iElem]  - R_XK[MX][iElem])  / epsFD;
+		res[MY][iElem]  = v[MY][iElem]  - alpha * dt * (elemData.u_t[MY][iElem]  - R_XK[MY][iElem])  / epsFD;
+		res[E][iElem]   = v[E][iElem]   - alpha * dt * (elemData.u_t[E][iElem]   - R_XK[E][iElem])   / epsFD;
+	}
+}
 
-		res[RHO][iElem] = v[RHO][iElem] - alpha * dt * (aElem->u_t[RHO] - R_XK[RHO][iElem]) / epsFD;
-		res[MX][iElem]  = v[MX][iElem]  - alpha * dt * (aElem->u_t[MX]  - R_XK[MX][iElem])  / epsFD;
-		res[MY][iElem]  = v[MY][iElem]  - alpha * dt * (aElem->u_t[MY]  - R_XK[MY][iElem])  / epsFD;
-		res[E][iElem]   = v[E][iElem]   - alpha * dt * (aElem->u_t[E]   - R_XK[E][iElem])   / epsFD;
+/**
+ * \brief Decide if the preconditioner has to be rebuilt and build it
+ *
+ * The preconditioner is kept frozen over several linear solves, i.e. Newton
+ * iterations and time steps. It is rebuilt after `precondRebuild` solves or
+ * as soon as the last solve needed more than `precondRebuildGMRES` GMRES
+ * iterations.
+ */
+void updatePrecond(void)
+{
+	if ((nPrecondBuilds == 0) || (nSolvesSinceBuild >= precondRebuild)
+			|| ((precondRebuildGMRES > 0) && (nLastGMRES > precondRebuildGMRES))) {
+		double tic = CPU_TIME();
+		buildMatrix(t);
+		tBuild += CPU_TIME() - tic;
+
+		nPrecondBuilds++;
+		nSolvesSinceBuild = 0;
 	}
+
+	nSolvesSinceBuild++;
 }
 
 /**
  * \brief Uses matrix free to solve the linear system
+ *
+ * The preconditioned vectors are stored, which makes this a flexible GMRES,
+ * since the preconditioner may change between the iterations. If the Krylov
+ * space is exhausted the iteration is restarted up to `nRestarts` times with
+ * the current solution.
  * \param[in] time Computation time at calculation
- * \param[in] dt Time step at calculation
  * \param[in] alpha Relaxation parameter
  * \param[in] B Right hand side
  * \param[in] normB Norm of right hand side
  * \param[in,out] abortCrit GMRES abort criterium
  * \param[out] delX Resulting x vector of the linear system
  */
-void GMRES_M(double time, double dt, double alpha, double **B,
-		double normB, double *abortCrit, double **delX)
+void GMRES_M(double time, double alpha, double **B, double normB,
+		double *abortCrit, double **delX)
 {
+	double ticGMRES = CPU_TIME();
 	*abortCrit = epsGMRES * normB;
 
 	double normR0 = normB;
@@ -400,105 +915,150 @@ void GMRES_M(double time, double dt, double alpha, double **B,
 		delX[MX][iElem]  = 0.0;
 		delX[MY][iElem]  = 0.0;
 		delX[E][iElem]   = 0.0;
-
-		V[0][RHO][iElem] = R0[RHO][iElem] / normR0;
-		V[0][MX][iElem]  = R0[MX][iElem]  / normR0;
-		V[0][MY][iElem]  = R0[MY][iElem]  / normR0;
-		V[0][E][iElem]   = R0[E][iElem]   / normR0;
 	}
 
 	nInnerGMRES = 0;
 
 	double gam[nKdim + 1];
-	gam[0] = normR0;
 
-	int m;
+	int m = 0;
 	double H[nKdim + 1][nKdim + 1], C[nKdim], S[nKdim];
 
 	if (usePrecond) {
-		buildMatrix(t, dt);
+		updatePrecond();
 	}
 
-	for (m = 0; m < nKdim; ++m) {
-		nInnerGMRES++;
-
-		if (usePrecond) {
-			LUSGS(V[m], Z[m]);
-		} else {
+	for (int iRestart = 0; iRestart <= nRestarts; ++iRestart) {
+		if (iRestart > 0) {
+			/* residual of the current solution, which is rounded to
+			 * the precision of the Krylov vectors */
 			#pragma omp parallel for
 			for (long iElem = 0; iElem < nElems; ++iElem) {
-				Z[m][RHO][iElem] = V[m][RHO][iElem];
-				Z[m][MX][iElem]  = V[m][MX][iElem];
-				Z[m][MY][iElem]  = V[m][MY][iElem];
-				Z[m][E][iElem]   = V[m][E][iElem];
+				Z[0][RHO][iElem] = delX[RHO][iElem];
+				Z[0][MX][iElem]  = delX[MX][iElem];
+				Z[0][MY][iElem]  = delX[MY][iElem];
+				Z[0][E][iElem]   = delX[E][iElem];
 			}
-		}
-
-		matrixVector(time, dt, alpha, Z[m], W);
 
-		/* Gram-Schmidt */
-		for (int nn = 0; nn <= m; ++nn) {
-			H[nn][m] = vectorDotProduct(V[nn], W);
+			double tic = CPU_TIME();
+			matrixVector(time, alpha, Z[0], W);
+			tMatVec += CPU_TIME() - tic;
 
 			#pragma omp parallel for
-			for (int iElem = 0; iElem < nElems; ++iElem) {
-				W[RHO][iElem] -= H[nn][m] * V[nn][RHO][iElem];
-				W[MX][iElem]  -= H[nn][m] * V[nn][MX][iElem];
-				W[MY][iElem]  -= H[nn][m] * V[nn][MY][iElem];
-				W[E][iElem]   -= H[nn][m] * V[nn][E][iElem];
+			for (long iElem = 0; iElem < nElems; ++iElem) {
+				R0[RHO][iElem] = - B[RHO][iElem] - W[RHO][iElem];
+				R0[MX][iElem]  = - B[MX][iElem]  - W[MX][iElem];
+				R0[MY][iElem]  = - B[MY][iElem]  - W[MY][iElem];
+				R0[E][iElem]   = - B[E][iElem]   - W[E][iElem];
 			}
-		}
 
-		double res = vectorDotProduct(W, W);
-
-		H[m + 1][m] = sqrt(res);
+			normR0 = sqrt(vectorDotProduct(R0, R0));
+			nRestartsGlobal++;
+		}
 
-		/* Givens rotation */
-		for (int nn = 0; nn <= m - 1; ++nn) {
-			double tmp   = C[nn] * H[nn][m] + S[nn] * H[nn + 1][m];
-			H[nn + 1][m] = - S[nn] * H[nn][m] + C[nn] * H[nn + 1][m];
-			H[nn][m]     = tmp;
+		#pragma omp parallel for
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			V[0][RHO][iElem] = R0[RHO][iElem] / normR0;
+			V[0][MX][iElem]  = R0[MX][iElem]  / normR0;
+			V[0][MY][iElem]  = R0[MY][iElem]  / normR0;
+			V[0][E][iElem]   = R0[E][iElem]   / normR0;
 		}
 
-		double bet = sqrt(H[m][m] * H[m][m] + H[m + 1][m] * H[m + 1][m]);
-		S[m] = H[m + 1][m] / bet;
-		C[m] = H[m][m] / bet;
-		H[m][m] = bet;
-		gam[m + 1] = - S[m] * gam[m];
-		gam[m] = C[m] * gam[m];
+		gam[0] = normR0;
 
-		if ((fabs(gam[m + 1]) <= *abortCrit) || (m == nKdim - 1)) {
-			double alp[nKdim];
-			for (int nn = m; nn >= 0; --nn) {
-				alp[nn] = gam[nn];
+		for (m = 0; m < nKdim; ++m) {
+			nInnerGMRES++;
 
-				for (int o = nn + 1; o <= m; ++o) {
-					alp[nn] -= H[nn][o] * alp[o];
+			double tic = CPU_TIME();
+			if (usePrecond) {
+				LUSGS(V[m], Z[m]);
+			} else {
+				#pragma omp parallel for
+				for (long iElem = 0; iElem < nElems; ++iElem) {
+					Z[m][RHO][iElem] = V[m][RHO][iElem];
+					Z[m][MX][iElem]  = V[m][MX][iElem];
+					Z[m][MY][iElem]  = V[m][MY][iElem];
+					Z[m][E][iElem]   = V[m][E][iElem];
 				}
-
-				alp[nn] /= H[nn][nn];
 			}
+			tPrecond += CPU_TIME() - tic;
+
+			tic = CPU_TIME();
+			matrixVector(time, alpha, Z[m], W);
+			tMatVec += CPU_TIME() - tic;
 
+			/* Gram-Schmidt */
 			for (int nn = 0; nn <= m; ++nn) {
+				H[nn][m] = krylovDotProduct(V[nn], W);
+
 				#pragma omp parallel for
-				for (long iElem = 0; iElem < nElems; ++iElem) {
-					delX[RHO][iElem] += alp[nn] * Z[nn][RHO][iElem];
-					delX[MX][iElem]  += alp[nn] * Z[nn][MX][iElem];
-					delX[MY][iElem]  += alp[nn] * Z[nn][MY][iElem];
-					delX[E][iElem]   += alp[nn] * Z[nn][E][iElem];
+				for (int iElem = 0; iElem < nElems; ++iElem) {
+					W[RHO][iElem] -= H[nn][m] * V[nn][RHO][iElem];
+					W[MX][iElem]  -= H[nn][m] * V[nn][MX][iElem];
+					W[MY][iElem]  -= H[nn][m] * V[nn][MY][iElem];
+					W[E][iElem]   -= H[nn][m] * V[nn][E][iElem];
 				}
 			}
-			nGMRESiterGlobal += nInnerGMRES;
 
-			return;
-		} else {
-			/* no convergence, next iteration */
-			#pragma omp parallel for
-			for (long iElem = 0; iElem < nElems; ++iElem) {
-				V[m + 1][RHO][iElem] = W[RHO][iElem] / H[m + 1][m];
-				V[m + 1][MX][iElem]  = W[MX][iElem]  / H[m + 1][m];
-				V[m + 1][MY][iElem]  = W[MY][iElem]  / H[m + 1][m];
-				V[m + 1][E][iElem]   = W[E][iElem]   / H[m + 1][m];
+			double res = vectorDotProduct(W, W);
+
+			H[m + 1][m] = sqrt(res);
+
+			/* Givens rotation */
+			for (int nn = 0; nn <= m - 1; ++nn) {
+				double tmp   = C[nn] * H[nn][m] + S[nn] * H[nn + 1][m];
+				H[nn + 1][m] = - S[nn] * H[nn][m] + C[nn] * H[nn + 1][m];
+				H[nn][m]     = tmp;
+			}
+
+			double bet = sqrt(H[m][m] * H[m][m] + H[m + 1][m] * H[m + 1][m]);
+			S[m] = H[m + 1][m] / bet;
+			C[m] = H[m][m] / bet;
+			H[m][m] = bet;
+			gam[m + 1] = - S[m] * gam[m];
+			gam[m] = C[m] * gam[m];
+
+			bool isConverged = (fabs(gam[m + 1]) <= *abortCrit);
+			if (isConverged || (m == nKdim - 1)) {
+				double alp[nKdim];
+				for (int nn = m; nn >= 0; --nn) {
+					alp[nn] = gam[nn];
+
+					for (int o = nn + 1; o <= m; ++o) {
+						alp[nn] -= H[nn][o] * alp[o];
+					}
+
+					alp[nn] /= H[nn][nn];
+				}
+
+				for (int nn = 0; nn <= m; ++nn) {
+					#pragma omp parallel for
+					for (long iElem = 0; iElem < nElems; ++iElem) {
+						delX[RHO][iElem] += alp[nn] * Z[nn][RHO][iElem];
+						delX[MX][iElem]  += alp[nn] * Z[nn][MX][iElem];
+						delX[MY][iElem]  += alp[nn] * Z[nn][MY][iElem];
+						delX[E][iElem]   += alp[nn] * Z[nn][E][iElem];
+					}
+				}
+
+				/* without restarts the solution of the full Krylov
+				 * space is accepted */
+				if (isConverged || (iRestart == nRestarts)) {
+					nGMRESiterGlobal += nInnerGMRES;
+					nLastGMRES = nInnerGMRES;
+
+					timerAdd(TIMER_GMRES, &ticGMRES);
+					return;
+				}
+			} else {
+				/* no convergence, next iteration */
+				#pragma omp parallel for
+				for (long iElem = 0; iElem < nElems; ++iElem) {
+					V[m + 1][RHO][iElem] = W[RHO][iElem] / H[m + 1][m];
+					V[m + 1][MX][iElem]  = W[MX][iElem]  / H[m + 1][m];
+					V[m + 1][MY][iElem]  = W[MY][iElem]  / H[m + 1][m];
+					V[m + 1][E][iElem]   = W[E][iElem]   / H[m + 1][m];
+				}
 			}
 		}
 	}
@@ -509,6 +1069,35 @@ void GMRES_M(double time, double dt, double alpha, double **B,
 	exit(1);
 }
 
+/**
+ * \brief Print the statistics of the linear solver
+ * \param[in] tTotal Total computation time
+ */
+void printLinearSolverStats(double tTotal)
+{
+	printf("| Newton Iterations: %d\n", nNewtonIterGlobal);
+	printf("| GMRES Iterations : %d", nGMRESiterGlobal);
+	if (nNewtonIterGlobal > 0) {
+		printf(" (%.3g per Newton iteration)", (double)nGMRESiterGlobal / nNewtonIterGlobal);
+	}
+	printf("\n");
+
+	if (nRestarts > 0) {
+		printf("| GMRES Restarts   : %d\n", nRestartsGlobal);
+	}
+
+	if (usePrecond) {
+		printf("| Precond. Builds  : %d\n", nPrecondBuilds);
+		printf("|   %-20s: %6.2f %%, %.6g s\n", "Precond. Build",
+				100.0 * tBuild / tTotal, tBuild);
+		printf("|   %-20s: %6.2f %%, %.6g s\n", "Precond. Apply",
+				100.0 * tPrecond / tTotal, tPrecond);
+	}
+
+	printf("|   %-20s: %6.2f %%, %.6g s\n", "Matrix Vector",
+			100.0 * tMatVec / tTotal, tMatVec);
+}
+
 /**
  * \brief Free all memory that was allocated for
  */
@@ -524,9 +1113,26 @@ void freeLinearSolver(void)
 
 		if (usePrecond) {
 			free(deltaXstar);
-			free(D);
 			free(Dinv);
+			free(blockRowPtr);
+			free(blockCol);
+			free(blockTrans);
+			free(sideBlock);
 			free(dRdU);
+
+			if (!useAnalyticJacobian) {
+				free(colorOffset);
+				free(colorElem);
+				free(pVarUnperturbed);
+			}
+
+			free(lusgsRank);
+			if (lusgsOrdering != LUSGS_SERIAL) {
+				free(fwOffset);
+				free(fwElem);
+				free(bwOffset);
+				free(bwElem);
+			}
 		}
 	}
 }
@@ -22,6 +22,8 @@ extern int nInnerNewton;
 
 extern int nInnerGMRES;
 
+extern int nPrecondBuilds;
+
 extern bool usePrecond;
 
 extern double rEps0;
@@ -38,8 +40,9 @@ extern double **R_XK;
 
 void initLinearSolver(void);
 double vectorDotProduct(double **A, double **B);
-void GMRES_M(double time, double dt, double alpha, double **B,
-		double normB, double *abortCrit, double **deltaX);
+void GMRES_M(double time, double alpha, double **B, double normB,
+		double *abortCrit, double **deltaX);
+void printLinearSolverStats(double tTotal);
 void freeLinearSolver(void);
 
 #endif
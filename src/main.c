@@ -19,8 +19,18 @@
 #include "mesh.h"
 #include "initialCondition.h"
 #include "finiteVolume.h"
+#include "reconstruction.h"
+#include "multigrid.h"
 #include "linearSolver.h"
 #include "analyze.h"
+#include "parallel.h"
+#include "checkpoint.h"
+#include "timer.h"
+#include "device.h"
+#include "insitu.h"
+#include "meshAdaptation.h"
+#include "meshSequencing.h"
+#include "batch.h"
 
 /** \brief Main function
  *
@@ -28,12 +38,26 @@
  * variables and initializing the time discretization loop. The function
  * finishes by deallocating all the allocated memory.
  *
+ * In batch mode, `ccfd case.ini -batch variant1.ini variant2.ini ...`, the
+ * variants are calculated one after another. Every variant consists of the
+ * parameters of `case.ini`, overridden by the parameters of its own file. The
+ * mesh and its geometry are only built for the first variant and kept for
+ * all following ones. With `batchJobs > 1` the time stepping of the
+ * variants runs concurrently in child processes, which share the mesh of
+ * the main process and split its threads, see `batch.c`.
+ *
+ * With mesh sequencing, every variant is calculated in stages on a series of
+ * meshes, from the coarsest one to the actual mesh, so the mesh is built
+ * anew for every stage.
+ *
  * \param[in] argc The number of command line arguments passed to `main`
  * \param[in] argv The argument vector containing the command line arguments
  * \return 0 = Success, 1 = Error during execution
  */
 int main(int argc, char *argv[])
 {
+	initParallel(&argc, &argv);
+
 	printf("=============================================================\n");
 	printf("                            C C F D                          \n");
 	printf("=============================================================\n");
@@ -49,12 +73,33 @@ int main(int argc, char *argv[])
 	printf("           Recreated in C by Heinz Heinrich Heinzer          \n");
 	printf("=============================================================\n");
 
+	if (argc < 2) {
+		printf("ERROR: Wrong number of arguments, must be 1 or 2\n");
+		exit(1);
+	}
+
+	/* check for batch mode */
+	int nVariants = 0;
+	char **variantFile = NULL;
+	if ((argc > 2) && !strcmp(argv[2], "-batch")) {
+		nVariants = argc - 3;
+		variantFile = argv + 3;
+		if (nVariants < 1) {
+			printf("ERROR: Batch mode needs at least one variant file\n");
+			exit(1);
+		}
+	}
+
 	/* read parameter file and make the command list */
 	fillCmds(argv[1]);
+	if (nVariants > 0) {
+		printf("\nBatch Variant 1 of %d:\n", nVariants);
+		overrideCmds(variantFile[0]);
+	}
 	isStationary = getBool("stationary", "T");
 
 	/* check command line arguments */
-	switch (argc) {
+	switch ((nVariants > 0) ? 2 : argc) {
 	case 2:
 		/* no restart required */
 		isRestart = false;
@@ -75,6 +120,13 @@ int main(int argc, char *argv[])
 		}
 		fclose(restartFile);
 
+		/* the checkpoint holds time and iteration itself */
+		if (isCheckpoint(restartFileName)) {
+			iniIterationNumber = 0;
+			startTime = 0.0;
+			break;
+		}
+
 		/* get restart time */
 		char *string = strstr(restartFileName, "_") + 1;
 		while (strstr(string, "_")) {
@@ -97,34 +149,99 @@ int main(int argc, char *argv[])
 		exit(1);
 	}
 
-	/* initialization routines */
-	initOutput();
-	initEquation();
-	initBoundary();
-	initMesh();
-	initInitialCondition();
-	initFV();
-	initTimeDisc();
-	initLinearSolver();
-	outputTimes = NULL;
+	bool hasMesh = false;
+	for (int iVariant = 0; iVariant < ((nVariants > 0) ? nVariants : 1); ++iVariant) {
+		int iStage = 0;
+		bool isStarted = false;
+		do {
+			if ((iVariant > 0) || (iStage > 0)) {
+				fillCmds(argv[1]);
+				if (nVariants > 0) {
+					printf("\nBatch Variant %d of %d:\n", iVariant + 1, nVariants);
+					overrideCmds(variantFile[iVariant]);
+				}
+				isStationary = getBool("stationary", "T");
+			}
+
+			/* initialization routines */
+			initBatch(nVariants);
+			initSequencing(iStage);
+			initOutput();
+			initEquation();
+			if ((iVariant == 0) && (iStage == 0)) {
+				initBoundary();
+			} else {
+				updateBoundary();
+			}
+			if (hasMesh && (nSequenceStages == 1)) {
+				reuseMesh();
+			} else {
+				/* every stage of the mesh sequencing has its own mesh */
+				if (hasMesh) {
+					freeMesh();
+				}
+				initMesh();
+				hasMesh = true;
+			}
+			initInitialCondition();
+			initFV();
+			initTimeDisc();
+			limitSequenceStage();
+			initLinearSolver();
+			initMultigrid();
+			initCheckpoint();
+			initTimers();
+			initAdaptation();
+			outputTimes = NULL;
+
+			/* setting initial condition, on a mesh refined towards it */
+			setInitialCondition();
+			adaptInitialCondition();
 
-	/* setting initial condition */
-	setInitialCondition();
+			/* initialize c_a, c_w, and c_p calculation as well as record points */
+			initAnalyze();
 
-	/* initialize c_a, c_w, and c_p calculation as well as record points */
-	initAnalyze();
+			/* load the in situ visualization pipeline */
+			initCatalyst();
 
-	/* print ignored commands */
-	ignoredCmds();
+			/* copy the solution and the mesh to the accelerator */
+			initDevice();
 
-	/* start time stepping routine */
-	timeDisc();
+			/* print ignored commands */
+			ignoredCmds();
 
-	/* clean that memory, like you should */
-	freeMesh();
+			/* start time stepping routine, a concurrent variant is
+			 * calculated with all its stages by a child process */
+			if ((iStage == 0) && startBatchJob()) {
+				isStarted = true;
+			} else {
+				timeDisc();
+				finishSequenceStage();
+			}
+
+			/* clean that memory, like you should, the mesh is kept for the
+			 * next variant */
+			freeAdaptation();
+			freeCatalyst();
+			freeDevice();
+			freeMultigrid();
+			freeOutputTimes();
+			freeInitialCondition();
+			freeAnalyze();
+			freeReconstruction();
+			freeLinearSolver();
+			freeTimers();
+		} while (!isStarted && (++iStage < nSequenceStages));
+
+		if (isBatchJob) {
+			break;
+		}
+	}
+	finishBatch();
+
+	if (hasMesh) {
+		freeMesh();
+	}
 	freeBoundary();
-	freeOutputTimes();
-	freeInitialCondition();
-	freeAnalyze();
-	freeLinearSolver();
+	freeParallel();
 }
@@ -95,6 +95,32 @@ enum limiterFunction {
 	VENKATAKRISHNAN		/**< Venkatakrishnan limiter */
 };
 
+/**
+ * \brief Ordering of the LU-SGS sweeps
+ */
+enum lusgsOrdering {
+	LUSGS_SERIAL,		/**< serial sweeps in element order */
+	LUSGS_LEVEL,		/**< level scheduled (wavefront) sweeps */
+	LUSGS_MULTICOLOR	/**< multicolor sweeps */
+};
+
+/**
+ * \brief Renumbering of the mesh elements
+ */
+enum meshRenumbering {
+	RENUMBER_NONE,		/**< keep the order of the mesh file */
+	RENUMBER_RCM,		/**< reverse Cuthill-McKee ordering */
+	RENUMBER_HILBERT	/**< Hilbert curve ordering of the barycenters */
+};
+
+/**
+ * \brief Multigrid cycle types
+ */
+enum multigridCycle {
+	V_CYCLE = 1,		/**< one coarse grid correction per level */
+	W_CYCLE			/**< two coarse grid corrections per level */
+};
+
 /**
  * \brief General parameters for the Program
  */
@@ -104,6 +130,28 @@ enum generalParameters {
 	NBC = 20		/**< maximum number of boundary conditions */
 };
 
+#ifdef MIXED_PRECISION
+typedef float krylov_t;		/**< Krylov vectors and preconditioner */
+#else
+typedef double krylov_t;	/**< Krylov vectors and preconditioner */
+#endif
+
+#ifdef FLOAT_FACES
+typedef float face_t;		/**< face states */
+#else
+typedef double face_t;		/**< face states */
+#endif
+
+/* functions and variables between these markers are also compiled for the
+ * device, since they are used by the offloaded kernels */
+#ifdef USE_GPU
+#define BEGIN_DEVICE _Pragma("omp declare target")
+#define END_DEVICE _Pragma("omp end declare target")
+#else
+#define BEGIN_DEVICE
+#define END_DEVICE
+#endif
+
 /**
  * \brief Output format for the results
  */
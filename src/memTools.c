@@ -18,8 +18,47 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
 
 #include "cgnslib.h"
+#include "memTools.h"
+
+/**
+ * \brief Block of an arena
+ */
+struct arenaBlock_t {
+	arenaBlock_t *prev;		/**< previous block of the arena */
+	long nObjs;			/**< number of objects in the block */
+	double data[];			/**< storage of the objects */
+};
+
+/** \brief Allocate a dynamic 1D array of integers
+ * \param[in] I Number of elements
+ * \return Pointer to a 1D integer array
+ */
+long *dyn1DintArray(long I)
+{
+	long *arr = calloc((I > 0 ? I : 1), sizeof(long));
+	if (!arr) {
+		printf("| ERROR: could not allocate arr\n");
+		exit(1);
+	}
+	return arr;
+}
+
+/** \brief Allocate a dynamic 1D array of doubles
+ * \param[in] I Number of elements
+ * \return Pointer to a 1D double array
+ */
+double *dyn1DdblArray(long I)
+{
+	double *arr = calloc((I > 0 ? I : 1), sizeof(double));
+	if (!arr) {
+		printf("| ERROR: could not allocate arr\n");
+		exit(1);
+	}
+	return arr;
+}
 
 /** \brief Allocate a dynamic 2D array of integers
  * \param[in] I Number of elements in the first dimension
@@ -81,6 +120,26 @@ double **dyn2DdblArray(long I, long J)
 	return arr;
 }
 
+/** \brief Allocate a dynamic 2D array of floats
+ * \param[in] I Number of elements in the first dimension
+ * \param[in] J Number of elements in the second dimension
+ * \return Pointer to a 2D float array
+ */
+float **dyn2DfltArray(long I, long J)
+{
+	float **arr = calloc(1, sizeof(float *) * I + sizeof(float) * I * J);
+	if (!arr) {
+		printf("| ERROR: could not allocate arr\n");
+		exit(1);
+	}
+
+	float *ptr = (float *)(arr + I);
+	for (long i = 0; i < I; ++i) {
+		arr[i] = ptr + J * i;
+	}
+	return arr;
+}
+
 /** \brief Allocate a dynamic 3D array of integers
  * \param[in] I Number of elements in the first dimension
  * \param[in] J Number of elements in the second dimension
@@ -131,6 +190,31 @@ double ***dyn3DdblArray(long I, long J, long K)
 	return arr;
 }
 
+/** \brief Allocate a dynamic 3D array of floats
+ * \param[in] I Number of elements in the first dimension
+ * \param[in] J Number of elements in the second dimension
+ * \param[in] K Number of elements in the third dimension
+ * \return Pointer to a 3D float array
+ */
+float ***dyn3DfltArray(long I, long J, long K)
+{
+	float ***arr = calloc(1, sizeof(float *) * I + sizeof(float **) * I * J + sizeof(float) * I * J * K);
+	if (!arr) {
+		printf("| ERROR: could not allocate arr\n");
+		exit(1);
+	}
+
+	float **ptrI = (float **)(arr + I);
+	float *ptrJ = (float *)(arr + I + I * J);
+	for (long i = 0; i < I; ++i) {
+		arr[i] = ptrI + J * i;
+		for (long j = 0; j < J; ++j) {
+			arr[i][j] = ptrJ + J * K * i + K * j;
+		}
+	}
+	return arr;
+}
+
 /** \brief Allocate a dynamic 4D array of doubles
  * \param[in] I Number of elements in the first dimension
  * \param[in] J Number of elements in the second dimension
@@ -180,3 +264,105 @@ char **dynStringArray(long I, long J)
 	}
 	return arr;
 }
+
+/** \brief Initialize an arena, the first block is allocated right away
+ * \param[out] arena Pointer to the arena
+ * \param[in] objSize Size of one object in bytes
+ * \param[in] blockSize Number of objects per block, best the total number
+ *	of objects, if it is known beforehand
+ */
+void initArena(arena_t *arena, size_t objSize, long blockSize)
+{
+	/* keep all objects aligned like the block storage */
+	arena->objSize = (objSize + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+	arena->blockSize = (blockSize > 1024 ? blockSize : 1024);
+	arena->nUsed = 0;
+	arena->block = NULL;
+}
+
+/** \brief Allocate zeroed, contiguous memory for some objects of an arena
+ * \param[in,out] arena Pointer to the arena
+ * \param[in] n Number of objects
+ * \return Pointer to the first object
+ */
+void *arenaAlloc(arena_t *arena, long n)
+{
+	if ((!arena->block) || (arena->nUsed + n > arena->block->nObjs)) {
+		long nObjs = (n > arena->blockSize ? n : arena->blockSize);
+		arenaBlock_t *block = calloc(1, sizeof(arenaBlock_t) + nObjs * arena->objSize);
+		if (!block) {
+			printf("| ERROR: could not allocate arena block\n");
+			exit(1);
+		}
+
+		block->prev = arena->block;
+		block->nObjs = nObjs;
+		arena->block = block;
+		arena->nUsed = 0;
+	}
+
+	void *ptr = (char *)arena->block->data + arena->nUsed * arena->objSize;
+	arena->nUsed += n;
+	return ptr;
+}
+
+/** \brief Free all objects of an arena at once
+ * \param[in,out] arena Pointer to the arena
+ */
+void freeArena(arena_t *arena)
+{
+	while (arena->block) {
+		arenaBlock_t *prev = arena->block->prev;
+		free(arena->block);
+		arena->block = prev;
+	}
+	arena->nUsed = 0;
+}
+
+/** \brief Peak resident memory of the process
+ * \return Peak resident set size in MB
+ */
+double peakMemory(void)
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss / 1024.0;
+}
+
+/** \brief Place the pages of a contiguous 2D array on the NUMA nodes of the
+ *	threads that work on them
+ *
+ * The pages of a large allocation are only placed in memory when they are
+ * written for the first time, on the NUMA node of the writing thread. Each
+ * thread zeros the part of every row that it gets with a static schedule over
+ * the second dimension, which is the schedule of the element and side loops.
+ * Has to be called before the array is written by a serial loop.
+ *
+ * \param[in,out] data First entry of the array
+ * \param[in] I Number of rows
+ * \param[in] J Number of entries per row
+ * \param[in] size Size of one entry in bytes
+ */
+void firstTouch(void *data, long I, long J, size_t size)
+{
+	char *ptr = data;
+
+	#pragma omp parallel
+	{
+		long jFirst = J, jLast = -1;
+
+		#pragma omp for schedule(static)
+		for (long j = 0; j < J; ++j) {
+			if (j < jFirst) {
+				jFirst = j;
+			}
+			jLast = j;
+		}
+
+		if (jLast >= jFirst) {
+			for (long i = 0; i < I; ++i) {
+				memset(ptr + (i * J + jFirst) * size, 0, (jLast - jFirst + 1) * size);
+			}
+		}
+	}
+}
@@ -7,13 +7,54 @@
 #ifndef MEMTOOLS_H
 #define MEMTOOLS_H
 
+#include <stddef.h>
+
 #include "cgnslib.h"
+#include "main.h"
+
+#ifdef MIXED_PRECISION
+#	define dyn2DkrylovArray dyn2DfltArray
+#	define dyn3DkrylovArray dyn3DfltArray
+#else
+#	define dyn2DkrylovArray dyn2DdblArray
+#	define dyn3DkrylovArray dyn3DdblArray
+#endif
+
+#ifdef FLOAT_FACES
+#	define dyn2DfaceArray dyn2DfltArray
+#else
+#	define dyn2DfaceArray dyn2DdblArray
+#endif
+
+typedef struct arenaBlock_t arenaBlock_t;
+typedef struct arena_t arena_t;
+
+/**
+ * \brief Arena for objects of a single type, the objects are allocated in
+ *	large contiguous blocks and can only be freed all at once
+ */
+struct arena_t {
+	size_t objSize;			/**< size of one object in bytes */
+	long blockSize;			/**< number of objects in a new block */
+	long nUsed;			/**< number of used objects in the current block */
+	arenaBlock_t *block;		/**< current block, linked to the previous ones */
+};
+
+void initArena(arena_t *arena, size_t objSize, long blockSize);
+void *arenaAlloc(arena_t *arena, long n);
+void freeArena(arena_t *arena);
+double peakMemory(void);
+void firstTouch(void *data, long I, long J, size_t size);
 
+long *dyn1DintArray(long I);
+double *dyn1DdblArray(long I);
 long **dyn2DintArray(long I, long J);
 cgsize_t **dyn2DcgsizeArray(long I, long J);
 double **dyn2DdblArray(long I, long J);
+float **dyn2DfltArray(long I, long J);
 long ***dyn3DintArray(long I, long J, long K);
 double ***dyn3DdblArray(long I, long J, long K);
+float ***dyn3DfltArray(long I, long J, long K);
 double ****dyn4DdblArray(long I, long J, long K, long L);
 char **dynStringArray(long I, long J);
 
@@ -7,6 +7,8 @@
  */
 
 typedef struct sideList_t sideList_t;
+typedef struct renumberList_t renumberList_t;
+typedef struct periodicHash_t periodicHash_t;
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -14,6 +16,7 @@ typedef struct sideList_t sideList_t;
 #include <math.h>
 #include <stdbool.h>
 #include <float.h>
+#include <omp.h>
 
 #include "main.h"
 #include "mesh.h"
@@ -22,6 +25,12 @@ typedef struct sideList_t sideList_t;
 #include "timeDiscretization.h"
 #include "memTools.h"
 #include "initialCondition.h"
+#include "parallel.h"
+#include "pointLocation.h"
+#include "gmsh.h"
+#include "meshCache.h"
+#include "solutionMapping.h"
+#include "meshSequencing.h"
 #include "cgnslib.h"
 
 /* extern variables */
@@ -35,16 +44,20 @@ char gridFile[STRLEN];			/**< complete name of the output mesh file */
 
 int meshType;				/**< code for the mesh type */
 int meshFormat;				/**< code for the mesh format */
+int meshRenumbering;			/**< renumbering of the mesh elements */
 
 long nNodes;				/**< global number of nodes */
 
 long nElems;				/**< global number of elements */
+long nElemsGlobal;			/**< number of elements of all partitions */
+long nHaloElems;			/**< number of halo elements */
 long nTrias;				/**< global number of triangles */
 long nQuads;				/**< global number of quadrangles */
 
 long nSides;				/**< global number of sides */
 long nBCsides;				/**< global number of BC sides */
 long nInnerSides;			/**< global number of non BC sides */
+long nInterfaceSides;			/**< number of sides to halo elements */
 
 double totalArea_q;			/**< inverse of the global area of the mesh */
 double xMin;				/**< maximum x-direction extension */
@@ -62,6 +75,18 @@ node_t *firstNode;			/**< pointer to first node */
 side_t *firstSide;			/**< pointer to first side */
 sidePtr_t *firstBCside;			/**< pointer to first BC side */
 
+arena_t nodeArena;			/**< storage of the nodes */
+arena_t elemArena;			/**< storage of the elements and ghost
+						elements */
+arena_t sideArena;			/**< storage of the sides */
+arena_t sidePtrArena;			/**< storage of the BC side list */
+arena_t elemNodeArena;			/**< storage of the element node arrays */
+arena_t quadArena;			/**< storage of the volume quadrature
+						points and weights */
+
+elemData_t elemData;			/**< element arrays used by the solver */
+sideData_t sideData;			/**< side arrays used by the solver */
+
 /**
  * \brief Helper structure for reading in the sides and deviding them into
  *	BC sides and non-BC sides
@@ -73,6 +98,38 @@ struct sideList_t {
 	bool isRotated;			/**< flag for if the side is rotated */
 };
 
+/**
+ * \brief Helper structure for sorting elements and sides by a key
+ */
+struct renumberList_t {
+	unsigned long long key[2];	/**< sorting keys, the first one has priority */
+	long id;			/**< original position in the array */
+};
+
+/**
+ * \brief Entry of the hash table used for connecting periodic sides
+ */
+struct periodicHash_t {
+	long key[NDIM];			/**< quantized position of the side */
+	int pair;			/**< number of the periodic BC pair */
+	long order;			/**< position in the BC side list */
+	side_t *side;			/**< BC side, NULL for an empty entry */
+};
+
+/**
+ * \brief Midpoint of an element edge
+ * \param[in] aElem A pointer to an element
+ * \param[in] iEdge Edge from node `iEdge` to the next node of the element
+ * \param[out] x Coordinates of the midpoint
+ */
+void edgeMidpoint(elem_t *aElem, int iEdge, double x[NDIM])
+{
+	node_t *aNode = aElem->node[iEdge];
+	node_t *bNode = aElem->node[(iEdge + 1) % aElem->elemType];
+	x[X] = 0.5 * (aNode->x[X] + bNode->x[X]);
+	x[Y] = 0.5 * (aNode->x[Y] + bNode->x[Y]);
+}
+
 /**
  * \brief Compute required vectors for reconstruction
  * \param[in] aElem A pointer to an element
@@ -113,46 +170,30 @@ void createReconstructionInfo(elem_t *aElem)
 		aSide = aSide->nextElemSide;
 	}
 
-	/* gaussian integration points and weights for volume integrals */
+	/* gaussian integration points and weights for volume integrals, the
+	 * edge midpoints are taken from the nodes, since an edge with a
+	 * hanging node consists of two sides */
 	switch (aElem->elemType) {
 	case 3:
 		aElem->nGP = 3;
-		aElem->wGP = malloc(aElem->nGP * sizeof(double));
-		if (!aElem->wGP) {
-			printf("| ERROR: could not allocate aElem->wGP\n");
-			exit(1);
-		}
+		aElem->xGP = arenaAlloc(&quadArena, aElem->nGP * NDIM);
+		aElem->wGP = arenaAlloc(&quadArena, aElem->nGP);
 
-		aElem->xGP = dyn2DdblArray(aElem->nGP, NDIM);
-
-		aSide = aElem->firstSide;
 		for (int iGP = 0; iGP < aElem->nGP; ++iGP) {
-			aElem->xGP[iGP][X] = aElem->bary[X] + aSide->GP[X];
-			aElem->xGP[iGP][Y] = aElem->bary[Y] + aSide->GP[Y];
+			edgeMidpoint(aElem, aElem->nGP - 1 - iGP, aElem->xGP[iGP]);
 
 			aElem->wGP[iGP] = aElem->area / 3.0;
-
-			aSide = aSide->nextElemSide;
 		}
 		break;
 	case 4:
 		aElem->nGP = 5;
-		aElem->wGP = malloc(aElem->nGP * sizeof(double));
-		if (!aElem->wGP) {
-			printf("| ERROR: could not allocate aElem->wGP\n");
-			exit(1);
-		}
-
-		aElem->xGP = dyn2DdblArray(aElem->nGP, NDIM);
+		aElem->xGP = arenaAlloc(&quadArena, aElem->nGP * NDIM);
+		aElem->wGP = arenaAlloc(&quadArena, aElem->nGP);
 
-		aSide = aElem->firstSide;
 		for (int iGP = 0; iGP < aElem->nGP - 1; ++iGP) {
-			aElem->xGP[iGP][X] = aElem->bary[X] + aSide->GP[X];
-			aElem->xGP[iGP][Y] = aElem->bary[Y] + aSide->GP[Y];
+			edgeMidpoint(aElem, aElem->nGP - 2 - iGP, aElem->xGP[iGP]);
 
 			aElem->wGP[iGP] = aElem->area / 6.0;
-
-			aSide = aSide->nextElemSide;
 		}
 		aElem->xGP[4][X] = 0.5 * (aElem->node[0]->x[X] + aElem->node[2]->x[X]);
 		aElem->xGP[4][Y] = 0.5 * (aElem->node[0]->x[Y] + aElem->node[2]->x[Y]);
@@ -166,6 +207,20 @@ void createReconstructionInfo(elem_t *aElem)
 	}
 }
 
+/**
+ * \brief Hash function for the quantized position of a periodic side
+ * \param[in] key Quantized position
+ * \param[in] pair Number of the periodic BC pair
+ * \return Hash value
+ */
+unsigned long periodicHash(const long key[NDIM], int pair)
+{
+	unsigned long hash = (unsigned long)key[X] * 73856093UL;
+	hash ^= (unsigned long)key[Y] * 19349663UL;
+	hash ^= (unsigned long)pair * 83492791UL;
+	return hash ^ (hash >> 29);
+}
+
 /**
  * \brief Create connection for periodic BCs
  */
@@ -173,74 +228,146 @@ void connectPeriodicBC(void)
 {
 	isPeriodic = false;
 
+	/* hash the sides of the second BC of every periodic pair by the
+	 * position of their GP, quantized with a cell size larger than the
+	 * matching tolerance */
+	const double h = 1e-6;
+	long nPeriodic = 0, nTargets = 0;
 	sidePtr_t *aBCside = firstBCside;
+	while (aBCside) {
+		if (aBCside->side->BC->BCtype == PERIODIC) {
+			nPeriodic++;
+			nTargets += ((aBCside->side->BC->BCid % 10) == 2);
+		}
+		aBCside = aBCside->next;
+	}
+
+	if (nPeriodic == 0) {
+		return;
+	}
+
+	unsigned long tableSize = 1;
+	while (tableSize < 2 * (unsigned long)nTargets) {
+		tableSize *= 2;
+	}
+
+	periodicHash_t *table = calloc(tableSize, sizeof(periodicHash_t));
+	if (!table) {
+		printf("| ERROR: could not allocate table\n");
+		exit(1);
+	}
+
+	long order = 0;
+	aBCside = firstBCside;
+	while (aBCside) {
+		side_t *sSide = aBCside->side;
+		if ((sSide->BC->BCtype == PERIODIC) && ((sSide->BC->BCid % 10) == 2)) {
+			periodicHash_t entry;
+			entry.key[X] = floor((sSide->GP[X] + sSide->elem->bary[X]) / h);
+			entry.key[Y] = floor((sSide->GP[Y] + sSide->elem->bary[Y]) / h);
+			entry.pair = sSide->BC->BCid / 10;
+			entry.order = order;
+			entry.side = sSide;
+
+			unsigned long iHash = periodicHash(entry.key, entry.pair) & (tableSize - 1);
+			while (table[iHash].side) {
+				iHash = (iHash + 1) & (tableSize - 1);
+			}
+			table[iHash] = entry;
+		}
+
+		order++;
+		aBCside = aBCside->next;
+	}
+
+	/* mark the sides that are replaced by their periodic counterpart */
+	long maxId = 0;
+	side_t *cSide = firstSide;
+	while (cSide) {
+		maxId = (cSide->id > maxId ? cSide->id : maxId);
+		cSide = cSide->next;
+	}
+
+	bool *isRemoved = calloc(maxId + 1, sizeof(bool));
+	if (!isRemoved) {
+		printf("| ERROR: could not allocate isRemoved\n");
+		exit(1);
+	}
+
+	aBCside = firstBCside;
 	double aGPpos[2], sGPpos[2];
-	bool isConnected;
 	while (aBCside) {
 		side_t *aSide = aBCside->side;
 		if ((aSide->BC->BCtype == PERIODIC) &&
 		    ((aSide->BC->BCid % 10) == 1)) {
 			isPeriodic = true;
-			isConnected = false;
 
 			aGPpos[X] = aSide->GP[X] + aSide->elem->bary[X];
 			aGPpos[Y] = aSide->GP[Y] + aSide->elem->bary[Y];
 
 			int nPeriodicBC = aSide->BC->BCid / 10;
 
-			sidePtr_t *sBCside = firstBCside;
-			while (sBCside) {
-				side_t *sSide = sBCside->side;
-
-				/* check for potential connection */
-				if ((sSide->BC->BCtype == PERIODIC) &&
-				    ((sSide->BC->BCid % 10) == 2) &&
-				    ((sSide->BC->BCid / 10) == nPeriodicBC)) {
-
-					/* check if the connection works out */
-					sGPpos[X] = sSide->GP[X] + sSide->elem->bary[X];
-					sGPpos[Y] = sSide->GP[Y] + sSide->elem->bary[Y];
-
-					if ((fabs(aGPpos[X] + aSide->BC->connection[X] - sGPpos[X]) +
-					     fabs(aGPpos[Y] + aSide->BC->connection[Y] - sGPpos[Y])) <= 1e-7) {
-
-						isConnected = true;
-
-						side_t *urSide = aSide->connection;
-						side_t *targetSide = sSide->connection;
-						urSide->connection = targetSide;
-						targetSide->connection = urSide;
-
-						/* reorganise lists: target side has to be removed */
-						nSides--;
-						if (firstSide == targetSide) {
-							firstSide = firstSide->next;
-						} else {
-							side_t *sSide = firstSide;
-							while (sSide) {
-								if (sSide->next == targetSide) {
-									sSide->next = targetSide->next;
-									break;
-								}
-								sSide = sSide->next;
-							}
+			/* the matching side is in one of the neighbouring cells,
+			 * take the first one of the BC side list */
+			long key[NDIM], keyTarget[NDIM];
+			key[X] = floor((aGPpos[X] + aSide->BC->connection[X]) / h);
+			key[Y] = floor((aGPpos[Y] + aSide->BC->connection[Y]) / h);
+			periodicHash_t *target = NULL;
+			for (keyTarget[X] = key[X] - 1; keyTarget[X] <= key[X] + 1; ++keyTarget[X]) {
+				for (keyTarget[Y] = key[Y] - 1; keyTarget[Y] <= key[Y] + 1; ++keyTarget[Y]) {
+					unsigned long iHash = periodicHash(keyTarget, nPeriodicBC) & (tableSize - 1);
+					while (table[iHash].side) {
+						periodicHash_t *entry = &table[iHash];
+						side_t *sSide = entry->side;
+						sGPpos[X] = sSide->GP[X] + sSide->elem->bary[X];
+						sGPpos[Y] = sSide->GP[Y] + sSide->elem->bary[Y];
+
+						/* check if the connection works out */
+						if ((entry->key[X] == keyTarget[X]) &&
+						    (entry->key[Y] == keyTarget[Y]) &&
+						    (entry->pair == nPeriodicBC) &&
+						    ((fabs(aGPpos[X] + aSide->BC->connection[X] - sGPpos[X]) +
+						      fabs(aGPpos[Y] + aSide->BC->connection[Y] - sGPpos[Y])) <= 1e-7) &&
+						    ((!target) || (entry->order < target->order))) {
+							target = entry;
 						}
-						break;
+
+						iHash = (iHash + 1) & (tableSize - 1);
 					}
 				}
-
-				sBCside = sBCside->next;
 			}
 
-			if (!isConnected) {
+			if (!target) {
 				printf("| ERROR in connectPeriodicBC: No connection found\n");
 				printf("| Side GP was: %g %g\n", aGPpos[X], aGPpos[Y]);
 				exit(1);
 			}
+
+			side_t *urSide = aSide->connection;
+			side_t *targetSide = target->side->connection;
+			urSide->connection = targetSide;
+			targetSide->connection = urSide;
+			isRemoved[targetSide->id] = true;
 		}
 
 		aBCside = aBCside->next;
 	}
+
+	/* reorganise lists: target sides have to be removed */
+	side_t **prevNext = &firstSide;
+	cSide = firstSide;
+	while (cSide) {
+		if (isRemoved[cSide->id]) {
+			*prevNext = cSide->next;
+			nSides--;
+		} else {
+			prevNext = &cSide->next;
+		}
+		cSide = cSide->next;
+	}
+
+	free(isRemoved);
+	free(table);
 }
 
 /**
@@ -303,7 +430,7 @@ void createElemInfo(elem_t *aElem)
 	}
 
 	/* element area and its inverse */
-	double vec[2], n[4][2], len[4];
+	double vec[2], n[4][2] = {{0.0}}, len[4] = {0.0};
 	for (int i = 0; i < aElem->elemType; ++i) {
 		int j = (i + 1) % aElem->elemType;
 		vec[X] = aElem->node[j]->x[X] - aElem->node[i]->x[X];
@@ -374,6 +501,59 @@ int compare(const void *a, const void *b)
 	}
 }
 
+/**
+ * \brief Sort the side list in linear time
+ *
+ * The entries are put into one bucket per lower node ID, which is a perfect
+ * hash for the side keys. The few entries of every bucket are then sorted
+ * with an insertion sort. The result is identical to a stable sort with
+ * `compare`.
+ * \param[in,out] sideList The side list, replaced by the sorted list
+ * \param[in] nEntries Number of entries in the side list
+ * \param[in] nVertices Number of nodes
+ */
+void sortSideList(sideList_t **sideList, long nEntries, long nVertices)
+{
+	long *offset = dyn1DintArray(nVertices + 1);
+	for (long i = 0; i < nEntries; ++i) {
+		offset[(*sideList)[i].node[0] + 1]++;
+	}
+
+	for (long iNode = 0; iNode < nVertices; ++iNode) {
+		offset[iNode + 1] += offset[iNode];
+	}
+
+	sideList_t *sorted = malloc(nEntries * sizeof(sideList_t) + 1);
+	long *pos = dyn1DintArray(nVertices);
+	if (!sorted) {
+		printf("| ERROR: could not allocate sorted\n");
+		exit(1);
+	}
+
+	for (long i = 0; i < nEntries; ++i) {
+		long iNode = (*sideList)[i].node[0];
+		sorted[offset[iNode] + pos[iNode]++] = (*sideList)[i];
+	}
+
+	#pragma omp parallel for
+	for (long iNode = 0; iNode < nVertices; ++iNode) {
+		for (long i = offset[iNode] + 1; i < offset[iNode + 1]; ++i) {
+			sideList_t entry = sorted[i];
+			long j = i;
+			while ((j > offset[iNode]) && (compare(&sorted[j - 1], &entry) > 0)) {
+				sorted[j] = sorted[j - 1];
+				j--;
+			}
+			sorted[j] = entry;
+		}
+	}
+
+	free(offset);
+	free(pos);
+	free(*sideList);
+	*sideList = sorted;
+}
+
 /**
  * \brief Create a cartesian mesh
  * \param[in,out] vertex Pointer to 2D array, used for the vertices
@@ -481,12 +661,10 @@ void createCartMesh(
 			k++;
 		}
 	}
-
-	free(cartMesh.nBC);
 }
 
 /**
- * \brief Read in a gmsh mesh file
+ * \brief Read in EMC2 mesh file
  * \param[in] fileName Name of the mesh file
  * \param[in,out] vertex Pointer to 2D array, used for the vertices
  * \param[in,out] nVertices Pointer to the number of total vertices in `vertex`
@@ -495,7 +673,7 @@ void createCartMesh(
  * \param[in,out] tria Pointer to a 2D array, used for the triangles
  * \param[in,out] quad Pointer to a 2D array, used for the quadrangles
  */
-void readGmsh(char fileName[STRLEN], double ***vertex, long *nVertices, long ***BCedge,
+void readEMC2(char fileName[STRLEN], double ***vertex, long *nVertices, long ***BCedge,
 		long *nBCedges, long ***tria, long ***quad)
 {
 	/* open the mesh file */
@@ -507,628 +685,122 @@ void readGmsh(char fileName[STRLEN], double ***vertex, long *nVertices, long ***
 
 	char line[STRLEN];
 
-	/* read in mesh format */
-	int mshFmt;
+	/* read number of vertices */
 	rewind(meshFile);
 	while (fgets(line, sizeof(line), meshFile)) {
-		if (!strcmp(line, "$MeshFormat\n")) {
+		if (strstr(line, "Vertices")) {
 			fgets(line, sizeof(line), meshFile);
-			sscanf(line, "%d", &mshFmt);
+			sscanf(line, "%ld", nVertices);
+			break;
+		} else if (strstr(line, "End")) {
 			break;
 		}
 	}
 
-	switch (mshFmt) {
-	case 2: {
-		/* read in number of nodes */
-		*nVertices = 0;
-		rewind(meshFile);
-		while (fgets(line, sizeof(line), meshFile)) {
-			if (!strcmp(line, "$Nodes\n")) {
-				fgets(line, sizeof(line), meshFile);
-				sscanf(line, "%ld", nVertices);
-				break;
-			}
-		}
-		if (*nVertices == 0) {
-			printf("| ERROR: No Nodes in Mesh file\n");
-			exit(1);
-		}
-
-		/* read in nodes */
-		long id;
+	/* allocate memory for vertices */
+	*vertex = dyn2DdblArray(*nVertices, 2);
+	for (long iVert = 0; iVert < *nVertices; ++iVert) {
+		fgets(line, sizeof(line), meshFile);
 		double x, y;
-		*vertex = dyn2DdblArray(*nVertices, 2);
-		for (long iVert = 0; iVert < *nVertices; ++iVert) {
+		sscanf(line, "%lg %lg", &x, &y);
+		(*vertex)[iVert][X] = x;
+		(*vertex)[iVert][Y] = y;
+	}
+
+	/* read number of edges */
+	long nEdges;
+	rewind(meshFile);
+	while (fgets(line, sizeof(line), meshFile)) {
+		if (strstr(line, "Edges")) {
 			fgets(line, sizeof(line), meshFile);
-			sscanf(line, "%ld %lg %lg", &id, &x, &y);
-			if (iVert == id - 1) {
-				(*vertex)[iVert][X] = x;
-				(*vertex)[iVert][Y] = y;
-			} else {
-				printf("| ERROR: NodeID %ld does not match Node Position\n", id);
-				exit(1);
-			}
+			sscanf(line, "%ld", &nEdges);
+			break;
+		} else if (strstr(line, "End")) {
+			break;
 		}
+	}
 
-		*nBCedges = nTrias = nQuads = 0;
+	/* read edge information, sort out edges with ID 0 */
+	(*nBCedges) = 0;
+	long **tmpEdges = dyn2DintArray(nEdges, 3);
+	for (long iEdge = 0; iEdge < nEdges; ++iEdge) {
+		fgets(line, sizeof(line), meshFile);
 
-		/* read in number of elements */
-		long nElem = 0;
-		rewind(meshFile);
-		while (fgets(line, sizeof(line), meshFile)) {
-			if (!strcmp(line, "$Elements\n")) {
-				fgets(line, sizeof(line), meshFile);
-				sscanf(line, "%ld", &nElem);
-				break;
-			}
-		}
-		if (nElem == 0) {
-			printf("| ERROR: No Elements in Mesh file\n");
-			exit(1);
-		}
+		long tmp;
+		sscanf(line, "%*d %*d %ld", &tmp);
 
-		/* allocate space for the elements, more than actually necessary,
-		 * because the number of individual elements is not known, will be
-		 * freeed later on though */
-		long **BCedgeTmp = dyn2DintArray(nElem, 3);
-		long **triaTmp = dyn2DintArray(nElem, 4);
-		long **quadTmp = dyn2DintArray(nElem, 5);
-		if (!BCedgeTmp || !triaTmp || !quadTmp) {
-			printf("| ERROR: Not enough memory available\n");
-			exit(1);
+		if (tmp != 0) {
+			long tmp0, tmp1, tmp2;
+			sscanf(line, "%ld %ld %ld", &tmp0, &tmp1, &tmp2);
+			tmpEdges[*nBCedges][0] = tmp0;
+			tmpEdges[*nBCedges][1] = tmp1;
+			tmpEdges[*nBCedges][2] = tmp2;
+			(*nBCedges)++;
 		}
+	}
 
-		/* read in elements */
-		int type, nTags, pGroup;
-		char *token, sep[] = " ";
-		for (long iElem = 0; iElem < nElem; ++iElem) {
-			fgets(line, sizeof(line), meshFile);
-
-			/* read element id */
-			token = strtok(line, sep);
-			if (token) {
-				id = strtol(token, NULL, 10);
-			} else {
-				printf("| ERROR: Reading error in gmsh file\n");
-				exit(1);
-			}
-
-			/* read element type */
-			token = strtok(NULL, sep);
-			if (token) {
-				type = strtol(token, NULL, 10);
-			} else {
-				printf("| ERROR: Reading error in gmsh file\n");
-				exit(1);
-			}
-
-			/* read number of integer tags */
-			token = strtok(NULL, sep);
-			if (token) {
-				nTags = strtol(token, NULL, 10);
-			} else {
-				printf("| ERROR: Reading error in gmsh file\n");
-				exit(1);
-			}
-
-			/* read physical group, first integer tag */
-			token = strtok(NULL, sep);
-			if (token) {
-				pGroup = strtol(token, NULL, 10);
-			} else {
-				printf("| ERROR: Reading error in gmsh file\n");
-				exit(1);
-			}
-
-			/* discard rest of tags */
-			for (int iTag = 1; iTag < nTags; ++iTag) {
-				token = strtok(NULL, sep);
-				if (!token) {
-					printf("| ERROR: Reading error in gmsh file\n");
-					exit(1);
-				}
-			}
-
-			/* handle different element types */
-			switch (type) {
-			case 1:
-				/* line */
-				if (pGroup > 100) {
-					/* boundary condition */
-					BCedgeTmp[*nBCedges][2] = pGroup;
-
-					/* read two nodes */
-					for (int i = 0; i < 2; ++i) {
-						token = strtok(NULL, sep);
-						if (!token) {
-							printf("| ERROR: Reading error in gmsh file\n");
-							exit(1);
-						}
-						BCedgeTmp[*nBCedges][i] = strtol(token, NULL, 10) - 1;
-					}
-
-					(*nBCedges)++;
-				}
-				break;
-			case 2:
-				/* triangle */
-				triaTmp[nTrias][3] = pGroup;
-
-				/* read three nodes */
-				for (int i = 0; i < 3; ++i) {
-					token = strtok(NULL, sep);
-					if (!token) {
-						printf("| ERROR: Reading error in gmsh file\n");
-						exit(1);
-					}
-					triaTmp[nTrias][i] = strtol(token, NULL, 10) - 1;
-				}
-
-				nTrias++;
-
-				break;
-			case 3:
-				/* quadrilateral */
-				quadTmp[nQuads][4] = pGroup;
-
-				/* read three nodes */
-				for (int i = 0; i < 4; ++i) {
-					token = strtok(NULL, sep);
-					if (!token) {
-						printf("| ERROR: Reading error in gmsh file\n");
-						exit(1);
-					}
-					quadTmp[nQuads][i] = strtol(token, NULL, 10) - 1;
-				}
-
-				nQuads++;
+	*BCedge = dyn2DintArray(*nBCedges, 3);
+	for (long iEdge = 0; iEdge < *nBCedges; ++iEdge) {
+		(*BCedge)[iEdge][0] = tmpEdges[iEdge][0] - 1;
+		(*BCedge)[iEdge][1] = tmpEdges[iEdge][1] - 1;
+		(*BCedge)[iEdge][2] = tmpEdges[iEdge][2];
+	}
 
-				break;
-			}
-		}
+	free(tmpEdges);
 
-		/* allocate right amount of space and free temporary space */
-		*BCedge = dyn2DintArray(*nBCedges, 3);
-		if (!*BCedge) {
-			printf("| ERROR: Not enough Memory\n");
-			exit(1);
-		} else {
-			for (long iBCedge = 0; iBCedge < *nBCedges; ++iBCedge) {
-				(*BCedge)[iBCedge][0] = BCedgeTmp[iBCedge][0];
-				(*BCedge)[iBCedge][1] = BCedgeTmp[iBCedge][1];
-				(*BCedge)[iBCedge][2] = BCedgeTmp[iBCedge][2];
-			}
+	/* read number of triangles */
+	nTrias = 0;
+	rewind(meshFile);
+	while (fgets(line, sizeof(line), meshFile)) {
+		if (strstr(line, "Triangles")) {
+			fgets(line, sizeof(line), meshFile);
+			sscanf(line, "%ld", &nTrias);
+			break;
+		} else if (strstr(line, "End")) {
+			break;
 		}
+	}
 
-		free(BCedgeTmp);
-
-		if (nTrias > 0) {
-			*tria = dyn2DintArray(nTrias, 4);
-			if (!*tria) {
-				printf("| ERROR: Not enough Memory\n");
-				exit(1);
-			} else {
-				for (long iTria = 0; iTria < nTrias; ++iTria) {
-					(*tria)[iTria][0] = triaTmp[iTria][0];
-					(*tria)[iTria][1] = triaTmp[iTria][1];
-					(*tria)[iTria][2] = triaTmp[iTria][2];
-					(*tria)[iTria][3] = triaTmp[iTria][3];
-				}
-			}
+	/* read in triangles */
+	if (nTrias > 0) {
+		*tria = dyn2DintArray(nTrias, 4);
+		for (long iTria = 0; iTria < nTrias; ++iTria) {
+			fgets(line, sizeof(line), meshFile);
+			long tmp0, tmp1, tmp2, tmp3;
+			sscanf(line, "%ld %ld %ld %ld", &tmp0, &tmp1, &tmp2, &tmp3);
+			(*tria)[iTria][0] = tmp0 - 1;
+			(*tria)[iTria][1] = tmp1 - 1;
+			(*tria)[iTria][2] = tmp2 - 1;
+			(*tria)[iTria][3] = tmp3;
 		}
+	}
 
-		free(triaTmp);
-
-		if (nQuads > 0) {
-			*quad = dyn2DintArray(nQuads, 5);
-			if (!*quad) {
-				printf("| ERROR: Not enough Memory\n");
-				exit(1);
-			} else {
-				for (long iQuad = 0; iQuad < nQuads; ++iQuad) {
-					(*quad)[iQuad][0] = quadTmp[iQuad][0];
-					(*quad)[iQuad][1] = quadTmp[iQuad][1];
-					(*quad)[iQuad][2] = quadTmp[iQuad][2];
-					(*quad)[iQuad][3] = quadTmp[iQuad][3];
-					(*quad)[iQuad][4] = quadTmp[iQuad][4];
-				}
-			}
+	/* read number of quadrangles */
+	nQuads = 0;
+	rewind(meshFile);
+	while (fgets(line, sizeof(line), meshFile)) {
+		if (strstr(line, "Quadrangles")) {
+			fgets(line, sizeof(line), meshFile);
+			sscanf(line, "%ld", &nQuads);
+			break;
+		} else if (strstr(line, "End")) {
+			break;
 		}
-
-		free(quadTmp);
-
-		break;
 	}
-	case 4: {
-		/* read curve number of entity tags */
-		long nPEntities, nCEntities;
-		rewind(meshFile);
-		while (fgets(line, sizeof(line), meshFile)) {
-			if (!strcmp(line, "$Entities\n")) {
-				fgets(line, sizeof(line), meshFile);
-				sscanf(line, "%ld %ld", &nPEntities, &nCEntities);
-				break;
-			}
-		}
-		if (nCEntities == 0) {
-			printf("| ERROR: No curves in mesh file\n");
-			exit(1);
-		}
 
-		/* read curve entity tags */
-		int pTag[nCEntities];
-		int iCentitiy = 0;
-		char *token, sep[] = " ";
-		for (int l = 0; l < nPEntities; l++) {
-			/* skip point tags */
+	/* read in quadrangles */
+	if (nQuads > 0) {
+		*quad = dyn2DintArray(nQuads, 5);
+		for (long iQuad = 0; iQuad < nQuads; ++iQuad) {
 			fgets(line, sizeof(line), meshFile);
-		}
-		for (int l = 0; l < nCEntities; l++) {
-			fgets(line, sizeof(line), meshFile);
-
-			token = strtok(line, sep);
-			for (int k = 0; k < 7; ++k) {
-				token = strtok(NULL, sep);
-			}
-			int numPtags = strtol(token, NULL, 10);
-
-			if (numPtags) {
-				token = strtok(NULL, sep);
-				pTag[iCentitiy++] = strtol(token, NULL, 10);
-			}
-		}
-
-		/* read in number of entity block and number of nordes */
-		*nVertices = 0;
-		int nEblocks;
-		rewind(meshFile);
-		while (fgets(line, sizeof(line), meshFile)) {
-			if (!strcmp(line, "$Nodes\n")) {
-				fgets(line, sizeof(line), meshFile);
-				sscanf(line, "%d %ld", &nEblocks, nVertices);
-				break;
-			}
-		}
-		if (*nVertices == 0) {
-			printf("| ERROR: No Nodes in Mesh file\n");
-			exit(1);
-		}
-
-		/* read in nodes */
-		long id[*nVertices];
-		long nNinB, iVert = 0, iId = 0;
-		double x, y;
-		*vertex = dyn2DdblArray(*nVertices, 2);
-		for (int e = 0; e < nEblocks; ++e) {
-			fgets(line, sizeof(line), meshFile);
-
-			/* read number of nodes in block */
-			sscanf(line, "%*d %*d %*d %ld", &nNinB);
-
-			/* read ids */
-			for (long i = 0; i < nNinB; ++i) {
-				fgets(line, sizeof(line), meshFile);
-				sscanf(line, "%ld", &id[iId++]);
-			}
-
-			/* read coordinates */
-			for (long i = 0; i < nNinB; ++i) {
-				fgets(line, sizeof(line), meshFile);
-				sscanf(line, "%lg %lg", &x, &y);
-
-				if (iVert == id[iVert] - 1) {
-					(*vertex)[iVert  ][X] = x;
-					(*vertex)[iVert++][Y] = y;
-				} else {
-					printf("| ERROR: NodeID %ld does not match Node Position\n", id[iVert]);
-					exit(1);
-				}
-			}
-		}
-
-		*nBCedges = nTrias = nQuads = 0;
-
-		/* read in number of element blocks and number of elements */
-		long nElem = 0;
-		rewind(meshFile);
-		while (fgets(line, sizeof(line), meshFile)) {
-			if (!strcmp(line, "$Elements\n")) {
-				fgets(line, sizeof(line), meshFile);
-				sscanf(line, "%d %ld", &nEblocks, &nElem);
-				break;
-			}
-		}
-		if (nElem == 0) {
-			printf("| ERROR: No Elements in Mesh file\n");
-			exit(1);
-		}
-
-		/* allocate space for the elements, more than actually necessary,
-		 * because the number of individual elements is not known, will be
-		 * freeed later on though */
-		long **BCedgeTmp = dyn2DintArray(nElem, 3);
-		long **triaTmp = dyn2DintArray(nElem, 4);
-		long **quadTmp = dyn2DintArray(nElem, 5);
-		if (!BCedgeTmp || !triaTmp || !quadTmp) {
-			printf("| ERROR: Not enough memory available\n");
-			exit(1);
-		}
-
-		/* read in elements */
-		int type;
-		for (int e = 0; e < nEblocks; ++e) {
-			fgets(line, sizeof(line), meshFile);
-
-			/* read element type and number of elements in block */
-			sscanf(line, "%*d %*d %d %ld", &type, &nNinB);
-
-			/* handle different element types */
-			switch (type) {
-			case 1:
-				/* line */
-				for (long i = 0; i < nNinB; ++i) {
-					/* boundary condition */
-					BCedgeTmp[*nBCedges][2] = pTag[e];
-
-					/* read two nodes */
-					fgets(line, sizeof(line), meshFile);
-					sscanf(line, "%*d %ld %ld",
-							&BCedgeTmp[*nBCedges][0],
-							&BCedgeTmp[*nBCedges][1]);
-
-					BCedgeTmp[*nBCedges][0]--;
-					BCedgeTmp[*nBCedges][1]--;
-
-					(*nBCedges)++;
-				}
-				break;
-			case 2:
-				/* triangle */
-				for (long i = 0; i < nNinB; ++i) {
-					triaTmp[nTrias][3] = 1;
-
-					/* read three nodes */
-					fgets(line, sizeof(line), meshFile);
-					sscanf(line, "%*d %ld %ld %ld",
-							&triaTmp[nTrias][0],
-							&triaTmp[nTrias][1],
-							&triaTmp[nTrias][2]);
-
-					triaTmp[nTrias][0]--;
-					triaTmp[nTrias][1]--;
-					triaTmp[nTrias][2]--;
-
-					nTrias++;
-				}
-
-				break;
-			case 3:
-				/* quadrilateral */
-				for (long i = 0; i < nNinB; ++i) {
-					quadTmp[nQuads][4] = 1;
-
-					/* read three nodes */
-					fgets(line, sizeof(line), meshFile);
-					sscanf(line, "%*d %ld %ld %ld %ld",
-							&quadTmp[nQuads][0],
-							&quadTmp[nQuads][1],
-							&quadTmp[nQuads][2],
-							&quadTmp[nQuads][3]);
-
-					quadTmp[nQuads][0]--;
-					quadTmp[nQuads][1]--;
-					quadTmp[nQuads][2]--;
-					quadTmp[nQuads][3]--;
-
-					nQuads++;
-				}
-
-				break;
-			}
-		}
-
-		/* allocate right amount of space and free temporary space */
-		*BCedge = dyn2DintArray(*nBCedges, 3);
-		if (!*BCedge) {
-			printf("| ERROR: Not enough Memory\n");
-			exit(1);
-		} else {
-			for (long iBCedge = 0; iBCedge < *nBCedges; ++iBCedge) {
-				(*BCedge)[iBCedge][0] = BCedgeTmp[iBCedge][0];
-				(*BCedge)[iBCedge][1] = BCedgeTmp[iBCedge][1];
-				(*BCedge)[iBCedge][2] = BCedgeTmp[iBCedge][2];
-			}
-		}
-
-		free(BCedgeTmp);
-
-		if (nTrias > 0) {
-			*tria = dyn2DintArray(nTrias, 4);
-			if (!*tria) {
-				printf("| ERROR: Not enough Memory\n");
-				exit(1);
-			} else {
-				for (long iTria = 0; iTria < nTrias; ++iTria) {
-					(*tria)[iTria][0] = triaTmp[iTria][0];
-					(*tria)[iTria][1] = triaTmp[iTria][1];
-					(*tria)[iTria][2] = triaTmp[iTria][2];
-					(*tria)[iTria][3] = triaTmp[iTria][3];
-				}
-			}
-		}
-		free(triaTmp);
-
-		if (nQuads > 0) {
-			*quad = dyn2DintArray(nQuads, 5);
-			if (!*quad) {
-				printf("| ERROR: Not enough Memory\n");
-				exit(1);
-			} else {
-				for (long iQuad = 0; iQuad < nQuads; ++iQuad) {
-					(*quad)[iQuad][0] = quadTmp[iQuad][0];
-					(*quad)[iQuad][1] = quadTmp[iQuad][1];
-					(*quad)[iQuad][2] = quadTmp[iQuad][2];
-					(*quad)[iQuad][3] = quadTmp[iQuad][3];
-					(*quad)[iQuad][4] = quadTmp[iQuad][4];
-				}
-			}
-		}
-		free(quadTmp);
-
-		break;
-	}
-	default:
-		printf("| ERROR: Wrong gmsh Mesh Format '%d'\n", mshFmt);
-		exit(1);
-	}
-
-	fclose(meshFile);
-
-	printf("| %7ld Nodes read\n", *nVertices);
-	printf("| %7ld Triangles read\n", nTrias);
-	printf("| %7ld Quadrangles read\n", nQuads);
-	printf("| %7ld Boundary Edges read\n", *nBCedges);
-}
-
-/**
- * \brief Read in EMC2 mesh file
- * \param[in] fileName Name of the mesh file
- * \param[in,out] vertex Pointer to 2D array, used for the vertices
- * \param[in,out] nVertices Pointer to the number of total vertices in `vertex`
- * \param[in,out] BCedge Pointer to 2D array, used for the BC edges
- * \param[in,out] nBCedges Pointer to the number of total BC edges
- * \param[in,out] tria Pointer to a 2D array, used for the triangles
- * \param[in,out] quad Pointer to a 2D array, used for the quadrangles
- */
-void readEMC2(char fileName[STRLEN], double ***vertex, long *nVertices, long ***BCedge,
-		long *nBCedges, long ***tria, long ***quad)
-{
-	/* open the mesh file */
-	FILE *meshFile = fopen(fileName, "r");
-	if (!meshFile) {
-		printf("| ERROR: Could not find Mesh File '%s'\n", fileName);
-		exit(1);
-	}
-
-	char line[STRLEN];
-
-	/* read number of vertices */
-	rewind(meshFile);
-	while (fgets(line, sizeof(line), meshFile)) {
-		if (strstr(line, "Vertices")) {
-			fgets(line, sizeof(line), meshFile);
-			sscanf(line, "%ld", nVertices);
-			break;
-		} else if (strstr(line, "End")) {
-			break;
-		}
-	}
-
-	/* allocate memory for vertices */
-	*vertex = dyn2DdblArray(*nVertices, 2);
-	for (long iVert = 0; iVert < *nVertices; ++iVert) {
-		fgets(line, sizeof(line), meshFile);
-		double x, y;
-		sscanf(line, "%lg %lg", &x, &y);
-		(*vertex)[iVert][X] = x;
-		(*vertex)[iVert][Y] = y;
-	}
-
-	/* read number of edges */
-	long nEdges;
-	rewind(meshFile);
-	while (fgets(line, sizeof(line), meshFile)) {
-		if (strstr(line, "Edges")) {
-			fgets(line, sizeof(line), meshFile);
-			sscanf(line, "%ld", &nEdges);
-			break;
-		} else if (strstr(line, "End")) {
-			break;
-		}
-	}
-
-	/* read edge information, sort out edges with ID 0 */
-	(*nBCedges) = 0;
-	long **tmpEdges = dyn2DintArray(nEdges, 3);
-	for (long iEdge = 0; iEdge < nEdges; ++iEdge) {
-		fgets(line, sizeof(line), meshFile);
-
-		long tmp;
-		sscanf(line, "%*d %*d %ld", &tmp);
-
-		if (tmp != 0) {
-			long tmp0, tmp1, tmp2;
-			sscanf(line, "%ld %ld %ld", &tmp0, &tmp1, &tmp2);
-			tmpEdges[*nBCedges][0] = tmp0;
-			tmpEdges[*nBCedges][1] = tmp1;
-			tmpEdges[*nBCedges][2] = tmp2;
-			(*nBCedges)++;
-		}
-	}
-
-	*BCedge = dyn2DintArray(*nBCedges, 3);
-	for (long iEdge = 0; iEdge < *nBCedges; ++iEdge) {
-		(*BCedge)[iEdge][0] = tmpEdges[iEdge][0] - 1;
-		(*BCedge)[iEdge][1] = tmpEdges[iEdge][1] - 1;
-		(*BCedge)[iEdge][2] = tmpEdges[iEdge][2];
-	}
-
-	free(tmpEdges);
-
-	/* read number of triangles */
-	nTrias = 0;
-	rewind(meshFile);
-	while (fgets(line, sizeof(line), meshFile)) {
-		if (strstr(line, "Triangles")) {
-			fgets(line, sizeof(line), meshFile);
-			sscanf(line, "%ld", &nTrias);
-			break;
-		} else if (strstr(line, "End")) {
-			break;
-		}
-	}
-
-	/* read in triangles */
-	if (nTrias > 0) {
-		*tria = dyn2DintArray(nTrias, 4);
-		for (long iTria = 0; iTria < nTrias; ++iTria) {
-			fgets(line, sizeof(line), meshFile);
-			long tmp0, tmp1, tmp2, tmp3;
-			sscanf(line, "%ld %ld %ld %ld", &tmp0, &tmp1, &tmp2, &tmp3);
-			(*tria)[iTria][0] = tmp0 - 1;
-			(*tria)[iTria][1] = tmp1 - 1;
-			(*tria)[iTria][2] = tmp2 - 1;
-			(*tria)[iTria][3] = tmp3;
-		}
-	}
-
-	/* read number of quadrangles */
-	nQuads = 0;
-	rewind(meshFile);
-	while (fgets(line, sizeof(line), meshFile)) {
-		if (strstr(line, "Quadrangles")) {
-			fgets(line, sizeof(line), meshFile);
-			sscanf(line, "%ld", &nQuads);
-			break;
-		} else if (strstr(line, "End")) {
-			break;
-		}
-	}
-
-	/* read in quadrangles */
-	if (nQuads > 0) {
-		*quad = dyn2DintArray(nQuads, 5);
-		for (long iQuad = 0; iQuad < nQuads; ++iQuad) {
-			fgets(line, sizeof(line), meshFile);
-			long tmp0, tmp1, tmp2, tmp3, tmp4;
-			sscanf(line, "%ld %ld %ld %ld %ld",
-					&tmp0, &tmp1, &tmp2, &tmp3, &tmp4);
-			(*quad)[iQuad][0] = tmp0 - 1;
-			(*quad)[iQuad][1] = tmp1 - 1;
-			(*quad)[iQuad][2] = tmp2 - 1;
-			(*quad)[iQuad][3] = tmp3 - 1;
-			(*quad)[iQuad][4] = tmp4;
+			long tmp0, tmp1, tmp2, tmp3, tmp4;
+			sscanf(line, "%ld %ld %ld %ld %ld",
+					&tmp0, &tmp1, &tmp2, &tmp3, &tmp4);
+			(*quad)[iQuad][0] = tmp0 - 1;
+			(*quad)[iQuad][1] = tmp1 - 1;
+			(*quad)[iQuad][2] = tmp2 - 1;
+			(*quad)[iQuad][3] = tmp3 - 1;
+			(*quad)[iQuad][4] = tmp4;
 		}
 	}
 
@@ -1393,267 +1065,608 @@ void readCGNS(char fileName[STRLEN], double ***vertex, long *nVertices, long ***
 	printf("| %7ld Boundary Edges read\n", *nBCedges);
 }
 
-/** \brief Create a cartesian or structured mesh
- *
- * Read in of all supported mesh types:
- *	- *.msh
- *	- *.msh2
- *	- *.msh4
- *	- *.emc2
- *	- *.cgns
+/**
+ * \brief Compare two entries of a `renumberList_t` list, first by their keys
+ *	and then by their original position
+ * \param[in] a Pointer to an entry of the list
+ * \param[in] b Pointer to an entry of the list
+ * \return Negative, zero or positive, if a is sorted before, equal to or after b
  */
-void createMesh(void)
+int compareRenumber(const void *a, const void *b)
 {
-	nTrias = nQuads = 0;
+	const renumberList_t *A = a;
+	const renumberList_t *B = b;
+	for (int i = 0; i < 2; ++i) {
+		if (A->key[i] != B->key[i]) {
+			return (A->key[i] < B->key[i]) ? -1 : 1;
+		}
+	}
+	return (A->id > B->id) - (A->id < B->id);
+}
 
-	/* create cartesian mesh or read unstructured mesh from file */
-	double **vertex = NULL;
-	long **tria, **quad, **BCedge;
-	tria = quad = BCedge = NULL;
-	long nVertices, nBCedges;
-	switch (meshType) {
-	case CARTESIAN:
-		createCartMesh(&vertex, &nVertices, &BCedge, &nBCedges, &quad);
-		break;
-	case UNSTRUCTURED:
-		if (!strcmp(strMeshFormat, ".msh") ||
-				!strcmp(strMeshFormat, ".msh2") ||
-				!strcmp(strMeshFormat, ".msh4")) {
-			printf("| Reading gmsh File:\n");
+/**
+ * \brief Index of a point along a Hilbert curve
+ * \param[in] n Number of cells of the curve per direction, power of two
+ * \param[in] x Cell index in x-direction
+ * \param[in] y Cell index in y-direction
+ * \return Position of the cell along the curve
+ */
+unsigned long long hilbertIndex(unsigned long n, unsigned long x, unsigned long y)
+{
+	unsigned long long d = 0;
+	for (unsigned long s = n / 2; s > 0; s /= 2) {
+		unsigned long rx = (x & s) > 0;
+		unsigned long ry = (y & s) > 0;
+		d += (unsigned long long)s * s * ((3 * rx) ^ ry);
+
+		/* rotate the quadrant */
+		if (ry == 0) {
+			if (rx == 1) {
+				x = s - 1 - x;
+				y = s - 1 - y;
+			}
+			unsigned long tmp = x;
+			x = y;
+			y = tmp;
+		}
+	}
+	return d;
+}
 
-			readGmsh(strMeshFile, &vertex, &nVertices, &BCedge,
-					&nBCedges, &tria, &quad);
+/**
+ * \brief Order the elements along a Hilbert curve through their barycenters
+ * \param[out] order Element IDs in the order of the curve
+ */
+void hilbertOrder(long *order)
+{
+	renumberList_t *list = malloc((nElems > 0 ? nElems : 1) * sizeof(renumberList_t));
+	if (!list) {
+		printf("| ERROR: could not allocate list\n");
+		exit(1);
+	}
 
-		} else if (!strcmp(strMeshFormat, ".mesh")) {
-			printf("| Reading EMC2 File:\n");
+	unsigned long n = 1ul << 16;
+	double dx = fmax(xMax - xMin, yMax - yMin) * (1.0 + 1e-12);
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		unsigned long x = (elem[iElem]->bary[X] - xMin) / dx * n;
+		unsigned long y = (elem[iElem]->bary[Y] - yMin) / dx * n;
+		list[iElem].key[0] = hilbertIndex(n, fmin(x, n - 1), fmin(y, n - 1));
+		list[iElem].key[1] = 0;
+		list[iElem].id = iElem;
+	}
 
-			readEMC2(strMeshFile, &vertex, &nVertices, &BCedge,
-					&nBCedges, &tria, &quad);
+	qsort(list, nElems, sizeof(list[0]), compareRenumber);
 
-		} else if (!strcmp(strMeshFormat, ".cgns")) {
-			printf("| Reading CGNS File:\n");
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		order[iElem] = list[iElem].id;
+	}
 
-			readCGNS(strMeshFile, &vertex, &nVertices, &BCedge,
-					&nBCedges, &tria, &quad);
+	free(list);
+}
 
-		} else {
-			printf("| ERROR: Unknown Mesh Format\n");
-			exit(1);
+/**
+ * \brief Number of neighbor elements of an element, ghost cells excluded
+ * \param[in] aElem The element
+ * \return Number of neighbors
+ */
+int nNeighbors(elem_t *aElem)
+{
+	int n = 0;
+	side_t *aSide = aElem->firstSide;
+	while (aSide) {
+		if (aSide->connection->elem->id >= 0) {
+			n++;
 		}
-		break;
+		aSide = aSide->nextElemSide;
 	}
+	return n;
+}
 
-	/* generate mesh information */
-	nElems = nTrias + nQuads;
-	nInnerSides = (3 * nTrias + 4 * nQuads - nBCedges) / 2;
-	nBCsides = nBCedges;
-	nSides = nInnerSides + nBCedges;
-	nNodes = 0;
+/**
+ * \brief Breadth first search of the Cuthill-McKee ordering
+ *
+ * Starting from `start`, all unvisited elements of its connected region are
+ * appended to `order`. The neighbors of every element are added ordered by
+ * ascending number of neighbors.
+ * \param[in] start Element ID of the start element
+ * \param[in] degree Number of neighbors of all elements
+ * \param[in,out] isVisited Flag for all elements that are already ordered
+ * \param[in,out] order Element IDs in Cuthill-McKee order
+ * \param[in,out] nOrdered Number of ordered elements
+ */
+void cuthillMcKee(long start, int *degree, bool *isVisited, long *order, long *nOrdered)
+{
+	long head = *nOrdered;
+	order[(*nOrdered)++] = start;
+	isVisited[start] = true;
 
-	/* create nodes */
-	node_t **vertexPtr = calloc(nVertices, sizeof(node_t *));
+	while (head < *nOrdered) {
+		elem_t *aElem = elem[order[head++]];
 
-	xMin = vertex[0][X];
-	xMax = vertex[0][X];
-	yMin = vertex[0][Y];
-	yMax = vertex[0][Y];
+		/* unvisited neighbors, sorted by their degree */
+		long nb[4];
+		int nNb = 0;
+		side_t *aSide = aElem->firstSide;
+		while (aSide) {
+			long id = aSide->connection->elem->id;
+			if ((id >= 0) && (!isVisited[id])) {
+				isVisited[id] = true;
+
+				int i = nNb++;
+				while ((i > 0) && (degree[nb[i - 1]] > degree[id])) {
+					nb[i] = nb[i - 1];
+					i--;
+				}
+				nb[i] = id;
+			}
+			aSide = aSide->nextElemSide;
+		}
 
-	firstNode = NULL;
-	for (long iNode = nVertices - 1; iNode >= 0; --iNode) {
-		node_t *aNode = calloc(1, sizeof(node_t));
-		if (!aNode) {
-			printf("| ERROR: could not allocate aNode\n");
+		for (int i = 0; i < nNb; ++i) {
+			order[(*nOrdered)++] = nb[i];
+		}
+	}
+}
+
+/**
+ * \brief Bandwidth of the element connectivity
+ * \return Maximum difference of the IDs of two neighboring elements
+ */
+long meshBandwidth(void)
+{
+	long bandwidth = 0;
+	for (long iSide = 0; iSide < nSides; ++iSide) {
+		long lElem = side[iSide]->elem->id;
+		long rElem = side[iSide]->connection->elem->id;
+		if ((lElem >= 0) && (rElem >= 0)) {
+			bandwidth = fmax(bandwidth, labs(lElem - rElem));
+		}
+	}
+	return bandwidth;
+}
+
+/**
+ * \brief Renumber the elements and sides to improve the memory locality
+ *
+ * The elements are either ordered by reverse Cuthill-McKee, which minimizes
+ * the bandwidth of the element connectivity, or along a Hilbert curve through
+ * the element barycenters. The sides are then sorted by the IDs of their
+ * elements. Only the `elem`, `side` and `BCside` arrays are reordered, the
+ * element list keeps the order of the mesh file, which is used for all file
+ * output.
+ */
+void renumberMesh(void)
+{
+	if (meshRenumbering == RENUMBER_NONE) {
+		return;
+	}
+
+	long bandwidthOld = meshBandwidth();
+
+	/* new element order: order[newID] = oldID */
+	long *order = malloc(nElems * sizeof(long));
+	if (!order) {
+		printf("| ERROR: could not allocate order\n");
+		exit(1);
+	}
+
+	switch (meshRenumbering) {
+	case RENUMBER_RCM: {
+		int *degree = malloc(nElems * sizeof(int));
+		bool *isVisited = calloc(nElems, sizeof(bool));
+		if ((!degree) || (!isVisited)) {
+			printf("| ERROR: could not allocate RCM arrays\n");
 			exit(1);
 		}
 
-		aNode->id = iNode;
-		aNode->x[X] = vertex[iNode][X];
-		aNode->x[Y] = vertex[iNode][Y];
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			degree[iElem] = nNeighbors(elem[iElem]);
+		}
 
-		xMin = fmin(aNode->x[X], xMin);
-		xMax = fmax(aNode->x[X], xMax);
-		yMin = fmin(aNode->x[Y], yMin);
-		yMax = fmax(aNode->x[Y], yMax);
+		long nOrdered = 0;
+		while (nOrdered < nElems) {
+			/* start a new region at the unvisited element with the
+			 * fewest neighbors */
+			long start = -1;
+			for (long iElem = 0; iElem < nElems; ++iElem) {
+				if ((!isVisited[iElem]) &&
+				    ((start < 0) || (degree[iElem] < degree[start]))) {
+					start = iElem;
+				}
+			}
 
-		aNode->next = firstNode;
-		firstNode = aNode;
+			/* pseudo-peripheral start: the last element of a first
+			 * search from there */
+			long nFirst = nOrdered;
+			cuthillMcKee(start, degree, isVisited, order, &nFirst);
+			start = order[nFirst - 1];
+			for (long i = nOrdered; i < nFirst; ++i) {
+				isVisited[order[i]] = false;
+			}
 
-		vertexPtr[iNode] = aNode;
+			cuthillMcKee(start, degree, isVisited, order, &nOrdered);
+		}
 
-		nNodes++;
+		/* reverse the ordering */
+		for (long i = 0; i < nElems / 2; ++i) {
+			long tmp = order[i];
+			order[i] = order[nElems - 1 - i];
+			order[nElems - 1 - i] = tmp;
+		}
+
+		free(degree);
+		free(isVisited);
+		printf("| Elements renumbered by reverse Cuthill-McKee ordering\n");
+		break;
+	}
+	case RENUMBER_HILBERT:
+		hilbertOrder(order);
+		printf("| Elements renumbered along a Hilbert curve\n");
+		break;
+	default:
+		printf("| ERROR: Mesh renumbering must be 0, 1 or 2\n");
+		exit(1);
 	}
-	free(vertex);
 
-	/* elements and side pointers */
-	sideList_t *sideList = calloc(2 * nSides, sizeof(sideList_t));
+	/* reorder the element array */
+	elem_t **elemOld = elem;
+	elem = malloc(nElems * sizeof(elem_t *));
+	if (!elem) {
+		printf("| ERROR: could not allocate elem\n");
+		exit(1);
+	}
 
-	firstElem = NULL;
-	long iElem = 0, iSidePtr = 0;
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		elem[iElem] = elemOld[order[iElem]];
+		elem[iElem]->id = iElem;
+	}
+	free(elemOld);
+	free(order);
+
+	/* sort the sides by their lower and higher element ID, ghost elements
+	 * are sorted last */
+	renumberList_t *list = malloc((nSides > 0 ? nSides : 1) * sizeof(renumberList_t));
+	if (!list) {
+		printf("| ERROR: could not allocate list\n");
+		exit(1);
+	}
 
-	/* loop over all triangles */
-	elem_t *prevElem = NULL;
-	for (long iTria = 0; iTria < nTrias; ++iTria) {
-		elem_t *aElem = calloc(1, sizeof(elem_t));
-		if (!aElem) {
-			printf("| ERROR: could not allocate aElem\n");
-			exit(1);
+	for (long iSide = 0; iSide < nSides; ++iSide) {
+		unsigned long long lElem = side[iSide]->elem->id;
+		unsigned long long rElem = side[iSide]->connection->elem->id;
+		if (side[iSide]->connection->elem->id < 0) {
+			rElem = nElems;
 		}
+		list[iSide].key[0] = (lElem < rElem) ? lElem : rElem;
+		list[iSide].key[1] = (lElem < rElem) ? rElem : lElem;
+		list[iSide].id = iSide;
+	}
 
-		aElem->id = iElem++;
-		aElem->elemType = 3;
-		aElem->domain = tria[iTria][aElem->elemType];
+	qsort(list, nSides, sizeof(list[0]), compareRenumber);
 
-		if (!firstElem) {
-			firstElem = aElem;
-			prevElem = aElem;
-		} else {
-			prevElem->next = aElem;
-			prevElem = aElem;
-		}
-		aElem->next = NULL;
+	side_t **sideOld = side;
+	side = malloc((nSides > 0 ? nSides : 1) * sizeof(side_t *));
+	if (!side) {
+		printf("| ERROR: could not allocate side\n");
+		exit(1);
+	}
 
-		aElem->node = calloc(aElem->elemType, sizeof(node_t *));
-		if (!aElem->node) {
-			printf("| ERROR: could not allocate aElem->node\n");
-			exit(1);
+	for (long iSide = 0; iSide < nSides; ++iSide) {
+		side[iSide] = sideOld[list[iSide].id];
+	}
+	free(sideOld);
+
+	/* sort the BC sides, and thereby the ghost cells, by their element */
+	for (long iSide = 0; iSide < nBCsides; ++iSide) {
+		list[iSide].key[0] = BCside[iSide]->connection->elem->id;
+		list[iSide].key[1] = 0;
+		list[iSide].id = iSide;
+	}
+
+	qsort(list, nBCsides, sizeof(list[0]), compareRenumber);
+
+	side_t **BCsideOld = malloc((nBCsides > 0 ? nBCsides : 1) * sizeof(side_t *));
+	if (!BCsideOld) {
+		printf("| ERROR: could not allocate BCsideOld\n");
+		exit(1);
+	}
+
+	memcpy(BCsideOld, BCside, nBCsides * sizeof(side_t *));
+	for (long iSide = 0; iSide < nBCsides; ++iSide) {
+		BCside[iSide] = BCsideOld[list[iSide].id];
+	}
+	free(BCsideOld);
+	free(list);
+
+	printf("| Connectivity bandwidth: %ld -> %ld\n", bandwidthOld, meshBandwidth());
+}
+
+/**
+ * \brief Order the sides of a cartesian mesh row by row
+ *
+ * The inner sides normal to the x-axis come first, ordered by their left
+ * element, followed by the inner sides normal to the y-axis, ordered by their
+ * lower element. The boundary and periodic sides follow in their previous
+ * order. For the elements in the order of `createCartMesh`, the inner side
+ * between the elements `iElem` and `iElem + 1` of row `j` is then
+ * `iElem - j`, and the one between the elements `iElem` and `iElem + iMax` is
+ * `(iMax - 1) * jMax + iElem`. The first element of every inner side is
+ * already the one with the lower ID, so only the side array is reordered.
+ */
+void orderCartesianSides(void)
+{
+	long iMax = cartMesh.iMax;
+	long jMax = cartMesh.jMax;
+	long nXsides = (iMax - 1) * jMax;
+	long nInner = nXsides + iMax * (jMax - 1);
+
+	side_t **sideNew = calloc((nSides > 0 ? nSides : 1), sizeof(side_t *));
+	if (!sideNew) {
+		printf("| ERROR: could not allocate sideNew\n");
+		exit(1);
+	}
+
+	long nPlaced = 0, nOther = nInner;
+	for (long iSide = 0; iSide < nSides; ++iSide) {
+		long lElem = side[iSide]->elem->id;
+		long rElem = side[iSide]->connection->elem->id;
+
+		long iNew = -1;
+		if ((lElem < 0) || (rElem < 0) || (rElem >= nElems)) {
+			iNew = -1;
+		} else if ((rElem == lElem + 1) && (lElem % iMax != iMax - 1) &&
+				(side[iSide]->n[X] > 0.0)) {
+			iNew = lElem - lElem / iMax;
+		} else if ((rElem == lElem + iMax) && (side[iSide]->n[Y] > 0.0)) {
+			iNew = nXsides + lElem;
 		}
 
-		for (int iNode = 0; iNode < aElem->elemType; ++iNode) {
-			aElem->node[iNode] = vertexPtr[tria[iTria][iNode]];
+		if (iNew >= 0) {
+			if ((iNew >= nInner) || sideNew[iNew]) {
+				break;
+			}
+			sideNew[iNew] = side[iSide];
+			nPlaced++;
+		} else if (nOther < nSides) {
+			sideNew[nOther++] = side[iSide];
 		}
+	}
+
+	/* keep the previous order, if the mesh does not have the expected
+	 * structure */
+	if ((nPlaced != nInner) || (nOther != nSides)) {
+		free(sideNew);
+		return;
+	}
+
+	free(side);
+	side = sideNew;
+}
+
+/**
+ * \brief Get the time since the last call and restart the measurement
+ * \param[in,out] tLast Time of the last call
+ * \return Time since the last call
+ */
+double lapTime(double *tLast)
+{
+	double tNow = CPU_TIME();
+	double dt = tNow - *tLast;
+	*tLast = tNow;
+	return dt;
+}
+
+/**
+ * \brief Initialize the arenas for the mesh entities, sized for a mesh with
+ *	the current number of triangles and quadrangles, the arenas grow on
+ *	demand
+ * \param[in] nVertices Number of nodes
+ * \param[in] nBCedges Number of boundary edges
+ */
+void initMeshArenas(long nVertices, long nBCedges)
+{
+	long nElemSides = 3 * nTrias + 4 * nQuads;
+
+	initArena(&nodeArena, sizeof(node_t), nVertices);
+	initArena(&elemArena, sizeof(elem_t), nTrias + nQuads + nBCedges);
+	initArena(&sideArena, sizeof(side_t), nElemSides + nBCedges);
+	initArena(&sidePtrArena, sizeof(sidePtr_t), nBCedges);
+	initArena(&elemNodeArena, sizeof(node_t *), nElemSides);
+	initArena(&quadArena, sizeof(double), (NDIM + 1) * (3 * nTrias + 5 * nQuads));
+}
+
+/**
+ * \brief Create an element and its sides, the sides are added to the side
+ *	list for the connection
+ * \param[in] iElem Position of the element in the mesh file
+ * \param[in] elemType Number of nodes of the element
+ * \param[in] elemNode Node IDs of the element, followed by its domain
+ * \param[in] edgeNode Hanging node of every edge, -1 for an edge without
+ *	hanging node, or NULL
+ * \param[in] vertexPtr Pointers to all nodes
+ * \param[in,out] sideList The side list
+ * \param[in,out] iSidePtr Number of entries in the side list
+ * \return Pointer to the element
+ */
+elem_t *createElem(long iElem, int elemType, const long *elemNode,
+		const long *edgeNode, node_t **vertexPtr, sideList_t *sideList,
+		long *iSidePtr)
+{
+	elem_t *aElem = arenaAlloc(&elemArena, 1);
+
+	aElem->id = iElem;
+	aElem->fileId = iElem;
+	aElem->elemType = elemType;
+	aElem->domain = elemNode[elemType];
+	aElem->next = NULL;
+
+	aElem->node = arenaAlloc(&elemNodeArena, aElem->elemType);
+
+	for (int iNode = 0; iNode < aElem->elemType; ++iNode) {
+		aElem->node[iNode] = vertexPtr[elemNode[iNode]];
+	}
+
+	aElem->bary[X] = aElem->bary[Y] = 0;
+	for (int iNode = 0; iNode < aElem->elemType; ++iNode) {
+		aElem->bary[X] += aElem->node[iNode]->x[X] / aElem->elemType;
+		aElem->bary[Y] += aElem->node[iNode]->x[Y] / aElem->elemType;
+	}
 
-		aElem->bary[X] = aElem->bary[Y] = 0;
-		for (int iNode = 0; iNode < aElem->elemType; ++iNode) {
-			aElem->bary[X] += aElem->node[iNode]->x[X] / aElem->elemType;
-			aElem->bary[Y] += aElem->node[iNode]->x[Y] / aElem->elemType;
+	aElem->firstSide = NULL;
+	for (int iEdge = 0; iEdge < aElem->elemType; ++iEdge) {
+		/* an edge with a hanging node consists of two sides */
+		node_t *edge[3] = {aElem->node[iEdge], NULL, NULL};
+		int nEdgeSides = 1;
+		if (edgeNode && (edgeNode[iEdge] >= 0)) {
+			edge[nEdgeSides++] = vertexPtr[edgeNode[iEdge]];
 		}
+		edge[nEdgeSides] = aElem->node[(iEdge + 1) % aElem->elemType];
 
-		aElem->firstSide = NULL;
-		for (int iSide = 0; iSide < aElem->elemType; ++iSide) {
-			side_t *aSide = calloc(1, sizeof(side_t));
-			if (!aSide) {
-				printf("| ERROR: could not allocate aSide\n");
-				exit(1);
-			}
+		for (int i = 0; i < nEdgeSides; ++i) {
+			side_t *aSide = arenaAlloc(&sideArena, 1);
 
-			aSide->id = iSidePtr;
+			aSide->id = *iSidePtr;
 			aSide->connection = NULL;
 			aSide->nextElemSide = NULL;
 			aSide->next = NULL;
 			aSide->BC = NULL;
-			aSide->node[0] = aElem->node[iSide];
-			aSide->node[1] = aElem->node[(iSide + 1) % aElem->elemType];
+			aSide->node[0] = edge[i];
+			aSide->node[1] = edge[i + 1];
 			aSide->elem = aElem;
 
 			aSide->nextElemSide = aElem->firstSide;
 			aElem->firstSide = aSide;
 
-			long iNode1 = aElem->node[iSide]->id;
-			long iNode2 = aElem->node[(iSide + 1) % aElem->elemType]->id;
+			long iNode1 = edge[i]->id;
+			long iNode2 = edge[i + 1]->id;
 
-			sideList[iSidePtr].node[0] = fmin(iNode1, iNode2);
-			sideList[iSidePtr].node[1] = fmax(iNode1, iNode2);
-			sideList[iSidePtr].BC = false;
+			sideList[*iSidePtr].node[0] = fmin(iNode1, iNode2);
+			sideList[*iSidePtr].node[1] = fmax(iNode1, iNode2);
+			sideList[*iSidePtr].BC = false;
 			if (fmin(iNode1, iNode2) == iNode2) {
-				sideList[iSidePtr].isRotated = true;
+				sideList[*iSidePtr].isRotated = true;
 			} else {
-				sideList[iSidePtr].isRotated = false;
+				sideList[*iSidePtr].isRotated = false;
 			}
-			sideList[iSidePtr].side = aSide;
+			sideList[*iSidePtr].side = aSide;
 
-			iSidePtr++;
+			(*iSidePtr)++;
 		}
 	}
-	if (nTrias > 0) {
-		free(tria);
-	}
 
-	/* loop over all quadrilaterals */
-	for (long iQuad = 0; iQuad < nQuads; ++iQuad) {
-		elem_t *aElem = calloc(1, sizeof(elem_t));
-		if (!aElem) {
-			printf("| ERROR: could not allocate aElem\n");
-			exit(0);
-		}
+	return aElem;
+}
 
-		aElem->id = iElem++;
-		aElem->elemType = 4;
-		aElem->domain = quad[iQuad][aElem->elemType];
+/**
+ * \brief Create the nodes, elements and sides of a mesh, connect them and
+ *	compute their geometry
+ *
+ * The elements are given by their node IDs, followed by their domain, the
+ * global `nTrias` and `nQuads` have to be set. An element edge may be split
+ * by the hanging node of a finer neighbor element: `edgeNode[iElem][iEdge]`
+ * is then the node in the middle of the edge from node `iEdge` to the next
+ * node of the element, otherwise it is -1, `iElem` counts the triangles
+ * first. The element keeps its corner nodes, but gets a side for each half
+ * of the edge, so that the fluxes over the hanging sides are calculated like
+ * over all other sides. All arrays are freed.
+ * \param[in] vertex Coordinates of the nodes
+ * \param[in] nVertices Number of nodes
+ * \param[in] BCedge Node IDs and BC code of the boundary edges
+ * \param[in] nBCedges Number of boundary edges
+ * \param[in] tria Nodes and domain of the triangles
+ * \param[in] quad Nodes and domain of the quadrilaterals
+ * \param[in] edgeNode Hanging nodes of the element edges, or NULL for a
+ *	conforming mesh
+ * \param[out] tPhase Time for the connectivity, the geometry and the BC setup
+ */
+void buildMesh(double **vertex, long nVertices, long **BCedge, long nBCedges,
+		long **tria, long **quad, long **edgeNode, double tPhase[3])
+{
+	double tLast = CPU_TIME();
 
-		if (!firstElem) {
-			firstElem = aElem;
-			prevElem = aElem;
-		} else {
-			prevElem->next = aElem;
-			prevElem = aElem;
+	/* generate mesh information */
+	nElems = nTrias + nQuads;
+	long nHangingNodes = 0;
+	for (long iElem = 0; (iElem < nElems) && edgeNode; ++iElem) {
+		for (int iEdge = 0; iEdge < (iElem < nTrias ? 3 : 4); ++iEdge) {
+			nHangingNodes += (edgeNode[iElem][iEdge] >= 0);
 		}
-		aElem->next = NULL;
+	}
+	nInnerSides = (3 * nTrias + 4 * nQuads + nHangingNodes - nBCedges) / 2;
+	nBCsides = nBCedges;
+	nSides = nInnerSides + nBCedges;
+	nNodes = 0;
 
-		aElem->node = calloc(aElem->elemType, sizeof(node_t *));
-		if (!aElem->node) {
-			printf("| ERROR: could not allocate aElem->node\n");
-			exit(0);
-		}
+	/* create nodes */
+	initMeshArenas(nVertices, nBCedges);
+	node_t **vertexPtr = calloc(nVertices, sizeof(node_t *));
 
-		for (int iNode = 0; iNode < aElem->elemType; ++iNode) {
-			aElem->node[iNode] = vertexPtr[quad[iQuad][iNode]];
-		}
+	xMin = vertex[0][X];
+	xMax = vertex[0][X];
+	yMin = vertex[0][Y];
+	yMax = vertex[0][Y];
 
-		aElem->bary[X] = aElem->bary[Y] = 0;
-		for (int iNode = 0; iNode < aElem->elemType; ++iNode) {
-			aElem->bary[X] += aElem->node[iNode]->x[X] / aElem->elemType;
-			aElem->bary[Y] += aElem->node[iNode]->x[Y] / aElem->elemType;
-		}
+	firstNode = NULL;
+	for (long iNode = nVertices - 1; iNode >= 0; --iNode) {
+		node_t *aNode = arenaAlloc(&nodeArena, 1);
 
-		aElem->firstSide = NULL;
-		for (int iSide = 0; iSide < aElem->elemType; ++iSide) {
-			side_t *aSide = calloc(1, sizeof(side_t));
-			if (!aSide) {
-				printf("| ERROR: could not allocate aSide\n");
-				exit(0);
-			}
+		aNode->id = iNode;
+		aNode->x[X] = vertex[iNode][X];
+		aNode->x[Y] = vertex[iNode][Y];
 
-			aSide->id = iSidePtr;
-			aSide->connection = NULL;
-			aSide->nextElemSide = NULL;
-			aSide->next = NULL;
-			aSide->BC = NULL;
-			aSide->node[0] = aElem->node[iSide];
-			aSide->node[1] = aElem->node[(iSide + 1) % aElem->elemType];
-			aSide->elem = aElem;
+		xMin = fmin(aNode->x[X], xMin);
+		xMax = fmax(aNode->x[X], xMax);
+		yMin = fmin(aNode->x[Y], yMin);
+		yMax = fmax(aNode->x[Y], yMax);
+
+		aNode->next = firstNode;
+		firstNode = aNode;
+
+		vertexPtr[iNode] = aNode;
 
-			aSide->nextElemSide = aElem->firstSide;
-			aElem->firstSide = aSide;
+		nNodes++;
+	}
+	free(vertex);
 
-			long iNode1 = aElem->node[iSide]->id;
-			long iNode2 = aElem->node[(iSide + 1) % aElem->elemType]->id;
+	/* elements and side pointers */
+	sideList_t *sideList = calloc(2 * nSides, sizeof(sideList_t));
 
-			sideList[iSidePtr].node[0] = fmin(iNode1, iNode2);
-			sideList[iSidePtr].node[1] = fmax(iNode1, iNode2);
-			sideList[iSidePtr].BC = false;
-			if (fmin(iNode1, iNode2) == iNode2) {
-				sideList[iSidePtr].isRotated = true;
-			} else {
-				sideList[iSidePtr].isRotated = false;
-			}
-			sideList[iSidePtr].side = aSide;
+	firstElem = NULL;
+	long iSidePtr = 0;
 
-			iSidePtr++;
+	/* the triangles come first, followed by the quadrilaterals */
+	elem_t *prevElem = NULL;
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		elem_t *aElem;
+		if (iElem < nTrias) {
+			aElem = createElem(iElem, 3, tria[iElem],
+					(edgeNode ? edgeNode[iElem] : NULL), vertexPtr,
+					sideList, &iSidePtr);
+		} else {
+			aElem = createElem(iElem, 4, quad[iElem - nTrias],
+					(edgeNode ? edgeNode[iElem] : NULL), vertexPtr,
+					sideList, &iSidePtr);
 		}
 
+		if (!firstElem) {
+			firstElem = aElem;
+		} else {
+			prevElem->next = aElem;
+		}
+		prevElem = aElem;
+	}
+	if (nTrias > 0) {
+		free(tria);
 	}
 	if (nQuads > 0) {
 		free(quad);
 	}
+	free(edgeNode);
 
 	/* sides and connectivity */
 	/* save all BCedges into the sideList array */
 	for (long iSide = 0; iSide < nBCsides; ++iSide) {
-		side_t *aSide = calloc(1, sizeof(side_t));
-		if (!aSide) {
-			printf("| ERROR: could not allocate aSide\n");
-			exit(0);
-		}
+		side_t *aSide = arenaAlloc(&sideArena, 1);
 
 		aSide->id = iSidePtr;
 		aSide->connection = NULL;
@@ -1662,11 +1675,7 @@ void createMesh(void)
 		aSide->node[0] = vertexPtr[BCedge[iSide][0]];
 		aSide->node[1] = vertexPtr[BCedge[iSide][1]];
 
-		elem_t *aElem = calloc(1, sizeof(elem_t));
-		if (!aElem) {
-			printf("| ERROR: could not allocate aElem\n");
-			exit(0);
-		}
+		elem_t *aElem = arenaAlloc(&elemArena, 1);
 
 		aElem->id = -1;
 		aSide->elem = aElem;
@@ -1707,7 +1716,7 @@ void createMesh(void)
 	free(vertexPtr);
 
 	/* sort sideList */
-	qsort(sideList, 2 * nSides, sizeof(sideList[0]), compare);
+	sortSideList(&sideList, 2 * nSides, nVertices);
 
 	/* initialize side lists in mesh */
 	firstSide = NULL;
@@ -1736,11 +1745,7 @@ void createMesh(void)
 			}
 
 			/* save boundary side (bSide) into boundary side list */
-			sidePtr_t *aBCside = calloc(1, sizeof(sidePtr_t));
-			if (!aBCside) {
-				printf("| ERROR: could not allocate aBCside\n");
-				exit(1);
-			}
+			sidePtr_t *aBCside = arenaAlloc(&sidePtrArena, 1);
 
 			aBCside->side = bSide;
 			aBCside->next = firstBCside;
@@ -1754,6 +1759,7 @@ void createMesh(void)
 		bSide->connection = aSide;
 	}
 	free(sideList);
+	tPhase[0] = lapTime(&tLast);
 
 	/* extend element info: area and projection of cell onto axes */
 	totalArea_q = 0.0;
@@ -1762,6 +1768,7 @@ void createMesh(void)
 		createElemInfo(aElem);
 		aElem = aElem->next;
 	}
+	tPhase[1] = lapTime(&tLast);
 
 	/* generate virtual barycenters and ghostcells */
 	sidePtr_t *aBCside = firstBCside;
@@ -1779,6 +1786,7 @@ void createMesh(void)
 
 		aBCside = aBCside->next;
 	}
+	tPhase[2] = lapTime(&tLast);
 
 	/* extend side info: vector between barycenters, gaussian integration
 	 * points and normal vectors */
@@ -1787,9 +1795,11 @@ void createMesh(void)
 		createSideInfo(aSide);
 		aSide = aSide->next;
 	}
+	tPhase[1] += lapTime(&tLast);
 
 	/* periodic BCs */
 	connectPeriodicBC();
+	tPhase[2] += lapTime(&tLast);
 
 	/* variables for reconstruction */
 	aElem = firstElem;
@@ -1797,6 +1807,7 @@ void createMesh(void)
 		createReconstructionInfo(aElem);
 		aElem = aElem->next;
 	}
+	tPhase[1] += lapTime(&tLast);
 
 	/* element and side lists */
 	side = calloc(nSides, sizeof(side_t *));
@@ -1818,7 +1829,7 @@ void createMesh(void)
 	}
 
 	aElem = firstElem;
-	iElem = 0;
+	long iElem = 0;
 	while (aElem) {
 		elem[iElem++] = aElem;
 		aElem = aElem->next;
@@ -1841,6 +1852,466 @@ void createMesh(void)
 		aBCside = aBCside->next;
 	}
 	nBCsides = iSide;
+	nElemsGlobal = nElems;
+	nHaloElems = 0;
+	nInterfaceSides = 0;
+	tPhase[0] += lapTime(&tLast);
+
+}
+
+/** \brief Create a cartesian or structured mesh
+ *
+ * Read in of all supported mesh types:
+ *	- *.msh
+ *	- *.msh2
+ *	- *.msh4
+ *	- *.emc2
+ *	- *.cgns
+ */
+void createMesh(void)
+{
+	nTrias = nQuads = 0;
+	double tLast = CPU_TIME();
+
+	/* create cartesian mesh or read unstructured mesh from file */
+	double **vertex = NULL;
+	long **tria, **quad, **BCedge;
+	tria = quad = BCedge = NULL;
+	long nVertices = 0, nBCedges = 0;
+	switch (meshType) {
+	case CARTESIAN:
+		createCartMesh(&vertex, &nVertices, &BCedge, &nBCedges, &quad);
+		break;
+	case UNSTRUCTURED:
+		if (!strcmp(strMeshFormat, ".msh") ||
+				!strcmp(strMeshFormat, ".msh2") ||
+				!strcmp(strMeshFormat, ".msh4")) {
+			printf("| Reading gmsh File:\n");
+
+			readGmsh(strMeshFile, &vertex, &nVertices, &BCedge,
+					&nBCedges, &tria, &quad);
+
+		} else if (!strcmp(strMeshFormat, ".mesh")) {
+			printf("| Reading EMC2 File:\n");
+
+			readEMC2(strMeshFile, &vertex, &nVertices, &BCedge,
+					&nBCedges, &tria, &quad);
+
+		} else if (!strcmp(strMeshFormat, ".cgns")) {
+			printf("| Reading CGNS File:\n");
+
+			readCGNS(strMeshFile, &vertex, &nVertices, &BCedge,
+					&nBCedges, &tria, &quad);
+
+		} else {
+			printf("| ERROR: Unknown Mesh Format\n");
+			exit(1);
+		}
+		break;
+	}
+
+	double tRead = lapTime(&tLast);
+
+	double tPhase[3];
+	buildMesh(vertex, nVertices, BCedge, nBCedges, tria, quad, NULL, tPhase);
+	double tConnect = tPhase[0], tGeometry = tPhase[1], tBC = tPhase[2];
+	lapTime(&tLast);
+
+	renumberMesh();
+	if ((meshType == CARTESIAN) && (meshRenumbering == RENUMBER_NONE)) {
+		orderCartesianSides();
+	}
+	double tRenumber = lapTime(&tLast);
+
+	printf("| Mesh Setup Time: %g s\n", tRead + tConnect + tGeometry + tBC + tRenumber);
+	printf("|   Read %g s, Connect %g s, Geometry %g s, BC Setup %g s, Renumbering %g s\n",
+			tRead, tConnect, tGeometry, tBC, tRenumber);
+}
+
+/**
+ * \brief Distribute the elements among the MPI ranks
+ *
+ * Every rank holds the complete mesh after reading it. The elements are
+ * split into chunks of equal size along a Hilbert curve, which gives compact
+ * partitions with short interfaces. Each rank keeps its own elements, in
+ * their previous order, and the elements of the neighbor partitions that
+ * share a side with them as halo elements, sorted by their owner. The local
+ * sides are the sides of the owned elements, and the interface sides to the
+ * halo elements are moved to the end of the side array, so that their fluxes
+ * can be calculated after the halo exchange. All other elements and sides
+ * are dropped, their memory stays in the mesh arenas, and the element list
+ * is reduced to the owned elements, still in the order of the mesh file.
+ */
+void partitionMesh(void)
+{
+	if (mpiSize == 1) {
+		return;
+	}
+
+	if (nElems < mpiSize) {
+		printf("| ERROR: Less elements than MPI ranks\n");
+		exit(1);
+	}
+
+	/* owner of every element */
+	long *order = malloc(nElems * sizeof(long));
+	int *owner = malloc(nElems * sizeof(int));
+	if ((!order) || (!owner)) {
+		printf("| ERROR: could not allocate owner\n");
+		exit(1);
+	}
+
+	hilbertOrder(order);
+	for (long i = 0; i < nElems; ++i) {
+		owner[order[i]] = i * mpiSize / nElems;
+	}
+	free(order);
+
+	/* owned elements (1) and halo elements (2) */
+	int *status = malloc(nElems * sizeof(int));
+	if (!status) {
+		printf("| ERROR: could not allocate status\n");
+		exit(1);
+	}
+
+	long nOwned = 0;
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		status[iElem] = (owner[iElem] == mpiRank);
+		nOwned += status[iElem];
+	}
+
+	long nHalo = 0;
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		if (status[iElem] != 1) {
+			continue;
+		}
+
+		side_t *aSide = elem[iElem]->firstSide;
+		while (aSide) {
+			long NBelem = aSide->connection->elem->id;
+			if ((NBelem >= 0) && (status[NBelem] == 0)) {
+				status[NBelem] = 2;
+				nHalo++;
+			}
+			aSide = aSide->nextElemSide;
+		}
+	}
+
+	/* local element array: owned elements, followed by the halo elements
+	 * sorted by their owner */
+	renumberList_t *list = malloc((nHalo > 0 ? nHalo : 1) * sizeof(renumberList_t));
+	elem_t **elemLocal = malloc((nOwned + nHalo) * sizeof(elem_t *));
+	int *haloRank = malloc((nHalo > 0 ? nHalo : 1) * sizeof(int));
+	if ((!list) || (!elemLocal) || (!haloRank)) {
+		printf("| ERROR: could not allocate elemLocal\n");
+		exit(1);
+	}
+
+	long iOwned = 0, iHalo = 0;
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		if (status[iElem] == 1) {
+			elemLocal[iOwned++] = elem[iElem];
+		} else if (status[iElem] == 2) {
+			list[iHalo].key[0] = owner[iElem];
+			list[iHalo].key[1] = iElem;
+			list[iHalo++].id = iElem;
+		}
+	}
+
+	qsort(list, nHalo, sizeof(list[0]), compareRenumber);
+
+	for (iHalo = 0; iHalo < nHalo; ++iHalo) {
+		elemLocal[nOwned + iHalo] = elem[list[iHalo].id];
+		haloRank[iHalo] = owner[list[iHalo].id];
+	}
+	free(list);
+	free(owner);
+
+	/* local sides, the interface sides start at the owned element */
+	side_t **sideLocal = malloc((nSides > 0 ? nSides : 1) * sizeof(side_t *));
+	if (!sideLocal) {
+		printf("| ERROR: could not allocate sideLocal\n");
+		exit(1);
+	}
+
+	long nSidesLocal = 0, nInterface = 0;
+	for (long iSide = 0; iSide < nSides; ++iSide) {
+		long lElem = side[iSide]->elem->id;
+		long rElem = side[iSide]->connection->elem->id;
+		if ((status[lElem] == 1) && ((rElem < 0) || (status[rElem] == 1))) {
+			sideLocal[nSidesLocal++] = side[iSide];
+		}
+	}
+
+	for (long iSide = 0; iSide < nSides; ++iSide) {
+		long lElem = side[iSide]->elem->id;
+		long rElem = side[iSide]->connection->elem->id;
+		if ((rElem < 0) || (status[lElem] + status[rElem] != 3)) {
+			continue;
+		}
+
+		if (status[lElem] == 1) {
+			sideLocal[nSidesLocal++] = side[iSide];
+		} else {
+			sideLocal[nSidesLocal++] = side[iSide]->connection;
+		}
+		nInterface++;
+	}
+
+	firstSide = (nSidesLocal > 0 ? sideLocal[0] : NULL);
+	for (long iSide = 0; iSide < nSidesLocal; ++iSide) {
+		sideLocal[iSide]->next = (iSide + 1 < nSidesLocal ? sideLocal[iSide + 1] : NULL);
+	}
+
+	/* boundary sides of the owned elements */
+	long nBCsidesLocal = 0;
+	for (long iSide = 0; iSide < nBCsides; ++iSide) {
+		if (status[BCside[iSide]->connection->elem->id] == 1) {
+			BCside[nBCsidesLocal++] = BCside[iSide];
+		}
+	}
+
+	sidePtr_t **aBCsidePtr = &firstBCside;
+	while (*aBCsidePtr) {
+		sidePtr_t *aBCside = *aBCsidePtr;
+		if (status[aBCside->side->connection->elem->id] == 1) {
+			aBCsidePtr = &aBCside->next;
+		} else {
+			*aBCsidePtr = aBCside->next;
+		}
+	}
+
+	/* element list in mesh file order */
+	elem_t **aElemPtr = &firstElem;
+	while (*aElemPtr) {
+		if (status[(*aElemPtr)->id] == 1) {
+			aElemPtr = &(*aElemPtr)->next;
+		} else {
+			*aElemPtr = (*aElemPtr)->next;
+		}
+	}
+
+	free(status);
+
+	free(elem);
+	free(side);
+	elem = elemLocal;
+	side = sideLocal;
+
+	nElems = nOwned;
+	nHaloElems = nHalo;
+	nSides = nSidesLocal;
+	nBCsides = nBCsidesLocal;
+	nInnerSides = nSides - nBCsides;
+	nInterfaceSides = nInterface;
+
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		elem[iElem]->id = iElem;
+	}
+
+	for (iHalo = 0; iHalo < nHaloElems; ++iHalo) {
+		elem[nElems + iHalo]->id = nElems + nBCsides + iHalo;
+	}
+
+	createHaloExchange(nHaloElems, haloRank);
+	free(haloRank);
+}
+
+/**
+ * \brief Create the structure-of-arrays copies of the mesh data, used by the
+ *	solver kernels, and allocate the arrays for the solution
+ */
+void createDataArrays(void)
+{
+	long nTotal = nElems + nBCsides + nHaloElems;
+
+	/* IDs: ghost elements follow the physical elements, element sides are
+	 * numbered per side */
+	for (long iSide = 0; iSide < nBCsides; ++iSide) {
+		BCside[iSide]->elem->id = nElems + iSide;
+	}
+
+	sidePtr_t *aBCside = firstBCside;
+	while (aBCside) {
+		if (aBCside->side->BC->BCtype == PERIODIC) {
+			aBCside->side->id = -1;
+		}
+		aBCside = aBCside->next;
+	}
+
+	for (long iSide = 0; iSide < nSides; ++iSide) {
+		side[iSide]->id = 2 * iSide;
+		side[iSide]->connection->id = 2 * iSide + 1;
+	}
+
+	/* element arrays */
+	elemData.bary = dyn2DdblArray(NDIM, nTotal);
+	elemData.sx = dyn1DdblArray(nElems);
+	elemData.sy = dyn1DdblArray(nElems);
+	elemData.area = dyn1DdblArray(nElems);
+	elemData.areaq = dyn1DdblArray(nElems);
+	elemData.sideOffset = dyn1DintArray(nElems + 1);
+
+	elemData.pVar = dyn2DdblArray(NVAR, nTotal);
+	elemData.cVar = dyn2DdblArray(NVAR, nElems);
+	elemData.cVarStage = dyn2DdblArray(NVAR, nElems);
+	elemData.u_x = dyn2DdblArray(NVAR, nTotal);
+	elemData.u_y = dyn2DdblArray(NVAR, nTotal);
+	elemData.u_t = dyn2DdblArray(NVAR, nElems);
+	elemData.source = dyn2DdblArray(NVAR, nElems);
+	elemData.dt = dyn1DdblArray(nElems);
+	elemData.dtLoc = dyn1DdblArray(nElems);
+	elemData.venkEps_sq = dyn1DdblArray(nElems);
+
+	/* the pages are placed by the threads that work on the elements, before
+	 * the serial loops below write to them */
+	firstTouch(elemData.bary[0], NDIM, nTotal, sizeof(double));
+	firstTouch(elemData.sx, 1, nElems, sizeof(double));
+	firstTouch(elemData.sy, 1, nElems, sizeof(double));
+	firstTouch(elemData.area, 1, nElems, sizeof(double));
+	firstTouch(elemData.areaq, 1, nElems, sizeof(double));
+	firstTouch(elemData.sideOffset, 1, nElems + 1, sizeof(long));
+	firstTouch(elemData.pVar[0], NVAR, nTotal, sizeof(double));
+	firstTouch(elemData.cVar[0], NVAR, nElems, sizeof(double));
+	firstTouch(elemData.cVarStage[0], NVAR, nElems, sizeof(double));
+	firstTouch(elemData.u_x[0], NVAR, nTotal, sizeof(double));
+	firstTouch(elemData.u_y[0], NVAR, nTotal, sizeof(double));
+	firstTouch(elemData.u_t[0], NVAR, nElems, sizeof(double));
+	firstTouch(elemData.source[0], NVAR, nElems, sizeof(double));
+	firstTouch(elemData.dt, 1, nElems, sizeof(double));
+	firstTouch(elemData.dtLoc, 1, nElems, sizeof(double));
+	firstTouch(elemData.venkEps_sq, 1, nElems, sizeof(double));
+
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		elem_t *aElem = elem[iElem];
+		elemData.bary[X][iElem] = aElem->bary[X];
+		elemData.bary[Y][iElem] = aElem->bary[Y];
+		elemData.sx[iElem] = aElem->sx;
+		elemData.sy[iElem] = aElem->sy;
+		elemData.area[iElem] = aElem->area;
+		elemData.areaq[iElem] = aElem->areaq;
+
+		long nElemSides = 0;
+		side_t *aSide = aElem->firstSide;
+		while (aSide) {
+			nElemSides++;
+			aSide = aSide->nextElemSide;
+		}
+		elemData.sideOffset[iElem + 1] = elemData.sideOffset[iElem] + nElemSides;
+	}
+
+	for (long iSide = 0; iSide < nBCsides; ++iSide) {
+		elem_t *gElem = BCside[iSide]->elem;
+		elemData.bary[X][gElem->id] = gElem->bary[X];
+		elemData.bary[Y][gElem->id] = gElem->bary[Y];
+	}
+
+	for (long iHalo = 0; iHalo < nHaloElems; ++iHalo) {
+		elem_t *hElem = elem[nElems + iHalo];
+		elemData.bary[X][hElem->id] = hElem->bary[X];
+		elemData.bary[Y][hElem->id] = hElem->bary[Y];
+	}
+
+	elemData.sideIdx = dyn1DintArray(elemData.sideOffset[nElems]);
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		long j = elemData.sideOffset[iElem];
+		side_t *aSide = elem[iElem]->firstSide;
+		while (aSide) {
+			elemData.sideIdx[j++] = aSide->id;
+			aSide = aSide->nextElemSide;
+		}
+	}
+
+	/* side arrays */
+	sideData.n = dyn2DdblArray(NDIM, nSides);
+	sideData.len = dyn1DdblArray(nSides);
+	sideData.baryBaryVec = dyn2DdblArray(NDIM, nSides);
+	sideData.baryBaryDist = dyn1DdblArray(nSides);
+	sideData.flux = dyn2DdblArray(NVAR, nSides);
+	sideData.elem = dyn1DintArray(2 * nSides);
+	sideData.GP = dyn2DdblArray(NDIM, 2 * nSides);
+	sideData.w = dyn2DdblArray(NDIM, 2 * nSides);
+	sideData.pVar = dyn2DfaceArray(NVAR, 2 * nSides);
+
+	firstTouch(sideData.n[0], NDIM, nSides, sizeof(double));
+	firstTouch(sideData.len, 1, nSides, sizeof(double));
+	firstTouch(sideData.baryBaryVec[0], NDIM, nSides, sizeof(double));
+	firstTouch(sideData.baryBaryDist, 1, nSides, sizeof(double));
+	firstTouch(sideData.flux[0], NVAR, nSides, sizeof(double));
+	firstTouch(sideData.elem, 1, 2 * nSides, sizeof(long));
+	firstTouch(sideData.GP[0], NDIM, 2 * nSides, sizeof(double));
+	firstTouch(sideData.w[0], NDIM, 2 * nSides, sizeof(double));
+	firstTouch(sideData.pVar[0], NVAR, 2 * nSides, sizeof(face_t));
+
+	for (long iSide = 0; iSide < nSides; ++iSide) {
+		side_t *aSide = side[iSide];
+		sideData.n[X][iSide] = aSide->n[X];
+		sideData.n[Y][iSide] = aSide->n[Y];
+		sideData.len[iSide] = aSide->len;
+		sideData.baryBaryVec[X][iSide] = aSide->baryBaryVec[X];
+		sideData.baryBaryVec[Y][iSide] = aSide->baryBaryVec[Y];
+		sideData.baryBaryDist[iSide] = aSide->baryBaryDist;
+
+		for (int i = 0; i < 2; ++i) {
+			side_t *bSide = (i == 0 ? aSide : aSide->connection);
+			sideData.elem[bSide->id] = bSide->elem->id;
+			sideData.GP[X][bSide->id] = bSide->GP[X];
+			sideData.GP[Y][bSide->id] = bSide->GP[Y];
+			sideData.w[X][bSide->id] = bSide->w[X];
+			sideData.w[Y][bSide->id] = bSide->w[Y];
+		}
+	}
+
+	sideData.BCsideId = dyn1DintArray(nBCsides);
+	sideData.BC = calloc((nBCsides > 0 ? nBCsides : 1), sizeof(boundary_t *));
+	if (!sideData.BC) {
+		printf("| ERROR: could not allocate sideData.BC\n");
+		exit(1);
+	}
+
+	for (long iSide = 0; iSide < nBCsides; ++iSide) {
+		sideData.BCsideId[iSide] = BCside[iSide]->connection->id / 2;
+		sideData.BC[iSide] = BCside[iSide]->BC;
+	}
+
+	groupBCsides(&sideData, &elemData, nElems, nBCsides);
+}
+
+/**
+ * \brief Free the structure-of-arrays copies of the mesh data
+ */
+void freeDataArrays(void)
+{
+	free(elemData.bary);
+	free(elemData.sx);
+	free(elemData.sy);
+	free(elemData.area);
+	free(elemData.areaq);
+	free(elemData.sideOffset);
+	free(elemData.sideIdx);
+	free(elemData.pVar);
+	free(elemData.cVar);
+	free(elemData.cVarStage);
+	free(elemData.u_x);
+	free(elemData.u_y);
+	free(elemData.u_t);
+	free(elemData.source);
+	free(elemData.dt);
+	free(elemData.dtLoc);
+	free(elemData.venkEps_sq);
+
+	free(sideData.n);
+	free(sideData.len);
+	free(sideData.baryBaryVec);
+	free(sideData.baryBaryDist);
+	free(sideData.flux);
+	free(sideData.elem);
+	free(sideData.GP);
+	free(sideData.w);
+	free(sideData.pVar);
+	free(sideData.BCsideId);
+	free(sideData.BC);
+	freeBCgroups(&sideData);
 }
 
 /**
@@ -1849,6 +2320,8 @@ void createMesh(void)
 void readMesh(void)
 {
 	meshType = getInt("meshType", "1"); /* default is cartesian */
+	meshRenumbering = getInt("meshRenumbering", "0");
+	useMeshCache = getBool("meshCache", "F");
 	switch (meshType) {
 	case UNSTRUCTURED:
 		printf("| Mesh Type is UNSTRUCTURED\n");
@@ -1906,6 +2379,9 @@ void readMesh(void)
 		printf("ERROR: Mesh type can only be unstructured(=0) or cartesian(=1)\n");
 		exit(1);
 	}
+
+	/* the coarse mesh of a mesh sequencing stage */
+	sequenceMesh();
 }
 
 /**
@@ -1916,69 +2392,145 @@ void initMesh(void)
 	printf("\nInitializing Mesh:\n");
 	readMesh();
 	strcat(strcpy(gridFile, strOutFile), "_mesh.cgns");
-	createMesh();
-	if ((iVisuProg == CGNS) && (!isRestart)) {
+	if (!readMeshCache()) {
+		createMesh();
+		writeMeshCache();
+	}
+
+	checkRestartMesh();
+	if ((iVisuProg == CGNS) && ((!isRestart) || isMappedRestart) && (mpiRank == 0)
+			&& (!isGridFileCurrent())) {
 		cgnsWriteMesh();
 	}
 	dxRef = sqrt(1.0 / (totalArea_q * nElems));
+	partitionMesh();
+	createDataArrays();
+	createPointLocation();
 }
 
 /**
- * \brief Free all allocated memory of the mesh
+ * \brief Keep the mesh for the next variant of a batch calculation
+ *
+ * The mesh parameters of the variant are read and have to describe the same
+ * mesh. The solution arrays are reset, so the variant starts from the same
+ * state as a separate calculation.
  */
-void freeMesh(void)
+void reuseMesh(void)
 {
-	/* free all nodes */
-	node_t *aNode = firstNode;
-	while (aNode) {
-		if (aNode->next) {
-			node_t *tmp = aNode;
-			aNode = aNode->next;
-			free(tmp);
-		} else {
-			free(aNode);
-			break;
-		}
-	}
+	printf("\nReusing Mesh:\n");
 
-	/* free all elements and their corresponding sides */
-	for (long iElem = 0; iElem < nElems; ++iElem) {
-		elem_t *aElem = elem[iElem];
-		free(aElem->xGP);
-		free(aElem->wGP);
-		free(aElem->node);
+	int meshTypeOld = meshType;
+	int meshRenumberingOld = meshRenumbering;
+	char strMeshFileOld[STRLEN];
+	strcpy(strMeshFileOld, strMeshFile);
+	cartMesh_t cartMeshOld = cartMesh;
+	double box[2 * NDIM] = {xMin, xMax, yMin, yMax};
 
-		side_t *aSide = aElem->firstSide;
-		while (aSide) {
-			if (aSide->nextElemSide) {
-				side_t *tmp = aSide;
-				aSide = aSide->nextElemSide;
-				free(tmp);
-			} else {
-				free(aSide);
-				break;
-			}
-		}
+	readMesh();
+
+	bool isSame = (meshType == meshTypeOld) && (meshRenumbering == meshRenumberingOld);
+	if (isSame && (meshType == UNSTRUCTURED)) {
+		isSame = !strcmp(strMeshFile, strMeshFileOld);
+	} else if (isSame) {
+		/* the extensions of the mesh are the ones of the vertices */
+		double tol = 1e-8 * fmax(box[1] - box[0], box[3] - box[2]);
+		isSame = (cartMesh.iMax == cartMeshOld.iMax) &&
+			(cartMesh.jMax == cartMeshOld.jMax) &&
+			!memcmp(cartMesh.nBC, cartMeshOld.nBC, 2 * NDIM * sizeof(int)) &&
+			!memcmp(cartMesh.BCtype, cartMeshOld.BCtype, sizeof(cartMesh.BCtype)) &&
+			!memcmp(cartMesh.BCrange, cartMeshOld.BCrange, sizeof(cartMesh.BCrange)) &&
+			(fabs(xMin - box[0]) < tol) && (fabs(xMax - box[1]) < tol) &&
+			(fabs(yMin - box[2]) < tol) && (fabs(yMax - box[3]) < tol);
+		free(cartMeshOld.nBC);
+	}
 
-		free(aElem);
+	if (!isSame) {
+		printf("| ERROR: The mesh cannot change between batch variants\n");
+		exit(1);
 	}
+
+	xMin = box[0];
+	xMax = box[1];
+	yMin = box[2];
+	yMax = box[3];
+
+	/* reset the solution */
+	long nTotal = nElems + nBCsides + nHaloElems;
+	memset(elemData.pVar[0], 0, NVAR * nTotal * sizeof(double));
+	memset(elemData.cVar[0], 0, NVAR * nElems * sizeof(double));
+	memset(elemData.cVarStage[0], 0, NVAR * nElems * sizeof(double));
+	memset(elemData.u_x[0], 0, NVAR * nTotal * sizeof(double));
+	memset(elemData.u_y[0], 0, NVAR * nTotal * sizeof(double));
+	memset(elemData.u_t[0], 0, NVAR * nElems * sizeof(double));
+	memset(elemData.source[0], 0, NVAR * nElems * sizeof(double));
+	memset(elemData.dt, 0, nElems * sizeof(double));
+	memset(elemData.dtLoc, 0, nElems * sizeof(double));
+	memset(elemData.venkEps_sq, 0, nElems * sizeof(double));
+	memset(sideData.flux[0], 0, NVAR * nSides * sizeof(double));
+	memset(sideData.pVar[0], 0, NVAR * 2 * nSides * sizeof(face_t));
+
+	/* the exact functions of the boundaries may have changed */
+	groupBCsides(&sideData, &elemData, nElems, nBCsides);
+	printf("| Mesh and geometry of the first variant are kept\n");
+}
+
+/**
+ * \brief Replace the mesh by a new one, e.g. after an adaptation
+ *
+ * The new mesh is built like in `buildMesh`, the solution arrays are
+ * allocated anew and have to be filled by the caller. The elements stay in
+ * the order of their arrays.
+ * \param[in] vertex Coordinates of the nodes
+ * \param[in] nVertices Number of nodes
+ * \param[in] BCedge Node IDs and BC code of the boundary edges
+ * \param[in] nBCedges Number of boundary edges
+ * \param[in] tria Nodes and domain of the triangles
+ * \param[in] quad Nodes and domain of the quadrilaterals
+ * \param[in] edgeNode Hanging nodes of the element edges, or NULL
+ */
+void replaceMesh(double **vertex, long nVertices, long **BCedge, long nBCedges,
+		long **tria, long **quad, long **edgeNode)
+{
+	freePointLocation();
+	freeDataArrays();
+
 	free(elem);
 	free(side);
+	free(BCside);
+
+	freeArena(&nodeArena);
+	freeArena(&elemArena);
+	freeArena(&sideArena);
+	freeArena(&sidePtrArena);
+	freeArena(&elemNodeArena);
+	freeArena(&quadArena);
+
+	double tPhase[3];
+	buildMesh(vertex, nVertices, BCedge, nBCedges, tria, quad, edgeNode, tPhase);
+	createDataArrays();
+	createPointLocation();
+}
 
-	/* free all BC sides */
-	sidePtr_t *aBCside = firstBCside;
-	while (aBCside) {
-		if (aBCside->next) {
-			sidePtr_t *tmp = aBCside;
-			aBCside = aBCside->next;
-			free(tmp->side->elem);
-			free(tmp->side);
-			free(tmp);
-		} else {
-			free(aBCside->side->elem);
-			free(aBCside->side);
-			free(aBCside);
-			break;
-		}
-	}
+/**
+ * \brief Free all allocated memory of the mesh
+ */
+void freeMesh(void)
+{
+	freePointLocation();
+	freeDataArrays();
+	free(cartMesh.nBC);
+	cartMesh.nBC = NULL;
+
+	/* nodes, elements and sides live in the arenas */
+	free(elem);
+	free(side);
+	free(BCside);
+	BCside = NULL;
+
+	freeArena(&nodeArena);
+	freeArena(&elemArena);
+	freeArena(&sideArena);
+	freeArena(&sidePtrArena);
+	freeArena(&elemNodeArena);
+	freeArena(&quadArena);
 }
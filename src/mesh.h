@@ -14,9 +14,12 @@ typedef struct elem_t elem_t;
 typedef struct side_t side_t;
 typedef struct sidePtr_t sidePtr_t;
 typedef struct cartMesh_t cartMesh_t;
+typedef struct elemData_t elemData_t;
+typedef struct sideData_t sideData_t;
 
 #include "main.h"
 #include "boundary.h"
+#include "memTools.h"
 
 /**
  * \brief Structure for a single node in a linked list of nodes
@@ -35,7 +38,6 @@ struct side_t {
 	int BCtype;			/**< boundary condition type */
 	int BCid;			/**< boundary condition Sub-ID */
 	boundary_t *BC;			/**< pointer to the boundary condition */
-	double pVar[NVAR];		/**< primitive variables state at side */
 	double n[NDIM];			/**< normal vector of side */
 	double len;			/**< length of the side */
 	double baryBaryVec[NDIM];	/**< vector from element barycenter to
@@ -45,7 +47,6 @@ struct side_t {
 						the Gaussian point of the side */
 	double w[NDIM];			/**< omegaX and omegaY entries for 2nd
 						order gradient reconstruction */
-	double flux[NVAR];		/**< numerical flux of the side */
 	side_t *connection;		/**< neighbor side */
 	side_t *nextElemSide;		/**< pointer to the next side of the
 						element */
@@ -71,27 +72,17 @@ struct elem_t {
 	int elemType;			/**< element type: triangle (3) or
 						quadrangle (4) */
 	long id;			/**< unique element Id */
+	long fileId;			/**< position of the element in the mesh
+						file */
 	int domain;			/**< flow domain number */
 	double bary[NDIM];		/**< coordinates ob element barycenter */
 	double sx;			/**< cell extension in x-direction */
 	double sy;			/**< cell extension in y-direction */
 	double area;			/**< area of the element */
 	double areaq;			/**< inverse of element area */
-	double pVar[NVAR];		/**< primitive variables of element */
-	double cVar[NVAR];		/**< conservative variables of element */
-	double cVarStage[NVAR];		/**< conservative variables at initial
-						Runge-Kutta stage */
-	double u_x[NVAR];		/**< x-gradient of primitive variables */
-	double u_y[NVAR];		/**< y-gradient of primitive variables */
-	double u_t[NVAR];		/**< t-gradient of primitive variables */
-	double source[NVAR];		/**< source term */
-	double dt;			/**< element time step */
-	double dtLoc;			/**< local element time step */
-	double venkEps_sq;		/**< Venkatakrishnan limiter constant
-						for element */
 	int innerSides;			/**< number of non-BC sides of element */
 	int nGP;			/**< number of Gaussian integration points */
-	double **xGP;			/**< Gaussian points for volume integral */
+	double (*xGP)[NDIM];		/**< Gaussian points for volume integral */
 	double *wGP;			/**< Gaussian weights */
 	side_t *firstSide;		/**< pointer to the first side of the element */
 	elem_t *next;			/**< pointer to the next element in
@@ -110,6 +101,89 @@ struct cartMesh_t {
 	int BCrange[2 * NDIM][NBC][2];	/**< list of BC ranges per side */
 };
 
+/** \brief Element data in structure-of-arrays layout, used by the solver
+ *
+ * All arrays are indexed by the element ID. The `nElems` physical elements
+ * are followed by the `nBCsides` ghost elements, the ghost element of
+ * `BCside[iBC]` has the ID `nElems + iBC`. The sides of element `iElem` are
+ * stored in CSR format: `sideIdx[sideOffset[iElem]]` up to
+ * `sideIdx[sideOffset[iElem + 1] - 1]`, in the order of the element's side
+ * list. With domain decomposition the `nHaloElems` halo elements of the
+ * neighbor partitions follow the ghost elements, `nTotal` is the number of
+ * all elements: `nElems + nBCsides + nHaloElems`.
+ */
+struct elemData_t {
+	double **bary;			/**< barycenter coordinates [NDIM][nTotal] */
+	double *sx;			/**< cell extension in x-direction */
+	double *sy;			/**< cell extension in y-direction */
+	double *area;			/**< area of the element */
+	double *areaq;			/**< inverse of element area */
+	long *sideOffset;		/**< CSR offsets into `sideIdx` [nElems + 1] */
+	long *sideIdx;			/**< element side IDs of all elements */
+	double **pVar;			/**< primitive variables [NVAR][nTotal] */
+	double **cVar;			/**< conservative variables [NVAR][nElems] */
+	double **cVarStage;		/**< conservative variables at initial
+						Runge-Kutta stage [NVAR][nElems] */
+	double **u_x;			/**< x-gradient of primitive variables
+						[NVAR][nTotal] */
+	double **u_y;			/**< y-gradient of primitive variables
+						[NVAR][nTotal] */
+	double **u_t;			/**< t-gradient of conservative variables
+						[NVAR][nElems] */
+	double **source;		/**< source term [NVAR][nElems] */
+	double *dt;			/**< element time step */
+	double *dtLoc;			/**< local element time step */
+	double *venkEps_sq;		/**< Venkatakrishnan limiter constant
+						for element */
+};
+
+/** \brief Side data in structure-of-arrays layout, used by the solver
+ *
+ * Side arrays are indexed by the ID `iSide` of `side[iSide]`. Every side
+ * consists of two element sides: the element side `2 * iSide` belongs to the
+ * element of `side[iSide]`, `2 * iSide + 1` to the element of its connection.
+ * The normal vector points from the first to the second element. For
+ * boundary sides the first element is always the physical one. The
+ * `nInterfaceSides` sides to halo elements are stored last, with the owned
+ * element first. The inner sides of a cartesian mesh without renumbering are
+ * stored row by row, see `orderCartesianSides`.
+ */
+struct sideData_t {
+	double **n;			/**< normal vector [NDIM][nSides] */
+	double *len;			/**< length of the side */
+	double **baryBaryVec;		/**< vector between the barycenters of
+						the two elements [NDIM][nSides] */
+	double *baryBaryDist;		/**< length of `baryBaryVec` */
+	double **flux;			/**< numerical flux [NVAR][nSides] */
+	long *elem;			/**< element ID of each element side
+						[2 * nSides] */
+	double **GP;			/**< vector from the element barycenter
+						to the Gaussian point [NDIM][2 * nSides] */
+	double **w;			/**< omegaX and omegaY entries for 2nd
+						order gradient reconstruction
+						[NDIM][2 * nSides] */
+	face_t **pVar;			/**< primitive variables state at the
+						element side [NVAR][2 * nSides] */
+	long *BCsideId;			/**< side ID of every BC side [nBCsides] */
+	boundary_t **BC;		/**< boundary condition of every BC side */
+	long *BCorder;			/**< BC sides grouped by their boundary
+						condition [nBCsides] */
+	long *BCoffset;			/**< first position of every boundary
+						condition in `BCorder` [nBC + 1] */
+	double **BCsideCache;		/**< ghost states of the time independent
+						exact functions at the sides
+						[NVAR][nBCsides], or NULL */
+	double **BCbaryCache;		/**< ghost states of the time independent
+						exact functions at the ghost
+						barycenters [NVAR][nBCsides], or NULL */
+	double **BCintState;		/**< internal states of the BC sides of
+						the fused residual, in double
+						precision [NVAR][nBCsides] */
+	double **BCghostState;		/**< ghost states of the BC sides of the
+						fused residual, in double
+						precision [NVAR][nBCsides] */
+};
+
 extern char strMeshFormat[STRLEN];
 extern char strMeshFile[STRLEN];
 extern char strIniCondFile[STRLEN];
@@ -119,16 +193,20 @@ extern char gridFile[STRLEN];
 
 extern int meshType;
 extern int meshFormat;
+extern int meshRenumbering;
 
 extern long nNodes;
 
 extern long nElems;
+extern long nElemsGlobal;
+extern long nHaloElems;
 extern long nTrias;
 extern long nQuads;
 
 extern long nSides;
 extern long nBCsides;
 extern long nInnerSides;
+extern long nInterfaceSides;
 
 extern double totalArea_q;
 extern double xMin;
@@ -146,7 +224,25 @@ extern node_t *firstNode;
 extern side_t *firstSide;
 extern sidePtr_t *firstBCside;
 
+extern elemData_t elemData;
+extern sideData_t sideData;
+
+extern arena_t nodeArena;
+extern arena_t elemArena;
+extern arena_t sideArena;
+extern arena_t sidePtrArena;
+extern arena_t elemNodeArena;
+extern arena_t quadArena;
+
+void initMeshArenas(long nVertices, long nBCedges);
+void buildMesh(double **vertex, long nVertices, long **BCedge, long nBCedges,
+		long **tria, long **quad, long **edgeNode, double tPhase[3]);
 void initMesh(void);
+void reuseMesh(void);
+void createDataArrays(void);
+void replaceMesh(double **vertex, long nVertices, long **BCedge, long nBCedges,
+		long **tria, long **quad, long **edgeNode);
+void freeDataArrays(void);
 void freeMesh(void);
 
 #endif
@@ -0,0 +1,1057 @@
+/** \file
+ *
+ * \brief Solution adaptive refinement and coarsening of the mesh
+ *
+ * Every element of the initial mesh is the root of a tree of cells. A refined
+ * cell is split into four children at the midpoints of its edges, a
+ * quadrilateral additionally at the mean of its nodes. The leaves of the
+ * trees are the elements of the current mesh. Neighboring elements differ by
+ * at most one refinement level, so an edge is split by at most one hanging
+ * node, which gives the coarser element a side for each half of the edge, see
+ * `buildMesh`.
+ *
+ * Every `adaptIterInterval` iterations the elements are refined, where the
+ * limited gradient of the density or the pressure from `spatialReconstruction`
+ * times the element size, relative to the mean value, exceeds
+ * `refineThreshold`, and coarsened, where it stays below `coarsenThreshold`
+ * for all four siblings. The children of a refined element get the
+ * reconstructed solution at their barycenters, corrected to the mean value of
+ * the parent, a coarsened element gets the area weighted mean value of its
+ * children, so the transfer is conservative.
+ *
+ * Cells are never deleted, coarsened cells keep their children for a later
+ * refinement, and the nodes on the edges are shared between the cells via a
+ * hash table of the edges, so the memory is bounded by the finest mesh that
+ * was reached. The new nodes lie on the straight edges of the initial mesh,
+ * curved boundaries are not resolved any better by the refinement.
+ *
+ * \author hhh
+ * \date Thu 15 Oct 2026 09:26:53 PM CEST
+ */
+
+typedef struct adaptCell_t adaptCell_t;
+typedef struct edgeHash_t edgeHash_t;
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <omp.h>
+
+#include "main.h"
+#include "meshAdaptation.h"
+#include "mesh.h"
+#include "boundary.h"
+#include "readInTools.h"
+#include "memTools.h"
+#include "equationOfState.h"
+#include "reconstruction.h"
+#include "finiteVolume.h"
+#include "timeDiscretization.h"
+#include "initialCondition.h"
+#include "multigrid.h"
+#include "output.h"
+#include "analyze.h"
+#include "insitu.h"
+#include "parallel.h"
+#include "timer.h"
+
+/**
+ * \brief Cell of the refinement trees
+ */
+struct adaptCell_t {
+	int elemType;			/**< number of nodes */
+	int level;			/**< refinement level, 0 for the initial
+					  mesh */
+	int domain;			/**< flow domain number */
+	bool isRefined;			/**< the children are part of the mesh */
+	long node[4];			/**< node IDs of the corners */
+	long parent;			/**< parent cell, -1 for the initial mesh */
+	long child;			/**< first of the four consecutive
+					  children, -1 if never refined */
+	long elemId;			/**< element ID of a leaf, -1 otherwise */
+};
+
+/**
+ * \brief Entry of the hash table of the split edges
+ */
+struct edgeHash_t {
+	long node[2];			/**< node IDs of the edge, ascending */
+	long midpoint;			/**< node ID of the midpoint, -1 for an
+					  empty entry */
+	long stamp;			/**< last mesh in which the edge is split */
+};
+
+/* extern variables */
+bool useAdaptation;			/**< solution adaptive mesh refinement flag */
+long adaptIterInterval;			/**< iteration interval of the adaptation */
+
+/* local variables */
+int maxRefinementLevel;			/**< maximum refinement level */
+double refineThreshold;			/**< relative change above which an
+					  element is refined */
+double coarsenThreshold;		/**< relative change below which an
+					  element is coarsened */
+int adaptVariable;			/**< primitive variable of the indicator */
+int nBufferLayers;			/**< number of element layers around the
+					  flagged elements that are refined
+					  as well */
+
+adaptCell_t *adaptCell;			/**< cells of all refinement trees, the
+					  roots come first */
+long nAdaptCells;			/**< number of cells */
+long nAdaptCellsAlloc;			/**< allocated number of cells */
+long nRootCells;			/**< number of elements of the initial mesh */
+long *leafCell;				/**< cell of every element */
+
+double (*adaptVertex)[NDIM];		/**< coordinates of all nodes */
+long nAdaptVertices;			/**< number of nodes */
+long nAdaptVerticesAlloc;		/**< allocated number of nodes */
+
+edgeHash_t *edgeTable;			/**< hash table of the split edges */
+long edgeTableSize;			/**< size of the hash table, a power of 2 */
+long nEdgeEntries;			/**< number of edges in the hash table */
+long meshStamp;				/**< number of the current mesh */
+
+long nBaseBCedges;			/**< number of BC edges of the initial mesh */
+long (*baseBCedge)[3];			/**< node IDs and BC code of the BC edges
+					  of the initial mesh */
+
+bool isAdapted;				/**< the mesh differs from the initial mesh */
+long nAdaptations;			/**< number of mesh changes */
+long nElemsMin;				/**< smallest number of elements */
+long nElemsMax;				/**< largest number of elements */
+
+/**
+ * \brief Append a node
+ * \param[in] x Coordinates of the node
+ * \return ID of the node
+ */
+static long newVertex(const double x[NDIM])
+{
+	if (nAdaptVertices == nAdaptVerticesAlloc) {
+		nAdaptVerticesAlloc = 2 * nAdaptVerticesAlloc + 1024;
+		adaptVertex = realloc(adaptVertex, nAdaptVerticesAlloc * sizeof(*adaptVertex));
+		if (!adaptVertex) {
+			printf("| ERROR: could not allocate adaptVertex\n");
+			exit(1);
+		}
+	}
+
+	adaptVertex[nAdaptVertices][X] = x[X];
+	adaptVertex[nAdaptVertices][Y] = x[Y];
+	return nAdaptVertices++;
+}
+
+/**
+ * \brief Append cells, the cell array may move
+ * \param[in] n Number of cells
+ * \return ID of the first cell
+ */
+static long newCells(long n)
+{
+	if (nAdaptCells + n > nAdaptCellsAlloc) {
+		nAdaptCellsAlloc = 2 * nAdaptCellsAlloc + n;
+		adaptCell = realloc(adaptCell, nAdaptCellsAlloc * sizeof(adaptCell_t));
+		if (!adaptCell) {
+			printf("| ERROR: could not allocate adaptCell\n");
+			exit(1);
+		}
+	}
+
+	long iFirst = nAdaptCells;
+	nAdaptCells += n;
+	return iFirst;
+}
+
+/**
+ * \brief Find the entry of an edge in the hash table
+ * \param[in] a First node ID of the edge
+ * \param[in] b Second node ID of the edge
+ * \return Entry of the edge, or the empty entry where it belongs
+ */
+static edgeHash_t *edgeEntry(long a, long b)
+{
+	long n0 = (a < b ? a : b);
+	long n1 = (a < b ? b : a);
+	unsigned long mask = edgeTableSize - 1;
+	unsigned long i = (((unsigned long)n0 * 73856093ul) ^
+			((unsigned long)n1 * 19349663ul)) & mask;
+	while ((edgeTable[i].midpoint >= 0) &&
+			((edgeTable[i].node[0] != n0) || (edgeTable[i].node[1] != n1))) {
+		i = (i + 1) & mask;
+	}
+
+	return &edgeTable[i];
+}
+
+/**
+ * \brief Double the size of the hash table
+ */
+static void growEdgeTable(void)
+{
+	edgeHash_t *oldTable = edgeTable;
+	long oldSize = edgeTableSize;
+
+	edgeTableSize = (oldSize > 0 ? 2 * oldSize : 4096);
+	edgeTable = malloc(edgeTableSize * sizeof(edgeHash_t));
+	if (!edgeTable) {
+		printf("| ERROR: could not allocate edgeTable\n");
+		exit(1);
+	}
+
+	for (long i = 0; i < edgeTableSize; ++i) {
+		edgeTable[i].midpoint = -1;
+	}
+
+	for (long i = 0; i < oldSize; ++i) {
+		if (oldTable[i].midpoint >= 0) {
+			*edgeEntry(oldTable[i].node[0], oldTable[i].node[1]) = oldTable[i];
+		}
+	}
+	free(oldTable);
+}
+
+/**
+ * \brief Midpoint of an edge, which is created, if necessary
+ * \param[in] a First node ID of the edge
+ * \param[in] b Second node ID of the edge
+ * \return Node ID of the midpoint
+ */
+static long midpointNode(long a, long b)
+{
+	if (2 * (nEdgeEntries + 1) > edgeTableSize) {
+		growEdgeTable();
+	}
+
+	edgeHash_t *entry = edgeEntry(a, b);
+	if (entry->midpoint < 0) {
+		double x[NDIM] = {0.5 * (adaptVertex[a][X] + adaptVertex[b][X]),
+			0.5 * (adaptVertex[a][Y] + adaptVertex[b][Y])};
+
+		entry->node[0] = (a < b ? a : b);
+		entry->node[1] = (a < b ? b : a);
+		entry->midpoint = newVertex(x);
+		entry->stamp = -1;
+		nEdgeEntries++;
+	}
+
+	return entry->midpoint;
+}
+
+/**
+ * \brief Hanging node of an edge in the current mesh
+ * \param[in] a First node ID of the edge
+ * \param[in] b Second node ID of the edge
+ * \return Node ID of the midpoint, -1 if the edge is not split
+ */
+static long splitNode(long a, long b)
+{
+	edgeHash_t *entry = edgeEntry(a, b);
+	if ((entry->midpoint >= 0) && (entry->stamp == meshStamp)) {
+		return entry->midpoint;
+	}
+
+	return -1;
+}
+
+/**
+ * \brief Refine a cell, the children of an earlier refinement are reused
+ * \param[in] iCell Cell ID
+ */
+static void refineCell(long iCell)
+{
+	if (adaptCell[iCell].child < 0) {
+		long iChild = newCells(4);
+		adaptCell_t *aCell = &adaptCell[iCell];
+		int n = aCell->elemType;
+
+		long m[4];
+		for (int k = 0; k < n; ++k) {
+			m[k] = midpointNode(aCell->node[k], aCell->node[(k + 1) % n]);
+		}
+
+		long childNode[4][4];
+		if (n == 3) {
+			long tri[4][3] = {{aCell->node[0], m[0], m[2]},
+				{m[0], aCell->node[1], m[1]},
+				{m[2], m[1], aCell->node[2]},
+				{m[0], m[1], m[2]}};
+			for (int i = 0; i < 4; ++i) {
+				for (int k = 0; k < 3; ++k) {
+					childNode[i][k] = tri[i][k];
+				}
+			}
+		} else {
+			double x[NDIM] = {0.0, 0.0};
+			for (int k = 0; k < 4; ++k) {
+				x[X] += 0.25 * adaptVertex[aCell->node[k]][X];
+				x[Y] += 0.25 * adaptVertex[aCell->node[k]][Y];
+			}
+			long c = newVertex(x);
+
+			long quad[4][4] = {{aCell->node[0], m[0], c, m[3]},
+				{m[0], aCell->node[1], m[1], c},
+				{c, m[1], aCell->node[2], m[2]},
+				{m[3], c, m[2], aCell->node[3]}};
+			for (int i = 0; i < 4; ++i) {
+				for (int k = 0; k < 4; ++k) {
+					childNode[i][k] = quad[i][k];
+				}
+			}
+		}
+
+		for (int i = 0; i < 4; ++i) {
+			adaptCell_t *aChild = &adaptCell[iChild + i];
+			aChild->elemType = n;
+			aChild->level = aCell->level + 1;
+			aChild->domain = aCell->domain;
+			aChild->isRefined = false;
+			for (int k = 0; k < n; ++k) {
+				aChild->node[k] = childNode[i][k];
+			}
+			aChild->parent = iCell;
+			aChild->child = -1;
+			aChild->elemId = -1;
+		}
+		aCell->child = iChild;
+	}
+
+	adaptCell[iCell].isRefined = true;
+}
+
+/**
+ * \brief Collect the leaves of a tree in depth-first order
+ * \param[in] iCell Root of the tree
+ * \param[out] leaf Array of the leaves
+ * \param[in,out] nLeaves Number of leaves
+ */
+static void collectLeaves(long iCell, long *leaf, long *nLeaves)
+{
+	if (adaptCell[iCell].isRefined) {
+		for (int i = 0; i < 4; ++i) {
+			collectLeaves(adaptCell[iCell].child + i, leaf, nLeaves);
+		}
+	} else {
+		leaf[(*nLeaves)++] = iCell;
+	}
+}
+
+/**
+ * \brief Add a BC edge of the initial mesh, split at the hanging nodes
+ * \param[in] a First node ID of the edge
+ * \param[in] b Second node ID of the edge
+ * \param[in] code BC code of the edge
+ * \param[out] BCedge BC edges of the mesh, or NULL to count them
+ * \param[in] nBCedges Number of BC edges so far
+ * \return Number of BC edges
+ */
+static long splitBCedge(long a, long b, long code, long **BCedge, long nBCedges)
+{
+	long m = splitNode(a, b);
+	if (m >= 0) {
+		nBCedges = splitBCedge(a, m, code, BCedge, nBCedges);
+		return splitBCedge(m, b, code, BCedge, nBCedges);
+	}
+
+	if (BCedge) {
+		BCedge[nBCedges][0] = a;
+		BCedge[nBCedges][1] = b;
+		BCedge[nBCedges][2] = code;
+	}
+	return nBCedges + 1;
+}
+
+/**
+ * \brief Replace the mesh with the leaves of the refinement trees
+ *
+ * The triangles come first, the elements are in depth-first order of the
+ * trees, so that the element order and the file IDs follow from the
+ * refinement flags alone.
+ */
+static void rebuildMesh(void)
+{
+	/* the edges of the refined cells are split */
+	meshStamp++;
+	for (long iCell = 0; iCell < nAdaptCells; ++iCell) {
+		adaptCell_t *aCell = &adaptCell[iCell];
+		if (aCell->isRefined) {
+			for (int k = 0; k < aCell->elemType; ++k) {
+				edgeEntry(aCell->node[k],
+					aCell->node[(k + 1) % aCell->elemType])->stamp = meshStamp;
+			}
+		}
+	}
+
+	long *leaf = dyn1DintArray(nAdaptCells);
+	long nLeaves = 0;
+	for (int elemType = 3; elemType <= 4; ++elemType) {
+		if (elemType == 4) {
+			nTrias = nLeaves;
+		}
+
+		for (long iCell = 0; iCell < nRootCells; ++iCell) {
+			if (adaptCell[iCell].elemType == elemType) {
+				collectLeaves(iCell, leaf, &nLeaves);
+			}
+		}
+	}
+	nQuads = nLeaves - nTrias;
+
+	/* only the corners and the hanging nodes of the leaves are nodes of
+	 * the mesh */
+	long *vertexId = dyn1DintArray(nAdaptVertices);
+	for (long iNode = 0; iNode < nAdaptVertices; ++iNode) {
+		vertexId[iNode] = -1;
+	}
+
+	long **edgeNode = dyn2DintArray(nLeaves, 4);
+	for (long iLeaf = 0; iLeaf < nLeaves; ++iLeaf) {
+		adaptCell_t *aCell = &adaptCell[leaf[iLeaf]];
+		for (int k = 0; k < 4; ++k) {
+			edgeNode[iLeaf][k] = -1;
+		}
+
+		for (int k = 0; k < aCell->elemType; ++k) {
+			vertexId[aCell->node[k]] = 0;
+			edgeNode[iLeaf][k] = splitNode(aCell->node[k],
+					aCell->node[(k + 1) % aCell->elemType]);
+			if (edgeNode[iLeaf][k] >= 0) {
+				vertexId[edgeNode[iLeaf][k]] = 0;
+			}
+		}
+	}
+
+	long nVertices = 0;
+	for (long iNode = 0; iNode < nAdaptVertices; ++iNode) {
+		if (vertexId[iNode] == 0) {
+			vertexId[iNode] = nVertices++;
+		}
+	}
+
+	double **vertex = dyn2DdblArray(nVertices, NDIM);
+	for (long iNode = 0; iNode < nAdaptVertices; ++iNode) {
+		if (vertexId[iNode] >= 0) {
+			vertex[vertexId[iNode]][X] = adaptVertex[iNode][X];
+			vertex[vertexId[iNode]][Y] = adaptVertex[iNode][Y];
+		}
+	}
+
+	long **tria = (nTrias > 0 ? dyn2DintArray(nTrias, 4) : NULL);
+	long **quad = (nQuads > 0 ? dyn2DintArray(nQuads, 5) : NULL);
+	for (long iLeaf = 0; iLeaf < nLeaves; ++iLeaf) {
+		adaptCell_t *aCell = &adaptCell[leaf[iLeaf]];
+		long *elemNode = (iLeaf < nTrias ? tria[iLeaf] : quad[iLeaf - nTrias]);
+		for (int k = 0; k < aCell->elemType; ++k) {
+			elemNode[k] = vertexId[aCell->node[k]];
+			if (edgeNode[iLeaf][k] >= 0) {
+				edgeNode[iLeaf][k] = vertexId[edgeNode[iLeaf][k]];
+			}
+		}
+		elemNode[aCell->elemType] = aCell->domain;
+	}
+
+	long nBCedges = 0;
+	for (long iEdge = 0; iEdge < nBaseBCedges; ++iEdge) {
+		nBCedges = splitBCedge(baseBCedge[iEdge][0], baseBCedge[iEdge][1],
+				baseBCedge[iEdge][2], NULL, nBCedges);
+	}
+
+	long **BCedge = dyn2DintArray(nBCedges, 3);
+	nBCedges = 0;
+	for (long iEdge = 0; iEdge < nBaseBCedges; ++iEdge) {
+		nBCedges = splitBCedge(baseBCedge[iEdge][0], baseBCedge[iEdge][1],
+				baseBCedge[iEdge][2], BCedge, nBCedges);
+	}
+
+	for (long iEdge = 0; iEdge < nBCedges; ++iEdge) {
+		BCedge[iEdge][0] = vertexId[BCedge[iEdge][0]];
+		BCedge[iEdge][1] = vertexId[BCedge[iEdge][1]];
+	}
+	free(vertexId);
+
+	replaceMesh(vertex, nVertices, BCedge, nBCedges, tria, quad, edgeNode);
+
+	/* the elements are not renumbered, the file ID is the leaf position */
+	for (long iCell = 0; iCell < nAdaptCells; ++iCell) {
+		adaptCell[iCell].elemId = -1;
+	}
+
+	free(leafCell);
+	leafCell = dyn1DintArray(nElems);
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		long iCell = leaf[elem[iElem]->fileId];
+		adaptCell[iCell].elemId = iElem;
+		leafCell[iElem] = iCell;
+	}
+	free(leaf);
+
+	isAdapted = true;
+	isGridFileOutdated = true;
+}
+
+/**
+ * \brief Transfer the solution of the old mesh onto the new mesh
+ * \param[in] oldElem Element ID of every cell in the old mesh
+ * \param[in] cVarOld Conservative variables of the old mesh
+ * \param[in] pVarOld Primitive variables of the old mesh
+ * \param[in] u_xOld x-gradients of the primitive variables of the old mesh
+ * \param[in] u_yOld y-gradients of the primitive variables of the old mesh
+ * \param[in] baryOld Barycenters of the old mesh
+ * \param[in] areaOld Element areas of the old mesh
+ */
+static void transferSolution(const long *oldElem, double **cVarOld,
+		double **pVarOld, double **u_xOld, double **u_yOld,
+		double **baryOld, const double *areaOld)
+{
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		long iCell = leafCell[iElem];
+		long iParent = adaptCell[iCell].parent;
+
+		if (oldElem[iCell] >= 0) {
+			/* unchanged element */
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				elemData.cVar[iVar][iElem] = cVarOld[iVar][oldElem[iCell]];
+			}
+		} else if ((iParent >= 0) && (oldElem[iParent] >= 0)) {
+			/* refined element, all children at once */
+			long firstChild = adaptCell[iParent].child;
+			if (iCell != firstChild) {
+				continue;
+			}
+
+			long jElem = oldElem[iParent];
+			double sumArea = 0.0, sum[NVAR] = {0.0};
+			for (int i = 0; i < 4; ++i) {
+				long kElem = adaptCell[firstChild + i].elemId;
+				double dx = elemData.bary[X][kElem] - baryOld[X][jElem];
+				double dy = elemData.bary[Y][kElem] - baryOld[Y][jElem];
+
+				double pVar[NVAR], cVar[NVAR];
+				for (int iVar = 0; iVar < NVAR; ++iVar) {
+					pVar[iVar] = pVarOld[iVar][jElem] +
+						u_xOld[iVar][jElem] * dx + u_yOld[iVar][jElem] * dy;
+				}
+				primCons(pVar, cVar);
+
+				for (int iVar = 0; iVar < NVAR; ++iVar) {
+					elemData.cVar[iVar][kElem] = cVar[iVar];
+					sum[iVar] += elemData.area[kElem] * cVar[iVar];
+				}
+				sumArea += elemData.area[kElem];
+			}
+
+			/* the mean value of the parent is kept, with a fallback
+			 * to the parent state, if that is not physical */
+			bool isPhysical = true;
+			for (int i = 0; i < 4; ++i) {
+				long kElem = adaptCell[firstChild + i].elemId;
+				double cVar[NVAR], pVar[NVAR];
+				for (int iVar = 0; iVar < NVAR; ++iVar) {
+					elemData.cVar[iVar][kElem] += (areaOld[jElem] *
+						cVarOld[iVar][jElem] - sum[iVar]) / sumArea;
+					cVar[iVar] = elemData.cVar[iVar][kElem];
+				}
+
+				consPrim(cVar, pVar);
+				isPhysical = isPhysical && (pVar[RHO] > 0.0) && (pVar[P] > 0.0);
+			}
+
+			for (int i = 0; (i < 4) && !isPhysical; ++i) {
+				long kElem = adaptCell[firstChild + i].elemId;
+				for (int iVar = 0; iVar < NVAR; ++iVar) {
+					elemData.cVar[iVar][kElem] = cVarOld[iVar][jElem];
+				}
+			}
+		} else {
+			/* coarsened element */
+			long firstChild = adaptCell[iCell].child;
+			double sumArea = 0.0;
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				elemData.cVar[iVar][iElem] = 0.0;
+			}
+
+			for (int i = 0; i < 4; ++i) {
+				long jElem = oldElem[firstChild + i];
+				for (int iVar = 0; iVar < NVAR; ++iVar) {
+					elemData.cVar[iVar][iElem] += areaOld[jElem] *
+						cVarOld[iVar][jElem];
+				}
+				sumArea += areaOld[jElem];
+			}
+
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				elemData.cVar[iVar][iElem] /= sumArea;
+			}
+		}
+	}
+
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		consPrimElem(iElem);
+	}
+}
+
+/**
+ * \brief Flag the elements, refine and coarsen the mesh and transfer the
+ *	solution
+ * \param[in] time Calculation time
+ * \return True, if the mesh was changed
+ */
+static bool adaptCells(double time)
+{
+	/* the gradients are needed for the indicator and the solution
+	 * transfer */
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		consPrimElem(iElem);
+	}
+	spatialReconstruction(time);
+
+	/* indicator: limited gradient times the element size, relative to the
+	 * mean value, i.e. the relative change over the element */
+	double *eta = dyn1DdblArray(nElems);
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		double q_x = elemData.u_x[adaptVariable][iElem];
+		double q_y = elemData.u_y[adaptVariable][iElem];
+		eta[iElem] = sqrt((q_x * q_x + q_y * q_y) * elemData.area[iElem]) /
+			elemData.pVar[adaptVariable][iElem];
+	}
+
+	/* the buffer layers keep the features on the refined elements until
+	 * the next adaptation */
+	double *etaNeighbor = dyn1DdblArray(nElems);
+	for (int iLayer = 0; iLayer < nBufferLayers; ++iLayer) {
+		for (long iSide = 0; iSide < nSides; ++iSide) {
+			long iElem = sideData.elem[2 * iSide];
+			long jElem = sideData.elem[2 * iSide + 1];
+			if ((iElem >= nElems) || (jElem >= nElems)) {
+				continue;
+			}
+
+			etaNeighbor[iElem] = fmax(etaNeighbor[iElem], eta[jElem]);
+			etaNeighbor[jElem] = fmax(etaNeighbor[jElem], eta[iElem]);
+		}
+
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			eta[iElem] = fmax(eta[iElem], etaNeighbor[iElem]);
+		}
+	}
+	free(etaNeighbor);
+
+	int *target = malloc(nAdaptCells * sizeof(int));
+	if (!target) {
+		printf("| ERROR: could not allocate target\n");
+		exit(1);
+	}
+
+	for (long iCell = 0; iCell < nAdaptCells; ++iCell) {
+		target[iCell] = adaptCell[iCell].level;
+	}
+
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		long iCell = leafCell[iElem];
+		int level = adaptCell[iCell].level;
+		if ((eta[iElem] > refineThreshold) && (level < maxRefinementLevel)) {
+			target[iCell] = level + 1;
+		} else if ((eta[iElem] < coarsenThreshold) && (level > 0)) {
+			target[iCell] = level - 1;
+		}
+	}
+	free(eta);
+
+	/* neighbors differ by one level at most, and only complete sets of
+	 * siblings are coarsened, the targets only increase until both hold */
+	bool isChanged = true;
+	while (isChanged) {
+		isChanged = false;
+		for (long iSide = 0; iSide < nSides; ++iSide) {
+			long iElem = sideData.elem[2 * iSide];
+			long jElem = sideData.elem[2 * iSide + 1];
+			if ((iElem >= nElems) || (jElem >= nElems)) {
+				continue;
+			}
+
+			long iCell = leafCell[iElem];
+			long jCell = leafCell[jElem];
+			if (target[iCell] > target[jCell] + 1) {
+				target[jCell] = target[iCell] - 1;
+				isChanged = true;
+			} else if (target[jCell] > target[iCell] + 1) {
+				target[iCell] = target[jCell] - 1;
+				isChanged = true;
+			}
+		}
+
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			long iCell = leafCell[iElem];
+			if (target[iCell] >= adaptCell[iCell].level) {
+				continue;
+			}
+
+			long firstChild = adaptCell[adaptCell[iCell].parent].child;
+			bool isCoarsened = true;
+			for (int i = 0; i < 4; ++i) {
+				adaptCell_t *aSibling = &adaptCell[firstChild + i];
+				if (aSibling->isRefined ||
+						(target[firstChild + i] >= aSibling->level)) {
+					isCoarsened = false;
+				}
+			}
+
+			if (!isCoarsened) {
+				target[iCell] = adaptCell[iCell].level;
+				isChanged = true;
+			}
+		}
+	}
+
+	bool isModified = false;
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		long iCell = leafCell[iElem];
+		if (target[iCell] > adaptCell[iCell].level) {
+			refineCell(iCell);
+			isModified = true;
+		} else if (target[iCell] < adaptCell[iCell].level) {
+			adaptCell[adaptCell[iCell].parent].isRefined = false;
+			isModified = true;
+		}
+	}
+	free(target);
+
+	if (!isModified) {
+		return false;
+	}
+
+	/* the old solution is taken over, before its arrays are freed with the
+	 * old mesh */
+	long *oldElem = dyn1DintArray(nAdaptCells);
+	for (long iCell = 0; iCell < nAdaptCells; ++iCell) {
+		oldElem[iCell] = adaptCell[iCell].elemId;
+	}
+
+	double **cVarOld = elemData.cVar;
+	double **pVarOld = elemData.pVar;
+	double **u_xOld = elemData.u_x;
+	double **u_yOld = elemData.u_y;
+	double **baryOld = elemData.bary;
+	double *areaOld = elemData.area;
+	elemData.cVar = NULL;
+	elemData.pVar = NULL;
+	elemData.u_x = NULL;
+	elemData.u_y = NULL;
+	elemData.bary = NULL;
+	elemData.area = NULL;
+
+	rebuildMesh();
+	transferSolution(oldElem, cVarOld, pVarOld, u_xOld, u_yOld, baryOld, areaOld);
+	updateFV();
+
+	free(oldElem);
+	free(cVarOld);
+	free(pVarOld);
+	free(u_xOld);
+	free(u_yOld);
+	free(baryOld);
+	free(areaOld);
+
+	nAdaptations++;
+	nElemsMin = (nElems < nElemsMin ? nElems : nElemsMin);
+	nElemsMax = (nElems > nElemsMax ? nElems : nElemsMax);
+	return true;
+}
+
+/**
+ * \brief Initialize the mesh adaptation, the current mesh is the initial
+ *	mesh of the refinement trees
+ */
+void initAdaptation(void)
+{
+	useAdaptation = getBool("meshAdaptation", "F");
+	if (!useAdaptation) {
+		return;
+	}
+
+	printf("\nInitializing Mesh Adaptation:\n");
+	if (spatialOrder == 1) {
+		printf("| ERROR: Mesh adaptation requires the gradients of the second order reconstruction\n");
+		exit(1);
+	}
+
+	if (mpiSize > 1) {
+		printf("| ERROR: Mesh adaptation requires a single partition\n");
+		exit(1);
+	}
+
+	if (isImplicit || (nMGlevels > 1) || (smoothingCoeff > 0.0) ||
+			(limiterFreezeResidual > 0.0)) {
+		printf("| ERROR: Mesh adaptation requires an explicit calculation without multigrid,\n");
+		printf("|        residual smoothing and limiter freezing\n");
+		exit(1);
+	}
+
+	if (isSeriesOutput || isAsyncOutput) {
+		printf("| ERROR: Mesh adaptation does not support series or asynchronous output\n");
+		exit(1);
+	}
+
+	for (boundary_t *aBC = firstBC; aBC; aBC = aBC->next) {
+		if (aBC->BCtype == PERIODIC) {
+			printf("| ERROR: Mesh adaptation does not support periodic boundaries\n");
+			exit(1);
+		}
+	}
+
+	adaptIterInterval = getInt("adaptIterInterval", "10");
+	maxRefinementLevel = getInt("maxRefinementLevel", "2");
+	refineThreshold = getDbl("refineThreshold", "0.05");
+	coarsenThreshold = getDbl("coarsenThreshold", "0.01");
+	nBufferLayers = getInt("adaptBufferLayers", "1");
+	switch (getInt("adaptVariable", "1")) {
+	case 1:
+		adaptVariable = RHO;
+		printf("| Indicator: Density Gradient\n");
+		break;
+	case 2:
+		adaptVariable = P;
+		printf("| Indicator: Pressure Gradient\n");
+		break;
+	default:
+		printf("| ERROR: Adaptation variable must be either 1 or 2\n");
+		exit(1);
+	}
+
+	if ((adaptIterInterval < 1) || (maxRefinementLevel < 0) ||
+			(nBufferLayers < 0) || (coarsenThreshold >= refineThreshold)) {
+		printf("| ERROR: Mesh adaptation needs adaptIterInterval >= 1, maxRefinementLevel >= 0,\n");
+		printf("|        adaptBufferLayers >= 0 and coarsenThreshold < refineThreshold\n");
+		exit(1);
+	}
+
+	printf("| Refinement Level: %d, Interval: %ld Iterations\n",
+			maxRefinementLevel, adaptIterInterval);
+	printf("| Thresholds: Refine %g, Coarsen %g\n", refineThreshold,
+			coarsenThreshold);
+
+	/* the nodes of the initial mesh keep their IDs */
+	nAdaptVertices = 0;
+	for (node_t *aNode = firstNode; aNode; aNode = aNode->next) {
+		aNode->id = newVertex(aNode->x);
+	}
+
+	nAdaptCells = 0;
+	nRootCells = nElems;
+	newCells(nRootCells);
+	leafCell = dyn1DintArray(nElems);
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		adaptCell_t *aCell = &adaptCell[iElem];
+		aCell->elemType = elem[iElem]->elemType;
+		aCell->level = 0;
+		aCell->domain = elem[iElem]->domain;
+		aCell->isRefined = false;
+		for (int k = 0; k < aCell->elemType; ++k) {
+			aCell->node[k] = elem[iElem]->node[k]->id;
+		}
+		aCell->parent = -1;
+		aCell->child = -1;
+		aCell->elemId = iElem;
+		leafCell[iElem] = iElem;
+	}
+
+	nBaseBCedges = nBCsides;
+	baseBCedge = malloc((nBCsides > 0 ? nBCsides : 1) * sizeof(*baseBCedge));
+	if (!baseBCedge) {
+		printf("| ERROR: could not allocate baseBCedge\n");
+		exit(1);
+	}
+
+	for (long iSide = 0; iSide < nBCsides; ++iSide) {
+		side_t *aSide = BCside[iSide];
+		baseBCedge[iSide][0] = aSide->node[0]->id;
+		baseBCedge[iSide][1] = aSide->node[1]->id;
+		baseBCedge[iSide][2] = (aSide->BC ?
+				aSide->BC->BCtype * 100 + aSide->BC->BCid : 0);
+	}
+
+	edgeTableSize = 0;
+	nEdgeEntries = 0;
+	meshStamp = 0;
+	growEdgeTable();
+
+	isAdapted = false;
+	nAdaptations = 0;
+	nElemsMin = nElems;
+	nElemsMax = nElems;
+}
+
+/**
+ * \brief Refine the initial mesh towards the initial condition, which is
+ *	set again on every new mesh
+ */
+void adaptInitialCondition(void)
+{
+	if (!useAdaptation || isRestart) {
+		return;
+	}
+
+	printf("\nAdapting Mesh to the Initial Condition:\n");
+	for (int iLevel = 0; iLevel < maxRefinementLevel; ++iLevel) {
+		if (!adaptCells(t)) {
+			break;
+		}
+
+		printf("| Level %d: %ld Elements\n", iLevel + 1, nElems);
+		setInitialCondition();
+	}
+}
+
+/**
+ * \brief Adapt the mesh to the current solution
+ * \param[in] time Calculation time
+ */
+void adaptMesh(double time)
+{
+	double tic = CPU_TIME();
+	if (adaptCells(time)) {
+		locateRecordPoints();
+		catalystUpdateMesh();
+	}
+	timerAdd(TIMER_ADAPTATION, &tic);
+}
+
+/**
+ * \brief Depth-first refinement flags of a tree
+ * \param[in] iCell Root of the tree
+ * \param[out] flags Refinement flags
+ * \param[in,out] nFlags Number of flags
+ */
+static void treeFlags(long iCell, char *flags, long *nFlags)
+{
+	flags[(*nFlags)++] = adaptCell[iCell].isRefined;
+	if (adaptCell[iCell].isRefined) {
+		for (int i = 0; i < 4; ++i) {
+			treeFlags(adaptCell[iCell].child + i, flags, nFlags);
+		}
+	}
+}
+
+/**
+ * \brief Refinement flags of the current mesh, for the checkpoint
+ * \param[out] flags Allocated array of the flags of all trees in depth-first
+ *	order, NULL without mesh adaptation
+ * \return Number of flags
+ */
+long adaptationFlags(char **flags)
+{
+	*flags = NULL;
+	if (!useAdaptation) {
+		return 0;
+	}
+
+	*flags = malloc(nAdaptCells);
+	if (!*flags) {
+		printf("| ERROR: could not allocate flags\n");
+		exit(1);
+	}
+
+	long nFlags = 0;
+	for (long iCell = 0; iCell < nRootCells; ++iCell) {
+		treeFlags(iCell, *flags, &nFlags);
+	}
+	return nFlags;
+}
+
+/**
+ * \brief Refine a tree by its depth-first refinement flags
+ * \param[in] iCell Root of the tree
+ * \param[in] flags Refinement flags
+ * \param[in] nFlags Number of flags
+ * \param[in,out] iFlag Position in the flags
+ * \return False, if the flags ended early
+ */
+static bool refineTree(long iCell, const char *flags, long nFlags, long *iFlag)
+{
+	if (*iFlag >= nFlags) {
+		return false;
+	}
+
+	if (flags[(*iFlag)++]) {
+		refineCell(iCell);
+		for (int i = 0; i < 4; ++i) {
+			if (!refineTree(adaptCell[iCell].child + i, flags, nFlags, iFlag)) {
+				return false;
+			}
+		}
+	} else {
+		adaptCell[iCell].isRefined = false;
+	}
+
+	return true;
+}
+
+/**
+ * \brief Rebuild the adapted mesh of a checkpoint from its refinement flags
+ * \param[in] flags Refinement flags of all trees in depth-first order
+ * \param[in] nFlags Number of flags
+ */
+void restoreAdaptation(const char *flags, long nFlags)
+{
+	long iFlag = 0;
+	for (long iCell = 0; iCell < nRootCells; ++iCell) {
+		if (!refineTree(iCell, flags, nFlags, &iFlag)) {
+			break;
+		}
+	}
+
+	if (iFlag != nFlags) {
+		printf("| ERROR: Refinement flags of the checkpoint do not match the mesh\n");
+		exit(1);
+	}
+
+	if (nAdaptCells > nRootCells) {
+		rebuildMesh();
+		updateFV();
+		nElemsMin = nElems;
+		nElemsMax = nElems;
+		printf("| Adapted Mesh: %ld Elements\n", nElems);
+	}
+}
+
+/**
+ * \brief Print the statistics of the mesh adaptation
+ */
+void printAdaptationStats(void)
+{
+	printf("| Mesh Adaptations : %ld\n", nAdaptations);
+	printf("| Elements         : %ld (%ld to %ld)\n", nElems, nElemsMin,
+			nElemsMax);
+}
+
+/**
+ * \brief Restore the initial mesh for the next batch variant and free the
+ *	refinement trees
+ */
+void freeAdaptation(void)
+{
+	if (!useAdaptation) {
+		return;
+	}
+
+	if (isAdapted) {
+		for (long iCell = 0; iCell < nAdaptCells; ++iCell) {
+			adaptCell[iCell].isRefined = false;
+		}
+		rebuildMesh();
+	}
+
+	free(adaptCell);
+	free(leafCell);
+	free(adaptVertex);
+	free(edgeTable);
+	free(baseBCedge);
+	adaptCell = NULL;
+	leafCell = NULL;
+	adaptVertex = NULL;
+	edgeTable = NULL;
+	nAdaptCellsAlloc = 0;
+	nAdaptVerticesAlloc = 0;
+	useAdaptation = false;
+}
@@ -0,0 +1,23 @@
+/** \file
+ *
+ * \author hhh
+ * \date Thu 15 Oct 2026 09:26:53 PM CEST
+ */
+
+#ifndef MESHADAPTATION_H
+#define MESHADAPTATION_H
+
+#include <stdbool.h>
+
+extern bool useAdaptation;
+extern long adaptIterInterval;
+
+void initAdaptation(void);
+void adaptInitialCondition(void);
+void adaptMesh(double time);
+long adaptationFlags(char **flags);
+void restoreAdaptation(const char *flags, long nFlags);
+void printAdaptationStats(void);
+void freeAdaptation(void);
+
+#endif
@@ -0,0 +1,638 @@
+/** \file
+ *
+ * \brief Binary cache of the preprocessed mesh
+ *
+ * The cache holds the complete mesh as it is after `createMesh`: nodes,
+ * elements with their geometry and volume quadrature, all element and ghost
+ * sides with normals, lengths, Gaussian point vectors and reconstruction
+ * weights, the connectivity and the BC assignments. Pointers are stored as
+ * indices: elements by their ID and sides by their side ID, which is unique
+ * for all element and ghost sides at that point.
+ *
+ * The cache is only used, if its key matches. The key is a hash over the
+ * mesh file and all ini options that change the preprocessed mesh.
+ *
+ * \author hhh
+ * \date Wed 14 Oct 2026 09:05:12 PM CEST
+ */
+
+typedef struct cacheHeader_t cacheHeader_t;
+typedef struct cacheElem_t cacheElem_t;
+typedef struct cacheSide_t cacheSide_t;
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <omp.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "main.h"
+#include "meshCache.h"
+#include "mesh.h"
+#include "boundary.h"
+#include "output.h"
+#include "parallel.h"
+#include "timeDiscretization.h"
+#include "memTools.h"
+
+#define CACHE_VERSION 2		/**< version of the cache layout */
+
+/**
+ * \brief Header of the cache file
+ */
+struct cacheHeader_t {
+	char magic[8];			/**< file identifier "CCFDMSH" */
+	long version;			/**< version of the cache layout */
+	uint64_t key;			/**< hash of the mesh file and options */
+	long nVertices;			/**< number of nodes */
+	long nElems;			/**< number of elements */
+	long nTrias;			/**< number of triangles */
+	long nQuads;			/**< number of quadrangles */
+	long nSides;			/**< number of sides */
+	long nBCsides;			/**< number of non-periodic BC sides */
+	long nInnerSides;		/**< number of inner sides */
+	long nSideTotal;		/**< number of element and ghost sides */
+	long nBCedges;			/**< number of entries in the BC side list */
+	long isPeriodic;		/**< periodic BC flag */
+	double totalArea_q;		/**< inverse of the total area */
+	double xMin;			/**< minimum x-direction extension */
+	double xMax;			/**< maximum x-direction extension */
+	double yMin;			/**< minimum y-direction extension */
+	double yMax;			/**< maximum y-direction extension */
+};
+
+/**
+ * \brief Element record of the cache file
+ */
+struct cacheElem_t {
+	long fileId;			/**< position of the element in the mesh file */
+	long elemType;			/**< number of nodes */
+	long domain;			/**< flow domain number */
+	long firstSide;			/**< side ID of the first element side */
+	long node[4];			/**< node IDs */
+	long nGP;			/**< number of volume Gaussian points */
+	double bary[NDIM];		/**< barycenter */
+	double sx;			/**< cell extension in x-direction */
+	double sy;			/**< cell extension in y-direction */
+	double area;			/**< area */
+	double areaq;			/**< inverse area */
+	double xGP[5][NDIM];		/**< volume Gaussian points */
+	double wGP[5];			/**< volume Gaussian weights */
+};
+
+/**
+ * \brief Side record of the cache file
+ */
+struct cacheSide_t {
+	long elem;			/**< element ID, -1 for a ghost element */
+	long connection;		/**< side ID of the neighbor side */
+	long nextElemSide;		/**< side ID of the next element side */
+	long node[2];			/**< node IDs */
+	long BC;			/**< BC code, -1 without BC */
+	double n[NDIM];			/**< normal vector */
+	double len;			/**< length */
+	double baryBaryVec[NDIM];	/**< barycenter to barycenter vector */
+	double baryBaryDist;		/**< length of `baryBaryVec` */
+	double GP[NDIM];		/**< barycenter to Gaussian point vector */
+	double w[NDIM];			/**< reconstruction weights */
+	double bary[NDIM];		/**< barycenter of the ghost element */
+};
+
+/* extern variables */
+bool useMeshCache;			/**< mesh cache flag */
+
+/* local variables */
+char cacheFile[2 * STRLEN];		/**< name of the cache file */
+bool isCached;				/**< mesh was read from the cache */
+bool hasKey;				/**< the mesh key could be computed */
+uint64_t cacheKey;			/**< key of the current mesh */
+
+/**
+ * \brief Add data to a 64-bit FNV-1a hash
+ * \param[in] hash Current hash value
+ * \param[in] data The data
+ * \param[in] size Size of the data in bytes
+ * \return New hash value
+ */
+uint64_t hashData(uint64_t hash, const void *data, size_t size)
+{
+	const unsigned char *c = data;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= c[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+/**
+ * \brief Compute the key of the current mesh
+ * \param[out] key The key
+ * \return False, if the mesh file could not be read
+ */
+bool meshKey(uint64_t *key)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	long version = CACHE_VERSION;
+	hash = hashData(hash, &version, sizeof(long));
+	hash = hashData(hash, &meshType, sizeof(int));
+	hash = hashData(hash, &meshRenumbering, sizeof(int));
+
+	switch (meshType) {
+	case UNSTRUCTURED: {
+		hash = hashData(hash, strMeshFile, strlen(strMeshFile));
+
+		int fd = open(strMeshFile, O_RDONLY);
+		struct stat fileStat;
+		if ((fd < 0) || (fstat(fd, &fileStat) != 0) || (fileStat.st_size == 0)) {
+			if (fd >= 0) {
+				close(fd);
+			}
+			return false;
+		}
+
+		void *map = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (map == MAP_FAILED) {
+			return false;
+		}
+
+		hash = hashData(hash, map, fileStat.st_size);
+		munmap(map, fileStat.st_size);
+		break;
+	}
+	case CARTESIAN:
+		hash = hashData(hash, &cartMesh.iMax, sizeof(int));
+		hash = hashData(hash, &cartMesh.jMax, sizeof(int));
+		hash = hashData(hash, &xMin, sizeof(double));
+		hash = hashData(hash, &xMax, sizeof(double));
+		hash = hashData(hash, &yMin, sizeof(double));
+		hash = hashData(hash, &yMax, sizeof(double));
+		for (int iSide = 0; iSide < 2 * NDIM; ++iSide) {
+			hash = hashData(hash, &cartMesh.nBC[iSide], sizeof(int));
+			for (int iBC = 0; iBC < cartMesh.nBC[iSide]; ++iBC) {
+				hash = hashData(hash, &cartMesh.BCtype[iSide][iBC], sizeof(int));
+				hash = hashData(hash, cartMesh.BCrange[iSide][iBC], 2 * sizeof(int));
+			}
+		}
+		break;
+	}
+
+	/* the periodic connections decide about the connectivity */
+	boundary_t *aBC = firstBC;
+	while (aBC) {
+		if (aBC->BCtype == PERIODIC) {
+			hash = hashData(hash, &aBC->BCid, sizeof(int));
+			hash = hashData(hash, aBC->connection, NDIM * sizeof(double));
+		}
+		aBC = aBC->next;
+	}
+
+	*key = hash;
+	return true;
+}
+
+/**
+ * \brief Get the boundary condition of a BC code
+ * \param[in] code BC code: 100 * type + ID, -1 without BC
+ * \return Pointer to the boundary condition
+ */
+boundary_t *getBC(long code)
+{
+	if (code < 0) {
+		return NULL;
+	}
+
+	boundary_t *aBC = firstBC;
+	while (aBC) {
+		if ((aBC->BCtype == code / 100) && (aBC->BCid == code % 100)) {
+			return aBC;
+		}
+		aBC = aBC->next;
+	}
+
+	printf("| ERROR: BC %ld from Gridgen Meshfile not defined in Parameter File\n", code);
+	exit(1);
+}
+
+/**
+ * \brief Store a side in its record
+ * \param[in] aSide The side
+ * \param[out] rec The side record
+ */
+void storeSide(side_t *aSide, cacheSide_t *rec)
+{
+	rec->elem = aSide->elem->id;
+	rec->connection = aSide->connection->id;
+	rec->nextElemSide = (aSide->nextElemSide ? aSide->nextElemSide->id : -1);
+	rec->node[0] = aSide->node[0]->id;
+	rec->node[1] = aSide->node[1]->id;
+	rec->BC = (aSide->BC ? 100 * aSide->BC->BCtype + aSide->BC->BCid : -1);
+	for (int iDim = 0; iDim < NDIM; ++iDim) {
+		rec->n[iDim] = aSide->n[iDim];
+		rec->baryBaryVec[iDim] = aSide->baryBaryVec[iDim];
+		rec->GP[iDim] = aSide->GP[iDim];
+		rec->w[iDim] = aSide->w[iDim];
+		rec->bary[iDim] = aSide->elem->bary[iDim];
+	}
+	rec->len = aSide->len;
+	rec->baryBaryDist = aSide->baryBaryDist;
+}
+
+/**
+ * \brief Write the preprocessed mesh into the cache file
+ *
+ * Only the first rank writes the cache. It is written into a temporary file
+ * that is renamed afterwards, so that concurrent runs never read a partial
+ * cache.
+ */
+void writeMeshCache(void)
+{
+	if ((!useMeshCache) || (isCached) || (!hasKey) || (mpiRank != 0)) {
+		return;
+	}
+
+	cacheHeader_t header;
+	memset(&header, 0, sizeof(header));
+	header.key = cacheKey;
+
+	strcpy(header.magic, "CCFDMSH");
+	header.version = CACHE_VERSION;
+	header.nVertices = nNodes;
+	header.nElems = nElems;
+	header.nTrias = nTrias;
+	header.nQuads = nQuads;
+	header.nSides = nSides;
+	header.nBCsides = nBCsides;
+	header.nInnerSides = nInnerSides;
+	header.isPeriodic = isPeriodic;
+	header.totalArea_q = totalArea_q;
+	header.xMin = xMin;
+	header.xMax = xMax;
+	header.yMin = yMin;
+	header.yMax = yMax;
+
+	sidePtr_t *aBCside = firstBCside;
+	while (aBCside) {
+		header.nBCedges++;
+		aBCside = aBCside->next;
+	}
+	header.nSideTotal = 3 * nTrias + 4 * nQuads + header.nBCedges;
+
+	/* collect all records */
+	double (*vertex)[NDIM] = malloc(nNodes * sizeof(double[NDIM]) + 1);
+	cacheElem_t *elemRec = calloc(nElems + 1, sizeof(cacheElem_t));
+	cacheSide_t *sideRec = calloc(header.nSideTotal + 1, sizeof(cacheSide_t));
+	long *list = malloc((nElems + 2 * nSides + 2 * header.nBCedges + 1) * sizeof(long));
+	if ((!vertex) || (!elemRec) || (!sideRec) || (!list)) {
+		printf("| ERROR: could not allocate mesh cache\n");
+		exit(1);
+	}
+
+	node_t *aNode = firstNode;
+	while (aNode) {
+		vertex[aNode->id][X] = aNode->x[X];
+		vertex[aNode->id][Y] = aNode->x[Y];
+		aNode = aNode->next;
+	}
+
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		elem_t *aElem = elem[iElem];
+		cacheElem_t *rec = &elemRec[iElem];
+		rec->fileId = aElem->fileId;
+		rec->elemType = aElem->elemType;
+		rec->domain = aElem->domain;
+		rec->firstSide = aElem->firstSide->id;
+		for (int iNode = 0; iNode < aElem->elemType; ++iNode) {
+			rec->node[iNode] = aElem->node[iNode]->id;
+		}
+		rec->nGP = aElem->nGP;
+		rec->bary[X] = aElem->bary[X];
+		rec->bary[Y] = aElem->bary[Y];
+		rec->sx = aElem->sx;
+		rec->sy = aElem->sy;
+		rec->area = aElem->area;
+		rec->areaq = aElem->areaq;
+		for (int iGP = 0; iGP < aElem->nGP; ++iGP) {
+			rec->xGP[iGP][X] = aElem->xGP[iGP][X];
+			rec->xGP[iGP][Y] = aElem->xGP[iGP][Y];
+			rec->wGP[iGP] = aElem->wGP[iGP];
+		}
+
+		side_t *aSide = aElem->firstSide;
+		while (aSide) {
+			storeSide(aSide, &sideRec[aSide->id]);
+			aSide = aSide->nextElemSide;
+		}
+	}
+
+	/* lists: elements, sides, side array, BC sides, BC side array */
+	long n = 0;
+	elem_t *aElem = firstElem;
+	while (aElem) {
+		list[n++] = aElem->id;
+		aElem = aElem->next;
+	}
+
+	side_t *aSide = firstSide;
+	while (aSide) {
+		list[n++] = aSide->id;
+		aSide = aSide->next;
+	}
+
+	for (long iSide = 0; iSide < nSides; ++iSide) {
+		list[n++] = side[iSide]->id;
+	}
+
+	aBCside = firstBCside;
+	while (aBCside) {
+		storeSide(aBCside->side, &sideRec[aBCside->side->id]);
+		list[n++] = aBCside->side->id;
+		aBCside = aBCside->next;
+	}
+
+	for (long iSide = 0; iSide < nBCsides; ++iSide) {
+		list[n++] = BCside[iSide]->id;
+	}
+
+	/* write into a temporary file and move it into place */
+	char tmpFile[2 * STRLEN + 4];
+	sprintf(tmpFile, "%s.tmp", cacheFile);
+	FILE *file = fopen(tmpFile, "wb");
+	if (!file) {
+		printf("| WARNING: could not write mesh cache '%s'\n", cacheFile);
+	} else {
+		bool isWritten =
+			(fwrite(&header, sizeof(header), 1, file) == 1) &&
+			(fwrite(vertex, sizeof(double[NDIM]), nNodes, file) == (size_t)nNodes) &&
+			(fwrite(elemRec, sizeof(cacheElem_t), nElems, file) == (size_t)nElems) &&
+			(fwrite(sideRec, sizeof(cacheSide_t), header.nSideTotal, file) == (size_t)header.nSideTotal) &&
+			(fwrite(list, sizeof(long), n, file) == (size_t)n);
+		isWritten = (fclose(file) == 0) && isWritten;
+
+		if ((isWritten) && (rename(tmpFile, cacheFile) == 0)) {
+			printf("| Mesh cache written to '%s'\n", cacheFile);
+		} else {
+			remove(tmpFile);
+			printf("| WARNING: could not write mesh cache '%s'\n", cacheFile);
+		}
+	}
+
+	free(vertex);
+	free(elemRec);
+	free(sideRec);
+	free(list);
+}
+
+/**
+ * \brief Read the preprocessed mesh from the cache file
+ * \return True, if the mesh was read, false if no matching cache exists
+ */
+bool readMeshCache(void)
+{
+	isCached = hasKey = false;
+	if (!useMeshCache) {
+		return false;
+	}
+
+	if (meshType == CARTESIAN) {
+		sprintf(cacheFile, "%s_mesh.cache", strOutFile);
+	} else {
+		sprintf(cacheFile, "%s.cache", strMeshFile);
+	}
+
+	/* the key has to be computed before `createMesh` changes the options */
+	double tStart = CPU_TIME();
+	hasKey = meshKey(&cacheKey);
+	if (!hasKey) {
+		return false;
+	}
+
+	int fd = open(cacheFile, O_RDONLY);
+	if (fd < 0) {
+		printf("| Mesh cache '%s' not found\n", cacheFile);
+		return false;
+	}
+
+	struct stat fileStat;
+	if ((fstat(fd, &fileStat) != 0) || ((size_t)fileStat.st_size < sizeof(cacheHeader_t))) {
+		close(fd);
+		printf("| Mesh cache '%s' is invalid\n", cacheFile);
+		return false;
+	}
+
+	size_t fileSize = fileStat.st_size;
+	void *map = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		printf("| Mesh cache '%s' is invalid\n", cacheFile);
+		return false;
+	}
+
+	cacheHeader_t header;
+	memcpy(&header, map, sizeof(header));
+	size_t nList = header.nElems + 2 * header.nSides + header.nBCedges + header.nBCsides;
+	if ((memcmp(header.magic, "CCFDMSH", 8)) || (header.version != CACHE_VERSION) ||
+			(header.key != cacheKey) || (fileSize != sizeof(header) +
+			header.nVertices * sizeof(double[NDIM]) +
+			header.nElems * sizeof(cacheElem_t) +
+			header.nSideTotal * sizeof(cacheSide_t) + nList * sizeof(long))) {
+		munmap(map, fileSize);
+		printf("| Mesh cache '%s' is outdated\n", cacheFile);
+		return false;
+	}
+
+	const double *vertex = (const void *)((char *)map + sizeof(header));
+	const cacheElem_t *elemRec = (const void *)(vertex + NDIM * header.nVertices);
+	const cacheSide_t *sideRec = (const void *)(elemRec + header.nElems);
+	const long *list = (const void *)(sideRec + header.nSideTotal);
+
+	nNodes = header.nVertices;
+	nElems = header.nElems;
+	nTrias = header.nTrias;
+	nQuads = header.nQuads;
+	nSides = header.nSides;
+	nBCsides = header.nBCsides;
+	nInnerSides = header.nInnerSides;
+	isPeriodic = header.isPeriodic;
+	totalArea_q = header.totalArea_q;
+	xMin = header.xMin;
+	xMax = header.xMax;
+	yMin = header.yMin;
+	yMax = header.yMax;
+	nElemsGlobal = nElems;
+	nHaloElems = 0;
+	nInterfaceSides = 0;
+
+	/* nodes */
+	initMeshArenas(nNodes, header.nBCedges);
+	node_t **vertexPtr = calloc(nNodes, sizeof(node_t *));
+	if (!vertexPtr) {
+		printf("| ERROR: could not allocate vertexPtr\n");
+		exit(1);
+	}
+
+	firstNode = NULL;
+	for (long iNode = nNodes - 1; iNode >= 0; --iNode) {
+		node_t *aNode = arenaAlloc(&nodeArena, 1);
+
+		aNode->id = iNode;
+		aNode->x[X] = vertex[NDIM * iNode + X];
+		aNode->x[Y] = vertex[NDIM * iNode + Y];
+		aNode->next = firstNode;
+		firstNode = aNode;
+		vertexPtr[iNode] = aNode;
+	}
+
+	/* elements */
+	elem = calloc(nElems, sizeof(elem_t *));
+	if (!elem) {
+		printf("| ERROR: could not allocate elem\n");
+		exit(1);
+	}
+
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		const cacheElem_t *rec = &elemRec[iElem];
+		elem_t *aElem = arenaAlloc(&elemArena, 1);
+
+		aElem->id = iElem;
+		aElem->fileId = rec->fileId;
+		aElem->elemType = rec->elemType;
+		aElem->domain = rec->domain;
+		aElem->bary[X] = rec->bary[X];
+		aElem->bary[Y] = rec->bary[Y];
+		aElem->sx = rec->sx;
+		aElem->sy = rec->sy;
+		aElem->area = rec->area;
+		aElem->areaq = rec->areaq;
+
+		aElem->node = arenaAlloc(&elemNodeArena, aElem->elemType);
+		aElem->nGP = rec->nGP;
+		aElem->xGP = arenaAlloc(&quadArena, aElem->nGP * NDIM);
+		aElem->wGP = arenaAlloc(&quadArena, aElem->nGP);
+
+		for (int iNode = 0; iNode < aElem->elemType; ++iNode) {
+			aElem->node[iNode] = vertexPtr[rec->node[iNode]];
+		}
+
+		for (int iGP = 0; iGP < aElem->nGP; ++iGP) {
+			aElem->xGP[iGP][X] = rec->xGP[iGP][X];
+			aElem->xGP[iGP][Y] = rec->xGP[iGP][Y];
+			aElem->wGP[iGP] = rec->wGP[iGP];
+		}
+
+		elem[iElem] = aElem;
+	}
+
+	/* sides, ghost sides get their own ghost element */
+	side_t **sidePtr = calloc(header.nSideTotal + 1, sizeof(side_t *));
+	if (!sidePtr) {
+		printf("| ERROR: could not allocate sidePtr\n");
+		exit(1);
+	}
+
+	for (long iSide = 0; iSide < header.nSideTotal; ++iSide) {
+		sidePtr[iSide] = arenaAlloc(&sideArena, 1);
+		sidePtr[iSide]->id = iSide;
+	}
+
+	for (long iSide = 0; iSide < header.nSideTotal; ++iSide) {
+		const cacheSide_t *rec = &sideRec[iSide];
+		side_t *aSide = sidePtr[iSide];
+		if (rec->elem >= 0) {
+			aSide->elem = elem[rec->elem];
+		} else {
+			aSide->elem = arenaAlloc(&elemArena, 1);
+			aSide->elem->id = -1;
+			aSide->elem->bary[X] = rec->bary[X];
+			aSide->elem->bary[Y] = rec->bary[Y];
+		}
+
+		aSide->connection = sidePtr[rec->connection];
+		aSide->nextElemSide = (rec->nextElemSide >= 0 ? sidePtr[rec->nextElemSide] : NULL);
+		aSide->node[0] = vertexPtr[rec->node[0]];
+		aSide->node[1] = vertexPtr[rec->node[1]];
+		aSide->BC = getBC(rec->BC);
+		for (int iDim = 0; iDim < NDIM; ++iDim) {
+			aSide->n[iDim] = rec->n[iDim];
+			aSide->baryBaryVec[iDim] = rec->baryBaryVec[iDim];
+			aSide->GP[iDim] = rec->GP[iDim];
+			aSide->w[iDim] = rec->w[iDim];
+		}
+		aSide->len = rec->len;
+		aSide->baryBaryDist = rec->baryBaryDist;
+	}
+
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		elem[iElem]->firstSide = sidePtr[elemRec[iElem].firstSide];
+	}
+
+	/* lists */
+	long n = 0;
+	firstElem = NULL;
+	elem_t **nextElem = &firstElem;
+	for (long i = 0; i < nElems; ++i) {
+		*nextElem = elem[list[n++]];
+		nextElem = &(*nextElem)->next;
+	}
+
+	firstSide = NULL;
+	side_t **nextSide = &firstSide;
+	for (long i = 0; i < nSides; ++i) {
+		*nextSide = sidePtr[list[n++]];
+		nextSide = &(*nextSide)->next;
+	}
+
+	side = calloc(nSides + 1, sizeof(side_t *));
+	BCside = calloc(nBCsides + 1, sizeof(side_t *));
+	if ((!side) || (!BCside)) {
+		printf("| ERROR: could not allocate side\n");
+		exit(1);
+	}
+
+	for (long iSide = 0; iSide < nSides; ++iSide) {
+		side[iSide] = sidePtr[list[n++]];
+	}
+
+	firstBCside = NULL;
+	sidePtr_t **nextBCside = &firstBCside;
+	for (long i = 0; i < header.nBCedges; ++i) {
+		*nextBCside = arenaAlloc(&sidePtrArena, 1);
+		(*nextBCside)->side = sidePtr[list[n++]];
+		nextBCside = &(*nextBCside)->next;
+	}
+
+	for (long iSide = 0; iSide < nBCsides; ++iSide) {
+		BCside[iSide] = sidePtr[list[n++]];
+	}
+
+	free(sidePtr);
+	free(vertexPtr);
+	munmap(map, fileSize);
+
+	isCached = true;
+	printf("| Mesh read from cache '%s' in %g s\n", cacheFile, CPU_TIME() - tStart);
+	printf("| %7ld Nodes read\n", nNodes);
+	printf("| %7ld Triangles read\n", nTrias);
+	printf("| %7ld Quadrangles read\n", nQuads);
+	printf("| %7ld Boundary Edges read\n", header.nBCedges);
+	return true;
+}
+
+/**
+ * \brief Check if the CGNS grid file of a cached mesh can be reused
+ * \return True, if the mesh was read from the cache and the grid file was
+ *	written after the cache
+ */
+bool isGridFileCurrent(void)
+{
+	struct stat gridStat, cacheStat;
+	return (isCached) && (stat(gridFile, &gridStat) == 0) &&
+		(stat(cacheFile, &cacheStat) == 0) &&
+		(gridStat.st_mtime >= cacheStat.st_mtime);
+}
@@ -0,0 +1,18 @@
+/** \file
+ *
+ * \author hhh
+ * \date Wed 14 Oct 2026 09:05:12 PM CEST
+ */
+
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include <stdbool.h>
+
+extern bool useMeshCache;
+
+bool readMeshCache(void);
+void writeMeshCache(void);
+bool isGridFileCurrent(void);
+
+#endif
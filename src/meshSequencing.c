@@ -0,0 +1,207 @@
+/** \file
+ *
+ * \brief Mesh sequencing of stationary calculations
+ *
+ * The calculation is run on a series of meshes within one call of `ccfd`,
+ * from the coarsest to the actual mesh. Every coarse stage stops after a
+ * given number of iterations or once its residual is low enough, and the next
+ * stage restarts from its last solution, which is mapped onto the finer mesh.
+ * The cartesian meshes of the coarse stages have half the elements in each
+ * direction per level, the unstructured ones are given by their mesh files.
+ *
+ * The coarse stages write their output with the suffix `_seq<level>`, only
+ * the last stage writes the output of the actual case.
+ *
+ * \author hhh
+ * \date Thu 15 Oct 2026 11:52:17 PM CEST
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "main.h"
+#include "meshSequencing.h"
+#include "readInTools.h"
+#include "mesh.h"
+#include "output.h"
+#include "timeDiscretization.h"
+#include "parallel.h"
+
+/* extern variables */
+int nSequenceStages = 1;		/**< number of meshes, 1 turns the mesh
+					  sequencing off */
+int sequenceLevel;			/**< coarsening level of the current stage,
+					  0 is the actual mesh */
+
+/* local variables */
+int iSequenceStage;			/**< current stage, from the coarsest mesh */
+double sequenceResidual;		/**< abort residual of the coarse stages */
+long sequenceIter;			/**< maximum number of iterations of a
+					  coarse stage */
+char stageSolutionFile[2 * STRLEN];	/**< last solution of the previous stage */
+long stageIter;				/**< last iteration of the previous stage */
+
+bool isRestartState;			/**< the restart state of the command line
+					  is saved */
+bool isRestartCalc;			/**< restart flag of the command line */
+char strIniCondFileCalc[STRLEN];	/**< restart file of the command line */
+long iniIterationNumberCalc;		/**< initial iteration of the command line */
+double startTimeCalc;			/**< start time of the command line */
+double restartTimeCalc;			/**< restart time of the command line */
+
+/**
+ * \brief Read the mesh sequencing parameters and set up the restart of a
+ *	stage from the previous one
+ *
+ * The first stage starts like the calculation itself, from the initial
+ * condition or the restart file of the command line.
+ * \param[in] iStage Index of the stage, from the coarsest mesh
+ */
+void initSequencing(int iStage)
+{
+	/* the restart state of the command line is restored for every variant */
+	if (!isRestartState) {
+		isRestartCalc = isRestart;
+		strcpy(strIniCondFileCalc, strIniCondFile);
+		iniIterationNumberCalc = iniIterationNumber;
+		startTimeCalc = startTime;
+		restartTimeCalc = restartTime;
+		isRestartState = true;
+	}
+
+	int nLevels = getInt("meshSequencing", "0");
+	if (nLevels < 0) {
+		printf("| ERROR: meshSequencing cannot be negative\n");
+		exit(1);
+	}
+
+	nSequenceStages = nLevels + 1;
+	iSequenceStage = iStage;
+	sequenceLevel = nLevels - iStage;
+	if (iStage == 0) {
+		isRestart = isRestartCalc;
+		strcpy(strIniCondFile, strIniCondFileCalc);
+		iniIterationNumber = iniIterationNumberCalc;
+		startTime = startTimeCalc;
+		restartTime = restartTimeCalc;
+	}
+
+	if (nLevels == 0) {
+		return;
+	}
+
+	printf("\nMesh Sequencing Stage %d of %d:\n", iStage + 1, nSequenceStages);
+	if (!isStationary) {
+		printf("| ERROR: Mesh sequencing is only possible for stationary calculations\n");
+		exit(1);
+	}
+
+	if (mpiSize > 1) {
+		printf("| ERROR: Mesh sequencing needs a single partition\n");
+		exit(1);
+	}
+
+	sequenceResidual = getDbl("sequenceResidual", "1e-4");
+	sequenceIter = getInt("sequenceIter", "1000");
+
+	if (iStage > 0) {
+		isRestart = true;
+		strcpy(strIniCondFile, stageSolutionFile);
+		iniIterationNumber = stageIter;
+		startTime = 0.0;
+		restartTime = 0.0;
+		printf("| Restart from '%s'\n", strIniCondFile);
+	}
+}
+
+/**
+ * \brief Replace the mesh parameters by the ones of the coarse mesh of the
+ *	stage, called at the end of `readMesh`
+ */
+void sequenceMesh(void)
+{
+	if (nSequenceStages == 1) {
+		return;
+	}
+
+	if (meshType == UNSTRUCTURED) {
+		/* the coarse meshes are given from the coarsest one on */
+		for (int iStage = 0; iStage < nSequenceStages - 1; ++iStage) {
+			char *tmp = getStr("sequenceMeshFile", NULL);
+			if (iStage == iSequenceStage) {
+				strcat(strcpy(strMeshFile, tmp), strMeshFormat);
+			}
+			free(tmp);
+		}
+	} else if (sequenceLevel > 0) {
+		int factor = 1 << sequenceLevel;
+		if ((cartMesh.iMax % factor) || (cartMesh.jMax % factor)) {
+			printf("| ERROR: nElemsX and nElemsY must be divisible by %d\n",
+					factor);
+			exit(1);
+		}
+
+		cartMesh.iMax /= factor;
+		cartMesh.jMax /= factor;
+		for (int iSide = 0; iSide < 2 * NDIM; ++iSide) {
+			for (int i = 0; i < cartMesh.nBC[iSide]; ++i) {
+				int *range = cartMesh.BCrange[iSide][i];
+				if (((range[0] - 1) % factor) || (range[1] % factor)) {
+					printf("| ERROR: The boundary segments must align with the coarse mesh\n");
+					exit(1);
+				}
+
+				range[0] = (range[0] - 1) / factor + 1;
+				range[1] /= factor;
+			}
+		}
+	}
+
+	printf("| Sequencing Level %d: ", sequenceLevel);
+	if (meshType == UNSTRUCTURED) {
+		printf("%s\n", strMeshFile);
+	} else {
+		printf("%d x %d Elements\n", cartMesh.iMax, cartMesh.jMax);
+	}
+}
+
+/**
+ * \brief Stop a coarse stage after `sequenceIter` iterations or at
+ *	`sequenceResidual`, called after `initTimeDisc`
+ */
+void limitSequenceStage(void)
+{
+	if (nSequenceStages == 1) {
+		return;
+	}
+
+	if (iVisuProg != CGNS) {
+		printf("| ERROR: Mesh sequencing needs the CGNS output\n");
+		exit(1);
+	}
+
+	if (sequenceLevel > 0) {
+		if (iniIterationNumber + sequenceIter < maxIter) {
+			maxIter = iniIterationNumber + sequenceIter;
+		}
+		abortResidual = sequenceResidual;
+		printf("| Coarse Stage: %ld Iterations, Abort Residual %g\n",
+				maxIter - iniIterationNumber, abortResidual);
+	}
+}
+
+/**
+ * \brief Remember the last solution of the stage, which the next stage
+ *	starts from
+ */
+void finishSequenceStage(void)
+{
+	if (nSequenceStages == 1) {
+		return;
+	}
+
+	strcpy(stageSolutionFile, lastSolutionFile);
+	stageIter = outputTimes->iter;
+}
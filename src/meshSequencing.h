@@ -0,0 +1,18 @@
+/** \file
+ *
+ * \author hhh
+ * \date Thu 15 Oct 2026 11:52:17 PM CEST
+ */
+
+#ifndef MESHSEQUENCING_H
+#define MESHSEQUENCING_H
+
+extern int nSequenceStages;
+extern int sequenceLevel;
+
+void initSequencing(int iStage);
+void sequenceMesh(void);
+void limitSequenceStage(void);
+void finishSequenceStage(void);
+
+#endif
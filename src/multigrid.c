@@ -0,0 +1,702 @@
+/** \file
+ *
+ * \brief Agglomeration multigrid for the acceleration of stationary
+ *	calculations
+ *
+ * The coarse levels are built by agglomerating every element with all of its
+ * neighbors, that are not yet part of a coarse element. The sides between two
+ * coarse elements are merged into a single side, boundary sides are kept as
+ * they are. The levels are coupled by the full approximation storage (FAS)
+ * scheme: the coarse levels are smoothed with the explicit time stepping of
+ * the fine mesh, by putting their data in place of the global mesh data, with
+ * first order reconstruction, local time steps and the forcing term in place
+ * of the source term.
+ *
+ * \author hhh
+ * \date Wed 14 Oct 2026 09:12:44 PM CEST
+ */
+
+typedef struct mgLevel_t mgLevel_t;
+typedef struct mgSide_t mgSide_t;
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+
+#include "main.h"
+#include "multigrid.h"
+#include "mesh.h"
+#include "readInTools.h"
+#include "memTools.h"
+#include "timeDiscretization.h"
+#include "finiteVolume.h"
+#include "equation.h"
+#include "equationOfState.h"
+#include "parallel.h"
+
+/**
+ * \brief Mesh and solution data of one multigrid level
+ */
+struct mgLevel_t {
+	long nElems;			/**< number of elements */
+	long nSides;			/**< number of sides */
+	long nBCsides;			/**< number of boundary sides */
+	long nInnerSides;		/**< number of inner sides */
+	elemData_t elemData;		/**< element data of the level */
+	sideData_t sideData;		/**< side data of the level */
+	long *coarseElem;		/**< element of the next coarser level,
+						that contains the element [nElems] */
+	long *fineOffset;		/**< CSR offsets into `fineElem` [nElems + 1] */
+	long *fineElem;			/**< elements of the next finer level,
+						that form the element */
+	double **cVarRestricted;	/**< conservative variables right after
+						the restriction [NVAR][nElems] */
+	double **residual;		/**< restricted residual of the next finer
+						level [NVAR][nElems] */
+};
+
+/**
+ * \brief Part of a coarse side, used for merging all sides between the same
+ *	two coarse elements
+ */
+struct mgSide_t {
+	long elem[2];			/**< the two coarse elements, ascending */
+	double nLen[NDIM];		/**< normal vector times side length,
+						from the first to the second element */
+	double xLen[NDIM];		/**< side midpoint times side length */
+	double len;			/**< length of the side */
+};
+
+/* extern variables */
+int nMGlevels;				/**< number of multigrid levels */
+int mgCycle;				/**< multigrid cycle type */
+
+/* local variables */
+int nPostSmooth;			/**< smoothing steps after the coarse grid
+					  correction */
+mgLevel_t *level;			/**< all levels, the first one is the
+					  mesh itself */
+int fineSpatialOrder;			/**< spatial order of the fine mesh */
+bool fineStructured;			/**< structured kernels flag of the fine
+					  mesh */
+bool fineCalcSource;			/**< source term flag of the fine mesh */
+bool fineLocalTimeStep;			/**< local time stepping flag of the fine
+					  mesh */
+
+/**
+ * \brief Compare two coarse sides by their elements
+ * \param[in] a Pointer to a coarse side
+ * \param[in] b Pointer to a coarse side
+ * \return Negative, zero or positive, if a is sorted before, equal to or after b
+ */
+int compareMGside(const void *a, const void *b)
+{
+	const mgSide_t *A = a;
+	const mgSide_t *B = b;
+	if (A->elem[0] != B->elem[0]) {
+		return (A->elem[0] < B->elem[0] ? -1 : 1);
+	}
+
+	return (A->elem[1] < B->elem[1] ? -1 : (A->elem[1] > B->elem[1]));
+}
+
+/**
+ * \brief Allocate the element and side arrays of a coarse level
+ * \param[in,out] aLevel The level, with the number of elements and sides set
+ */
+void allocateLevel(mgLevel_t *aLevel)
+{
+	long nTotal = aLevel->nElems + aLevel->nBCsides;
+	elemData_t *e = &aLevel->elemData;
+	sideData_t *s = &aLevel->sideData;
+
+	e->bary = dyn2DdblArray(NDIM, nTotal);
+	e->sx = dyn1DdblArray(aLevel->nElems);
+	e->sy = dyn1DdblArray(aLevel->nElems);
+	e->area = dyn1DdblArray(aLevel->nElems);
+	e->areaq = dyn1DdblArray(aLevel->nElems);
+	e->sideOffset = dyn1DintArray(aLevel->nElems + 1);
+	e->pVar = dyn2DdblArray(NVAR, nTotal);
+	e->cVar = dyn2DdblArray(NVAR, aLevel->nElems);
+	e->cVarStage = dyn2DdblArray(NVAR, aLevel->nElems);
+	e->u_x = dyn2DdblArray(NVAR, nTotal);
+	e->u_y = dyn2DdblArray(NVAR, nTotal);
+	e->u_t = dyn2DdblArray(NVAR, aLevel->nElems);
+	e->source = dyn2DdblArray(NVAR, aLevel->nElems);
+	e->dt = dyn1DdblArray(aLevel->nElems);
+	e->dtLoc = dyn1DdblArray(aLevel->nElems);
+	e->venkEps_sq = dyn1DdblArray(aLevel->nElems);
+
+	s->n = dyn2DdblArray(NDIM, aLevel->nSides);
+	s->len = dyn1DdblArray(aLevel->nSides);
+	s->baryBaryVec = dyn2DdblArray(NDIM, aLevel->nSides);
+	s->baryBaryDist = dyn1DdblArray(aLevel->nSides);
+	s->flux = dyn2DdblArray(NVAR, aLevel->nSides);
+	s->elem = dyn1DintArray(2 * aLevel->nSides);
+	s->GP = dyn2DdblArray(NDIM, 2 * aLevel->nSides);
+	s->w = dyn2DdblArray(NDIM, 2 * aLevel->nSides);
+	s->pVar = dyn2DfaceArray(NVAR, 2 * aLevel->nSides);
+	s->BCsideId = dyn1DintArray(aLevel->nBCsides);
+	s->BC = calloc((aLevel->nBCsides > 0 ? aLevel->nBCsides : 1), sizeof(boundary_t *));
+	if (!s->BC) {
+		printf("| ERROR: could not allocate sideData.BC\n");
+		exit(1);
+	}
+
+	aLevel->cVarRestricted = dyn2DdblArray(NVAR, aLevel->nElems);
+	aLevel->residual = dyn2DdblArray(NVAR, aLevel->nElems);
+}
+
+/**
+ * \brief Set the geometry of a side of a coarse level
+ * \param[in,out] c The coarse level
+ * \param[in] iSide Side of the coarse level
+ * \param[in] nLen Normal vector times length of the side
+ * \param[in] x Midpoint of the side
+ */
+void setCoarseSide(mgLevel_t *c, long iSide, const double nLen[NDIM],
+		const double x[NDIM])
+{
+	elemData_t *e = &c->elemData;
+	sideData_t *s = &c->sideData;
+	long lElem = s->elem[2 * iSide];
+	long rElem = s->elem[2 * iSide + 1];
+
+	double len = sqrt(nLen[X] * nLen[X] + nLen[Y] * nLen[Y]);
+	s->len[iSide] = len;
+	s->n[X][iSide] = nLen[X] / len;
+	s->n[Y][iSide] = nLen[Y] / len;
+
+	s->baryBaryVec[X][iSide] = e->bary[X][rElem] - e->bary[X][lElem];
+	s->baryBaryVec[Y][iSide] = e->bary[Y][rElem] - e->bary[Y][lElem];
+	s->baryBaryDist[iSide] = sqrt(
+			s->baryBaryVec[X][iSide] * s->baryBaryVec[X][iSide] +
+			s->baryBaryVec[Y][iSide] * s->baryBaryVec[Y][iSide]);
+
+	s->GP[X][2 * iSide] = x[X] - e->bary[X][lElem];
+	s->GP[Y][2 * iSide] = x[Y] - e->bary[Y][lElem];
+	s->GP[X][2 * iSide + 1] = x[X] - e->bary[X][rElem];
+	s->GP[Y][2 * iSide + 1] = x[Y] - e->bary[Y][rElem];
+
+	/* cell extensions for the time step */
+	e->sx[lElem] += 0.5 * fabs(nLen[X]);
+	e->sy[lElem] += 0.5 * fabs(nLen[Y]);
+	if (rElem < c->nElems) {
+		e->sx[rElem] += 0.5 * fabs(nLen[X]);
+		e->sy[rElem] += 0.5 * fabs(nLen[Y]);
+	}
+}
+
+/**
+ * \brief Create the next coarser level by agglomeration
+ *
+ * The elements are visited in their order, every element that is not yet
+ * agglomerated forms a new coarse element together with all of its free
+ * neighbors. An element without free neighbors is added to the smallest
+ * adjacent coarse element instead.
+ * \param[in,out] f The fine level, receives the coarse element of every element
+ * \param[out] c The coarse level
+ */
+void createCoarseLevel(mgLevel_t *f, mgLevel_t *c)
+{
+	elemData_t *fe = &f->elemData;
+	sideData_t *fs = &f->sideData;
+
+	/* agglomeration */
+	f->coarseElem = dyn1DintArray(f->nElems);
+	long *nFine = dyn1DintArray(f->nElems);
+	for (long iElem = 0; iElem < f->nElems; ++iElem) {
+		f->coarseElem[iElem] = -1;
+	}
+
+	long nCoarse = 0;
+	for (long iElem = 0; iElem < f->nElems; ++iElem) {
+		if (f->coarseElem[iElem] >= 0) {
+			continue;
+		}
+
+		long nFree = 0, smallest = -1;
+		for (long j = fe->sideOffset[iElem]; j < fe->sideOffset[iElem + 1]; ++j) {
+			long NBelem = fs->elem[fe->sideIdx[j] ^ 1];
+			if (NBelem >= f->nElems) {
+				continue;
+			}
+
+			if (f->coarseElem[NBelem] < 0) {
+				f->coarseElem[NBelem] = nCoarse;
+				nFree++;
+			} else if ((smallest < 0) || (nFine[f->coarseElem[NBelem]] < nFine[smallest])) {
+				smallest = f->coarseElem[NBelem];
+			}
+		}
+
+		if ((nFree == 0) && (smallest >= 0)) {
+			f->coarseElem[iElem] = smallest;
+			nFine[smallest]++;
+		} else {
+			f->coarseElem[iElem] = nCoarse;
+			nFine[nCoarse++] = nFree + 1;
+		}
+	}
+
+	/* merge the sides between the same coarse elements */
+	mgSide_t *list = malloc((f->nSides > 0 ? f->nSides : 1) * sizeof(mgSide_t));
+	if (!list) {
+		printf("| ERROR: could not allocate list\n");
+		exit(1);
+	}
+
+	long nList = 0;
+	for (long iSide = 0; iSide < f->nSides; ++iSide) {
+		long lElem = fs->elem[2 * iSide];
+		long rElem = fs->elem[2 * iSide + 1];
+		if (rElem >= f->nElems) {
+			continue;
+		}
+
+		long a = f->coarseElem[lElem];
+		long b = f->coarseElem[rElem];
+		if (a == b) {
+			continue;
+		}
+
+		double sign = (a < b ? 1.0 : -1.0);
+		double len = fs->len[iSide];
+		mgSide_t *aSide = &list[nList++];
+		aSide->elem[0] = (a < b ? a : b);
+		aSide->elem[1] = (a < b ? b : a);
+		aSide->nLen[X] = sign * fs->n[X][iSide] * len;
+		aSide->nLen[Y] = sign * fs->n[Y][iSide] * len;
+		aSide->xLen[X] = (fs->GP[X][2 * iSide] + fe->bary[X][lElem]) * len;
+		aSide->xLen[Y] = (fs->GP[Y][2 * iSide] + fe->bary[Y][lElem]) * len;
+		aSide->len = len;
+	}
+
+	qsort(list, nList, sizeof(mgSide_t), compareMGside);
+
+	long nMerged = 0;
+	for (long i = 0; i < nList; ++i) {
+		if ((nMerged > 0) && (compareMGside(&list[nMerged - 1], &list[i]) == 0)) {
+			mgSide_t *aSide = &list[nMerged - 1];
+			aSide->nLen[X] += list[i].nLen[X];
+			aSide->nLen[Y] += list[i].nLen[Y];
+			aSide->xLen[X] += list[i].xLen[X];
+			aSide->xLen[Y] += list[i].xLen[Y];
+			aSide->len += list[i].len;
+		} else {
+			list[nMerged++] = list[i];
+		}
+	}
+
+	/* sides that cancel out do not carry any flux */
+	long nInner = 0;
+	for (long i = 0; i < nMerged; ++i) {
+		double nLen = sqrt(list[i].nLen[X] * list[i].nLen[X]
+				+ list[i].nLen[Y] * list[i].nLen[Y]);
+		if (nLen > 1e-12 * list[i].len) {
+			list[nInner++] = list[i];
+		}
+	}
+
+	/* coarse elements */
+	c->nElems = nCoarse;
+	c->nBCsides = f->nBCsides;
+	c->nInnerSides = nInner;
+	c->nSides = nInner + f->nBCsides;
+	allocateLevel(c);
+
+	elemData_t *ce = &c->elemData;
+	sideData_t *cs = &c->sideData;
+
+	c->fineOffset = dyn1DintArray(nCoarse + 1);
+	c->fineElem = dyn1DintArray(f->nElems);
+	for (long iElem = 0; iElem < f->nElems; ++iElem) {
+		c->fineOffset[f->coarseElem[iElem] + 1]++;
+	}
+	for (long iCoarse = 0; iCoarse < nCoarse; ++iCoarse) {
+		c->fineOffset[iCoarse + 1] += c->fineOffset[iCoarse];
+		nFine[iCoarse] = c->fineOffset[iCoarse];
+	}
+	for (long iElem = 0; iElem < f->nElems; ++iElem) {
+		c->fineElem[nFine[f->coarseElem[iElem]]++] = iElem;
+	}
+	free(nFine);
+
+	for (long iElem = 0; iElem < f->nElems; ++iElem) {
+		long iCoarse = f->coarseElem[iElem];
+		ce->area[iCoarse] += fe->area[iElem];
+		ce->bary[X][iCoarse] += fe->area[iElem] * fe->bary[X][iElem];
+		ce->bary[Y][iCoarse] += fe->area[iElem] * fe->bary[Y][iElem];
+	}
+
+	for (long iCoarse = 0; iCoarse < nCoarse; ++iCoarse) {
+		ce->areaq[iCoarse] = 1.0 / ce->area[iCoarse];
+		ce->bary[X][iCoarse] *= ce->areaq[iCoarse];
+		ce->bary[Y][iCoarse] *= ce->areaq[iCoarse];
+	}
+
+	/* coarse sides: the merged inner sides followed by the boundary sides,
+	 * whose ghost elements are mirrored at the side midpoint */
+	for (long iSide = 0; iSide < nInner; ++iSide) {
+		cs->elem[2 * iSide] = list[iSide].elem[0];
+		cs->elem[2 * iSide + 1] = list[iSide].elem[1];
+
+		double x[NDIM] = {
+			list[iSide].xLen[X] / list[iSide].len,
+			list[iSide].xLen[Y] / list[iSide].len};
+		setCoarseSide(c, iSide, list[iSide].nLen, x);
+	}
+	free(list);
+
+	for (long iBC = 0; iBC < f->nBCsides; ++iBC) {
+		long fSide = fs->BCsideId[iBC];
+		long lElem = fs->elem[2 * fSide];
+		long iSide = nInner + iBC;
+		long iCoarse = f->coarseElem[lElem];
+		long gElem = nCoarse + iBC;
+
+		double x[NDIM] = {
+			fs->GP[X][2 * fSide] + fe->bary[X][lElem],
+			fs->GP[Y][2 * fSide] + fe->bary[Y][lElem]};
+		ce->bary[X][gElem] = 2.0 * x[X] - ce->bary[X][iCoarse];
+		ce->bary[Y][gElem] = 2.0 * x[Y] - ce->bary[Y][iCoarse];
+
+		cs->elem[2 * iSide] = iCoarse;
+		cs->elem[2 * iSide + 1] = gElem;
+		cs->BCsideId[iBC] = iSide;
+		cs->BC[iBC] = fs->BC[iBC];
+
+		double nLen[NDIM] = {
+			fs->n[X][fSide] * fs->len[fSide],
+			fs->n[Y][fSide] * fs->len[fSide]};
+		setCoarseSide(c, iSide, nLen, x);
+	}
+
+	/* CSR list of the sides of every coarse element */
+	for (long iSide = 0; iSide < c->nSides; ++iSide) {
+		ce->sideOffset[cs->elem[2 * iSide] + 1]++;
+		if (cs->elem[2 * iSide + 1] < nCoarse) {
+			ce->sideOffset[cs->elem[2 * iSide + 1] + 1]++;
+		}
+	}
+
+	long *pos = dyn1DintArray(nCoarse);
+	for (long iCoarse = 0; iCoarse < nCoarse; ++iCoarse) {
+		ce->sideOffset[iCoarse + 1] += ce->sideOffset[iCoarse];
+		pos[iCoarse] = ce->sideOffset[iCoarse];
+	}
+
+	ce->sideIdx = dyn1DintArray(ce->sideOffset[nCoarse]);
+	for (long iSide = 0; iSide < 2 * c->nSides; ++iSide) {
+		long iCoarse = cs->elem[iSide];
+		if (iCoarse < nCoarse) {
+			ce->sideIdx[pos[iCoarse]++] = iSide;
+		}
+	}
+	free(pos);
+
+	groupBCsides(cs, ce, nCoarse, c->nBCsides);
+}
+
+/**
+ * \brief Put the data of a level in place of the global mesh data
+ * \param[in] iLevel The level
+ */
+void setLevel(int iLevel)
+{
+	mgLevel_t *aLevel = &level[iLevel];
+	nElems = aLevel->nElems;
+	nSides = aLevel->nSides;
+	nBCsides = aLevel->nBCsides;
+	nInnerSides = aLevel->nInnerSides;
+	elemData = aLevel->elemData;
+	sideData = aLevel->sideData;
+
+	spatialOrder = (iLevel == 0 ? fineSpatialOrder : 1);
+	useStructured = (iLevel == 0 ? fineStructured : false);
+	doCalcSource = (iLevel == 0 ? fineCalcSource : false);
+	isLocalTimeStep = (iLevel == 0 ? fineLocalTimeStep : true);
+}
+
+/**
+ * \brief Initialize the multigrid levels
+ */
+void initMultigrid(void)
+{
+	printf("\nInitializing Multigrid:\n");
+	nMGlevels = getInt("multigridLevels", "1");
+	if (nMGlevels < 2) {
+		nMGlevels = 1;
+		return;
+	}
+
+	if ((!isStationary) || isImplicit) {
+		printf("| ERROR: Multigrid requires a stationary, explicit calculation\n");
+		exit(1);
+	}
+
+	if (mpiSize > 1) {
+		printf("| ERROR: Multigrid is not available with MPI\n");
+		exit(1);
+	}
+
+	mgCycle = getInt("multigridCycle", "1");
+	switch (mgCycle) {
+	case V_CYCLE:
+		printf("| Cycle: V-Cycle\n");
+		break;
+	case W_CYCLE:
+		printf("| Cycle: W-Cycle\n");
+		break;
+	default:
+		printf("| ERROR: Multigrid cycle must be either 1 or 2\n");
+		exit(1);
+	}
+
+	nPostSmooth = getInt("multigridPostSmooth", "0");
+
+	fineSpatialOrder = spatialOrder;
+	fineStructured = useStructured;
+	fineCalcSource = doCalcSource;
+	fineLocalTimeStep = isLocalTimeStep;
+
+	level = calloc(nMGlevels, sizeof(mgLevel_t));
+	if (!level) {
+		printf("| ERROR: could not allocate level\n");
+		exit(1);
+	}
+
+	level[0].nElems = nElems;
+	level[0].nSides = nSides;
+	level[0].nBCsides = nBCsides;
+	level[0].nInnerSides = nInnerSides;
+	level[0].elemData = elemData;
+	level[0].sideData = sideData;
+	printf("| Level 0: %ld elements, %ld sides\n", nElems, nSides);
+
+	for (int iLevel = 1; iLevel < nMGlevels; ++iLevel) {
+		createCoarseLevel(&level[iLevel - 1], &level[iLevel]);
+		printf("| Level %d: %ld elements, %ld sides\n", iLevel,
+				level[iLevel].nElems, level[iLevel].nSides);
+
+		/* stop as soon as the agglomeration does not pay off */
+		if ((level[iLevel].nElems == 1) ||
+				(level[iLevel].nElems > 0.8 * level[iLevel - 1].nElems)) {
+			nMGlevels = iLevel + 1;
+			break;
+		}
+	}
+}
+
+/**
+ * \brief Smoothing step on a level, with the explicit time stepping scheme
+ * \param[in] iLevel The level
+ * \param[in] time Computation time at calculation
+ * \param[in] dt Time step of the fine level
+ * \param[out] resIter Residual vector for time step
+ */
+void smooth(int iLevel, double time, double dt, double resIter[NVAR + 2])
+{
+	if (iLevel > 0) {
+		bool viscousTimeStepDominates;
+		calcTimeStep(printTime, &dt, &viscousTimeStepDominates);
+	}
+
+	if ((timeOrder == 1) && (nRKstages == 1)) {
+		explicitTimeStepEuler(time, resIter);
+	} else {
+		explicitTimeStepRK(time, dt, resIter);
+	}
+}
+
+/**
+ * \brief Restrict the solution and the residual of a level to the next
+ *	coarser level and set the forcing term there
+ *
+ * The residual of the fine level has to be computed beforehand. The forcing
+ * term is set, so that the residual of the restricted solution equals the
+ * restricted residual of the fine level.
+ * \param[in] iLevel The coarse level
+ * \param[in] time Computation time at calculation
+ */
+void restrictLevel(int iLevel, double time)
+{
+	elemData_t *fe = &level[iLevel - 1].elemData;
+	mgLevel_t *c = &level[iLevel];
+	elemData_t *ce = &c->elemData;
+
+	#pragma omp parallel for
+	for (long iElem = 0; iElem < c->nElems; ++iElem) {
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			double cVar = 0.0, residual = 0.0;
+			for (long j = c->fineOffset[iElem]; j < c->fineOffset[iElem + 1]; ++j) {
+				long fElem = c->fineElem[j];
+				cVar += fe->area[fElem] * fe->cVar[iVar][fElem];
+				residual += fe->area[fElem] * fe->u_t[iVar][fElem];
+			}
+
+			ce->cVar[iVar][iElem] = cVar * ce->areaq[iElem];
+			c->cVarRestricted[iVar][iElem] = ce->cVar[iVar][iElem];
+			c->residual[iVar][iElem] = residual;
+			ce->source[iVar][iElem] = 0.0;
+		}
+	}
+
+	setLevel(iLevel);
+
+	#pragma omp parallel for
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		consPrimElem(iElem);
+	}
+
+	fvTimeDerivative(time);
+
+	#pragma omp parallel for
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			elemData.source[iVar][iElem] = c->residual[iVar][iElem]
+				- elemData.area[iElem] * elemData.u_t[iVar][iElem];
+		}
+	}
+}
+
+/**
+ * \brief Add the coarse grid correction of the next coarser level to a level
+ *
+ * The correction is injected into all elements that form a coarse element.
+ * It is skipped for elements, where it would lead to a negative density or
+ * pressure.
+ * \param[in] iLevel The fine level
+ */
+void prolongLevel(int iLevel)
+{
+	mgLevel_t *c = &level[iLevel + 1];
+	elemData_t *ce = &c->elemData;
+	long *coarseElem = level[iLevel].coarseElem;
+
+	setLevel(iLevel);
+
+	#pragma omp parallel for
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		long iCoarse = coarseElem[iElem];
+		double cVarOld[NVAR];
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			cVarOld[iVar] = elemData.cVar[iVar][iElem];
+			elemData.cVar[iVar][iElem] += ce->cVar[iVar][iCoarse]
+				- c->cVarRestricted[iVar][iCoarse];
+		}
+
+		consPrimElem(iElem);
+
+		if ((elemData.pVar[RHO][iElem] <= 0.0) || (elemData.pVar[P][iElem] <= 0.0)) {
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				elemData.cVar[iVar][iElem] = cVarOld[iVar];
+			}
+			consPrimElem(iElem);
+		}
+	}
+}
+
+/**
+ * \brief Recursive multigrid cycle, starting at a level
+ * \param[in] iLevel The level
+ * \param[in] time Computation time at calculation
+ * \param[in] dt Time step of the fine level
+ * \param[out] resIter Residual vector of the smoothing step on the level
+ */
+void cycleLevel(int iLevel, double time, double dt, double resIter[NVAR + 2])
+{
+	smooth(iLevel, time, dt, resIter);
+	if (iLevel == nMGlevels - 1) {
+		return;
+	}
+
+	/* coarse grid correction, with the residual of the smoothed solution */
+	fvTimeDerivative(time);
+	restrictLevel(iLevel + 1, time);
+
+	int nCorrections = (mgCycle == W_CYCLE ? 2 : 1);
+	for (int i = 0; i < nCorrections; ++i) {
+		double resCoarse[NVAR + 2];
+		cycleLevel(iLevel + 1, time, dt, resCoarse);
+	}
+
+	prolongLevel(iLevel);
+
+	for (int i = 0; i < nPostSmooth; ++i) {
+		smooth(iLevel, time, dt, resIter);
+	}
+}
+
+/**
+ * \brief Perform one multigrid cycle, in place of a single explicit time step
+ * \param[in] time Computation time at calculation
+ * \param[in] dt Time step at calculation
+ * \param[out] resIter Residual vector for time step
+ */
+void multigridCycle(double time, double dt, double resIter[NVAR + 2])
+{
+	double dtFine = dtGlobal;
+	cycleLevel(0, time, dt, resIter);
+	dtGlobal = dtFine;
+}
+
+/**
+ * \brief Free the coarse levels
+ */
+void freeMultigrid(void)
+{
+	if (nMGlevels < 2) {
+		return;
+	}
+
+	for (int iLevel = 0; iLevel < nMGlevels; ++iLevel) {
+		mgLevel_t *aLevel = &level[iLevel];
+		free(aLevel->coarseElem);
+		if (iLevel == 0) {
+			continue;
+		}
+
+		free(aLevel->fineOffset);
+		free(aLevel->fineElem);
+		free(aLevel->cVarRestricted);
+		free(aLevel->residual);
+
+		elemData_t *e = &aLevel->elemData;
+		free(e->bary);
+		free(e->sx);
+		free(e->sy);
+		free(e->area);
+		free(e->areaq);
+		free(e->sideOffset);
+		free(e->sideIdx);
+		free(e->pVar);
+		free(e->cVar);
+		free(e->cVarStage);
+		free(e->u_x);
+		free(e->u_y);
+		free(e->u_t);
+		free(e->source);
+		free(e->dt);
+		free(e->dtLoc);
+		free(e->venkEps_sq);
+
+		sideData_t *s = &aLevel->sideData;
+		free(s->n);
+		free(s->len);
+		free(s->baryBaryVec);
+		free(s->baryBaryDist);
+		free(s->flux);
+		free(s->elem);
+		free(s->GP);
+		free(s->w);
+		free(s->pVar);
+		free(s->BCsideId);
+		free(s->BC);
+		freeBCgroups(s);
+	}
+
+	free(level);
+}
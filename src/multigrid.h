@@ -0,0 +1,19 @@
+/** \file
+ *
+ * \author hhh
+ * \date Wed 14 Oct 2026 09:12:44 PM CEST
+ */
+
+#ifndef MULTIGRID_H
+#define MULTIGRID_H
+
+#include "main.h"
+
+extern int nMGlevels;
+extern int mgCycle;
+
+void initMultigrid(void);
+void multigridCycle(double time, double dt, double resIter[NVAR + 2]);
+void freeMultigrid(void);
+
+#endif
@@ -6,10 +6,15 @@
  * \date Mon 23 Mar 2020 10:42:06 PM CET
  */
 
+typedef struct outputJob_t outputJob_t;
+
+#define N_FIELDS 5			/**< number of CGNS solution fields */
+
 #include <stdio.h>
 #include <string.h>
 #include <omp.h>
 #include <math.h>
+#include <pthread.h>
 
 #include "main.h"
 #include "output.h"
@@ -20,6 +25,30 @@
 #include "exactFunction.h"
 #include "cgnslib.h"
 #include "memTools.h"
+#include "parallel.h"
+#include "timer.h"
+#include "device.h"
+#include "insitu.h"
+#include "meshAdaptation.h"
+#include "meshSequencing.h"
+#include "solutionMapping.h"
+
+/**
+ * \brief Gathered flow solution of one output file, as passed to the writer
+ */
+struct outputJob_t {
+	char fileName[2 * STRLEN];	/**< name of the output file */
+	char solutionName[32];		/**< name of the solution node in the
+						CGNS time series file */
+	double time;			/**< computational time of the solution */
+	double timeOverall;		/**< overall time of the solution */
+	double **flowData;		/**< flow solution, as collected by
+						`gatherFlowData`, NULL for the
+						master file */
+	outputTime_t *outputTimes;	/**< latest output time of the master
+						file, or of the time series file
+						for flow solutions */
+};
 
 /* extern variables */
 char strOutFile[STRLEN];		/**< name of the output file */
@@ -29,6 +58,104 @@ int iVisuProg;				/**< output format code */
 FILE *resFile;				/**< residual file pointer */
 bool doErrorOutput;			/**< error output flag */
 outputTime_t *outputTimes;		/**< the first output time object */
+bool isAsyncOutput;			/**< write the output in a separate thread */
+bool isSeriesOutput;			/**< write all CGNS solutions into a single
+					  time series file */
+bool isGridFileOutdated;		/**< the mesh changed since the grid file
+					  was written */
+
+/* local variables */
+int outputQueueSize;			/**< maximum number of solutions that are
+					  buffered for the writer */
+outputJob_t **outputQueue;		/**< ring buffer of the buffered solutions */
+int queueHead;				/**< position of the oldest solution */
+int nQueued;				/**< number of buffered solutions, including
+					  the one being written */
+bool doStopWriter;			/**< the writer terminates once the queue
+					  is empty */
+double tOutputWait;			/**< time the solver waited for the writer */
+pthread_t writerThread;			/**< the writer thread */
+pthread_mutex_t queueMutex;		/**< lock of the queue */
+pthread_cond_t jobAdded;		/**< signals a new solution in the queue */
+pthread_cond_t jobDone;			/**< signals a written solution */
+
+char seriesFile[2 * STRLEN];		/**< name of the time series file */
+char lastSolutionFile[2 * STRLEN];	/**< CGNS file of the latest flow
+					  solution */
+bool isSeriesCreated;			/**< the time series file was created */
+bool isSinglePrecision;			/**< write the CGNS fields in single
+					  precision */
+int compressionLevel;			/**< deflate level of the CGNS fields */
+bool isOutputField[N_FIELDS];		/**< fields that are written to CGNS */
+
+/** \brief Names of the CGNS solution fields */
+const char *fieldNames[N_FIELDS] = {"Density", "VelocityX", "VelocityY",
+	"VelocityZ", "Pressure"};
+/** \brief Columns of the CGNS solution fields in the gathered flow data,
+ *	-1 for fields that are zero */
+const int fieldColumns[N_FIELDS] = {NDIM + RHO, NDIM + VX, NDIM + VY, -1,
+	NDIM + P};
+
+void *outputWriter(void *arg);
+void cgnsFinalizeOutput(outputTime_t *firstOutputTime);
+
+/**
+ * \brief Initialize the CGNS solution output: the time series file, the
+ *	written fields, their precision and compression
+ */
+void initCGNSoutput(void)
+{
+	isSeriesOutput = getBool("seriesOutput", "F");
+	isSeriesCreated = false;
+	if (isSeriesOutput) {
+		strcat(strcpy(seriesFile, strOutFile), "_Series.cgns");
+	}
+
+	isSinglePrecision = getBool("singlePrecisionOutput", "F");
+
+	/* all fields, unless only some of them are specified */
+	char *tmp = getStr("outputVariables",
+			"Density,VelocityX,VelocityY,VelocityZ,Pressure");
+	for (int iField = 0; iField < N_FIELDS; ++iField) {
+		isOutputField[iField] = false;
+	}
+
+	char *tok = strtok(tmp, ",");
+	while (tok) {
+		int iField = 0;
+		while ((iField < N_FIELDS) && strcmp(tok, fieldNames[iField])) {
+			iField++;
+		}
+
+		if (iField == N_FIELDS) {
+			printf("| ERROR: Output variable '%s' unknown\n", tok);
+			exit(1);
+		}
+
+		isOutputField[iField] = true;
+		tok = strtok(NULL, ",");
+	}
+	free(tmp);
+
+	/* the HDF5 backend stores compressed fields in chunked datasets */
+	compressionLevel = getInt("outputCompression", "0");
+	if ((compressionLevel < 0) || (compressionLevel > 9)) {
+		printf("| ERROR: outputCompression must be between 0 and 9\n");
+		exit(1);
+	}
+
+#if CG_BUILD_HDF5
+	if (cg_set_file_type(CG_FILE_HDF5))
+		cg_error_exit();
+
+	if (cg_configure(CG_CONFIG_HDF5_COMPRESS, (void *)(size_t)compressionLevel))
+		cg_error_exit();
+#else
+	if (compressionLevel > 0) {
+		printf("| WARNING: CGNS was built without HDF5, the output is not compressed\n");
+	}
+#endif
+}
 
 /**
  * \brief Initialize output
@@ -41,105 +168,157 @@ void initOutput(void)
 	strcpy(strOutFile, tmp);
 	free(tmp);
 
+	/* the coarse stages of the mesh sequencing have their own files */
+	if (sequenceLevel > 0) {
+		sprintf(strOutFile + strlen(strOutFile), "_seq%d", sequenceLevel);
+	}
+
 	IOtimeInterval = getDbl("IOtimeInterval", NULL);
 	IOiterInterval = getDbl("IOiterInterval", NULL);
 	iVisuProg = getInt("outputFormat", "1");
+	if (iVisuProg == CGNS) {
+		initCGNSoutput();
+	}
+
+	isAsyncOutput = getBool("asyncOutput", "F");
+	if (isAsyncOutput) {
+		outputQueueSize = getInt("outputQueueSize", "2");
+		if (outputQueueSize < 1) {
+			printf("| ERROR: outputQueueSize must be at least 1\n");
+			exit(1);
+		}
+
+		outputQueue = calloc(outputQueueSize, sizeof(outputJob_t *));
+		if (!outputQueue) {
+			printf("| ERROR: could not allocate outputQueue\n");
+			exit(1);
+		}
+
+		pthread_mutex_init(&queueMutex, NULL);
+		pthread_cond_init(&jobAdded, NULL);
+		pthread_cond_init(&jobDone, NULL);
+		if (pthread_create(&writerThread, NULL, outputWriter, NULL)) {
+			printf("| ERROR: could not start the output thread\n");
+			exit(1);
+		}
+	}
 }
 
 /**
- * \brief Tabular CSV output, only for 1D data
- * \param[in] fileName The name of the output file
+ * \brief Collect the flow solution of all elements in the order of the mesh
+ *	file
+ *
+ * Every row holds the coordinates of the barycenter, followed by the
+ * primitive variables. With domain decomposition the rows of all partitions
+ * are gathered on the root, all other partitions receive NULL.
  * \param[in] time The computational time of the output result
- * \param[in] doExact If the exact exact solution should be written, instead
+ * \param[in] doExact If the exact exact solution should be collected, instead
  *	of the computed flow results
+ * \return `nElemsGlobal`x`NDIM + NVAR` array of the flow solution
  */
-void csvOutput(char fileName[STRLEN], double time, bool doExact)
+double **gatherFlowData(double time, bool doExact)
 {
-	/* prepare data (only for equidistant grids) */
-	double **flowData = dyn2DdblArray(nElems, NVAR);
-	if (doExact) {
-		long iElem = 0;
-		elem_t *aElem = firstElem;
+	double **flowData = dyn2DdblArray(nElems, NDIM + NVAR);
+	long *fileId = dyn1DintArray(nElems);
+
+	long iElem = 0;
+	elem_t *aElem = firstElem;
+	while (aElem) {
 		double pVar[NVAR];
-		while (aElem) {
+		if (doExact) {
 			exactFunc(intExactFunc, aElem->bary, time, pVar);
-			flowData[iElem][0] = aElem->bary[X];
-			flowData[iElem][1] = pVar[RHO];
-			flowData[iElem][2] = pVar[VX];
-			flowData[iElem][3] = pVar[P];
-			iElem++;
-			aElem = aElem->next;
+		} else {
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				pVar[iVar] = elemData.pVar[iVar][aElem->id];
+			}
 		}
-	} else {
-		long iElem = 0;
-		elem_t *aElem = firstElem;
-		while (aElem) {
-			flowData[iElem][0] = aElem->bary[X];
-			flowData[iElem][1] = aElem->pVar[RHO];
-			flowData[iElem][2] = aElem->pVar[VX];
-			flowData[iElem][3] = aElem->pVar[P];
-			iElem++;
-			aElem = aElem->next;
+
+		flowData[iElem][X] = aElem->bary[X];
+		flowData[iElem][Y] = aElem->bary[Y];
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			flowData[iElem][NDIM + iVar] = pVar[iVar];
 		}
+
+		fileId[iElem] = aElem->fileId;
+		iElem++;
+		aElem = aElem->next;
 	}
 
-	/* sort array */
-	long n = nElems;
+	long nRows;
+	double **allData = gatherRows(flowData, nElems, NDIM + NVAR, fileId, &nRows);
+	free(flowData);
+	free(fileId);
+
+	return allData;
+}
+
+/**
+ * \brief Sort the rows of the flow solution by their x-coordinate
+ * \param[in,out] flowData Flow solution as collected by `gatherFlowData`
+ */
+void sortFlowData(double **flowData)
+{
+	long n = nElemsGlobal;
 	bool isSwapped = true;
-	double tmp[NVAR];
+	double tmp[NDIM + NVAR];
 	while (isSwapped && (n > 0)) {
 		isSwapped = false;
 		for (long iElem = 0; iElem < n - 1; ++iElem) {
-			if (flowData[iElem][0] > flowData[iElem + 1][0]) {
-				memcpy(tmp, flowData[iElem + 1], NVAR * sizeof(double));
-				memcpy(flowData[iElem + 1], flowData[iElem], NVAR * sizeof(double));
-				memcpy(flowData[iElem], tmp, NVAR * sizeof(double));
+			if (flowData[iElem][X] > flowData[iElem + 1][X]) {
+				memcpy(tmp, flowData[iElem + 1], (NDIM + NVAR) * sizeof(double));
+				memcpy(flowData[iElem + 1], flowData[iElem], (NDIM + NVAR) * sizeof(double));
+				memcpy(flowData[iElem], tmp, (NDIM + NVAR) * sizeof(double));
 				isSwapped = true;
 			}
 		}
 		n--;
 	}
+}
+
+/**
+ * \brief Tabular CSV output, only for 1D data
+ * \param[in] job The flow solution and the name of the output file
+ */
+void csvOutput(outputJob_t *job)
+{
+	/* prepare data (only for equidistant grids) */
+	double **flowData = job->flowData;
+	sortFlowData(flowData);
 
 	/* write data */
-	FILE *csvFile = fopen(fileName, "w");
+	FILE *csvFile = fopen(job->fileName, "w");
 	fprintf(csvFile, "CoordinateX, Density, Velocity, Pressure\n");
-	for (long iElem = 0; iElem < nElems; ++iElem) {
-		fprintf(csvFile, "%15.9f,%15.9f,%15.9f,%15.9f\n", flowData[iElem][0],
-			flowData[iElem][1], flowData[iElem][2], flowData[iElem][3]);
+	for (long iElem = 0; iElem < nElemsGlobal; ++iElem) {
+		fprintf(csvFile, "%15.9f,%15.9f,%15.9f,%15.9f\n", flowData[iElem][X],
+			flowData[iElem][NDIM + RHO], flowData[iElem][NDIM + VX],
+			flowData[iElem][NDIM + P]);
 	}
 	fclose(csvFile);
-
-	free(flowData);
 }
 
 /**
- * \brief Write solution to CGNS file
- * \param[in] fileName The name of the output file
- * \param[in] time The computational time of the output result
- * \param[in] doExact If the exact exact solution should be written, instead
- *	of the computed flow results
+ * \brief Create the base and the zone of a CGNS solution file, the vertices
+ *	and the connectivity are linked from the CGNS grid file
+ * \param[in] indexFile Index of the opened CGNS file
+ * \param[out] indexBase Index of the created base
+ * \param[out] indexZone Index of the created zone
  */
-void cgnsOutput(char fileName[STRLEN], double time, bool doExact)
+void cgnsWriteZone(int indexFile, int *indexBase, int *indexZone)
 {
-	/* open solution file */
-	int indexFile, indexBase, indexZone, indexSolution, indexField;
-	if (cg_open(fileName, CG_MODE_WRITE, &indexFile))
-		cg_error_exit();
-
 	/* set up data for CGNS */
-	cgsize_t iSize[3] = {nNodes, nElems, 0};
+	cgsize_t iSize[3] = {nNodes, nElemsGlobal, 0};
 
 	/* create base */
-	if (cg_base_write(indexFile, "Base", 2, 3, &indexBase))
+	if (cg_base_write(indexFile, "Base", 2, 3, indexBase))
 		cg_error_exit();
 
 	/* create zone */
-	if (cg_zone_write(indexFile, indexBase, "Zone", iSize, Unstructured,
-				&indexZone))
+	if (cg_zone_write(indexFile, *indexBase, "Zone", iSize, Unstructured,
+				indexZone))
 		cg_error_exit();
 
 	/* link vertices and connectivity from the CGNS grid file */
-	if (cg_goto(indexFile, indexBase, "Zone_t", indexZone, "end"))
+	if (cg_goto(indexFile, *indexBase, "Zone_t", *indexZone, "end"))
 		cg_error_exit();
 
 	if (cg_link_write("GridCoordinates", gridFile, "/Base/Zone/GridCoordinates"))
@@ -154,176 +333,427 @@ void cgnsOutput(char fileName[STRLEN], double time, bool doExact)
 		if (cg_link_write("Quadrilaterals", gridFile, "/Base/Zone/Quadrilaterals"))
 			cg_error_exit();
 	}
+}
 
-	/* create new solution zone */
-	if (cg_sol_write(indexFile, indexBase, indexZone, "FlowSolution",
+/**
+ * \brief Write the selected fields of a flow solution into a new solution
+ *	node of a CGNS file
+ * \param[in] indexFile Index of the opened CGNS file
+ * \param[in] indexBase Index of the base
+ * \param[in] indexZone Index of the zone
+ * \param[in] solutionName Name of the solution node
+ * \param[in] flowData Flow solution, as collected by `gatherFlowData`
+ */
+void cgnsWriteFields(int indexFile, int indexBase, int indexZone,
+		const char *solutionName, double **flowData)
+{
+	int indexSolution, indexField;
+	if (cg_sol_write(indexFile, indexBase, indexZone, solutionName,
 				CellCenter, &indexSolution))
 		cg_error_exit();
 
-	/* prepare density array, x-velocity array, y-velocity array, and
-	 * pressure array */
-	double *rhoArr = malloc(nElems * sizeof(double));
-	double *vxArr  = malloc(nElems * sizeof(double));
-	double *vyArr  = malloc(nElems * sizeof(double));
-	double *vzArr  = malloc(nElems * sizeof(double));
-	double *pArr   = malloc(nElems * sizeof(double));
-
+	/* the fields are converted to a CGNS compatible format one by one */
+	double *dblArr = NULL;
+	float *fltArr = NULL;
+	if (isSinglePrecision) {
+		fltArr = malloc(nElemsGlobal * sizeof(float));
+	} else {
+		dblArr = malloc(nElemsGlobal * sizeof(double));
+	}
 
-	/* save solution in a CGNS compatible format */
-	if (doExact) {
-		elem_t *aElem = firstElem;
+	if ((!dblArr) && (!fltArr)) {
+		printf("| ERROR: could not allocate field array\n");
+		exit(1);
+	}
 
-		while (aElem) {
-			double pVar[NVAR];
-			exactFunc(intExactFunc, aElem->bary, time, pVar);
+	for (int iField = 0; iField < N_FIELDS; ++iField) {
+		if (!isOutputField[iField]) {
+			continue;
+		}
 
-			rhoArr[aElem->id] = pVar[RHO];
-			vxArr[aElem->id]  = pVar[VX];
-			vyArr[aElem->id]  = pVar[VY];
-			vzArr[aElem->id]  = 0.0;
-			pArr[aElem->id]   = pVar[P];
+		int iCol = fieldColumns[iField];
+		for (long iElem = 0; iElem < nElemsGlobal; ++iElem) {
+			double value = (iCol >= 0 ? flowData[iElem][iCol] : 0.0);
+			if (isSinglePrecision) {
+				fltArr[iElem] = value;
+			} else {
+				dblArr[iElem] = value;
+			}
+		}
 
-			aElem = aElem->next;
+		if (isSinglePrecision) {
+			if (cg_field_write(indexFile, indexBase, indexZone,
+						indexSolution, RealSingle,
+						fieldNames[iField], fltArr,
+						&indexField))
+				cg_error_exit();
+		} else {
+			if (cg_field_write(indexFile, indexBase, indexZone,
+						indexSolution, RealDouble,
+						fieldNames[iField], dblArr,
+						&indexField))
+				cg_error_exit();
 		}
+	}
+
+	free(dblArr);
+	free(fltArr);
+}
+
+/**
+ * \brief Write the convergence information of a solution into the base of a
+ *	CGNS file, used at restart
+ * \param[in] indexFile Index of the opened CGNS file
+ * \param[in] indexBase Index of the base
+ * \param[in] job The flow solution
+ */
+void cgnsWriteConvergenceInfo(int indexFile, int indexBase, outputJob_t *job)
+{
+	if (cg_goto(indexFile, indexBase, "end"))
+		cg_error_exit();
+
+	char text[STRLEN];
+	sprintf(text, "%20.12f %20.12f", job->time, job->timeOverall);
+
+	if (cg_descriptor_write("ConvergenceInfo", text))
+		cg_error_exit();
+}
+
+/**
+ * \brief Name of the CGNS solution node of an output time, named after the
+ *	iteration for stationary and after the time for unsteady calculations,
+ *	which restart with iteration zero
+ * \param[out] name The name of the solution node
+ * \param[in] prefix The prefix of the name
+ * \param[in] outputTime The output time
+ */
+void cgnsSolutionName(char name[32], const char *prefix, outputTime_t *outputTime)
+{
+	if (isStationary) {
+		sprintf(name, "%s%09ld", prefix, outputTime->iter);
 	} else {
-		elem_t *aElem = firstElem;
+		sprintf(name, "%s%015.7f", prefix, outputTime->time);
+	}
+}
 
-		while (aElem) {
+/**
+ * \brief Write the iterative data of a CGNS file, that tells ParaView about
+ *	time series of the flow solutions
+ * \param[in] indexFile Index of the opened CGNS file
+ * \param[in] indexBase Index of the base
+ * \param[in] indexZone Index of the zone
+ * \param[in] firstOutputTime The latest output time
+ */
+void cgnsWriteIterativeData(int indexFile, int indexBase, int indexZone,
+		outputTime_t *firstOutputTime)
+{
+	/* count number of data outputs */
+	cgsize_t nOutputs = 0;
+	outputTime_t *outputTime = firstOutputTime;
+	while (outputTime) {
+		nOutputs++;
+		outputTime = outputTime->next;
+	}
 
-			rhoArr[aElem->id] = aElem->pVar[RHO];
-			vxArr[aElem->id]  = aElem->pVar[VX];
-			vyArr[aElem->id]  = aElem->pVar[VY];
-			vzArr[aElem->id]  = 0.0;
-			pArr[aElem->id]   = aElem->pVar[P];
+	/* allocate and fill arrays */
+	double times[nOutputs];
+	long iters[nOutputs];
+	char solutionNames[nOutputs][32];
 
-			aElem = aElem->next;
-		}
+	long iOutput = nOutputs;
+	outputTime = firstOutputTime;
+	while (outputTime) {
+		iOutput--;
+		times[iOutput] = outputTime->time;
+		iters[iOutput] = outputTime->iter;
+		cgnsSolutionName(solutionNames[iOutput], "FlowSolution", outputTime);
+		outputTime = outputTime->next;
 	}
 
-	/* write solution to CGNS file */
-	if (cg_field_write(indexFile, indexBase, indexZone, indexSolution,
-				RealDouble, "Density", rhoArr, &indexField))
+	/* crete BaseIter node */
+	if (cg_biter_write(indexFile, indexBase, "TimeIterValues", nOutputs))
 		cg_error_exit();
 
-	if (cg_field_write(indexFile, indexBase, indexZone, indexSolution,
-				RealDouble, "VelocityX", vxArr, &indexField))
+	if (cg_goto(indexFile, indexBase, "BaseIterativeData_t", 1, "end"))
 		cg_error_exit();
 
-	if (cg_field_write(indexFile, indexBase, indexZone, indexSolution,
-				RealDouble, "VelocityY", vyArr, &indexField))
+	cgsize_t tmp1[1] = {nOutputs};
+	if (cg_array_write("TimeValues", RealDouble, 1, tmp1, times))
 		cg_error_exit();
 
-	if (cg_field_write(indexFile, indexBase, indexZone, indexSolution,
-				RealDouble, "VelocityZ", vzArr, &indexField))
+	if (cg_array_write("IterationValues", Integer, 1, tmp1, iters))
 		cg_error_exit();
 
-	if (cg_field_write(indexFile, indexBase, indexZone, indexSolution,
-				RealDouble, "Pressure", pArr, &indexField))
+	/* create ZoneIter node */
+	if (cg_ziter_write(indexFile, indexBase, indexZone, "ZoneIterativeData"))
 		cg_error_exit();
 
-	/* write convergence information */
-	if (cg_goto(indexFile, indexBase, "end"))
+	if (cg_goto(indexFile, indexBase, "Zone_t", indexZone, "ZoneIterativeData_t",
+				1, "end"))
 		cg_error_exit();
 
-	char text[STRLEN];
-	sprintf(text, "%20.12f %20.12f", time, timeOverall);
+	cgsize_t tmp2[2] = {32, nOutputs};
+	if (cg_array_write("FlowSolutionPointers", Character, 2, tmp2, solutionNames))
+		cg_error_exit();
+}
 
-	if (cg_descriptor_write("ConvergenceInfo", text))
+/**
+ * \brief Write solution to CGNS file
+ * \param[in] job The flow solution and the name of the output file
+ */
+void cgnsOutput(outputJob_t *job)
+{
+	/* open solution file */
+	int indexFile, indexBase, indexZone;
+	if (cg_open(job->fileName, CG_MODE_WRITE, &indexFile))
 		cg_error_exit();
 
+	cgnsWriteZone(indexFile, &indexBase, &indexZone);
+	cgnsWriteFields(indexFile, indexBase, indexZone, "FlowSolution",
+			job->flowData);
+	cgnsWriteConvergenceInfo(indexFile, indexBase, job);
+
 	/* close file */
 	if (cg_close(indexFile))
 		cg_error_exit();
-
-	/* deallocate memory */
-	free(rhoArr);
-	free(vxArr);
-	free(vyArr);
-	free(vzArr);
-	free(pArr);
 }
 
 /**
- * \brief Curve data output, only for 1D data
- * \param[in] fileName The name of the output file
- * \param[in] time The computational time of the output result
- * \param[in] doExact If the exact exact solution should be written, instead
- *	of the computed flow results
+ * \brief Append a solution to the CGNS time series file
+ *
+ * The file is created with the first solution, every following solution is
+ * added as another `FlowSolution_t` node of the zone. The iterative data are
+ * rewritten with every flow solution, so the file is complete after each
+ * output. They only list the solutions of the current calculation, after a
+ * restart the earlier solutions are kept, but no longer listed.
+ * \param[in] job The flow solution and the name of its solution node
  */
-void curveOutput(char fileName[STRLEN], double time, bool doExact)
+void cgnsSeriesOutput(outputJob_t *job)
 {
-	/* prepare data */
-	double **flowData = dyn2DdblArray(nElems, NVAR);
-	if (doExact) {
-		long iElem = 0;
-		elem_t *aElem = firstElem;
-		while (aElem) {
-			double pVar[NVAR];
-			exactFunc(intExactFunc, aElem->bary, time, pVar);
-
-			flowData[iElem][0] = aElem->bary[X];
-			flowData[iElem][1] = pVar[RHO];
-			flowData[iElem][2] = pVar[VX];
-			flowData[iElem][3] = pVar[P];
-
-			iElem++;
-			aElem = aElem->next;
+	/* a restarted calculation continues the existing file, unless its mesh
+	 * has changed */
+	if ((!isSeriesCreated) && isRestart && (!isMappedRestart)) {
+		FILE *file = fopen(seriesFile, "r");
+		if (file) {
+			fclose(file);
+			isSeriesCreated = true;
 		}
+	}
+
+	int indexFile, indexBase = 1, indexZone = 1;
+	if (isSeriesCreated) {
+		if (cg_open(seriesFile, CG_MODE_MODIFY, &indexFile))
+			cg_error_exit();
 	} else {
-		long iElem = 0;
-		elem_t *aElem = firstElem;
-		while (aElem) {
-			flowData[iElem][0] = aElem->bary[X];
-			flowData[iElem][1] = aElem->pVar[RHO];
-			flowData[iElem][2] = aElem->pVar[VX];
-			flowData[iElem][3] = aElem->pVar[P];
-
-			iElem++;
-			aElem = aElem->next;
-		}
+		if (cg_open(seriesFile, CG_MODE_WRITE, &indexFile))
+			cg_error_exit();
+
+		cgnsWriteZone(indexFile, &indexBase, &indexZone);
+		isSeriesCreated = true;
 	}
 
-	/* sort array */
-	long n = nElems;
-	bool isSwapped = true;
-	double tmp[NVAR];
-	while (isSwapped && (n > 0)) {
-		isSwapped = false;
-		for (long iElem = 0; iElem < n - 1; ++iElem) {
-			if (flowData[iElem][0] > flowData[iElem + 1][0]) {
-				memcpy(tmp, flowData[iElem + 1], NVAR * sizeof(double));
-				memcpy(flowData[iElem + 1], flowData[iElem], NVAR * sizeof(double));
-				memcpy(flowData[iElem], tmp, NVAR * sizeof(double));
-				isSwapped = true;
-			}
-		}
-		n--;
+	cgnsWriteFields(indexFile, indexBase, indexZone, job->solutionName,
+			job->flowData);
+
+	/* exact solutions are not part of the time series */
+	if (job->outputTimes) {
+		cgnsWriteConvergenceInfo(indexFile, indexBase, job);
+		cgnsWriteIterativeData(indexFile, indexBase, indexZone,
+				job->outputTimes);
 	}
 
+	if (cg_close(indexFile))
+		cg_error_exit();
+}
+
+/**
+ * \brief Curve data output, only for 1D data
+ * \param[in] job The flow solution and the name of the output file
+ */
+void curveOutput(outputJob_t *job)
+{
+	/* prepare data */
+	double **flowData = job->flowData;
+	sortFlowData(flowData);
+
 	/* write data */
-	FILE *curveFile = fopen(fileName, "w");
+	FILE *curveFile = fopen(job->fileName, "w");
 
 	fprintf(curveFile, "#Density\n");
-	for (long iElem = 0; iElem < nElems; ++iElem) {
-		fprintf(curveFile, "%15.9f,%15.9f\n", flowData[iElem][0],
-				flowData[iElem][1]);
+	for (long iElem = 0; iElem < nElemsGlobal; ++iElem) {
+		fprintf(curveFile, "%15.9f,%15.9f\n", flowData[iElem][X],
+				flowData[iElem][NDIM + RHO]);
 	}
 
 	fprintf(curveFile, "\n#Velocity\n");
-	for (long iElem = 0; iElem < nElems; ++iElem) {
-		fprintf(curveFile, "%15.9f,%15.9f\n", flowData[iElem][0],
-				flowData[iElem][2]);
+	for (long iElem = 0; iElem < nElemsGlobal; ++iElem) {
+		fprintf(curveFile, "%15.9f,%15.9f\n", flowData[iElem][X],
+				flowData[iElem][NDIM + VX]);
 	}
 
 	fprintf(curveFile, "\n#Pressure\n");
-	for (long iElem = 0; iElem < nElems; ++iElem) {
-		fprintf(curveFile, "%15.9f,%15.9f\n", flowData[iElem][0],
-				flowData[iElem][3]);
+	for (long iElem = 0; iElem < nElemsGlobal; ++iElem) {
+		fprintf(curveFile, "%15.9f,%15.9f\n", flowData[iElem][X],
+				flowData[iElem][NDIM + P]);
 	}
 
 	fclose(curveFile);
+}
 
-	free(flowData);
+/**
+ * \brief Write a gathered flow solution to its file, dependent on the output
+ *	format
+ * \param[in] job The flow solution and the name of the output file, both are
+ *	freed afterwards
+ */
+void writeOutputJob(outputJob_t *job)
+{
+	if (!job->flowData) {
+		cgnsFinalizeOutput(job->outputTimes);
+		free(job);
+		return;
+	}
+
+	switch (iVisuProg) {
+	case CGNS:
+		if (isSeriesOutput) {
+			cgnsSeriesOutput(job);
+		} else {
+			cgnsOutput(job);
+		}
+		break;
+	case CURVE:
+		curveOutput(job);
+		break;
+	case CSV:
+		csvOutput(job);
+		break;
+	default:
+		printf("| ERROR: Output Format unknown\n");
+		exit(1);
+	}
+
+	free(job->flowData);
+	free(job);
+}
+
+/**
+ * \brief Main routine of the writer thread, writes the queued solutions in
+ *	order until it is stopped
+ * \param[in] arg Unused
+ * \return NULL
+ */
+void *outputWriter(void *arg)
+{
+	(void)arg;
+
+	pthread_mutex_lock(&queueMutex);
+	while (true) {
+		while ((nQueued == 0) && (!doStopWriter)) {
+			pthread_cond_wait(&jobAdded, &queueMutex);
+		}
+
+		if (nQueued == 0) {
+			break;
+		}
+
+		/* the solution stays in the queue, until it is written */
+		outputJob_t *job = outputQueue[queueHead];
+		pthread_mutex_unlock(&queueMutex);
+
+		writeOutputJob(job);
+
+		pthread_mutex_lock(&queueMutex);
+		queueHead = (queueHead + 1) % outputQueueSize;
+		nQueued--;
+		pthread_cond_signal(&jobDone);
+	}
+	pthread_mutex_unlock(&queueMutex);
+
+	return NULL;
+}
+
+/**
+ * \brief Hand a gathered flow solution to the writer thread, waits only if
+ *	the queue is full
+ * \param[in] job The flow solution and the name of the output file
+ */
+void queueOutputJob(outputJob_t *job)
+{
+	double tic = CPU_TIME();
+	pthread_mutex_lock(&queueMutex);
+	while (nQueued == outputQueueSize) {
+		pthread_cond_wait(&jobDone, &queueMutex);
+	}
+
+	outputQueue[(queueHead + nQueued) % outputQueueSize] = job;
+	nQueued++;
+	pthread_cond_signal(&jobAdded);
+	pthread_mutex_unlock(&queueMutex);
+	tOutputWait += CPU_TIME() - tic;
+}
+
+/**
+ * \brief Write all pending solutions and terminate the writer thread, all
+ *	following outputs are written directly
+ */
+void stopOutputWriter(void)
+{
+	pthread_mutex_lock(&queueMutex);
+	doStopWriter = true;
+	pthread_cond_signal(&jobAdded);
+	pthread_mutex_unlock(&queueMutex);
+
+	double tic = CPU_TIME();
+	pthread_join(writerThread, NULL);
+	tOutputWait += CPU_TIME() - tic;
+
+	pthread_mutex_destroy(&queueMutex);
+	pthread_cond_destroy(&jobAdded);
+	pthread_cond_destroy(&jobDone);
+	free(outputQueue);
+	isAsyncOutput = false;
+
+	printf("| Asynchronous Output: waited %.6g s for the writer\n", tOutputWait);
+}
+
+/**
+ * \brief Gather the flow solution and write it, or queue it for the writer
+ *	thread
+ * \param[in] fileName The name of the output file
+ * \param[in] solutionName The name of the solution node in the CGNS time
+ *	series file
+ * \param[in] time The computational time of the output result
+ * \param[in] doExact If the exact exact solution should be written, instead
+ *	of the computed flow results
+ */
+void flowOutput(char fileName[2 * STRLEN], const char *solutionName,
+		double time, bool doExact)
+{
+	/* the root writes the solution of all partitions */
+	double **flowData = gatherFlowData(time, doExact);
+	if (!flowData) {
+		return;
+	}
+
+	outputJob_t *job = malloc(sizeof(outputJob_t));
+	if (!job) {
+		printf("| ERROR: could not allocate job\n");
+		exit(1);
+	}
+
+	strcpy(job->fileName, fileName);
+	strcpy(job->solutionName, solutionName);
+	job->time = time;
+	job->timeOverall = timeOverall;
+	job->flowData = flowData;
+	job->outputTimes = (doExact ? NULL : outputTimes);
+
+	if (isAsyncOutput) {
+		queueOutputJob(job);
+	} else {
+		writeOutputJob(job);
+	}
 }
 
 /**
@@ -333,6 +763,10 @@ void curveOutput(char fileName[STRLEN], double time, bool doExact)
  */
 void dataOutput(double time, long iter)
 {
+	deviceToHost();
+
+	double tic = CPU_TIME();
+
 	/* output times */
 	outputTime_t *outputTime = calloc(1, sizeof(outputTime_t));
 	if (!outputTime) {
@@ -345,31 +779,48 @@ void dataOutput(double time, long iter)
 	outputTime->next = outputTimes;
 	outputTimes = outputTime;
 
-	/* write flow solution */
-	char fileName[2 * STRLEN];
-	if (isStationary) {
-		sprintf(fileName, "%s_%09ld", strOutFile, iter);
-	} else {
-		sprintf(fileName, "%s_%015.7f", strOutFile, time);
-	}
+	/* file extension */
+	char *extension = NULL;
 	switch (iVisuProg) {
 	case CGNS:
-		strcat(fileName, ".cgns");
-		cgnsOutput(fileName, time, false);
+		extension = ".cgns";
 		break;
 	case CURVE:
-		strcat(fileName, ".curve");
-		curveOutput(fileName, time, false);
+		extension = ".curve";
 		break;
 	case CSV:
-		strcat(fileName, ".csv");
-		csvOutput(fileName, time, false);
+		extension = ".csv";
 		break;
 	default:
 		printf("| ERROR: Output Format unknown\n");
 		exit(1);
 	}
 
+	/* an adapted mesh is written with the first solution on it */
+	if ((iVisuProg == CGNS) && isGridFileOutdated) {
+		char suffix[32];
+		sprintf(suffix, "_mesh_%09ld.cgns", iter);
+		strcat(strcpy(gridFile, strOutFile), suffix);
+		cgnsWriteMesh();
+		isGridFileOutdated = false;
+	}
+
+	/* write flow solution */
+	char fileName[2 * STRLEN];
+	if (isStationary) {
+		sprintf(fileName, "%s_%09ld", strOutFile, iter);
+	} else {
+		sprintf(fileName, "%s_%015.7f", strOutFile, time);
+	}
+	strcat(fileName, extension);
+	if (iVisuProg == CGNS) {
+		strcpy(lastSolutionFile, (isSeriesOutput ? seriesFile : fileName));
+	}
+
+	char solutionName[32];
+	cgnsSolutionName(solutionName, "FlowSolution", outputTime);
+	flowOutput(fileName, solutionName, time, false);
+
 	/* write exact solution, if applicable */
 	if (hasExactSolution) {
 		if (isStationary) {
@@ -377,24 +828,20 @@ void dataOutput(double time, long iter)
 		} else {
 			sprintf(fileName, "%s_ex_%015.7f", strOutFile, time);
 		}
-		switch (iVisuProg) {
-		case CGNS:
-			strcat(fileName, ".cgns");
-			cgnsOutput(fileName, time, true);
-			break;
-		case CURVE:
-			strcat(fileName, ".curve");
-			curveOutput(fileName, time, true);
-			break;
-		case CSV:
-			strcat(fileName, ".csv");
-			csvOutput(fileName, time, true);
-			break;
-		default:
-			printf("| ERROR: Output Format unknown\n");
-			exit(1);
-		}
+		strcat(fileName, extension);
+
+		cgnsSolutionName(solutionName, "ExactSolution", outputTime);
+		flowOutput(fileName, solutionName, time, true);
+	}
+
+	/* pressure distribution of the wing, once the side states are known */
+	if (doCalcWing && (iter > iniIterationNumber)) {
+		cpOutput();
 	}
+	timerAdd(TIMER_OUTPUT, &tic);
+
+	/* in situ visualization of the same solution */
+	catalystOutput(time, iter);
 }
 
 /**
@@ -403,30 +850,13 @@ void dataOutput(double time, long iter)
  * This function creates a `<case>_Master.cgns` file that has links to all the
  * output times of previous flow solutions. This makes it easier to load an
  * entire case into ParaView.
+ * \param[in] firstOutputTime The latest output time, the output times are
+ *	only ever prepended, so that the list is not modified by later outputs
  */
-void cgnsFinalizeOutput(void)
+void cgnsFinalizeOutput(outputTime_t *firstOutputTime)
 {
-	/* count number of data outputs */
-	cgsize_t nOutputs = 0;
-	outputTime_t *outputTime = outputTimes;
-	while (outputTime) {
-		nOutputs++;
-		outputTime = outputTime->next;
-	}
-
-	/* allocate and fill arrays */
-	double times[nOutputs];
-	long iters[nOutputs];
-	char solutionNames[nOutputs][32];
-
-	long iOutput = nOutputs;
-	outputTime = outputTimes;
-	while (outputTime) {
-		iOutput--;
-		times[iOutput] = outputTime->time;
-		iters[iOutput] = outputTime->iter;
-		sprintf(solutionNames[iOutput], "FlowSolution%09ld", iters[iOutput]);
-		outputTime = outputTime->next;
+	if (mpiRank > 0) {
+		return;
 	}
 
 	int indexFile, indexBase, indexZone;
@@ -436,80 +866,32 @@ void cgnsFinalizeOutput(void)
 	if (cg_open(masterFileName, CG_MODE_WRITE, &indexFile))
 		cg_error_exit();
 
-	/* set up data for CGNS */
-	cgsize_t iSize[3] = {nNodes, nElems, 0};
-
-	/* create base */
-	if (cg_base_write(indexFile, "Base", 2, 3, &indexBase))
-		cg_error_exit();
-
-	/* create zone */
-	if (cg_zone_write(indexFile, indexBase, "Zone", iSize, Unstructured,
-				&indexZone))
-		cg_error_exit();
-
-	/* link vertices and connectivity from the CGNS grid file */
-	if (cg_goto(indexFile, indexBase, "Zone_t", indexZone, "end"))
-		cg_error_exit();
-
-	if (cg_link_write("GridCoordinates", gridFile, "/Base/Zone/GridCoordinates"))
-		cg_error_exit();
-
-	if (nTrias > 0) {
-		if (cg_link_write("Triangles", gridFile, "/Base/Zone/Triangles"))
-			cg_error_exit();
-	}
-
-	if (nQuads > 0) {
-		if (cg_link_write("Quadrilaterals", gridFile, "/Base/Zone/Quadrilaterals"))
-			cg_error_exit();
-	}
+	cgnsWriteZone(indexFile, &indexBase, &indexZone);
 
 	/* link solutions */
 	if (cg_goto(indexFile, indexBase, "Zone_t", indexZone, "end"))
 		cg_error_exit();
-	for (iOutput = 0; iOutput < nOutputs; iOutput++) {
-		char solutionFileName[2 * STRLEN];
+
+	outputTime_t *outputTime = firstOutputTime;
+	while (outputTime) {
+		char solutionName[32], solutionFileName[2 * STRLEN];
+		cgnsSolutionName(solutionName, "FlowSolution", outputTime);
 		if (isStationary) {
 			sprintf(solutionFileName, "%s_%09ld.cgns", strOutFile,
-					iters[iOutput]);
-			if (cg_link_write(solutionNames[iOutput], solutionFileName,
-					"/Base/Zone/FlowSolution"))
-				cg_error_exit();
+					outputTime->iter);
 		} else {
 			sprintf(solutionFileName, "%s_%015.7f.cgns", strOutFile,
-					times[iOutput]);
-			if (cg_link_write(solutionNames[iOutput], solutionFileName,
-					"/Base/Zone/FlowSolution"))
-				cg_error_exit();
+					outputTime->time);
 		}
-	}
-
-	/* crete BaseIter node */
-	if (cg_biter_write(indexFile, indexBase, "TimeIterValues", nOutputs))
-		cg_error_exit();
 
-	if (cg_goto(indexFile, indexBase, "BaseIterativeData_t", 1, "end"))
-		cg_error_exit();
-
-	cgsize_t tmp1[1] = {nOutputs};
-	if (cg_array_write("TimeValues", RealDouble, 1, tmp1, times))
-		cg_error_exit();
-
-	if (cg_array_write("IterationValues", Integer, 1, tmp1, iters))
-		cg_error_exit();
-
-	/* create ZoneIter node */
-	if (cg_ziter_write(indexFile, indexBase, indexZone, "ZoneIterativeData"))
-		cg_error_exit();
+		if (cg_link_write(solutionName, solutionFileName,
+				"/Base/Zone/FlowSolution"))
+			cg_error_exit();
 
-	if (cg_goto(indexFile, indexBase, "Zone_t", indexZone, "ZoneIterativeData_t",
-				1, "end"))
-		cg_error_exit();
+		outputTime = outputTime->next;
+	}
 
-	cgsize_t tmp2[2] = {32, nOutputs};
-	if (cg_array_write("FlowSolutionPointers", Character, 2, tmp2, solutionNames))
-		cg_error_exit();
+	cgnsWriteIterativeData(indexFile, indexBase, indexZone, firstOutputTime);
 
 	/* close file */
 	if (cg_close(indexFile))
@@ -518,11 +900,39 @@ void cgnsFinalizeOutput(void)
 
 /**
  * \brief Finalize the data output, if necessary
+ *
+ * With asynchronous output the CGNS master file is written by the writer
+ * thread as well, after all pending solutions.
  */
 void finalizeDataOutput(void)
 {
-	if (iVisuProg == CGNS) {
-		cgnsFinalizeOutput();
+	/* the time series file is complete after every output, the solutions
+	 * of an adapted mesh do not share one grid */
+	if ((iVisuProg != CGNS) || isSeriesOutput || useAdaptation) {
+		return;
+	}
+
+	if (isAsyncOutput && (mpiRank == 0)) {
+		outputJob_t *job = calloc(1, sizeof(outputJob_t));
+		if (!job) {
+			printf("| ERROR: could not allocate job\n");
+			exit(1);
+		}
+
+		job->outputTimes = outputTimes;
+		queueOutputJob(job);
+	} else {
+		cgnsFinalizeOutput(outputTimes);
+	}
+}
+
+/**
+ * \brief Wait for all pending asynchronous outputs to be written
+ */
+void closeDataOutput(void)
+{
+	if (isAsyncOutput) {
+		stopOutputWriter();
 	}
 }
 
@@ -532,7 +942,7 @@ void finalizeDataOutput(void)
 void cgnsWriteMesh(void)
 {
 	/* set up data */
-	cgsize_t iSize[3] = {nNodes, nElems, 0};
+	cgsize_t iSize[3] = {nNodes, nElemsGlobal, 0};
 
 	/* allocate element arrays */
 	cgsize_t **trias = dyn2DcgsizeArray(nTrias, 3);
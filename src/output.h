@@ -30,10 +30,15 @@ extern int iVisuProg;
 extern FILE *resFile;
 extern bool doErrorOutput;
 extern outputTime_t *outputTimes;
+extern bool isAsyncOutput;
+extern bool isSeriesOutput;
+extern bool isGridFileOutdated;
+extern char lastSolutionFile[2 * STRLEN];
 
 void initOutput(void);
 void dataOutput(double time, long iter);
 void finalizeDataOutput(void);
+void closeDataOutput(void);
 void cgnsWriteMesh(void);
 void freeOutputTimes(void);
 
@@ -0,0 +1,413 @@
+/** \file
+ *
+ * \brief Domain decomposition with MPI: halo exchange, global reductions and
+ *	gathering of distributed data
+ *
+ * Without `USE_MPI` all functions reduce to the serial case of a single
+ * partition, so the callers do not need to distinguish between the builds.
+ *
+ * \author hhh
+ * \date Wed 14 Oct 2026 06:02:17 PM CEST
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+
+#include "main.h"
+#include "parallel.h"
+#include "mesh.h"
+#include "memTools.h"
+
+#define MAX_HALO_ARRAYS 2	/**< number of arrays exchanged at once */
+
+/* extern variables */
+int mpiRank;				/**< rank of this process */
+int mpiSize;				/**< number of processes */
+
+/* local variables */
+int nNbRanks;				/**< number of neighbor partitions */
+int *nbRank;				/**< rank of each neighbor partition */
+long *recvOffset;			/**< first halo element of each neighbor */
+long *sendOffset;			/**< first entry of each neighbor in `sendElem` */
+long *sendElem;				/**< elements that are halo elements of
+						the neighbor partitions */
+double *sendBuf;			/**< buffer for the elements to send */
+double *recvBuf;			/**< buffer for the received halo elements */
+int nExchangeArrays;			/**< number of arrays of the pending exchange */
+double **exchangeArrays[MAX_HALO_ARRAYS];	/**< arrays of the pending exchange */
+#ifdef USE_MPI
+MPI_Request *requests;			/**< requests of the pending exchange */
+#endif
+
+/**
+ * \brief Initialize MPI and get the rank of this process
+ *
+ * The standard output of all ranks except the first one is discarded, since
+ * every rank runs through the same initialization and time stepping.
+ *
+ * \param[in] argc Pointer to the number of command line arguments
+ * \param[in] argv Pointer to the command line arguments
+ */
+void initParallel(int *argc, char ***argv)
+{
+#ifdef USE_MPI
+	/* MPI is only called by the master thread of the parallel regions */
+	int provided;
+	MPI_Init_thread(argc, argv, MPI_THREAD_FUNNELED, &provided);
+	if (provided < MPI_THREAD_FUNNELED) {
+		printf("| ERROR: MPI does not support MPI_THREAD_FUNNELED\n");
+		exit(1);
+	}
+	MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+	MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+
+	if (mpiRank > 0) {
+		if (!freopen("/dev/null", "w", stdout)) {
+			printf("| ERROR: could not redirect output of rank %d\n", mpiRank);
+			exit(1);
+		}
+	}
+#else
+	(void)argc;
+	(void)argv;
+	mpiRank = 0;
+	mpiSize = 1;
+#endif
+	nNbRanks = 0;
+}
+
+/**
+ * \brief Set up the communication pattern of the halo exchange
+ *
+ * The halo elements are numbered consecutively by the rank of their owner
+ * and by their global ID, the elements that are sent to a neighbor are
+ * sorted by their ID as well. Since the local IDs keep the global order,
+ * both sides agree on the order of the exchanged elements, without any
+ * communication.
+ *
+ * \param[in] nHalos Number of halo elements
+ * \param[in] haloRank Owner of each halo element
+ */
+void createHaloExchange(long nHalos, const int *haloRank)
+{
+	nNbRanks = 0;
+	for (long iHalo = 0; iHalo < nHalos; ++iHalo) {
+		if ((iHalo == 0) || (haloRank[iHalo] != haloRank[iHalo - 1])) {
+			nNbRanks++;
+		}
+	}
+
+	nbRank = calloc((nNbRanks > 0 ? nNbRanks : 1), sizeof(int));
+	int *haloNb = calloc((nHalos > 0 ? nHalos : 1), sizeof(int));
+	if ((!nbRank) || (!haloNb)) {
+		printf("| ERROR: could not allocate halo exchange\n");
+		exit(1);
+	}
+
+	recvOffset = dyn1DintArray(nNbRanks + 1);
+	int iNb = -1;
+	for (long iHalo = 0; iHalo < nHalos; ++iHalo) {
+		if ((iHalo == 0) || (haloRank[iHalo] != haloRank[iHalo - 1])) {
+			iNb++;
+			nbRank[iNb] = haloRank[iHalo];
+			recvOffset[iNb] = iHalo;
+		}
+		haloNb[iHalo] = iNb;
+	}
+	recvOffset[nNbRanks] = nHalos;
+
+	/* elements to send: the owned elements at the interface sides to
+	 * the halo elements of every neighbor */
+	long firstHalo = nElems + nBCsides;
+	long *mark = malloc((nElems > 0 ? nElems : 1) * sizeof(long));
+	if (!mark) {
+		printf("| ERROR: could not allocate mark\n");
+		exit(1);
+	}
+
+	sendOffset = dyn1DintArray(nNbRanks + 1);
+	sendElem = dyn1DintArray(nInterfaceSides);
+	long nSend = 0;
+	for (iNb = 0; iNb < nNbRanks; ++iNb) {
+		sendOffset[iNb] = nSend;
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			mark[iElem] = 0;
+		}
+
+		for (long iSide = nSides - nInterfaceSides; iSide < nSides; ++iSide) {
+			long iElem = side[iSide]->elem->id;
+			long iHalo = side[iSide]->connection->elem->id - firstHalo;
+			if ((haloNb[iHalo] == iNb) && (!mark[iElem])) {
+				mark[iElem] = 1;
+				nSend++;
+			}
+		}
+
+		/* counting sort by element ID */
+		long iSend = sendOffset[iNb];
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			if (mark[iElem]) {
+				sendElem[iSend++] = iElem;
+			}
+		}
+	}
+	sendOffset[nNbRanks] = nSend;
+
+	free(mark);
+	free(haloNb);
+
+	sendBuf = dyn1DdblArray(nSend * NVAR * MAX_HALO_ARRAYS);
+	recvBuf = dyn1DdblArray(nHalos * NVAR * MAX_HALO_ARRAYS);
+#ifdef USE_MPI
+	requests = malloc((nNbRanks > 0 ? 2 * nNbRanks : 1) * sizeof(MPI_Request));
+	if (!requests) {
+		printf("| ERROR: could not allocate requests\n");
+		exit(1);
+	}
+#endif
+
+	printf("| Partition %d: %ld elements, %ld halo elements, %d neighbors\n",
+			mpiRank, nElems, nHalos, nNbRanks);
+}
+
+/**
+ * \brief Start the non-blocking exchange of element arrays with the
+ *	neighbor partitions
+ *
+ * The owned values at the partition interfaces are sent, the values of the
+ * halo elements are received. The arrays must not be read at the halo
+ * elements, nor be written at the sent elements, until
+ * `finishHaloExchange` is called.
+ *
+ * \param[in] nArrays Number of arrays, at most `MAX_HALO_ARRAYS`
+ * \param[in,out] arrays Element arrays of size [NVAR][nElems + nBCsides +
+ *	nHaloElems]
+ */
+void startHaloExchange(int nArrays, double **arrays[])
+{
+	nExchangeArrays = nArrays;
+	for (int iArr = 0; iArr < nArrays; ++iArr) {
+		exchangeArrays[iArr] = arrays[iArr];
+	}
+
+#ifdef USE_MPI
+	int nVal = NVAR * nArrays;
+	for (int iNb = 0; iNb < nNbRanks; ++iNb) {
+		long nRecv = recvOffset[iNb + 1] - recvOffset[iNb];
+		MPI_Irecv(recvBuf + recvOffset[iNb] * nVal, nRecv * nVal, MPI_DOUBLE,
+				nbRank[iNb], 0, MPI_COMM_WORLD, &requests[iNb]);
+	}
+
+	for (int iNb = 0; iNb < nNbRanks; ++iNb) {
+		long nSend = sendOffset[iNb + 1] - sendOffset[iNb];
+		double *buf = sendBuf + sendOffset[iNb] * nVal;
+		for (int iArr = 0; iArr < nArrays; ++iArr) {
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				double *val = buf + (iArr * NVAR + iVar) * nSend;
+				for (long i = 0; i < nSend; ++i) {
+					val[i] = arrays[iArr][iVar][sendElem[sendOffset[iNb] + i]];
+				}
+			}
+		}
+
+		MPI_Isend(buf, nSend * nVal, MPI_DOUBLE, nbRank[iNb], 0,
+				MPI_COMM_WORLD, &requests[nNbRanks + iNb]);
+	}
+#endif
+}
+
+/**
+ * \brief Wait for the pending halo exchange and store the halo values
+ */
+void finishHaloExchange(void)
+{
+#ifdef USE_MPI
+	MPI_Waitall(2 * nNbRanks, requests, MPI_STATUSES_IGNORE);
+
+	int nVal = NVAR * nExchangeArrays;
+	long firstHalo = nElems + nBCsides;
+	for (int iNb = 0; iNb < nNbRanks; ++iNb) {
+		long nRecv = recvOffset[iNb + 1] - recvOffset[iNb];
+		double *buf = recvBuf + recvOffset[iNb] * nVal;
+		for (int iArr = 0; iArr < nExchangeArrays; ++iArr) {
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				double *val = buf + (iArr * NVAR + iVar) * nRecv;
+				double *halo = exchangeArrays[iArr][iVar] + firstHalo + recvOffset[iNb];
+				for (long i = 0; i < nRecv; ++i) {
+					halo[i] = val[i];
+				}
+			}
+		}
+	}
+#endif
+	nExchangeArrays = 0;
+}
+
+/**
+ * \brief Sum of values over all partitions
+ * \param[in,out] val Local values, overwritten with the global sums
+ * \param[in] n Number of values
+ */
+void globalSum(double *val, int n)
+{
+#ifdef USE_MPI
+	if (mpiSize > 1) {
+		MPI_Allreduce(MPI_IN_PLACE, val, n, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+	}
+#else
+	(void)val;
+	(void)n;
+#endif
+}
+
+/**
+ * \brief Minimum of values over all partitions
+ * \param[in,out] val Local values, overwritten with the global minima
+ * \param[in] n Number of values
+ */
+void globalMin(double *val, int n)
+{
+#ifdef USE_MPI
+	if (mpiSize > 1) {
+		MPI_Allreduce(MPI_IN_PLACE, val, n, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+	}
+#else
+	(void)val;
+	(void)n;
+#endif
+}
+
+/**
+ * \brief Maximum of values over all partitions
+ * \param[in,out] val Local values, overwritten with the global maxima
+ * \param[in] n Number of values
+ */
+void globalMax(double *val, int n)
+{
+#ifdef USE_MPI
+	if (mpiSize > 1) {
+		MPI_Allreduce(MPI_IN_PLACE, val, n, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+	}
+#else
+	(void)val;
+	(void)n;
+#endif
+}
+
+/**
+ * \brief Gather the rows of a distributed 2D array on the first rank
+ *
+ * Without positions the rows are concatenated in the order of the ranks,
+ * otherwise every row is stored at its global position.
+ *
+ * \param[in] data Local rows [nRows][nCols], allocated by `dyn2DdblArray`
+ * \param[in] nRows Number of local rows
+ * \param[in] nCols Number of columns
+ * \param[in] pos Global position of every local row, or NULL
+ * \param[out] nRowsGlobal Number of gathered rows
+ * \return Gathered rows on the first rank, NULL on all other ranks
+ */
+double **gatherRows(double **data, long nRows, int nCols, const long *pos,
+		long *nRowsGlobal)
+{
+	double *local = (double *)(data + nRows);
+	double **all;
+	long *allPos = NULL;
+
+#ifdef USE_MPI
+	int count = nRows * nCols;
+	int *counts = NULL, *displs = NULL;
+	if (mpiRank == 0) {
+		counts = malloc(mpiSize * sizeof(int));
+		displs = malloc(mpiSize * sizeof(int));
+		if ((!counts) || (!displs)) {
+			printf("| ERROR: could not allocate counts\n");
+			exit(1);
+		}
+	}
+
+	MPI_Gather(&count, 1, MPI_INT, counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+	*nRowsGlobal = 0;
+	if (mpiRank == 0) {
+		displs[0] = 0;
+		for (int iRank = 1; iRank < mpiSize; ++iRank) {
+			displs[iRank] = displs[iRank - 1] + counts[iRank - 1];
+		}
+		*nRowsGlobal = (displs[mpiSize - 1] + counts[mpiSize - 1]) / nCols;
+	}
+
+	all = dyn2DdblArray(*nRowsGlobal, nCols);
+	MPI_Gatherv(local, count, MPI_DOUBLE, (double *)(all + *nRowsGlobal),
+			counts, displs, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+	if (pos) {
+		allPos = dyn1DintArray(*nRowsGlobal);
+		if (mpiRank == 0) {
+			for (int iRank = 0; iRank < mpiSize; ++iRank) {
+				counts[iRank] /= nCols;
+				displs[iRank] /= nCols;
+			}
+		}
+		MPI_Gatherv(pos, nRows, MPI_LONG, allPos, counts, displs,
+				MPI_LONG, 0, MPI_COMM_WORLD);
+	}
+
+	free(counts);
+	free(displs);
+
+	if (mpiRank > 0) {
+		free(all);
+		free(allPos);
+		return NULL;
+	}
+#else
+	*nRowsGlobal = nRows;
+	all = dyn2DdblArray(nRows, nCols);
+	memcpy(all + nRows, local, nRows * nCols * sizeof(double));
+	if (pos) {
+		allPos = dyn1DintArray(nRows);
+		memcpy(allPos, pos, nRows * sizeof(long));
+	}
+#endif
+
+	if (!pos) {
+		return all;
+	}
+
+	/* sort the rows by their global position */
+	double **sorted = dyn2DdblArray(*nRowsGlobal, nCols);
+	for (long iRow = 0; iRow < *nRowsGlobal; ++iRow) {
+		memcpy(sorted[allPos[iRow]], all[iRow], nCols * sizeof(double));
+	}
+
+	free(all);
+	free(allPos);
+	return sorted;
+}
+
+/**
+ * \brief Free the halo exchange and finalize MPI
+ */
+void freeParallel(void)
+{
+	if (sendOffset) {
+		free(nbRank);
+		free(recvOffset);
+		free(sendOffset);
+		free(sendElem);
+		free(sendBuf);
+		free(recvBuf);
+#ifdef USE_MPI
+		free(requests);
+#endif
+	}
+
+#ifdef USE_MPI
+	MPI_Finalize();
+#endif
+}
@@ -0,0 +1,24 @@
+/** \file
+ *
+ * \author hhh
+ * \date Wed 14 Oct 2026 06:02:17 PM CEST
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+extern int mpiRank;
+extern int mpiSize;
+
+void initParallel(int *argc, char ***argv);
+void createHaloExchange(long nHalos, const int *haloRank);
+void startHaloExchange(int nArrays, double **arrays[]);
+void finishHaloExchange(void);
+void globalSum(double *val, int n);
+void globalMin(double *val, int n);
+void globalMax(double *val, int n);
+double **gatherRows(double **data, long nRows, int nCols, const long *pos,
+		long *nRowsGlobal);
+void freeParallel(void);
+
+#endif
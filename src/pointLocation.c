@@ -0,0 +1,195 @@
+/** \file
+ *
+ * \brief Uniform grid over the element bounding boxes, used to find the
+ *	element that contains a point
+ *
+ * Each grid cell holds all elements whose bounding box overlaps with it, so
+ * that only the elements of a single cell have to be tested for a point.
+ * The grid has about as many cells as the partition has elements.
+ *
+ * \author hhh
+ * \date Wed 14 Oct 2026 07:02:51 PM CEST
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "main.h"
+#include "pointLocation.h"
+#include "mesh.h"
+#include "memTools.h"
+
+/* local variables */
+double gridMin[NDIM];			/**< lower left corner of the grid */
+double gridDxQ[NDIM];			/**< inverse of the grid cell size */
+long gridN[NDIM];			/**< number of grid cells per direction */
+long *cellOffset;			/**< CSR offsets into `cellElem` */
+long *cellElem;				/**< elements of each grid cell */
+
+/**
+ * \brief Get the range of grid cells that is overlapped by the bounding box
+ *	of an element
+ * \param[in] aElem The element
+ * \param[out] lo Lower cell index per direction
+ * \param[out] hi Upper cell index per direction
+ */
+void elemCellRange(elem_t *aElem, long lo[NDIM], long hi[NDIM])
+{
+	for (int iDim = 0; iDim < NDIM; ++iDim) {
+		double xMinElem = aElem->node[0]->x[iDim];
+		double xMaxElem = xMinElem;
+		for (int iNode = 1; iNode < aElem->elemType; ++iNode) {
+			xMinElem = fmin(xMinElem, aElem->node[iNode]->x[iDim]);
+			xMaxElem = fmax(xMaxElem, aElem->node[iNode]->x[iDim]);
+		}
+
+		lo[iDim] = (long)((xMinElem - gridMin[iDim]) * gridDxQ[iDim]);
+		hi[iDim] = (long)((xMaxElem - gridMin[iDim]) * gridDxQ[iDim]);
+		lo[iDim] = (lo[iDim] < 0 ? 0 : (lo[iDim] >= gridN[iDim] ? gridN[iDim] - 1 : lo[iDim]));
+		hi[iDim] = (hi[iDim] < 0 ? 0 : (hi[iDim] >= gridN[iDim] ? gridN[iDim] - 1 : hi[iDim]));
+	}
+}
+
+/**
+ * \brief Build the grid of the elements of the partition
+ */
+void createPointLocation(void)
+{
+	/* bounding box of the partition */
+	double boxMin[NDIM] = {1e200, 1e200};
+	double boxMax[NDIM] = {-1e200, -1e200};
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		elem_t *aElem = elem[iElem];
+		for (int iNode = 0; iNode < aElem->elemType; ++iNode) {
+			for (int iDim = 0; iDim < NDIM; ++iDim) {
+				boxMin[iDim] = fmin(boxMin[iDim], aElem->node[iNode]->x[iDim]);
+				boxMax[iDim] = fmax(boxMax[iDim], aElem->node[iNode]->x[iDim]);
+			}
+		}
+	}
+
+	/* square cells, about one element per cell */
+	double dx = sqrt((boxMax[X] - boxMin[X]) * (boxMax[Y] - boxMin[Y])
+			/ (nElems > 0 ? nElems : 1));
+	for (int iDim = 0; iDim < NDIM; ++iDim) {
+		double len = boxMax[iDim] - boxMin[iDim];
+		if (!(dx > 0.0)) {
+			dx = fmax(len, 1.0);
+		}
+		gridN[iDim] = (long)(len / dx) + 1;
+		if (gridN[iDim] > nElems + 1) {
+			gridN[iDim] = nElems + 1;
+		}
+		gridMin[iDim] = boxMin[iDim];
+		gridDxQ[iDim] = (len > 0.0 ? gridN[iDim] / len : 0.0);
+	}
+
+	/* count the elements per cell, then sort them into the cells */
+	long nCells = gridN[X] * gridN[Y];
+	cellOffset = dyn1DintArray(nCells + 1);
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		long lo[NDIM], hi[NDIM];
+		elemCellRange(elem[iElem], lo, hi);
+		for (long j = lo[Y]; j <= hi[Y]; ++j) {
+			for (long i = lo[X]; i <= hi[X]; ++i) {
+				cellOffset[j * gridN[X] + i + 1]++;
+			}
+		}
+	}
+
+	for (long iCell = 0; iCell < nCells; ++iCell) {
+		cellOffset[iCell + 1] += cellOffset[iCell];
+	}
+
+	long *pos = dyn1DintArray(nCells);
+	cellElem = dyn1DintArray(cellOffset[nCells]);
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		long lo[NDIM], hi[NDIM];
+		elemCellRange(elem[iElem], lo, hi);
+		for (long j = lo[Y]; j <= hi[Y]; ++j) {
+			for (long i = lo[X]; i <= hi[X]; ++i) {
+				long iCell = j * gridN[X] + i;
+				cellElem[cellOffset[iCell] + pos[iCell]++] = iElem;
+			}
+		}
+	}
+	free(pos);
+}
+
+/**
+ * \brief Check if a point lies inside of an element
+ * \param[in] aElem The element
+ * \param[in] x Coordinates of the point
+ * \return True, if the point is not outside of any of the element edges
+ */
+bool isInsideElem(elem_t *aElem, const double x[NDIM])
+{
+	for (int i = 0; i < aElem->elemType; ++i) {
+		int iNode1 = i;
+		int iNode2 = i + 1;
+		if (iNode2 >= aElem->elemType) {
+			iNode2 = 0;
+		}
+
+		/* outward normal of the edge */
+		double u[NDIM];
+		u[X] = aElem->node[iNode2]->x[Y] - aElem->node[iNode1]->x[Y];
+		u[Y] = aElem->node[iNode1]->x[X] - aElem->node[iNode2]->x[X];
+		double tmp = sqrt(u[X] * u[X] + u[Y] * u[Y]);
+		u[X] /= tmp;
+		u[Y] /= tmp;
+
+		double dx[NDIM];
+		dx[X] = x[X] - aElem->node[iNode1]->x[X];
+		dx[Y] = x[Y] - aElem->node[iNode1]->x[Y];
+
+		double projection = u[X] * dx[X] + u[Y] * dx[Y];
+		if (projection > 0.0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * \brief Find the element of the partition that contains a point
+ * \param[in] x Coordinates of the point
+ * \return The element with the lowest ID that contains the point, NULL if
+ *	the point is outside of the partition
+ */
+elem_t *findElem(const double x[NDIM])
+{
+	long iCell[NDIM];
+	for (int iDim = 0; iDim < NDIM; ++iDim) {
+		double pos = (x[iDim] - gridMin[iDim]) * gridDxQ[iDim];
+		if ((pos < 0.0) || (pos > gridN[iDim])) {
+			return NULL;
+		}
+
+		iCell[iDim] = (long)pos;
+		if (iCell[iDim] >= gridN[iDim]) {
+			iCell[iDim] = gridN[iDim] - 1;
+		}
+	}
+
+	long cell = iCell[Y] * gridN[X] + iCell[X];
+	for (long k = cellOffset[cell]; k < cellOffset[cell + 1]; ++k) {
+		if (isInsideElem(elem[cellElem[k]], x)) {
+			return elem[cellElem[k]];
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \brief Free the grid
+ */
+void freePointLocation(void)
+{
+	free(cellOffset);
+	free(cellElem);
+}
@@ -0,0 +1,20 @@
+/** \file
+ *
+ * \author hhh
+ * \date Wed 14 Oct 2026 07:02:51 PM CEST
+ */
+
+#ifndef POINTLOCATION_H
+#define POINTLOCATION_H
+
+#include <stdbool.h>
+
+#include "main.h"
+#include "mesh.h"
+
+void createPointLocation(void);
+bool isInsideElem(elem_t *aElem, const double x[NDIM]);
+elem_t *findElem(const double x[NDIM]);
+void freePointLocation(void);
+
+#endif
@@ -104,6 +104,82 @@ void fillCmds(char iniFileName[STRLEN])
 	fclose(iniFile);
 }
 
+/** \brief Count the commands with a key
+ *
+ * \param[in] aCmd The first command of the list
+ * \param[in] key The key of the commands
+ * \return The number of commands with the key
+ */
+static int countCmds(cmd_t *aCmd, const char *key)
+{
+	int n = 0;
+	for (; aCmd; aCmd = aCmd->next) {
+		n += !strcmp(aCmd->key, key);
+	}
+
+	return n;
+}
+
+/** \brief Override commands with the commands of another parameter file
+ *
+ * The occurrences of a key in the second file replace the values of the
+ * occurrences in the commands list one by one, so a key that is given
+ * several times, e.g. the angle of attack of the initial and the boundary
+ * condition, has to be given as many times in the second file. Keys that
+ * are not in the commands list are appended.
+ *
+ * \param[in] iniFileName The name of the parameter file with the overrides
+ */
+void overrideCmds(char iniFileName[STRLEN])
+{
+	cmd_t *baseCmd = firstCmd;
+	firstCmd = NULL;
+	fillCmds(iniFileName);
+	cmd_t *overrideCmd = firstCmd;
+	firstCmd = baseCmd;
+
+	for (cmd_t *aCmd = overrideCmd; aCmd; aCmd = aCmd->next) {
+		int nBase = countCmds(baseCmd, aCmd->key);
+		int nOverride = countCmds(overrideCmd, aCmd->key);
+		if ((nBase > 0) && (nBase != nOverride)) {
+			printf("| ERROR: '%s' is given %d times in '%s', but %d times in the case file\n",
+					aCmd->key, nOverride, iniFileName, nBase);
+			exit(1);
+		}
+	}
+
+	/* replace the values in the order of the occurrences */
+	cmd_t *lastCmd = NULL;
+	for (cmd_t *aCmd = baseCmd; aCmd; aCmd = aCmd->next) {
+		for (cmd_t *bCmd = overrideCmd; bCmd; bCmd = bCmd->next) {
+			if (!strcmp(aCmd->key, bCmd->key)) {
+				strcpy(aCmd->value, bCmd->value);
+				if (bCmd->prev) {
+					bCmd->prev->next = bCmd->next;
+				} else {
+					overrideCmd = bCmd->next;
+				}
+				if (bCmd->next) {
+					bCmd->next->prev = bCmd->prev;
+				}
+				free(bCmd);
+				break;
+			}
+		}
+		lastCmd = aCmd;
+	}
+
+	/* append the new keys */
+	if (lastCmd) {
+		lastCmd->next = overrideCmd;
+		if (overrideCmd) {
+			overrideCmd->prev = lastCmd;
+		}
+	} else {
+		firstCmd = overrideCmd;
+	}
+}
+
 /** \brief Delete a single node of the command list.
  *
  * Before deleting the command, the previous command is connected to the next
@@ -419,6 +495,7 @@ void freeCmds(void)
 			break;
 		}
 	}
+	firstCmd = NULL;
 }
 
 /**
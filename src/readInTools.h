@@ -12,6 +12,7 @@
 #include "main.h"
 
 void fillCmds(char iniFileName[STRLEN]);
+void overrideCmds(char iniFileName[STRLEN]);
 char *getStr(const char *key, const char *proposal);
 int countKeys(const char *key, const int proposal);
 long getInt(const char *key, const char *proposal);
@@ -6,6 +6,8 @@
  * \date Sat 28 Mar 2020 10:17:02 AM CET
  */
 
+#include <stdbool.h>
+#include <stdlib.h>
 #include <math.h>
 
 #include "main.h"
@@ -16,58 +18,53 @@
 /* extern variables */
 int limiter;				/**< limiter selection */
 double venk_k;				/**< constant for Venkatakrishnan limiter */
+double limiterFreezeResidual;		/**< residual below which the limiter is
+					  frozen, 0 never freezes it */
+bool isLimiterFrozen;			/**< the limiter values are kept fixed */
+double **limiterPhi;			/**< limiter values of the elements */
 
 /**
  * \brief Limiter after Barth & Jespersen
  * \note 2D, unstructured limiter
- * \param[in] aElem Pointer to an element
+ * \param[in] iElem Element ID
+ * \param[in] u_x Unlimited x-gradient of the element
+ * \param[in] u_y Unlimited y-gradient of the element
+ * \param[in] uMin Minimum of the element's and its neighbors' states
+ * \param[in] uMax Maximum of the element's and its neighbors' states
+ * \param[out] phi Limiter values of the element
  */
-void limiterBarthJespersen(elem_t *aElem)
+void limiterBarthJespersen(long iElem, double u_x[NVAR], double u_y[NVAR],
+		double uMin[NVAR], double uMax[NVAR], double phi[NVAR])
 {
-	/* determine uMin and uMax */
-	double uMin[NVAR], uMax[NVAR];
-	uMin[RHO] = uMax[RHO] = aElem->pVar[RHO];
-	uMin[VX]  = uMax[VX]  = aElem->pVar[VX];
-	uMin[VY]  = uMax[VY]  = aElem->pVar[VY];
-	uMin[P]   = uMax[P]   = aElem->pVar[P];
-
-	side_t *aSide = aElem->firstSide;
-	while (aSide) {
-		uMin[RHO] = fmin(uMin[RHO], aSide->connection->elem->pVar[RHO]);
-		uMin[VX]  = fmin(uMin[VX],  aSide->connection->elem->pVar[VX]);
-		uMin[VY]  = fmin(uMin[VY],  aSide->connection->elem->pVar[VY]);
-		uMin[P]   = fmin(uMin[P],   aSide->connection->elem->pVar[P]);
-
-		uMax[RHO] = fmax(uMax[RHO], aSide->connection->elem->pVar[RHO]);
-		uMax[VX]  = fmax(uMax[VX],  aSide->connection->elem->pVar[VX]);
-		uMax[VY]  = fmax(uMax[VY],  aSide->connection->elem->pVar[VY]);
-		uMax[P]   = fmax(uMax[P],   aSide->connection->elem->pVar[P]);
-
-		aSide = aSide->nextElemSide;
-	}
+	double pVar[NVAR] = {
+		elemData.pVar[RHO][iElem], elemData.pVar[VX][iElem],
+		elemData.pVar[VY][iElem],  elemData.pVar[P][iElem]
+	};
 
 	double minDiff[NVAR], maxDiff[NVAR];
-	minDiff[RHO] = uMin[RHO] - aElem->pVar[RHO];
-	minDiff[VX]  = uMin[VX]  - aElem->pVar[VX];
-	minDiff[VY]  = uMin[VY]  - aElem->pVar[VY];
-	minDiff[P]   = uMin[P]   - aElem->pVar[P];
+	minDiff[RHO] = uMin[RHO] - pVar[RHO];
+	minDiff[VX]  = uMin[VX]  - pVar[VX];
+	minDiff[VY]  = uMin[VY]  - pVar[VY];
+	minDiff[P]   = uMin[P]   - pVar[P];
 
-	maxDiff[RHO] = uMax[RHO] - aElem->pVar[RHO];
-	maxDiff[VX]  = uMax[VX]  - aElem->pVar[VX];
-	maxDiff[VY]  = uMax[VY]  - aElem->pVar[VY];
-	maxDiff[P]   = uMax[P]   - aElem->pVar[P];
+	maxDiff[RHO] = uMax[RHO] - pVar[RHO];
+	maxDiff[VX]  = uMax[VX]  - pVar[VX];
+	maxDiff[VY]  = uMax[VY]  - pVar[VY];
+	maxDiff[P]   = uMax[P]   - pVar[P];
 
 	/* loop over all edges: determine phi */
-	double phi[NVAR] = {1.0, 1.0, 1.0, 1.0}, phiLoc[NVAR], uDiff[NVAR];
-	aSide = aElem->firstSide;
-	while (aSide) {
+	double phiLoc[NVAR], uDiff[NVAR];
+	phi[RHO] = phi[VX] = phi[VY] = phi[P] = 1.0;
+	for (long j = elemData.sideOffset[iElem]; j < elemData.sideOffset[iElem + 1]; ++j) {
+		long iSide = elemData.sideIdx[j];
+
 		phiLoc[RHO] = 1.0;
 		phiLoc[VX]  = 1.0;
 		phiLoc[VY]  = 1.0;
 		phiLoc[P]   = 1.0;
 		for (int iVar = 0; iVar < NVAR; ++iVar) {
-			uDiff[iVar] = aElem->u_x[iVar] * aSide->GP[X]
-				    + aElem->u_y[iVar] * aSide->GP[Y];
+			uDiff[iVar] = u_x[iVar] * sideData.GP[X][iSide]
+				    + u_y[iVar] * sideData.GP[Y][iSide];
 			if (uDiff[iVar] > 0.0) {
 				phiLoc[iVar] = fmin(1.0, maxDiff[iVar] / uDiff[iVar]);
 			} else if (uDiff[iVar] < 0.0) {
@@ -79,61 +76,38 @@ void limiterBarthJespersen(elem_t *aElem)
 		phi[VX]  = fmin(phi[VX],  phiLoc[VX]);
 		phi[VY]  = fmin(phi[VY],  phiLoc[VY]);
 		phi[P]   = fmin(phi[P],   phiLoc[P]);
-
-		aSide = aSide->nextElemSide;
 	}
-
-	/* compute limited gradients */
-	aElem->u_x[RHO] *= phi[RHO];
-	aElem->u_x[VX]  *= phi[VX];
-	aElem->u_x[VY]  *= phi[VY];
-	aElem->u_x[P]   *= phi[P];
-
-	aElem->u_y[RHO] *= phi[RHO];
-	aElem->u_y[VX]  *= phi[VX];
-	aElem->u_y[VY]  *= phi[VY];
-	aElem->u_y[P]   *= phi[P];
 }
 
 /**
  * \brief Limiter after Venkatakrishnan, with additional limiting parameter k
  * \note 2D, unstructured limiter
- * \param[in] aElem Pointer to an element
+ * \param[in] iElem Element ID
+ * \param[in] u_x Unlimited x-gradient of the element
+ * \param[in] u_y Unlimited y-gradient of the element
+ * \param[in] uMin Minimum of the element's and its neighbors' states
+ * \param[in] uMax Maximum of the element's and its neighbors' states
+ * \param[out] phi Limiter values of the element
  */
-void limiterVenkatakrishnan(elem_t *aElem)
+void limiterVenkatakrishnan(long iElem, double u_x[NVAR], double u_y[NVAR],
+		double uMin[NVAR], double uMax[NVAR], double phi[NVAR])
 {
-	/* determine uMin and uMax */
-	double uMin[NVAR], uMax[NVAR];
-	uMin[RHO] = uMax[RHO] = aElem->pVar[RHO];
-	uMin[VX]  = uMax[VX]  = aElem->pVar[VX];
-	uMin[VY]  = uMax[VY]  = aElem->pVar[VY];
-	uMin[P]   = uMax[P]   = aElem->pVar[P];
-
-	side_t *aSide = aElem->firstSide;
-	while (aSide) {
-		uMin[RHO] = fmin(uMin[RHO], aSide->connection->elem->pVar[RHO]);
-		uMin[VX]  = fmin(uMin[VX],  aSide->connection->elem->pVar[VX]);
-		uMin[VY]  = fmin(uMin[VY],  aSide->connection->elem->pVar[VY]);
-		uMin[P]   = fmin(uMin[P],   aSide->connection->elem->pVar[P]);
-
-		uMax[RHO] = fmax(uMax[RHO], aSide->connection->elem->pVar[RHO]);
-		uMax[VX]  = fmax(uMax[VX],  aSide->connection->elem->pVar[VX]);
-		uMax[VY]  = fmax(uMax[VY],  aSide->connection->elem->pVar[VY]);
-		uMax[P]   = fmax(uMax[P],   aSide->connection->elem->pVar[P]);
-
-		aSide = aSide->nextElemSide;
-	}
+	double pVar[NVAR] = {
+		elemData.pVar[RHO][iElem], elemData.pVar[VX][iElem],
+		elemData.pVar[VY][iElem],  elemData.pVar[P][iElem]
+	};
+	double venkEps_sq = elemData.venkEps_sq[iElem];
 
 	double minDiff[NVAR], maxDiff[NVAR], minDiffsq[NVAR], maxDiffsq[NVAR];
-	minDiff[RHO] = uMin[RHO] - aElem->pVar[RHO];
-	minDiff[VX]  = uMin[VX]  - aElem->pVar[VX];
-	minDiff[VY]  = uMin[VY]  - aElem->pVar[VY];
-	minDiff[P]   = uMin[P]   - aElem->pVar[P];
+	minDiff[RHO] = uMin[RHO] - pVar[RHO];
+	minDiff[VX]  = uMin[VX]  - pVar[VX];
+	minDiff[VY]  = uMin[VY]  - pVar[VY];
+	minDiff[P]   = uMin[P]   - pVar[P];
 
-	maxDiff[RHO] = uMax[RHO] - aElem->pVar[RHO];
-	maxDiff[VX]  = uMax[VX]  - aElem->pVar[VX];
-	maxDiff[VY]  = uMax[VY]  - aElem->pVar[VY];
-	maxDiff[P]   = uMax[P]   - aElem->pVar[P];
+	maxDiff[RHO] = uMax[RHO] - pVar[RHO];
+	maxDiff[VX]  = uMax[VX]  - pVar[VX];
+	maxDiff[VY]  = uMax[VY]  - pVar[VY];
+	maxDiff[P]   = uMax[P]   - pVar[P];
 
 	minDiffsq[RHO] = minDiff[RHO] * minDiff[RHO];
 	minDiffsq[VX]  = minDiff[VX]  * minDiff[VX];
@@ -146,28 +120,30 @@ void limiterVenkatakrishnan(elem_t *aElem)
 	maxDiffsq[P]   = maxDiff[P]   * maxDiff[P];
 
 	/* loop over all edges: determine phi */
-	double phi[NVAR] = {1.0, 1.0, 1.0, 1.0}, phiLoc[NVAR], uDiff[NVAR], uDiffsq[NVAR];
-	aSide = aElem->firstSide;
-	while (aSide) {
+	double phiLoc[NVAR], uDiff[NVAR], uDiffsq[NVAR];
+	phi[RHO] = phi[VX] = phi[VY] = phi[P] = 1.0;
+	for (long j = elemData.sideOffset[iElem]; j < elemData.sideOffset[iElem + 1]; ++j) {
+		long iSide = elemData.sideIdx[j];
+
 		phiLoc[RHO] = 1.0;
 		phiLoc[VX]  = 1.0;
 		phiLoc[VY]  = 1.0;
 		phiLoc[P]   = 1.0;
 		for (int iVar = 0; iVar < NVAR; ++iVar) {
-			uDiff[iVar] = aElem->u_x[iVar] * aSide->GP[X]
-				    + aElem->u_y[iVar] * aSide->GP[Y];
+			uDiff[iVar] = u_x[iVar] * sideData.GP[X][iSide]
+				    + u_y[iVar] * sideData.GP[Y][iSide];
 			uDiffsq[iVar] = uDiff[iVar] * uDiff[iVar];
 
 			if (uDiff[iVar] > 0.0) {
-				phiLoc[iVar] = 1.0 / uDiff[iVar] * (((maxDiffsq[iVar] + aElem->venkEps_sq) * uDiff[iVar]
+				phiLoc[iVar] = 1.0 / uDiff[iVar] * (((maxDiffsq[iVar] + venkEps_sq) * uDiff[iVar]
 							+ 2.0 * uDiffsq[iVar] * maxDiff[iVar])
 						/ (maxDiffsq[iVar] + 2.0 * uDiffsq[iVar] + uDiff[iVar]
-							* maxDiff[iVar] + aElem->venkEps_sq));
+							* maxDiff[iVar] + venkEps_sq));
 			} else if (uDiff[iVar] < 0.0) {
-				phiLoc[iVar] = 1.0 / uDiff[iVar] * (((minDiffsq[iVar] + aElem->venkEps_sq) * uDiff[iVar]
+				phiLoc[iVar] = 1.0 / uDiff[iVar] * (((minDiffsq[iVar] + venkEps_sq) * uDiff[iVar]
 							+ 2.0 * uDiffsq[iVar] * minDiff[iVar])
 						/ (minDiffsq[iVar] + 2.0 * uDiffsq[iVar] + uDiff[iVar]
-							* minDiff[iVar] + aElem->venkEps_sq));
+							* minDiff[iVar] + venkEps_sq));
 			}
 		}
 
@@ -175,20 +151,132 @@ void limiterVenkatakrishnan(elem_t *aElem)
 		phi[VX]  = fmin(phi[VX],  phiLoc[VX]);
 		phi[VY]  = fmin(phi[VY],  phiLoc[VY]);
 		phi[P]   = fmin(phi[P],   phiLoc[P]);
+	}
+}
 
-		aSide = aSide->nextElemSide;
+/**
+ * \brief Add the contribution of a neighbor to the gradients of an element
+ *
+ * The extrema of the neighbor states, which the limiters need, are collected
+ * along with the gradients.
+ * \param[in] iSide Element side index, pointing to the neighbor
+ * \param[in] iElem Element ID
+ * \param[in] NBelem Neighbor element ID
+ * \param[in,out] u_x x-gradient of the element
+ * \param[in,out] u_y y-gradient of the element
+ * \param[in,out] uMin Minimum of the states
+ * \param[in,out] uMax Maximum of the states
+ */
+static inline void addGradient(long iSide, long iElem, long NBelem,
+		double u_x[NVAR], double u_y[NVAR], double uMin[NVAR], double uMax[NVAR])
+{
+	double pVarNB[NVAR] = {
+		elemData.pVar[RHO][NBelem], elemData.pVar[VX][NBelem],
+		elemData.pVar[VY][NBelem],  elemData.pVar[P][NBelem]
+	};
+
+	double pDiff[NVAR];
+	pDiff[RHO] = pVarNB[RHO] - elemData.pVar[RHO][iElem];
+	pDiff[VX]  = pVarNB[VX]  - elemData.pVar[VX][iElem];
+	pDiff[VY]  = pVarNB[VY]  - elemData.pVar[VY][iElem];
+	pDiff[P]   = pVarNB[P]   - elemData.pVar[P][iElem];
+
+	u_x[RHO] += sideData.w[X][iSide] * pDiff[RHO];
+	u_x[VX]  += sideData.w[X][iSide] * pDiff[VX];
+	u_x[VY]  += sideData.w[X][iSide] * pDiff[VY];
+	u_x[P]   += sideData.w[X][iSide] * pDiff[P];
+
+	u_y[RHO] += sideData.w[Y][iSide] * pDiff[RHO];
+	u_y[VX]  += sideData.w[Y][iSide] * pDiff[VX];
+	u_y[VY]  += sideData.w[Y][iSide] * pDiff[VY];
+	u_y[P]   += sideData.w[Y][iSide] * pDiff[P];
+
+	uMin[RHO] = fmin(uMin[RHO], pVarNB[RHO]);
+	uMin[VX]  = fmin(uMin[VX],  pVarNB[VX]);
+	uMin[VY]  = fmin(uMin[VY],  pVarNB[VY]);
+	uMin[P]   = fmin(uMin[P],   pVarNB[P]);
+
+	uMax[RHO] = fmax(uMax[RHO], pVarNB[RHO]);
+	uMax[VX]  = fmax(uMax[VX],  pVarNB[VX]);
+	uMax[VY]  = fmax(uMax[VY],  pVarNB[VY]);
+	uMax[P]   = fmax(uMax[P],   pVarNB[P]);
+}
+
+/**
+ * \brief Initialize the gradients and the extrema of the states of an element
+ * \param[in] iElem Element ID
+ * \param[out] u_x x-gradient of the element
+ * \param[out] u_y y-gradient of the element
+ * \param[out] uMin Minimum of the states
+ * \param[out] uMax Maximum of the states
+ */
+static inline void startGradient(long iElem, double u_x[NVAR], double u_y[NVAR],
+		double uMin[NVAR], double uMax[NVAR])
+{
+	for (int iVar = 0; iVar < NVAR; ++iVar) {
+		u_x[iVar] = u_y[iVar] = 0.0;
+		uMin[iVar] = uMax[iVar] = elemData.pVar[iVar][iElem];
 	}
+}
 
-	/* compute limited gradients */
-	aElem->u_x[RHO] *= phi[RHO];
-	aElem->u_x[VX]  *= phi[VX];
-	aElem->u_x[VY]  *= phi[VY];
-	aElem->u_x[P]   *= phi[P];
+/**
+ * \brief Store and limit the gradients of an element
+ *
+ * Once the limiter is frozen the stored limiter values are used, until then
+ * they are stored, if freezing is enabled.
+ * \param[in] iElem Element ID
+ * \param[in] u_x x-gradient of the element
+ * \param[in] u_y y-gradient of the element
+ * \param[in] uMin Minimum of the element's and its neighbors' states
+ * \param[in] uMax Maximum of the element's and its neighbors' states
+ */
+static inline void limitGradient(long iElem, double u_x[NVAR], double u_y[NVAR],
+		double uMin[NVAR], double uMax[NVAR])
+{
+	double phi[NVAR] = {1.0, 1.0, 1.0, 1.0};
+	if (isLimiterFrozen) {
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			phi[iVar] = limiterPhi[iVar][iElem];
+		}
+	} else {
+		switch (limiter) {
+		case BARTHJESPERSEN:
+			limiterBarthJespersen(iElem, u_x, u_y, uMin, uMax, phi);
+			break;
+		case VENKATAKRISHNAN:
+			limiterVenkatakrishnan(iElem, u_x, u_y, uMin, uMax, phi);
+			break;
+		}
+
+		if (limiterPhi) {
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				limiterPhi[iVar][iElem] = phi[iVar];
+			}
+		}
+	}
 
-	aElem->u_y[RHO] *= phi[RHO];
-	aElem->u_y[VX]  *= phi[VX];
-	aElem->u_y[VY]  *= phi[VY];
-	aElem->u_y[P]   *= phi[P];
+	for (int iVar = 0; iVar < NVAR; ++iVar) {
+		elemData.u_x[iVar][iElem] = u_x[iVar] * phi[iVar];
+		elemData.u_y[iVar][iElem] = u_y[iVar] * phi[iVar];
+	}
+}
+
+/**
+ * \brief Compute and limit the gradients of an element from the neighbors
+ *	in its side list
+ * \param[in] iElem Element ID
+ */
+static inline void elemLimitedGradient(long iElem)
+{
+	double u_x[NVAR], u_y[NVAR], uMin[NVAR], uMax[NVAR];
+	startGradient(iElem, u_x, u_y, uMin, uMax);
+
+	for (long j = elemData.sideOffset[iElem]; j < elemData.sideOffset[iElem + 1]; ++j) {
+		long iSide = elemData.sideIdx[j];
+		addGradient(iSide, iElem, sideData.elem[iSide ^ 1], u_x, u_y, uMin, uMax);
+	}
+
+	limitGradient(iElem, u_x, u_y, uMin, uMax);
 }
 
 /**
@@ -201,114 +289,124 @@ void spatialReconstruction(double time)
 		/* set side states to be equal to mean value */
 		#pragma omp parallel for
 		for (long iElem = 0; iElem < nElems; ++iElem) {
-			elem_t *aElem = elem[iElem];
-			side_t *aSide = aElem->firstSide;
-			aElem->u_x[RHO] = 0.0;
-			aElem->u_x[VX]  = 0.0;
-			aElem->u_x[VY]  = 0.0;
-			aElem->u_x[P]   = 0.0;
-
-			aElem->u_y[RHO] = 0.0;
-			aElem->u_y[VX]  = 0.0;
-			aElem->u_y[VY]  = 0.0;
-			aElem->u_y[P]   = 0.0;
-
-			aElem->u_t[RHO] = 0.0;
-			aElem->u_t[VX]  = 0.0;
-			aElem->u_t[VY]  = 0.0;
-			aElem->u_t[P]   = 0.0;
-
-			while (aSide) {
-				aSide->pVar[RHO] = aElem->pVar[RHO];
-				aSide->pVar[VX]  = aElem->pVar[VX];
-				aSide->pVar[VY]  = aElem->pVar[VY];
-				aSide->pVar[P]   = aElem->pVar[P];
-				aSide = aSide->nextElemSide;
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				elemData.u_x[iVar][iElem] = 0.0;
+				elemData.u_y[iVar][iElem] = 0.0;
+				elemData.u_t[iVar][iElem] = 0.0;
+			}
+
+			for (long j = elemData.sideOffset[iElem]; j < elemData.sideOffset[iElem + 1]; ++j) {
+				long iSide = elemData.sideIdx[j];
+				sideData.pVar[RHO][iSide] = elemData.pVar[RHO][iElem];
+				sideData.pVar[VX][iSide]  = elemData.pVar[VX][iElem];
+				sideData.pVar[VY][iSide]  = elemData.pVar[VY][iElem];
+				sideData.pVar[P][iSide]   = elemData.pVar[P][iElem];
 			}
 		}
 	} else {
 		/* reconstruction of values at side GPs */
 		#pragma omp parallel for
 		for (long iElem = 0; iElem < nElems; ++iElem) {
-			elem_t *aElem = elem[iElem];
-			aElem->u_x[RHO] = 0.0;
-			aElem->u_x[VX]  = 0.0;
-			aElem->u_x[VY]  = 0.0;
-			aElem->u_x[P]   = 0.0;
-
-			aElem->u_y[RHO] = 0.0;
-			aElem->u_y[VX]  = 0.0;
-			aElem->u_y[VY]  = 0.0;
-			aElem->u_y[P]   = 0.0;
-
-			aElem->u_t[RHO] = 0.0;
-			aElem->u_t[VX]  = 0.0;
-			aElem->u_t[VY]  = 0.0;
-			aElem->u_t[P]   = 0.0;
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				elemData.u_x[iVar][iElem] = 0.0;
+				elemData.u_y[iVar][iElem] = 0.0;
+				elemData.u_t[iVar][iElem] = 0.0;
+			}
 		}
 
+		#pragma omp parallel
 		setBCatBarys(time);
 
+		/* limited gradients and reconstruction of the values at side GPs */
 		#pragma omp parallel for
 		for (long iElem = 0; iElem < nElems; ++iElem) {
-			elem_t *aElem = elem[iElem];
-			side_t *aSide = aElem->firstSide;
-			while (aSide) {
-				double pDiff[NVAR];
-				pDiff[RHO] = aSide->connection->elem->pVar[RHO] - aSide->elem->pVar[RHO];
-				pDiff[VX]  = aSide->connection->elem->pVar[VX]  - aSide->elem->pVar[VX];
-				pDiff[VY]  = aSide->connection->elem->pVar[VY]  - aSide->elem->pVar[VY];
-				pDiff[P]   = aSide->connection->elem->pVar[P]   - aSide->elem->pVar[P];
-
-				aElem->u_x[RHO] += aSide->w[X] * pDiff[RHO];
-				aElem->u_x[VX]  += aSide->w[X] * pDiff[VX];
-				aElem->u_x[VY]  += aSide->w[X] * pDiff[VY];
-				aElem->u_x[P]   += aSide->w[X] * pDiff[P];
-
-				aElem->u_y[RHO] += aSide->w[Y] * pDiff[RHO];
-				aElem->u_y[VX]  += aSide->w[Y] * pDiff[VX];
-				aElem->u_y[VY]  += aSide->w[Y] * pDiff[VY];
-				aElem->u_y[P]   += aSide->w[Y] * pDiff[P];
-
-				aSide = aSide->nextElemSide;
-			}
-		}
-
-		/* limit gradients and reconstruct values at side GPs */
-		#pragma omp parallel for
-		for (long iElem = 0; iElem < nElems; ++iElem) {
-			elem_t *aElem = elem[iElem];
-
-			/* limit gradient */
-			switch (limiter) {
-			case BARTHJESPERSEN:
-				limiterBarthJespersen(aElem);
-				break;
-			case VENKATAKRISHNAN:
-				limiterVenkatakrishnan(aElem);
-				break;
-			}
+			elemLimitedGradient(iElem);
 
 			/* reconstruct values at side GPs */
-			side_t *aSide = aElem->firstSide;
-			while (aSide) {
-				double dx = aSide->GP[X];
-				double dy = aSide->GP[Y];
+			for (long j = elemData.sideOffset[iElem]; j < elemData.sideOffset[iElem + 1]; ++j) {
+				long iSide = elemData.sideIdx[j];
+				double dx = sideData.GP[X][iSide];
+				double dy = sideData.GP[Y][iSide];
 
-				aSide->pVar[RHO] = aElem->pVar[RHO]
-					+ dx * aElem->u_x[RHO] + dy * aElem->u_y[RHO];
+				sideData.pVar[RHO][iSide] = elemData.pVar[RHO][iElem]
+					+ dx * elemData.u_x[RHO][iElem] + dy * elemData.u_y[RHO][iElem];
 
-				aSide->pVar[VX]  = aElem->pVar[VX]
-					+ dx * aElem->u_x[VX]  + dy * aElem->u_y[VX];
+				sideData.pVar[VX][iSide]  = elemData.pVar[VX][iElem]
+					+ dx * elemData.u_x[VX][iElem]  + dy * elemData.u_y[VX][iElem];
 
-				aSide->pVar[VY]  = aElem->pVar[VY]
-					+ dx * aElem->u_x[VY]  + dy * aElem->u_y[VY];
+				sideData.pVar[VY][iSide]  = elemData.pVar[VY][iElem]
+					+ dx * elemData.u_x[VY][iElem]  + dy * elemData.u_y[VY][iElem];
 
-				aSide->pVar[P]   = aElem->pVar[P]
-					+ dx * aElem->u_x[P]   + dy * aElem->u_y[P];
+				sideData.pVar[P][iSide]   = elemData.pVar[P][iElem]
+					+ dx * elemData.u_x[P][iElem]   + dy * elemData.u_y[P][iElem];
+			}
+		}
+	}
+}
 
-				aSide = aSide->nextElemSide;
+/**
+ * \brief Compute and limit the gradients of a cartesian mesh
+ *
+ * The neighbors and sides of the interior elements follow from their
+ * position, see `orderCartesianSides`, in the order of their side lists. The
+ * elements at the boundaries use their side lists.
+ */
+static void structuredLimitedGradients(void)
+{
+	long iMax = cartMesh.iMax;
+	long jMax = cartMesh.jMax;
+	long nXsides = (iMax - 1) * jMax;
+
+	#pragma omp for
+	for (long j = 0; j < jMax; ++j) {
+		if ((j == 0) || (j == jMax - 1) || (iMax < 3)) {
+			for (long iElem = j * iMax; iElem < (j + 1) * iMax; ++iElem) {
+				elemLimitedGradient(iElem);
 			}
+			continue;
 		}
+
+		elemLimitedGradient(j * iMax);
+		for (long iElem = j * iMax + 1; iElem < (j + 1) * iMax - 1; ++iElem) {
+			double u_x[NVAR], u_y[NVAR], uMin[NVAR], uMax[NVAR];
+			startGradient(iElem, u_x, u_y, uMin, uMax);
+			addGradient(2 * (iElem - j - 1) + 1, iElem, iElem - 1, u_x, u_y, uMin, uMax);
+			addGradient(2 * (nXsides + iElem), iElem, iElem + iMax, u_x, u_y, uMin, uMax);
+			addGradient(2 * (iElem - j), iElem, iElem + 1, u_x, u_y, uMin, uMax);
+			addGradient(2 * (nXsides + iElem - iMax) + 1, iElem, iElem - iMax, u_x, u_y, uMin, uMax);
+			limitGradient(iElem, u_x, u_y, uMin, uMax);
+		}
+		elemLimitedGradient((j + 1) * iMax - 1);
+	}
+}
+
+/**
+ * \brief Compute and limit the gradients of all elements in a single pass
+ *
+ * The limiter of an element only needs its own gradient and the states of
+ * its neighbors, so both can be done while the element is in cache. The
+ * ghost states at the barycenters have to be set beforehand. Has to be called
+ * by all threads of a parallel region.
+ */
+void limitedGradients(void)
+{
+	if (useStructured) {
+		structuredLimitedGradients();
+		return;
 	}
+
+	#pragma omp for schedule(static)
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		elemLimitedGradient(iElem);
+	}
+}
+
+/**
+ * \brief Free the stored limiter values
+ */
+void freeReconstruction(void)
+{
+	free(limiterPhi);
+	limiterPhi = NULL;
+	isLimiterFrozen = false;
 }
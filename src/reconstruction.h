@@ -7,9 +7,16 @@
 #ifndef RECONSTRUCTION_H
 #define RECONSTRUCTION_H
 
+#include <stdbool.h>
+
 extern int limiter;
 extern double venk_k;
+extern double limiterFreezeResidual;
+extern bool isLimiterFrozen;
+extern double **limiterPhi;
 
 void spatialReconstruction(double time);
+void limitedGradients(void);
+void freeReconstruction(void);
 
 #endif
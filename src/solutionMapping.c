@@ -0,0 +1,453 @@
+/** \file
+ *
+ * \brief Restart from the flow solution of a different mesh
+ *
+ * If the CGNS restart file belongs to another mesh, e.g. a converged solution
+ * on a coarser mesh, its solution is mapped onto the elements of the
+ * partition. Every element takes the state of the donor element that contains
+ * its barycenter, elements outside of the donor mesh, e.g. at curved walls,
+ * take the state of the donor element with the nearest barycenter. On nested
+ * meshes, like the refinements of a coarser mesh, the mean values of the
+ * donor elements are kept.
+ *
+ * The donor elements and their solution are read in chunks of `MAP_CHUNK`
+ * elements, together with the range of nodes that the chunk refers to, so the
+ * restart file is never loaded as a whole. The barycenters of the partition
+ * are sorted into a uniform grid, every donor element only tests the
+ * barycenters of the grid cells that are overlapped by its bounding box.
+ *
+ * \author hhh
+ * \date Thu 15 Oct 2026 11:48:05 PM CEST
+ */
+
+typedef struct donor_t donor_t;
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include "main.h"
+#include "solutionMapping.h"
+#include "mesh.h"
+#include "readInTools.h"
+#include "memTools.h"
+#include "timeDiscretization.h"
+#include "output.h"
+#include "parallel.h"
+#include "checkpoint.h"
+#include "meshSequencing.h"
+#include "cgnslib.h"
+
+#define MAP_CHUNK 65536			/**< number of donor elements read at once */
+#define NO_DONOR 1e300			/**< distance of an element without donor */
+
+/**
+ * \brief Element of the donor mesh
+ */
+struct donor_t {
+	int nNodes;			/**< number of nodes */
+	double x[4][NDIM];		/**< coordinates of the nodes */
+	double pVar[NVAR];		/**< primitive variables */
+};
+
+/* extern variables */
+bool isMappedRestart;			/**< the restart solution belongs to
+					  another mesh */
+
+/* local variables */
+char mappedGridFile[STRLEN];		/**< name of the grid file, which is
+					  written under a temporary name until
+					  the donor is read */
+double mapGridMin[NDIM];		/**< lower left corner of the grid */
+double mapGridDxQ[NDIM];		/**< inverse of the grid cell size */
+long mapGridN[NDIM];			/**< number of grid cells per direction */
+long *mapCellOffset;			/**< CSR offsets into `mapCellElem` */
+long *mapCellElem;			/**< elements of each grid cell */
+double *mapDist;			/**< squared distance to the barycenter of
+					  the current donor, -1 inside of it */
+
+/**
+ * \brief Check if the restart file belongs to another mesh, called with the
+ *	complete mesh before the partitioning
+ *
+ * The grid file of a mapped restart is written under a temporary name, since
+ * the restart file may link to a grid file of the same name.
+ */
+void checkRestartMesh(void)
+{
+	bool doForceMapping = getBool("restartMapping", "F");
+
+	/* the stages of the mesh sequencing restart from another mesh */
+	doForceMapping |= (sequenceLevel < nSequenceStages - 1);
+
+	isMappedRestart = false;
+	mappedGridFile[0] = '\0';
+	if ((!isRestart) || isCheckpoint(strIniCondFile)) {
+		return;
+	}
+
+	int indexFile;
+	if (cg_open(strIniCondFile, CG_MODE_READ, &indexFile))
+		cg_error_exit();
+
+	char zoneName[33];
+	cgsize_t iSize[3];
+	if (cg_zone_read(indexFile, 1, 1, zoneName, iSize))
+		cg_error_exit();
+
+	if (cg_close(indexFile))
+		cg_error_exit();
+
+	isMappedRestart = doForceMapping || (iSize[1] != nElemsGlobal);
+	if (!isMappedRestart) {
+		return;
+	}
+
+	printf("| Restart Solution of %ld Elements is Mapped onto %ld Elements\n",
+			(long)iSize[1], nElemsGlobal);
+	if (iVisuProg == CGNS) {
+		strcpy(mappedGridFile, gridFile);
+		strcat(gridFile, ".new");
+	}
+}
+
+/**
+ * \brief Get the grid cell of a point
+ * \param[in] x Coordinates of the point
+ * \return Index of the grid cell
+ */
+static long mapGridCell(const double x[NDIM])
+{
+	long iCell[NDIM];
+	for (int iDim = 0; iDim < NDIM; ++iDim) {
+		iCell[iDim] = (long)((x[iDim] - mapGridMin[iDim]) * mapGridDxQ[iDim]);
+		iCell[iDim] = (iCell[iDim] < 0 ? 0 :
+			(iCell[iDim] >= mapGridN[iDim] ? mapGridN[iDim] - 1 : iCell[iDim]));
+	}
+
+	return iCell[Y] * mapGridN[X] + iCell[X];
+}
+
+/**
+ * \brief Sort the barycenters of the partition into a uniform grid with about
+ *	one barycenter per cell
+ */
+static void createMapGrid(void)
+{
+	double boxMin[NDIM] = {1e200, 1e200};
+	double boxMax[NDIM] = {-1e200, -1e200};
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		for (int iDim = 0; iDim < NDIM; ++iDim) {
+			boxMin[iDim] = fmin(boxMin[iDim], elemData.bary[iDim][iElem]);
+			boxMax[iDim] = fmax(boxMax[iDim], elemData.bary[iDim][iElem]);
+		}
+	}
+
+	double dx = sqrt((boxMax[X] - boxMin[X]) * (boxMax[Y] - boxMin[Y])
+			/ (nElems > 0 ? nElems : 1));
+	for (int iDim = 0; iDim < NDIM; ++iDim) {
+		double len = boxMax[iDim] - boxMin[iDim];
+		if (!(dx > 0.0)) {
+			dx = fmax(len, 1.0);
+		}
+		mapGridN[iDim] = (long)(len / dx) + 1;
+		if (mapGridN[iDim] > nElems + 1) {
+			mapGridN[iDim] = nElems + 1;
+		}
+		mapGridMin[iDim] = boxMin[iDim];
+		mapGridDxQ[iDim] = (len > 0.0 ? mapGridN[iDim] / len : 0.0);
+	}
+
+	long nCells = mapGridN[X] * mapGridN[Y];
+	mapCellOffset = dyn1DintArray(nCells + 1);
+	long *cell = dyn1DintArray(nElems);
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		double x[NDIM] = {elemData.bary[X][iElem], elemData.bary[Y][iElem]};
+		cell[iElem] = mapGridCell(x);
+		mapCellOffset[cell[iElem] + 1]++;
+	}
+
+	for (long iCell = 0; iCell < nCells; ++iCell) {
+		mapCellOffset[iCell + 1] += mapCellOffset[iCell];
+	}
+
+	long *pos = dyn1DintArray(nCells);
+	mapCellElem = dyn1DintArray(nElems);
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		mapCellElem[mapCellOffset[cell[iElem]] + pos[cell[iElem]]++] = iElem;
+	}
+	free(pos);
+	free(cell);
+
+	mapDist = dyn1DdblArray(nElems);
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		mapDist[iElem] = NO_DONOR;
+	}
+}
+
+/**
+ * \brief Check if a point lies inside of a donor element, independent of the
+ *	orientation of its nodes
+ * \param[in] aDonor The donor element
+ * \param[in] x Coordinates of the point
+ * \return True, if the point is not outside of any of the element edges
+ */
+static bool isInsideDonor(const donor_t *aDonor, const double x[NDIM])
+{
+	double area = 0.0;
+	for (int k = 0; k < aDonor->nNodes; ++k) {
+		const double *a = aDonor->x[k];
+		const double *b = aDonor->x[(k + 1) % aDonor->nNodes];
+		area += a[X] * b[Y] - a[Y] * b[X];
+	}
+
+	for (int k = 0; k < aDonor->nNodes; ++k) {
+		const double *a = aDonor->x[k];
+		const double *b = aDonor->x[(k + 1) % aDonor->nNodes];
+		double cross = (b[X] - a[X]) * (x[Y] - a[Y]) - (b[Y] - a[Y]) * (x[X] - a[X]);
+		if (cross * area < 0.0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * \brief Map the states of a chunk of donor elements onto the elements of the
+ *	partition
+ *
+ * An element inside of a donor keeps the state of the first such donor,
+ * otherwise it takes the state of the donor with the nearest barycenter,
+ * which is searched within one donor size around the donor.
+ * \param[in] donor The donor elements
+ * \param[in] nDonors Number of donor elements
+ */
+static void mapDonors(const donor_t *donor, long nDonors)
+{
+	for (long iDonor = 0; iDonor < nDonors; ++iDonor) {
+		const donor_t *aDonor = &donor[iDonor];
+		double boxMin[NDIM] = {1e200, 1e200};
+		double boxMax[NDIM] = {-1e200, -1e200};
+		double center[NDIM] = {0.0, 0.0};
+		for (int k = 0; k < aDonor->nNodes; ++k) {
+			for (int iDim = 0; iDim < NDIM; ++iDim) {
+				boxMin[iDim] = fmin(boxMin[iDim], aDonor->x[k][iDim]);
+				boxMax[iDim] = fmax(boxMax[iDim], aDonor->x[k][iDim]);
+				center[iDim] += aDonor->x[k][iDim] / aDonor->nNodes;
+			}
+		}
+
+		double h = fmax(boxMax[X] - boxMin[X], boxMax[Y] - boxMin[Y]);
+		long lo[NDIM], hi[NDIM];
+		bool isOutside = false;
+		for (int iDim = 0; iDim < NDIM; ++iDim) {
+			boxMin[iDim] -= h;
+			boxMax[iDim] += h;
+			double posMin = (boxMin[iDim] - mapGridMin[iDim]) * mapGridDxQ[iDim];
+			double posMax = (boxMax[iDim] - mapGridMin[iDim]) * mapGridDxQ[iDim];
+			if ((posMax < 0.0) || (posMin > mapGridN[iDim])) {
+				isOutside = true;
+			}
+
+			lo[iDim] = (posMin < 0.0 ? 0 : (long)posMin);
+			hi[iDim] = (posMax >= mapGridN[iDim] ? mapGridN[iDim] - 1 : (long)posMax);
+		}
+
+		if (isOutside) {
+			continue;
+		}
+
+		for (long j = lo[Y]; j <= hi[Y]; ++j) {
+			for (long i = lo[X]; i <= hi[X]; ++i) {
+				long iCell = j * mapGridN[X] + i;
+				for (long k = mapCellOffset[iCell]; k < mapCellOffset[iCell + 1]; ++k) {
+					long iElem = mapCellElem[k];
+					if (mapDist[iElem] < 0.0) {
+						continue;
+					}
+
+					double x[NDIM] = {elemData.bary[X][iElem], elemData.bary[Y][iElem]};
+					double dist;
+					if (isInsideDonor(aDonor, x)) {
+						dist = -1.0;
+					} else if ((x[X] < boxMin[X]) || (x[X] > boxMax[X]) ||
+							(x[Y] < boxMin[Y]) || (x[Y] > boxMax[Y])) {
+						continue;
+					} else {
+						dist = (x[X] - center[X]) * (x[X] - center[X]) +
+							(x[Y] - center[Y]) * (x[Y] - center[Y]);
+					}
+
+					if (dist < mapDist[iElem]) {
+						mapDist[iElem] = dist;
+						for (int iVar = 0; iVar < NVAR; ++iVar) {
+							elemData.pVar[iVar][iElem] = aDonor->pVar[iVar];
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+/**
+ * \brief Map the flow solution of a CGNS file of another mesh onto the
+ *	elements of the partition
+ *
+ * The triangle and quadrilateral sections of the file are read chunk by
+ * chunk, the cell centered solution is numbered like these elements.
+ * \param[in] indexFile Index of the opened CGNS file
+ * \param[in] iSol Index of the flow solution
+ * \param[in] nDonorElems Number of cells of the zone
+ */
+void mapRestartSolution(int indexFile, int iSol, long nDonorElems)
+{
+	const char *fieldName[NVAR] = {
+		[RHO] = "Density", [VX] = "VelocityX", [VY] = "VelocityY",
+		[P] = "Pressure"};
+
+	createMapGrid();
+
+	int nSections;
+	if (cg_nsections(indexFile, 1, 1, &nSections))
+		cg_error_exit();
+
+	donor_t *donor = malloc(MAP_CHUNK * sizeof(donor_t));
+	cgsize_t *elems = malloc(4 * MAP_CHUNK * sizeof(cgsize_t));
+	double **field = dyn2DdblArray(NVAR, MAP_CHUNK);
+	if ((!donor) || (!elems)) {
+		printf("| ERROR: could not allocate donor\n");
+		exit(1);
+	}
+
+	long nDonors = 0;
+	for (int indexSection = 1; indexSection <= nSections; ++indexSection) {
+		char sectionName[33];
+		ElementType_t sectionType;
+		cgsize_t elStart, elEnd;
+		int nbndry, parentFlag;
+		if (cg_section_read(indexFile, 1, 1, indexSection, sectionName,
+				&sectionType, &elStart, &elEnd, &nbndry, &parentFlag))
+			cg_error_exit();
+
+		int nNodes;
+		switch (sectionType) {
+		case TRI_3:
+			nNodes = 3;
+			break;
+		case QUAD_4:
+			nNodes = 4;
+			break;
+		default:
+			continue;
+		}
+
+		if (elEnd > nDonorElems) {
+			printf("| ERROR: The cells of the restart file have to be numbered first\n");
+			exit(1);
+		}
+
+		for (cgsize_t first = elStart; first <= elEnd; first += MAP_CHUNK) {
+			cgsize_t last = (elEnd - first < MAP_CHUNK ? elEnd : first + MAP_CHUNK - 1);
+			long nChunk = last - first + 1;
+			if (cg_elements_partial_read(indexFile, 1, 1, indexSection,
+					first, last, elems, NULL))
+				cg_error_exit();
+
+			/* only the nodes of the chunk are read */
+			cgsize_t nodeMin = elems[0], nodeMax = elems[0];
+			for (long i = 1; i < nChunk * nNodes; ++i) {
+				nodeMin = (elems[i] < nodeMin ? elems[i] : nodeMin);
+				nodeMax = (elems[i] > nodeMax ? elems[i] : nodeMax);
+			}
+
+			double **coord = dyn2DdblArray(NDIM, nodeMax - nodeMin + 1);
+			cgsize_t rMin[1] = {nodeMin}, rMax[1] = {nodeMax};
+			if (cg_coord_read(indexFile, 1, 1, "CoordinateX", RealDouble,
+					rMin, rMax, coord[X]))
+				cg_error_exit();
+			if (cg_coord_read(indexFile, 1, 1, "CoordinateY", RealDouble,
+					rMin, rMax, coord[Y]))
+				cg_error_exit();
+
+			rMin[0] = first;
+			rMax[0] = last;
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				if (cg_field_read(indexFile, 1, 1, iSol, fieldName[iVar],
+						RealDouble, rMin, rMax, field[iVar]))
+					cg_error_exit();
+			}
+
+			for (long i = 0; i < nChunk; ++i) {
+				donor[i].nNodes = nNodes;
+				for (int k = 0; k < nNodes; ++k) {
+					long iNode = elems[i * nNodes + k] - nodeMin;
+					donor[i].x[k][X] = coord[X][iNode];
+					donor[i].x[k][Y] = coord[Y][iNode];
+				}
+
+				for (int iVar = 0; iVar < NVAR; ++iVar) {
+					donor[i].pVar[iVar] = field[iVar][i];
+				}
+			}
+			free(coord);
+
+			mapDonors(donor, nChunk);
+			nDonors += nChunk;
+		}
+	}
+
+	free(donor);
+	free(elems);
+	free(field);
+
+	if (nDonors != nDonorElems) {
+		printf("| ERROR: Only %ld of %ld cells of the restart file are triangles or quadrilaterals\n",
+				nDonors, nDonorElems);
+		exit(1);
+	}
+}
+
+/**
+ * \brief Check that every element got a donor and put the grid file of the
+ *	mesh in place, once the restart file is read on all partitions
+ */
+void finishRestartMapping(void)
+{
+	double nMapped[3] = {0.0};
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		if (mapDist[iElem] < 0.0) {
+			nMapped[0]++;
+		} else if (mapDist[iElem] < NO_DONOR) {
+			nMapped[1]++;
+		} else {
+			nMapped[2]++;
+		}
+	}
+	globalSum(nMapped, 3);
+
+	free(mapCellOffset);
+	free(mapCellElem);
+	free(mapDist);
+
+	if (nMapped[2] > 0.0) {
+		printf("| ERROR: %.0f elements lie outside of the mesh of the restart file\n",
+				nMapped[2]);
+		exit(1);
+	}
+
+	printf("| %.0f Elements inside of Donor Elements, %.0f from the Nearest Donor\n",
+			nMapped[0], nMapped[1]);
+
+	if (mappedGridFile[0] != '\0') {
+		if ((mpiRank == 0) && rename(gridFile, mappedGridFile)) {
+			printf("| ERROR: could not rename '%s'\n", gridFile);
+			exit(1);
+		}
+		strcpy(gridFile, mappedGridFile);
+		mappedGridFile[0] = '\0';
+	}
+}
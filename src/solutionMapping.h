@@ -0,0 +1,18 @@
+/** \file
+ *
+ * \author hhh
+ * \date Thu 15 Oct 2026 11:48:05 PM CEST
+ */
+
+#ifndef SOLUTIONMAPPING_H
+#define SOLUTIONMAPPING_H
+
+#include <stdbool.h>
+
+extern bool isMappedRestart;
+
+void checkRestartMesh(void);
+void mapRestartSolution(int indexFile, int iSol, long nDonorElems);
+void finishRestartMapping(void);
+
+#endif
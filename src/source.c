@@ -60,26 +60,28 @@ void evalSource(int iSource, double x[NDIM], double time, double source[NVAR])
 }
 
 /**
- * \brief Calculate the contribution of the source terms
+ * \brief Calculate the contribution of the source terms, has to be called by
+ *	all threads of a parallel region
  * \param[in] time The computation time at which the evaluate the source term
  */
 void calcSource(double time)
 {
-	#pragma omp parallel for
+	#pragma omp for schedule(static)
 	for (long iElem = 0; iElem < nElems; ++iElem) {
 		elem_t *aElem = elem[iElem];
-		aElem->source[RHO] = 0.0;
-		aElem->source[VX]  = 0.0;
-		aElem->source[VY]  = 0.0;
-		aElem->source[E]   = 0.0;
+		double elemSource[NVAR] = {0.0};
 
 		double source[NVAR] = {0.0};
 		for (int iGP = 0; iGP < aElem->nGP; ++iGP) {
 			evalSource(sourceFunc, aElem->xGP[iGP], time, source);
-			aElem->source[RHO] += source[RHO] * aElem->wGP[iGP];
-			aElem->source[VX]  += source[VX]  * aElem->wGP[iGP];
-			aElem->source[VY]  += source[VY]  * aElem->wGP[iGP];
-			aElem->source[E]   += source[E]   * aElem->wGP[iGP];
+			elemSource[RHO] += source[RHO] * aElem->wGP[iGP];
+			elemSource[VX]  += source[VX]  * aElem->wGP[iGP];
+			elemSource[VY]  += source[VY]  * aElem->wGP[iGP];
+			elemSource[E]   += source[E]   * aElem->wGP[iGP];
+		}
+
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			elemData.source[iVar][iElem] = elemSource[iVar];
 		}
 	}
 }
@@ -23,12 +23,24 @@
 #include "linearSolver.h"
 #include "equationOfState.h"
 #include "finiteVolume.h"
+#include "reconstruction.h"
 #include "memTools.h"
+#include "timer.h"
+#include "parallel.h"
+#include "multigrid.h"
+#include "checkpoint.h"
+#include "device.h"
+#include "insitu.h"
+#include "meshAdaptation.h"
+#include "batch.h"
 
 /* extern variables */
 double	cfl;				/**< Courant-Friedrichs-Lewy number */
 double	dfl;				/**< diffusive Courant-Friedrichs-Lewy number */
 double	t;				/**< global calculation time */
+double	dtGlobal;			/**< time step of the current iteration,
+					  the mean of the element time steps for
+					  local time stepping */
 
 double	timeOverall;			/**< overall time */
 
@@ -36,6 +48,7 @@ int	timeOrder;			/**< order of the time integration */
 bool	isTimeStep1D;			/**< flag for 1D problem */
 
 bool	isStationary;			/**< flag for stationary problem */
+bool	isLocalTimeStep;		/**< local time stepping flag */
 long	maxIter;			/**< maximum number of iterations */
 double	stopTime;			/**< simulation end time */
 long	iniIterationNumber;		/**< initial iteration number */
@@ -56,12 +69,34 @@ double	printTime;			/**< calculation time after which to output */
 int	nRKstages;			/**< number of Runge-Kutta stages */
 double	RKcoeff[6] = {0.0};		/**< array of Runge-Kutta coefficients */
 bool	isImplicit;			/**< implicit calculation flag */
+double	smoothingCoeff;			/**< implicit residual smoothing coefficient */
+int	nSmoothingIter;			/**< Jacobi iterations of the residual smoothing */
+bool	isCflRamping;			/**< switched evolution relaxation of the CFL number */
+double	cflMin;				/**< lower bound of the ramped CFL number */
+double	cflMax;				/**< upper bound of the ramped CFL number */
+double	cflGrowth;			/**< maximum factor between the CFL numbers of
+					  two iterations */
+double	cflBackoff;			/**< factor on the CFL number after a failed
+					  Newton iteration */
+double	cflResidual;			/**< residual of the previous iteration */
+bool	isDualTimeStepping;		/**< BDF2 with dual time stepping flag */
+double	dtPrevious;			/**< previous physical time step, 0 without
+					  a previous solution */
+double	**cVarPrevious;			/**< conservative variables of the previous
+					  time step */
 
 /* local variables */
 double **deltaX;			/**< variable used in implicit calculation */
 double **Q;				/**< variable used in implicit calculation */
 double **F_X0;				/**< variable used in implicit calculation */
 double **F_XK;				/**< variable used in implicit calculation */
+double **resUnsmoothed;			/**< time step weighted residual before smoothing */
+double **resSmoothed;			/**< smoothed residual [NVAR][nTotal] */
+double **resSmoothedNew;		/**< next Jacobi iterate of `resSmoothed` */
+int	nPseudoIter;			/**< maximum number of pseudo time steps */
+double	pseudoCfl;			/**< CFL number of the pseudo time steps */
+double	pseudoResidual;			/**< reduction of the unsteady residual at
+					  which the pseudo time stepping stops */
 
 /**
  * \brief Initialize the time discretization
@@ -178,6 +213,7 @@ void initTimeDisc(void)
 	}
 
 	/* stationary computation */
+	isDualTimeStepping = false;
 	if (isStationary) {
 		doAbortOnClResidual = doAbortOnCdResidual = false;
 
@@ -216,8 +252,79 @@ void initTimeDisc(void)
 			printf("| ERROR: Wrong Definition of Abort Residual\n");
 			exit(1);
 		}
+
+		/* switched evolution relaxation: the CFL number follows the
+		 * decrease of the residual */
+		isCflRamping = false;
+		if (isImplicit) {
+			isCflRamping = getBool("cflRamping", "F");
+		}
+		if (isCflRamping) {
+			cflMin = getDbl("cflMin", "0.01");
+			cflMax = getDbl("cflMax", "1000");
+			cflGrowth = getDbl("cflGrowth", "2");
+			cflBackoff = getDbl("cflBackoff", "0.5");
+			if ((cflMin <= 0.0) || (cflMin > cfl) || (cflMax < cfl)
+					|| (cflGrowth < 1.0) || (cflBackoff <= 0.0)
+					|| (cflBackoff >= 1.0)) {
+				printf("| ERROR: Wrong Definition of CFL Ramping\n");
+				exit(1);
+			}
+			cflResidual = 0.0;
+			printf("| CFL Ramping: %g <= CFL <= %g\n", cflMin, cflMax);
+		}
 	} else {
+		isCflRamping = false;
 		printf("| Transient Problem\n");
+
+		/* second order in time, the physical time step is not limited
+		 * by the stability of the pseudo time stepping */
+		isDualTimeStepping = false;
+		if (isImplicit) {
+			isDualTimeStepping = getBool("dualTimeStepping", "F");
+		}
+		if (isDualTimeStepping) {
+			nPseudoIter = getInt("nPseudoIter", "20");
+			pseudoCfl = getDbl("pseudoCFL", "10");
+			pseudoResidual = getDbl("pseudoResidual", "1e-3");
+			if ((nPseudoIter < 1) || (pseudoCfl <= 0.0)
+					|| (pseudoResidual <= 0.0) || (pseudoResidual >= 1.0)) {
+				printf("| ERROR: Wrong Definition of Dual Time Stepping\n");
+				exit(1);
+			}
+
+			cVarPrevious = dyn2DdblArray(NVAR, nElems);
+			dtPrevious = 0.0;
+			printf("| Dual Time Stepping: BDF2, at most %d Pseudo Time Steps with CFL %g\n",
+					nPseudoIter, pseudoCfl);
+		}
+	}
+
+	/* every element advances with its own time step */
+	isLocalTimeStep = getBool("localTimeStep", "F");
+	if (isLocalTimeStep) {
+		if (!isStationary) {
+			printf("| ERROR: Local Time Stepping requires a stationary problem\n");
+			exit(1);
+		}
+		printf("| Local Time Stepping\n");
+	}
+
+	/* implicit residual smoothing of the explicit time stepping */
+	smoothingCoeff = getDbl("residualSmoothing", "0.0");
+	if (smoothingCoeff > 0.0) {
+		if ((!isStationary) || isImplicit) {
+			printf("| ERROR: Residual Smoothing requires a stationary, explicit calculation\n");
+			exit(1);
+		}
+
+		nSmoothingIter = getInt("smoothingIterations", "2");
+		printf("| Implicit Residual Smoothing: %d Jacobi Iterations\n", nSmoothingIter);
+
+		long nTotal = nElems + nBCsides + nHaloElems;
+		resUnsmoothed = dyn2DdblArray(NVAR, nElems);
+		resSmoothed = dyn2DdblArray(NVAR, nTotal);
+		resSmoothedNew = dyn2DdblArray(NVAR, nTotal);
 	}
 
 	maxIter = getInt("maxIter", "100000");
@@ -234,13 +341,68 @@ void initTimeDisc(void)
 	} else {
 		printf("| Start Time: %g\n", t);
 	}
+}
 
-	printIter = (iniIterationNumber / IOiterInterval + 1) * IOiterInterval;
-	printTime = (floor(t / IOtimeInterval) + 1) * IOtimeInterval;
+/**
+ * \brief Compute the stable time steps of the elements
+ *
+ * The convective and viscous time steps of every element are stored in
+ * `elemData.dt`, their minima over the elements of the partition are
+ * returned.
+ * \param[in] cflConv Courant-Friedrichs-Lewy number
+ * \param[in] dflVisc Diffusive Courant-Friedrichs-Lewy number
+ * \param[out] dtMin Minimum of the convective and of the viscous time steps
+ */
+static void stableTimeSteps(double cflConv, double dflVisc, double dtMin[2])
+{
+	double gamPrMax = fmax(4.0 / 3.0, gam / Pr);
+	double dtConvMax = 1e150;
+	#pragma omp parallel for reduction(min:dtConvMax)
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		/* convective time step */
+		double a = sqrt(gam * elemData.pVar[P][iElem] / elemData.pVar[RHO][iElem]);
+		double sumSpectralRadii = (fabs(elemData.pVar[VX][iElem]) + a) * elemData.sx[iElem]
+					+ (fabs(elemData.pVar[VY][iElem]) + a) * elemData.sy[iElem];
+		double dtConv = cflConv * elemData.area[iElem] / sumSpectralRadii;
+		if (!isfinite(dtConv)) {
+			printf("| Convective Time Step NaN\n");
+			exit(1);
+		}
+		elemData.dt[iElem] = dtConv;
+		dtConvMax = fmin(dtConvMax, dtConv);
+	}
+
+	/* viscous time step */
+	double dtViscMax = 1e150;
+	if (mu > 1e-10) {
+		#pragma omp parallel for reduction(min:dtViscMax)
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			double sumSpectralRadii
+				= gamPrMax * mu * elemData.sx[iElem] * elemData.sx[iElem]
+				+ gamPrMax * mu * elemData.sy[iElem] * elemData.sy[iElem];
+			double dtVisc = dflVisc * elemData.pVar[RHO][iElem] * elemData.pVar[RHO][iElem]
+				* elemData.area[iElem] * elemData.area[iElem]
+				/ (4.0 * sumSpectralRadii);
+			if (!isfinite(dtVisc)) {
+				printf("| Viscous Time Step NaN\n");
+				exit(1);
+			}
+			elemData.dt[iElem] = fmin(elemData.dt[iElem], dtVisc);
+			dtViscMax = fmin(dtViscMax, dtVisc);
+		}
+	}
+
+	dtMin[0] = dtConvMax;
+	dtMin[1] = dtViscMax;
 }
 
 /**
  * \brief Compute the time step
+ *
+ * The time step of every element is stored in `elemData.dt`. It is the global
+ * minimum of the stable time steps, or for local time stepping the stable time
+ * step of the element itself. The resulting time step is then the area
+ * weighted mean of the element time steps, by which the pseudo time advances.
  * \param[in] pTime The print time interval
  * \param[out] dt The resulting time step
  * \param[out] viscousTimeStepDominates Flag for if the viscous time step is
@@ -248,15 +410,21 @@ void initTimeDisc(void)
  */
 void calcTimeStep(double pTime, double *dt, bool *viscousTimeStepDominates)
 {
+	double tic = CPU_TIME();
+
 	/* calculate local timestep for each cell */
 	*viscousTimeStepDominates = false;
-	if (isTimeStep1D) {
+	if (useDevice) {
+		double dtMin[2];
+		deviceTimeStep(dtMin);
+		globalMin(dtMin, 2);
+		*dt = fmin(dtMin[0], dtMin[1]);
+	} else if (isTimeStep1D) {
 		double dtMax = 1e150;
 		#pragma omp parallel for reduction(min:dtMax)
 		for (long iElem = 0; iElem < nElems; ++iElem) {
-			elem_t *aElem = elem[iElem];
-			double a = sqrt(gam * aElem->pVar[P] / aElem->pVar[RHO]);
-			double dtConv = cfl * aElem->sy / (fabs(aElem->pVar[VX]) + a);
+			double a = sqrt(gam * elemData.pVar[P][iElem] / elemData.pVar[RHO][iElem]);
+			double dtConv = cfl * elemData.sy[iElem] / (fabs(elemData.pVar[VX][iElem]) + a);
 			if (!isfinite(dtConv)) {
 				printf("| Convective Time Step NaN\n");
 				exit(1);
@@ -265,47 +433,20 @@ void calcTimeStep(double pTime, double *dt, bool *viscousTimeStepDominates)
 				printf("| TimeStep1D not implemented for Navier Stokes. Set mu = 0 or turn off timeStep1D\n");
 				exit(1);
 			}
+			elemData.dt[iElem] = dtConv;
 			dtMax = fmin(dtMax, dtConv);
 		}
 
+		globalMin(&dtMax, 1);
 		*dt = dtMax;
 	} else {
-		double gamPrMax = fmax(4.0 / 3.0, gam / Pr);
-		double dtConvMax = 1e150;
-		#pragma omp parallel for reduction(min:dtConvMax)
-		for (long iElem = 0; iElem < nElems; ++iElem) {
-			elem_t *aElem = elem[iElem];
-			/* convective time step */
-			double a = sqrt(gam * aElem->pVar[P] / aElem->pVar[RHO]);
-			double sumSpectralRadii = (fabs(aElem->pVar[VX]) + a) * aElem->sx
-						+ (fabs(aElem->pVar[VY]) + a) * aElem->sy;
-			double dtConv = cfl * aElem->area / sumSpectralRadii;
-			if (!isfinite(dtConv)) {
-				printf("| Convective Time Step NaN\n");
-				exit(1);
-			}
-			dtConvMax = fmin(dtConvMax, dtConv);
-		}
+		double dtMin[2];
+		stableTimeSteps(cfl, dfl, dtMin);
 
-		/* viscous time step */
-		double dtViscMax = 1e150;
-		if (mu > 1e-10) {
-			#pragma omp parallel for reduction(min:dtViscMax)
-			for (long iElem = 0; iElem < nElems; ++iElem) {
-				elem_t *aElem = elem[iElem];
-				double sumSpectralRadii
-					= gamPrMax * mu * aElem->sx * aElem->sx
-					+ gamPrMax * mu * aElem->sy * aElem->sy;
-				double dtVisc = dfl * aElem->pVar[RHO] * aElem->pVar[RHO]
-					* aElem->area * aElem->area
-					/ (4.0 * sumSpectralRadii);
-				if (!isfinite(dtVisc)) {
-					printf("| Viscous Time Step NaN\n");
-					exit(1);
-				}
-				dtViscMax = fmin(dtViscMax, dtVisc);
-			}
-		}
+		/* minimum over all partitions */
+		globalMin(dtMin, 2);
+		double dtConvMax = dtMin[0];
+		double dtViscMax = dtMin[1];
 
 		*dt = fmin(dtConvMax, dtViscMax);
 		if (dtViscMax < dtConvMax) {
@@ -313,88 +454,259 @@ void calcTimeStep(double pTime, double *dt, bool *viscousTimeStepDominates)
 		}
 	}
 
+	if (isLocalTimeStep) {
+		/* keep the stable time step of each cell */
+		double dtMean[2] = {0.0, 0.0};
+		if (useDevice) {
+			deviceMeanTimeStep(dtMean);
+		} else {
+			#pragma omp parallel for reduction(+:dtMean[:2])
+			for (long iElem = 0; iElem < nElems; ++iElem) {
+				dtMean[0] += elemData.area[iElem] * elemData.dt[iElem];
+				dtMean[1] += elemData.area[iElem];
+			}
+		}
+
+		globalSum(dtMean, 2);
+		*dt = dtMean[0] / dtMean[1];
+		dtGlobal = *dt;
+		timerAdd(TIMER_TIMESTEP, &tic);
+		return;
+	}
+
 	/* special treatment for data output and stoptime */
 	if ((t + *dt > pTime) || (t + *dt > stopTime)) {
 		*dt = fmin(pTime, stopTime) - t;
 	} else if ((t + 1.5 * *dt > pTime) || (t + 1.5 * *dt > stopTime)) {
 		*dt = 0.5 * (fmin(pTime, stopTime) - t);
 	}
+	dtGlobal = *dt;
 
 	/* set local time step for each cell to the global time step */
+	if (useDevice) {
+		deviceSetTimeStep(*dt);
+	} else {
+		#pragma omp parallel for
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			elemData.dt[iElem] = *dt;
+		}
+	}
+	timerAdd(TIMER_TIMESTEP, &tic);
+}
+
+/**
+ * \brief Implicit residual smoothing of the time derivative
+ *
+ * The increments `dt * u_t` of the elements are smoothed with the central
+ * operator `(1 + eps * n) R_i - eps * sum_j R_j = dt_i * u_t_i`, where the sum
+ * runs over the `n` neighbors of element `i` that are no ghost elements. The
+ * system is solved approximately with a few Jacobi iterations, which damps
+ * the high frequencies of the residual and thereby allows larger CFL numbers
+ * for the explicit time stepping.
+ */
+static void smoothResidual(void)
+{
 	#pragma omp parallel for
 	for (long iElem = 0; iElem < nElems; ++iElem) {
-		elem_t *aElem = elem[iElem];
-		aElem->dt = *dt;
+		double dtElem = elemData.dt[iElem];
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			resUnsmoothed[iVar][iElem] = dtElem * elemData.u_t[iVar][iElem];
+			resSmoothed[iVar][iElem] = resUnsmoothed[iVar][iElem];
+		}
+	}
+
+	for (int iIter = 0; iIter < nSmoothingIter; ++iIter) {
+		double **halo[] = {resSmoothed};
+		startHaloExchange(1, halo);
+		finishHaloExchange();
+
+		#pragma omp parallel for
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			double sum[NVAR] = {0.0};
+			int nNeighbors = 0;
+
+			for (long j = elemData.sideOffset[iElem]; j < elemData.sideOffset[iElem + 1]; ++j) {
+				long NBelem = sideData.elem[elemData.sideIdx[j] ^ 1];
+
+				/* the ghost elements do not take part */
+				if ((NBelem >= nElems) && (NBelem < nElems + nBCsides)) {
+					continue;
+				}
+
+				sum[RHO] += resSmoothed[RHO][NBelem];
+				sum[MX]  += resSmoothed[MX][NBelem];
+				sum[MY]  += resSmoothed[MY][NBelem];
+				sum[E]   += resSmoothed[E][NBelem];
+				nNeighbors++;
+			}
+
+			double diagq = 1.0 / (1.0 + smoothingCoeff * nNeighbors);
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				resSmoothedNew[iVar][iElem] = (resUnsmoothed[iVar][iElem]
+						+ smoothingCoeff * sum[iVar]) * diagq;
+			}
+		}
+
+		double **tmp = resSmoothed;
+		resSmoothed = resSmoothedNew;
+		resSmoothedNew = tmp;
+	}
+
+	#pragma omp parallel for
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		double dtElemq = 1.0 / elemData.dt[iElem];
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			elemData.u_t[iVar][iElem] = resSmoothed[iVar][iElem] * dtElemq;
+		}
+	}
+}
+
+/**
+ * \brief Update the conservative variables with the Euler scheme, has to be
+ *	called by all threads of a parallel region
+ *
+ * The static schedule over the elements matches the calculation of the time
+ * derivatives in `fvTimeDerivativeThread`, so no barrier is needed in between.
+ */
+static void eulerUpdate(void)
+{
+	#pragma omp for schedule(static) nowait
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		double dtElem = elemData.dt[iElem];
+		elemData.cVar[RHO][iElem] += dtElem * elemData.u_t[RHO][iElem];
+		elemData.cVar[MX][iElem]  += dtElem * elemData.u_t[MX][iElem];
+		elemData.cVar[MY][iElem]  += dtElem * elemData.u_t[MY][iElem];
+		elemData.cVar[E][iElem]   += dtElem * elemData.u_t[E][iElem];
+
+		consPrimElem(iElem);
+	}
+}
+
+/**
+ * \brief Update the conservative variables with a stage of the Runge-Kutta
+ *	scheme, has to be called by all threads of a parallel region
+ *
+ * The static schedule over the elements matches the calculation of the time
+ * derivatives in `fvTimeDerivativeThread`, so no barrier is needed in between.
+ *
+ * \param[in] iStage Runge-Kutta stage
+ */
+static void rkStageUpdate(int iStage)
+{
+	#pragma omp for schedule(static) nowait
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		double dtElem = elemData.dt[iElem];
+		elemData.cVar[RHO][iElem] = elemData.cVarStage[RHO][iElem]
+			+ RKcoeff[iStage] * dtElem * elemData.u_t[RHO][iElem];
+
+		elemData.cVar[MX][iElem]  = elemData.cVarStage[MX][iElem]
+			+ RKcoeff[iStage] * dtElem * elemData.u_t[MX][iElem];
+
+		elemData.cVar[MY][iElem]  = elemData.cVarStage[MY][iElem]
+			+ RKcoeff[iStage] * dtElem * elemData.u_t[MY][iElem];
+
+		elemData.cVar[E][iElem]   = elemData.cVarStage[E][iElem]
+			+ RKcoeff[iStage] * dtElem * elemData.u_t[E][iElem];
+
+		consPrimElem(iElem);
 	}
 }
 
 /**
- * \brief Performs explicit time step using Euler scheme
+ * \brief Performs explicit time step using Euler scheme, with the time steps
+ *	of the elements
+ *
+ * With the fused residual evaluation and without residual smoothing, the
+ * residual and the update are done in a single parallel region.
+ *
  * \param[in] time Computation time at calculation
- * \param[in] dt Time step at calculation
  * \param[out] resIter Residual vector for time step
  */
-void explicitTimeStepEuler(double time, double dt, double resIter[NVAR + 2])
+void explicitTimeStepEuler(double time, double resIter[NVAR + 2])
 {
-	fvTimeDerivative(time);
+	if (useDevice) {
+		deviceTimeStepEuler(resIter);
+		return;
+	}
 
-	#pragma omp parallel for
-	for (long iElem = 0; iElem < nElems; ++iElem) {
-		elem_t *aElem = elem[iElem];
+	double tic;
+	if (useFusedResidual && (smoothingCoeff <= 0.0)) {
+		#pragma omp parallel
+		{
+			fvTimeDerivativeThread(time);
+			#pragma omp master
+			tic = CPU_TIME();
+			eulerUpdate();
+		}
+	} else {
+		fvTimeDerivative(time);
 
-		aElem->cVar[RHO] += dt * aElem->u_t[RHO];
-		aElem->cVar[MX]  += dt * aElem->u_t[MX];
-		aElem->cVar[MY]  += dt * aElem->u_t[MY];
-		aElem->cVar[E]   += dt * aElem->u_t[E];
+		tic = CPU_TIME();
+		if (smoothingCoeff > 0.0) {
+			smoothResidual();
+		}
 
-		consPrim(aElem->cVar, aElem->pVar);
+		#pragma omp parallel
+		eulerUpdate();
 	}
+	timerAdd(TIMER_TIMEUPDATE, &tic);
 
 	globalResidual(resIter);
 }
 
 /**
  * \brief Performs explicit time step using Runge-Kutta scheme `nRKstages` stages
+ *
+ * With the fused residual evaluation and without residual smoothing, each
+ * stage runs in a single parallel region, see `explicitTimeStepEuler`.
+ *
  * \param[in] time Computation time at calculation
  * \param[in] dt Time step at calculation
  * \param[out] resIter Residual vector for time step
  */
 void explicitTimeStepRK(double time, double dt, double resIter[NVAR + 2])
 {
+	if (useDevice) {
+		deviceTimeStepRK(resIter);
+		return;
+	}
+
 	/* save the initial solution as needed for the RK scheme */
-	#pragma omp parallel for
+	double tic = CPU_TIME();
+	#pragma omp parallel for schedule(static)
 	for (long iElem = 0; iElem < nElems; ++iElem) {
-		elem_t *aElem = elem[iElem];
-		aElem->cVarStage[RHO] = aElem->cVar[RHO];
-		aElem->cVarStage[MX]  = aElem->cVar[MX];
-		aElem->cVarStage[MY]  = aElem->cVar[MY];
-		aElem->cVarStage[E]   = aElem->cVar[E];
+		elemData.cVarStage[RHO][iElem] = elemData.cVar[RHO][iElem];
+		elemData.cVarStage[MX][iElem]  = elemData.cVar[MX][iElem];
+		elemData.cVarStage[MY][iElem]  = elemData.cVar[MY][iElem];
+		elemData.cVarStage[E][iElem]   = elemData.cVar[E][iElem];
 	}
+	timerAdd(TIMER_TIMEUPDATE, &tic);
 
 	/* loop over the RK stages */
 	for (int iStage = 1; iStage <= nRKstages; ++iStage) {
 		double dtStage = RKcoeff[iStage - 1] * dt;
-		fvTimeDerivative(time + dtStage);
 
 		/* time update of conservative variables */
-		#pragma omp parallel for
-		for (long iElem = 0; iElem < nElems; ++iElem) {
-			elem_t *aElem = elem[iElem];
-
-			aElem->cVar[RHO] = aElem->cVarStage[RHO]
-				+ RKcoeff[iStage] * dt * aElem->u_t[RHO];
-
-			aElem->cVar[MX]  = aElem->cVarStage[MX]
-				+ RKcoeff[iStage] * dt * aElem->u_t[MX];
-
-			aElem->cVar[MY]  = aElem->cVarStage[MY]
-				+ RKcoeff[iStage] * dt * aElem->u_t[MY];
+		if (useFusedResidual && (smoothingCoeff <= 0.0)) {
+			#pragma omp parallel
+			{
+				fvTimeDerivativeThread(time + dtStage);
+				#pragma omp master
+				tic = CPU_TIME();
+				rkStageUpdate(iStage);
+			}
+		} else {
+			fvTimeDerivative(time + dtStage);
 
-			aElem->cVar[E]   = aElem->cVarStage[E]
-				+ RKcoeff[iStage] * dt * aElem->u_t[E];
+			tic = CPU_TIME();
+			if (smoothingCoeff > 0.0) {
+				smoothResidual();
+			}
 
-			consPrim(aElem->cVar, aElem->pVar);
+			#pragma omp parallel
+			rkStageUpdate(iStage);
 		}
+		timerAdd(TIMER_TIMEUPDATE, &tic);
 	}
 
 	globalResidual(resIter);
@@ -408,68 +720,71 @@ void explicitTimeStepRK(double time, double dt, double resIter[NVAR + 2])
  * \param[in] time Computation time at calculation
  * \param[in] dt Time step at calculation
  * \param[out] resIter Residual vector for time step
+ * \return False if the Newton method did not converge, the solution is then
+ *	reset to the state at the beginning of the time step
  */
-void implicitTimeStep(double time, double dt, double resIter[NVAR + 2])
+bool implicitTimeStep(double time, double dt, double resIter[NVAR + 2])
 {
 	/* input parameters for Newton */
 	double alpha = 1.0;
 	double beta = 1.0;
 
+	double tic = CPU_TIME();
 	#pragma omp parallel for
 	for (long iElem = 0; iElem < nElems; ++iElem) {
-		elem_t *aElem = elem[iElem];
-
-		Q[RHO][iElem] = aElem->cVar[RHO];
-		Q[MX][iElem]  = aElem->cVar[MX];
-		Q[MY][iElem]  = aElem->cVar[MY];
-		Q[E][iElem]   = aElem->cVar[E];
+		Q[RHO][iElem] = elemData.cVar[RHO][iElem];
+		Q[MX][iElem]  = elemData.cVar[MX][iElem];
+		Q[MY][iElem]  = elemData.cVar[MY][iElem];
+		Q[E][iElem]   = elemData.cVar[E][iElem];
 
-		consPrim(aElem->cVar, aElem->pVar);
+		consPrimElem(iElem);
 	}
+	timerAdd(TIMER_TIMEUPDATE, &tic);
 
 	/* Newton */
 	time = t + beta * dt;
 
 	fvTimeDerivative(time);
 
+	tic = CPU_TIME();
 	#pragma omp parallel for
 	for (long iElem = 0; iElem < nElems; ++iElem) {
-		elem_t *aElem = elem[iElem];
-
-		F_X0[RHO][iElem] = aElem->cVar[RHO] - Q[RHO][iElem]
-			- alpha * dt * aElem->u_t[RHO];
+		double dtElem = elemData.dt[iElem];
+		F_X0[RHO][iElem] = elemData.cVar[RHO][iElem] - Q[RHO][iElem]
+			- alpha * dtElem * elemData.u_t[RHO][iElem];
 
-		F_X0[MX][iElem]  = aElem->cVar[MX]  - Q[MX][iElem]
-			- alpha * dt * aElem->u_t[MX];
+		F_X0[MX][iElem]  = elemData.cVar[MX][iElem]  - Q[MX][iElem]
+			- alpha * dtElem * elemData.u_t[MX][iElem];
 
-		F_X0[MY][iElem]  = aElem->cVar[MY]  - Q[MY][iElem]
-			- alpha * dt * aElem->u_t[MY];
+		F_X0[MY][iElem]  = elemData.cVar[MY][iElem]  - Q[MY][iElem]
+			- alpha * dtElem * elemData.u_t[MY][iElem];
 
-		F_X0[E][iElem]   = aElem->cVar[E]   - Q[E][iElem]
-			- alpha * dt * aElem->u_t[E];
+		F_X0[E][iElem]   = elemData.cVar[E][iElem]   - Q[E][iElem]
+			- alpha * dtElem * elemData.u_t[E][iElem];
 
-		XK[RHO][iElem] = aElem->cVar[RHO];
-		XK[MX][iElem]  = aElem->cVar[MX];
-		XK[MY][iElem]  = aElem->cVar[MY];
-		XK[E][iElem]   = aElem->cVar[E];
+		XK[RHO][iElem] = elemData.cVar[RHO][iElem];
+		XK[MX][iElem]  = elemData.cVar[MX][iElem];
+		XK[MY][iElem]  = elemData.cVar[MY][iElem];
+		XK[E][iElem]   = elemData.cVar[E][iElem];
 
-		R_XK[RHO][iElem] = aElem->u_t[RHO];
-		R_XK[MX][iElem]  = aElem->u_t[MX];
-		R_XK[MY][iElem]  = aElem->u_t[MY];
-		R_XK[E][iElem]   = aElem->u_t[E];
+		R_XK[RHO][iElem] = elemData.u_t[RHO][iElem];
+		R_XK[MX][iElem]  = elemData.u_t[MX][iElem];
+		R_XK[MY][iElem]  = elemData.u_t[MY][iElem];
+		R_XK[E][iElem]   = elemData.u_t[E][iElem];
 
 		F_XK[RHO][iElem] = F_X0[RHO][iElem];
 		F_XK[MX][iElem]  = F_X0[MX][iElem];
 		F_XK[MY][iElem]  = F_X0[MY][iElem];
 		F_XK[E][iElem]   = F_X0[E][iElem];
 	}
+	timerAdd(TIMER_TIMEUPDATE, &tic);
 
 	/* vector dot product */
 	double norm2_F_X0 = vectorDotProduct(F_X0, F_X0);
 
 	/* preparation for matrix vector multiplication */
 	double eps2newtonLoc =
-		fmax(1e-8 * 1e-8 * nElems * eps2newton / norm2_F_X0,
+		fmax(1e-8 * 1e-8 * nElemsGlobal * eps2newton / norm2_F_X0,
 		     eps2newton);
 	double norm2_F_XK = norm2_F_X0;
 
@@ -499,42 +814,43 @@ void implicitTimeStep(double time, double dt, double resIter[NVAR + 2])
 
 		nInnerNewton++;
 
-		GMRES_M(time, dt, alpha, F_XK, sqrt(norm2_F_XK),
+		GMRES_M(time, alpha, F_XK, sqrt(norm2_F_XK),
 				&abortCritGMRES, deltaX);
 
+		tic = CPU_TIME();
 		#pragma omp parallel for
 		for (long iElem = 0; iElem < nElems; ++iElem) {
-			elem_t *aElem = elem[iElem];
-
 			XK[RHO][iElem] += deltaX[RHO][iElem];
 			XK[MX][iElem]  += deltaX[MX][iElem];
 			XK[MY][iElem]  += deltaX[MY][iElem];
 			XK[E][iElem]   += deltaX[E][iElem];
 
-			aElem->cVar[RHO] = XK[RHO][iElem];
-			aElem->cVar[MX]  = XK[MX][iElem];
-			aElem->cVar[MY]  = XK[MY][iElem];
-			aElem->cVar[E]   = XK[E][iElem];
+			elemData.cVar[RHO][iElem] = XK[RHO][iElem];
+			elemData.cVar[MX][iElem]  = XK[MX][iElem];
+			elemData.cVar[MY][iElem]  = XK[MY][iElem];
+			elemData.cVar[E][iElem]   = XK[E][iElem];
 
-			consPrim(aElem->cVar, aElem->pVar);
+			consPrimElem(iElem);
 		}
+		timerAdd(TIMER_TIMEUPDATE, &tic);
 
 		fvTimeDerivative(time);
 
+		tic = CPU_TIME();
 		#pragma omp parallel for
 		for (long iElem = 0; iElem < nElems; ++iElem) {
-			elem_t *aElem = elem[iElem];
-
-			R_XK[RHO][iElem] = aElem->u_t[RHO];
-			R_XK[MX][iElem]  = aElem->u_t[MX];
-			R_XK[MY][iElem]  = aElem->u_t[MY];
-			R_XK[E][iElem]   = aElem->u_t[E];
-
-			F_XK[RHO][iElem] = aElem->cVar[RHO] - Q[RHO][iElem] - alpha * dt * aElem->u_t[RHO];
-			F_XK[MX][iElem]  = aElem->cVar[MX]  - Q[MX][iElem]  - alpha * dt * aElem->u_t[MX];
-			F_XK[MY][iElem]  = aElem->cVar[MY]  - Q[MY][iElem]  - alpha * dt * aElem->u_t[MY];
-			F_XK[E][iElem]   = aElem->cVar[E]   - Q[E][iElem]   - alpha * dt * aElem->u_t[E];
+			R_XK[RHO][iElem] = elemData.u_t[RHO][iElem];
+			R_XK[MX][iElem]  = elemData.u_t[MX][iElem];
+			R_XK[MY][iElem]  = elemData.u_t[MY][iElem];
+			R_XK[E][iElem]   = elemData.u_t[E][iElem];
+
+			double dtElem = elemData.dt[iElem];
+			F_XK[RHO][iElem] = elemData.cVar[RHO][iElem] - Q[RHO][iElem] - alpha * dtElem * elemData.u_t[RHO][iElem];
+			F_XK[MX][iElem]  = elemData.cVar[MX][iElem]  - Q[MX][iElem]  - alpha * dtElem * elemData.u_t[MX][iElem];
+			F_XK[MY][iElem]  = elemData.cVar[MY][iElem]  - Q[MY][iElem]  - alpha * dtElem * elemData.u_t[MY][iElem];
+			F_XK[E][iElem]   = elemData.cVar[E][iElem]   - Q[E][iElem]   - alpha * dtElem * elemData.u_t[E][iElem];
 		}
+		timerAdd(TIMER_TIMEUPDATE, &tic);
 
 		norm2_F_XK = vectorDotProduct(F_XK, F_XK);
 	}
@@ -545,7 +861,151 @@ void implicitTimeStep(double time, double dt, double resIter[NVAR + 2])
 		printf("| %g\n", eps2newton);
 		printf("| Newton NOT converged with %d Newton iteraions\n", nInnerNewton);
 		printf("| Norm / Norm_R0 = %g\n", norm2_F_XK / norm2_F_X0);
-		exit(1);
+
+		tic = CPU_TIME();
+		#pragma omp parallel for
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			elemData.cVar[RHO][iElem] = Q[RHO][iElem];
+			elemData.cVar[MX][iElem]  = Q[MX][iElem];
+			elemData.cVar[MY][iElem]  = Q[MY][iElem];
+			elemData.cVar[E][iElem]   = Q[E][iElem];
+
+			consPrimElem(iElem);
+		}
+		timerAdd(TIMER_TIMEUPDATE, &tic);
+
+		return false;
+	}
+
+	globalResidual(resIter);
+	return true;
+}
+
+/**
+ * \brief Adapt the CFL number to the residual of the last iteration
+ *
+ * Switched evolution relaxation: the CFL number is scaled by the ratio of the
+ * previous to the current residual of the abort variable, so that it grows
+ * while the solution converges and shrinks when the residual rises again. The
+ * change per iteration is bounded by `cflGrowth`.
+ * \param[in] resIter Residual vector of the iteration
+ */
+static void rampCfl(double resIter[NVAR + 2])
+{
+	double res = fabs(resIter[abortVariable]);
+	if ((cflResidual > 0.0) && (res > 0.0)) {
+		double ratio = fmin(fmax(cflResidual / res, 1.0 / cflGrowth), cflGrowth);
+		cfl = fmin(fmax(cfl * ratio, cflMin), cflMax);
+	}
+	cflResidual = res;
+}
+
+/**
+ * \brief Second order implicit time step with dual time stepping
+ *
+ * The backward difference formula of second order with variable time steps,
+ * with w = dt / dtPrevious,
+ *
+ *	U - Q - alpha dt R(U) = 0,	alpha = (1 + w) / (1 + 2 w),
+ *	Q = ((1 + w)^2 U^n - w^2 U^(n-1)) / (1 + 2 w),
+ *
+ * is solved by marching in pseudo time with the local pseudo time steps dtau
+ * of `pseudoCFL`. Every pseudo time step is an implicit Euler step, which is
+ * linearized and solved by the GMRES of the Newton method. Its system
+ * (I - h dR/dU) dU = -h r, with the unsteady residual r = (U - Q) / (alpha dt)
+ * - R(U), has the form of the Newton system with the combined time step
+ * h = alpha dt dtau / (alpha dt + dtau) of each element, which approaches the
+ * Newton method for large pseudo time steps. The first time step, without a
+ * previous solution, uses the implicit Euler scheme, alpha = 1 and Q = U^n.
+ *
+ * \param[in] time Computation time at the beginning of the time step
+ * \param[in] dt Physical time step
+ * \param[out] resIter Residual vector for time step
+ */
+static void dualTimeStep(double time, double dt, double resIter[NVAR + 2])
+{
+	double w = (dtPrevious > 0.0 ? dt / dtPrevious : 0.0);
+	double alphaDt = (1.0 + w) / (1.0 + 2.0 * w) * dt;
+	double cN = (1.0 + w) * (1.0 + w) / (1.0 + 2.0 * w);
+	double cPrevious = w * w / (1.0 + 2.0 * w);
+
+	double tic = CPU_TIME();
+	#pragma omp parallel for
+	for (long iElem = 0; iElem < nElems; ++iElem) {
+		for (int iVar = 0; iVar < NVAR; ++iVar) {
+			double cVarN = elemData.cVar[iVar][iElem];
+			Q[iVar][iElem] = cN * cVarN - cPrevious * cVarPrevious[iVar][iElem];
+			cVarPrevious[iVar][iElem] = cVarN;
+		}
+	}
+	timerAdd(TIMER_TIMEUPDATE, &tic);
+	dtPrevious = dt;
+
+	time += dt;
+
+	/* pseudo time steps */
+	double norm2_R0 = 0.0, norm2_R = 0.0;
+	nInnerNewton = 0;
+	while (true) {
+		tic = CPU_TIME();
+		double dtMin[2];
+		stableTimeSteps(pseudoCfl, dfl * pseudoCfl / cfl, dtMin);
+		timerAdd(TIMER_TIMESTEP, &tic);
+
+		fvTimeDerivative(time);
+
+		tic = CPU_TIME();
+		#pragma omp parallel for
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			double dtau = elemData.dt[iElem];
+			double h = alphaDt * dtau / (alphaDt + dtau);
+			elemData.dt[iElem] = h;
+
+			for (int iVar = 0; iVar < NVAR; ++iVar) {
+				double r = (elemData.cVar[iVar][iElem] - Q[iVar][iElem]) / alphaDt
+					- elemData.u_t[iVar][iElem];
+				F_X0[iVar][iElem] = r;
+				F_XK[iVar][iElem] = h * r;
+				XK[iVar][iElem] = elemData.cVar[iVar][iElem];
+				R_XK[iVar][iElem] = elemData.u_t[iVar][iElem];
+			}
+		}
+		timerAdd(TIMER_TIMEUPDATE, &tic);
+
+		norm2_R = vectorDotProduct(F_X0, F_X0);
+		if (nInnerNewton == 0) {
+			norm2_R0 = norm2_R;
+		}
+		if ((norm2_R <= pseudoResidual * pseudoResidual * norm2_R0)
+				|| (nInnerNewton == nPseudoIter)) {
+			break;
+		}
+
+		nInnerNewton++;
+
+		double abortCritGMRES;
+		GMRES_M(time, 1.0, F_XK, sqrt(vectorDotProduct(F_XK, F_XK)),
+				&abortCritGMRES, deltaX);
+
+		tic = CPU_TIME();
+		#pragma omp parallel for
+		for (long iElem = 0; iElem < nElems; ++iElem) {
+			elemData.cVar[RHO][iElem] = XK[RHO][iElem] + deltaX[RHO][iElem];
+			elemData.cVar[MX][iElem]  = XK[MX][iElem]  + deltaX[MX][iElem];
+			elemData.cVar[MY][iElem]  = XK[MY][iElem]  + deltaX[MY][iElem];
+			elemData.cVar[E][iElem]   = XK[E][iElem]   + deltaX[E][iElem];
+
+			consPrimElem(iElem);
+		}
+		timerAdd(TIMER_TIMEUPDATE, &tic);
+	}
+
+	nNewtonIterGlobal += nInnerNewton;
+
+	if (norm2_R > pseudoResidual * pseudoResidual * norm2_R0) {
+		printf("| WARNING: Dual Time Stepping NOT converged with %d Pseudo Time Steps\n",
+				nInnerNewton);
+		printf("| Norm / Norm_R0 = %g\n", sqrt(norm2_R / norm2_R0));
 	}
 
 	globalResidual(resIter);
@@ -560,10 +1020,17 @@ void timeDisc(void)
 {
 	bool hasConverged = (isStationary ? false : true);
 
-	/* write initial condition to disk */
-	printf("\nWriting Initial Condition to Disk:\n");
-	dataOutput(t, iniIterationNumber);
-	printf("| done.\n");
+	/* the restart file may have set the time and the iteration number, a
+	 * checkpoint continues the output schedule and was already written */
+	if (!isCheckpointRestart) {
+		printIter = (iniIterationNumber / IOiterInterval + 1) * IOiterInterval;
+		printTime = (floor(t / IOtimeInterval) + 1) * IOtimeInterval;
+
+		/* write initial condition to disk */
+		printf("\nWriting Initial Condition to Disk:\n");
+		dataOutput(t, iniIterationNumber);
+		printf("| done.\n");
+	}
 
 	/* main program loop */
 	printf("\nStarting Computation:\n");
@@ -572,12 +1039,22 @@ void timeDisc(void)
 		if (omp_get_max_threads() > 1) {
 			printf("| OpenMP Enabled: Running on %d threads\n",
 					omp_get_max_threads());
+
+			/* the pages of the arrays are placed by the threads
+			 * that work on them, which only pays off if the
+			 * threads stay on their cores, the concurrent batch
+			 * variants would be pinned to the same cores */
+			if ((omp_get_proc_bind() == omp_proc_bind_false) && !isBatchJob) {
+				printf("| WARNING: OpenMP threads are not pinned, set e.g.\n");
+				printf("|          OMP_PROC_BIND=close OMP_PLACES=cores\n");
+			}
 		} else {
 			printf("| OpenMP Enabled: Running on 1 thread\n");
 		}
 	#else
 		printf("| OpenMP Disabled: Running on 1 thread\n");
 	#endif
+	printf("| Peak Resident Memory: %g MB\n", peakMemory());
 
 	long start = iniIterationNumber + 1;
 	double tStart = CPU_TIME();
@@ -598,13 +1075,30 @@ void timeDisc(void)
 		/* main computation loop */
 		double resIter[NVAR + 2] = {0.0};
 		if (!isImplicit) {
-			if ((timeOrder == 1) && (nRKstages == 1)) {
-				explicitTimeStepEuler(t, dt, resIter);
+			if (nMGlevels > 1) {
+				multigridCycle(t, dt, resIter);
+			} else if ((timeOrder == 1) && (nRKstages == 1)) {
+				explicitTimeStepEuler(t, resIter);
 			} else {
 				explicitTimeStepRK(t, dt, resIter);
 			}
+		} else if (isDualTimeStepping) {
+			dualTimeStep(t, dt, resIter);
 		} else {
-			implicitTimeStep(t, dt, resIter);
+			while (!implicitTimeStep(t, dt, resIter)) {
+				if ((!isCflRamping) || (cfl * cflBackoff < cflMin)) {
+					exit(1);
+				}
+
+				cfl *= cflBackoff;
+				printf("| WARNING: Repeating Iteration %ld with CFL %g\n",
+						iter, cfl);
+				calcTimeStep(printTime, &dt, &viscousTimeStepDominates);
+			}
+
+			if (isCflRamping) {
+				rampCfl(resIter);
+			}
 		}
 		t += dt;
 
@@ -630,6 +1124,12 @@ void timeDisc(void)
 
 		/* residual abort criterion */
 		if (isStationary) {
+			if ((limiterFreezeResidual > 0.0) && (!isLimiterFrozen)
+					&& (fabs(resIter[abortVariable]) <= limiterFreezeResidual)) {
+				isLimiterFrozen = true;
+				printf("| Limiter Frozen at Iteration %ld\n", iter);
+			}
+
 			if (fabs(resIter[abortVariable]) <= abortResidual) {
 				if (doAbortOnClResidual) {
 					if (fabs(resIter[4]) <= clAbortResidual) {
@@ -705,6 +1205,9 @@ void timeDisc(void)
 					printf("|            MY : %20.14e\n", resIter[MY]);
 					printf("|            E  : %20.14e\n", resIter[E]);
 				}
+				if (isCflRamping) {
+					printf("|            CFL: %g\n", cfl);
+				}
 			} else {
 				printf("| Time     : %.10g\n", t);
 				calcTimeStep(printTime + 1e150, &dt, &viscousTimeStepDominates);
@@ -714,6 +1217,10 @@ void timeDisc(void)
 				}
 			}
 
+			if (useAdaptation) {
+				printf("| Elements : %ld\n", nElems);
+			}
+
 			if (hasExactSolution) {
 				calcErrors(t);
 			}
@@ -729,6 +1236,19 @@ void timeDisc(void)
 				printIter += IOiterInterval;
 			}
 		}
+
+		/* the mesh follows the solution */
+		if (useAdaptation && (iter % adaptIterInterval == 0)) {
+			adaptMesh(t);
+		}
+
+		/* in situ visualization between the data outputs */
+		if (useCatalyst && (catalystIterInterval > 0)
+				&& (iter % catalystIterInterval == 0)) {
+			catalystOutput(t, iter);
+		}
+
+		checkpoint(iter);
 	}
 
 	double tEnd = CPU_TIME();
@@ -749,23 +1269,25 @@ void timeDisc(void)
 		}
 	}
 
+	/* wait for the pending outputs */
+	closeDataOutput();
+
 	/* standard output */
 	printf("\nComputation Time: %.10g s\n", tEnd - tStart);
 	if (isImplicit) {
-		printf("| Newton Iterations: %d\n", nNewtonIterGlobal);
-		printf("| GMRES Iterations : %d\n", nGMRESiterGlobal);
+		printLinearSolverStats(tEnd - tStart);
+	}
+	if (useAdaptation) {
+		printAdaptationStats();
 	}
+	printTimers(tEnd - tStart, (iter > maxIter ? iter - start : iter - start + 1));
 
 	/* close all open files */
-	if (isStationary) {
+	if (resFile) {
 		fclose(resFile);
 	}
 
-	if (recordPoint.nPoints > 0) {
-		for (int iPt = 0; iPt < recordPoint.nPoints; ++iPt) {
-			fclose(recordPoint.ioFile[iPt]);
-		}
-	}
+	closeRecordPoints();
 
 	/* free memory that is allocated for implicit calculation */
 	if (isImplicit) {
@@ -774,4 +1296,14 @@ void timeDisc(void)
 		free(F_X0);
 		free(F_XK);
 	}
+
+	if (isDualTimeStepping) {
+		free(cVarPrevious);
+	}
+
+	if (smoothingCoeff > 0.0) {
+		free(resUnsmoothed);
+		free(resSmoothed);
+		free(resSmoothedNew);
+	}
 }
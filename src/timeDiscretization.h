@@ -10,6 +10,8 @@
 #include <stdbool.h>
 #include <time.h>
 
+#include "main.h"
+
 #ifdef _OPENMP
 /**
  * \brief Get the CPU time for a parallel program
@@ -25,6 +27,7 @@
 extern double	cfl;
 extern double	dfl;
 extern double	t;
+extern double	dtGlobal;
 
 extern double	timeOverall;
 
@@ -32,6 +35,7 @@ extern int	timeOrder;
 extern bool	isTimeStep1D;
 
 extern bool	isStationary;
+extern bool	isLocalTimeStep;
 extern long	maxIter;
 extern double	stopTime;
 extern long	iniIterationNumber;
@@ -52,8 +56,18 @@ extern double	printTime;
 extern int	nRKstages;
 extern double	RKcoeff[6];
 extern bool	isImplicit;
+extern double	smoothingCoeff;
+extern int	nSmoothingIter;
+extern bool	isCflRamping;
+extern double	cflResidual;
+extern bool	isDualTimeStepping;
+extern double	dtPrevious;
+extern double	**cVarPrevious;
 
 void initTimeDisc(void);
+void calcTimeStep(double pTime, double *dt, bool *viscousTimeStepDominates);
+void explicitTimeStepEuler(double time, double resIter[NVAR + 2]);
+void explicitTimeStepRK(double time, double dt, double resIter[NVAR + 2]);
 void timeDisc(void);
 
 #endif
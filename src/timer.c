@@ -0,0 +1,222 @@
+/** \file
+ *
+ * \brief Accumulating wall clock timers for the phases of the residual
+ *	evaluation and of the time loop
+ *
+ * Every phase accumulates its time and the number of timed sections. The
+ * flux and update loops additionally accumulate the busy time of every
+ * thread, which shows the load imbalance between the threads. At the end of
+ * the run the timers are printed and optionally dumped into a JSON file.
+ *
+ * \author hhh
+ * \date Wed 14 Oct 2026 10:12:31 AM CEST
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+
+#include "main.h"
+#include "timer.h"
+#include "timeDiscretization.h"
+#include "readInTools.h"
+#include "output.h"
+#include "mesh.h"
+#include "parallel.h"
+
+/* extern variables */
+double timerSum[NTIMERS];		/**< accumulated time of each phase */
+long timerCount[NTIMERS];		/**< number of timed sections of each
+					  phase */
+
+/* local variables */
+const char *timerName[NTIMERS] = {
+	"Reconstruction",
+	"Boundary Conditions",
+	"Flux Calculation",
+	"Source Term",
+	"Residual Update",
+	"Halo Exchange",
+	"Time Step",
+	"Time Update",
+	"Analyze",
+	"Data Output",
+	"Jacobian Assembly",
+	"LU-SGS",
+	"GMRES",
+	"Device Transfer",
+	"Mesh Adaptation"
+};
+
+int nThreads;				/**< number of threads */
+double (*threadSum)[NTIMERS];		/**< accumulated busy time of each
+					  thread and phase */
+char timerFile[STRLEN];			/**< name of the JSON timer file, empty
+					  if none is written */
+
+/**
+ * \brief Initialize the timers
+ */
+void initTimers(void)
+{
+	char *tmp = getStr("timerFile", "");
+	strcpy(timerFile, tmp);
+	free(tmp);
+
+#ifdef _OPENMP
+	nThreads = omp_get_max_threads();
+#else
+	nThreads = 1;
+#endif
+
+	threadSum = calloc(nThreads, sizeof(double[NTIMERS]));
+	if (!threadSum) {
+		printf("| ERROR: could not allocate threadSum\n");
+		exit(1);
+	}
+}
+
+/**
+ * \brief Add the time since tic to a phase and restart tic
+ * \param[in] phase The phase to which the time is added
+ * \param[in,out] tic Start time of the phase, set to the current time
+ */
+void timerAdd(int phase, double *tic)
+{
+	double toc = CPU_TIME();
+	timerSum[phase] += toc - *tic;
+	timerCount[phase]++;
+	*tic = toc;
+}
+
+/**
+ * \brief Add the busy time of the calling thread to a phase, called by every
+ *	thread of a parallel region before the barrier
+ * \param[in] phase The phase to which the time is added
+ * \param[in] tic Time at which the thread started its work
+ */
+void timerThreadAdd(int phase, double tic)
+{
+#ifdef _OPENMP
+	threadSum[omp_get_thread_num()][phase] += CPU_TIME() - tic;
+#else
+	threadSum[0][phase] += CPU_TIME() - tic;
+#endif
+}
+
+/**
+ * \brief Load imbalance of a phase between the threads
+ * \param[in] phase The phase
+ * \return Maximum over mean busy time of the threads, 0 if the phase has no
+ *	thread timers
+ */
+double timerImbalance(int phase)
+{
+	double tMax = 0.0, tMean = 0.0;
+	for (int iThread = 0; iThread < nThreads; ++iThread) {
+		tMax = (threadSum[iThread][phase] > tMax ?
+				threadSum[iThread][phase] : tMax);
+		tMean += threadSum[iThread][phase] / nThreads;
+	}
+
+	return (tMean > 0.0 ? tMax / tMean : 0.0);
+}
+
+/**
+ * \brief Write the timers into the JSON timer file
+ * \param[in] tTotal Total computation time
+ * \param[in] nIter Number of iterations
+ */
+void writeTimerFile(double tTotal, long nIter)
+{
+	FILE *file = fopen(timerFile, "w");
+	if (!file) {
+		printf("| WARNING: could not write timer file '%s'\n", timerFile);
+		return;
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"case\": \"%s\",\n", strOutFile);
+	fprintf(file, "  \"elements\": %ld,\n", nElemsGlobal);
+	fprintf(file, "  \"ranks\": %d,\n", mpiSize);
+	fprintf(file, "  \"threads\": %d,\n", nThreads);
+	fprintf(file, "  \"iterations\": %ld,\n", nIter);
+	fprintf(file, "  \"time\": %.9g,\n", tTotal);
+	fprintf(file, "  \"cellUpdatesPerSecond\": %.9g,\n",
+			(tTotal > 0.0 ? nElemsGlobal * nIter / tTotal : 0.0));
+	fprintf(file, "  \"cellResidualsPerSecond\": %.9g,\n",
+			(tTotal > 0.0 ? nElemsGlobal * timerCount[TIMER_UPDATE] / tTotal : 0.0));
+	fprintf(file, "  \"phases\": [\n");
+	for (int iPhase = 0; iPhase < NTIMERS; ++iPhase) {
+		fprintf(file, "    {\"name\": \"%s\", \"time\": %.9g, \"calls\": %ld, "
+				"\"imbalance\": %.6g}%s\n", timerName[iPhase],
+				timerSum[iPhase], timerCount[iPhase],
+				timerImbalance(iPhase),
+				(iPhase < NTIMERS - 1 ? "," : ""));
+	}
+	fprintf(file, "  ]\n");
+	fprintf(file, "}\n");
+	fclose(file);
+
+	printf("| Timers written to '%s'\n", timerFile);
+}
+
+/**
+ * \brief Print the accumulated time of all phases and the throughput
+ * \param[in] tTotal Total computation time
+ * \param[in] nIter Number of iterations
+ */
+void printTimers(double tTotal, long nIter)
+{
+	if (tTotal > 0.0) {
+		printf("| Cell Updates per Second   : %.6g\n",
+				nElemsGlobal * nIter / tTotal);
+		printf("| Cell Residuals per Second : %.6g\n",
+				nElemsGlobal * timerCount[TIMER_UPDATE] / tTotal);
+	}
+
+	double tSum = 0.0;
+	for (int iPhase = 0; iPhase < NRESIDUALTIMERS; ++iPhase) {
+		tSum += timerSum[iPhase];
+	}
+
+	if (tSum > 0.0) {
+		printf("| Residual Evaluation: %6.2f %% of the computation, %.6g s\n",
+				100.0 * tSum / tTotal, tSum);
+		for (int iPhase = 0; iPhase < NRESIDUALTIMERS; ++iPhase) {
+			printf("|   %-20s: %6.2f %%, %.6g s", timerName[iPhase],
+					100.0 * timerSum[iPhase] / tSum, timerSum[iPhase]);
+
+			/* maximum over mean busy time of the threads */
+			double imbalance = timerImbalance(iPhase);
+			if (imbalance > 0.0) {
+				printf(", imbalance %.3f", imbalance);
+			}
+			printf("\n");
+		}
+	}
+
+	/* the time loop phases may contain residual evaluations */
+	printf("| Time Loop Phases:\n");
+	for (int iPhase = NRESIDUALTIMERS; iPhase < NTIMERS; ++iPhase) {
+		if (timerCount[iPhase] > 0) {
+			printf("|   %-20s: %6.2f %%, %.6g s, %ld calls\n",
+					timerName[iPhase],
+					100.0 * timerSum[iPhase] / tTotal,
+					timerSum[iPhase], timerCount[iPhase]);
+		}
+	}
+
+	if ((strlen(timerFile) > 0) && (mpiRank == 0)) {
+		writeTimerFile(tTotal, nIter);
+	}
+}
+
+/**
+ * \brief Free the thread timers
+ */
+void freeTimers(void)
+{
+	free(threadSum);
+}
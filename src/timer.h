@@ -0,0 +1,44 @@
+/** \file
+ *
+ * \author hhh
+ * \date Wed 14 Oct 2026 10:12:31 AM CEST
+ */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+/**
+ * \brief Timed phases, first the exclusive phases of the residual evaluation,
+ *	then the phases of the time loop, which may contain residual evaluations
+ */
+enum timerPhase {
+	TIMER_RECONSTRUCTION,	/**< gradients, limiting and side states */
+	TIMER_BOUNDARY,		/**< ghost states at barycenters and sides */
+	TIMER_FLUX,		/**< numerical fluxes */
+	TIMER_SOURCE,		/**< source term */
+	TIMER_UPDATE,		/**< accumulation of the time derivative */
+	TIMER_COMMUNICATION,	/**< halo exchange with the neighbor partitions */
+	NRESIDUALTIMERS,	/**< number of residual evaluation phases */
+	TIMER_TIMESTEP = NRESIDUALTIMERS, /**< time step calculation */
+	TIMER_TIMEUPDATE,	/**< update loops of the time integration */
+	TIMER_ANALYZE,		/**< residuals, coefficients and record points */
+	TIMER_OUTPUT,		/**< data output */
+	TIMER_MATRIX,		/**< assembly of the preconditioner */
+	TIMER_LUSGS,		/**< LU-SGS preconditioner sweeps */
+	TIMER_GMRES,		/**< GMRES solves, including the matrix vector
+				  products and the preconditioner */
+	TIMER_TRANSFER,		/**< transfers between the device and the host */
+	TIMER_ADAPTATION,	/**< refinement and coarsening of the mesh */
+	NTIMERS			/**< number of timed phases */
+};
+
+extern double timerSum[NTIMERS];
+extern long timerCount[NTIMERS];
+
+void initTimers(void);
+void timerAdd(int phase, double *tic);
+void timerThreadAdd(int phase, double tic);
+void printTimers(double tTotal, long nIter);
+void freeTimers(void);
+
+#endif